@@ -38,12 +38,25 @@ extern "C" {
 
 #define ESP_BLOCKDEV_CMD_MARK_DELETED       ESP_BLOCKDEV_CMD_SYSTEM_BASE        /*!< mark given range as invalid, data to be deleted/overwritten eventually */
 #define ESP_BLOCKDEV_CMD_ERASE_CONTENTS     ESP_BLOCKDEV_CMD_SYSTEM_BASE + 1    /*!< erase required range and set the contents to the device's default bit values */
+#define ESP_BLOCKDEV_CMD_GET_STATS          ESP_BLOCKDEV_CMD_SYSTEM_BASE + 2    /*!< get the operation statistics of the device */
 
 typedef struct esp_blockdev_cmd_arg_erase_t {
     uint64_t start_addr;                            /*!< IN  - starting address of the disk space to erase/trim/discard/sanitize (in bytes), must be a multiple of erase block size */
     size_t erase_len;                               /*!< IN  - size of the area to erase/trim/discard/sanitize (in bytes), must be a multiple of erase block size */
 } esp_blockdev_cmd_arg_erase_t;
 
+typedef struct esp_blockdev_cmd_arg_stats_t {
+    uint32_t read_ops;                              /*!< OUT - number of read operations requested from the device */
+    uint32_t write_ops;                             /*!< OUT - number of write operations requested from the device */
+    uint32_t erase_ops;                             /*!< OUT - number of erase operations requested from the device */
+    uint32_t lower_read_ops;                        /*!< OUT - number of read operations issued to the underlying device(s) */
+    uint32_t lower_write_ops;                       /*!< OUT - number of write operations issued to the underlying device(s) */
+    uint32_t lower_erase_ops;                       /*!< OUT - number of erase operations issued to the underlying device(s) */
+    uint32_t hits;                                  /*!< OUT - number of blocks or requests served by the device without accessing the underlying device(s) */
+    uint64_t read_bytes;                            /*!< OUT - number of bytes read from the device */
+    uint64_t write_bytes;                           /*!< OUT - number of bytes written to the device */
+} esp_blockdev_cmd_arg_stats_t;
+
 /**
  * @brief Block device property flags
  *
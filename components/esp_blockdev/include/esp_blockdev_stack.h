@@ -0,0 +1,174 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include "esp_err.h"
+#include "esp_blockdev.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * @file esp_blockdev_stack.h
+ * @brief Generic stacking devices of the Block Device Layer.
+ *
+ * Each device created by the functions below wraps one or more existing BDL devices (the lower devices)
+ * and exposes the same interface, so the devices can be combined into stacks in any order.
+ *
+ * Common rules:
+ * - The lower devices are not owned by the stacking device. They must stay valid until the stacking device
+ *   is released and they have to be released by the caller afterwards.
+ * - Device flags are inherited from the lower device(s), the geometry is derived from them.
+ * - All the devices support the ESP_BLOCKDEV_CMD_GET_STATS ioctl command, other commands are passed to the lower device(s).
+ * - The devices have no internal locking. Accesses to one stack must be serialized by the caller,
+ *   as it is done by the file systems.
+ */
+
+/**
+ * @brief Configuration of the block cache device
+ */
+typedef struct {
+    size_t block_size;                  /*!< Size of one cached block in bytes. 0 means the erase size of the lower device.
+                                             Must be a multiple of the read and write sizes of the lower device. */
+    size_t block_count;                 /*!< Number of cached blocks */
+} esp_blockdev_cache_config_t;
+
+#define ESP_BLOCKDEV_CACHE_CONFIG_DEFAULT() { \
+    .block_size = 0, \
+    .block_count = 8, \
+}
+
+/**
+ * @brief Create a block cache device on top of a lower device
+ *
+ * Blocks read from the lower device are kept in RAM and the least recently used block is replaced on a miss.
+ * Writes are passed to the lower device immediately (write-through) and the cached copies are updated,
+ * taking the and_type_write flag of the lower device into account. Erased ranges are dropped from the cache.
+ * Reads at least as large as the whole cache bypass it.
+ *
+ * @param lower Lower device handle
+ * @param config Cache configuration
+ * @param[out] out_handle New device handle
+ *
+ * @return
+ *      - ESP_OK on success
+ *      - ESP_ERR_INVALID_ARG if a parameter is NULL or the configuration doesn't fit the lower device geometry
+ *      - ESP_ERR_NO_MEM if the memory for the cache can't be allocated
+ */
+esp_err_t esp_blockdev_cache_get_blockdev(esp_blockdev_handle_t lower, const esp_blockdev_cache_config_t *config, esp_blockdev_handle_t *out_handle);
+
+/**
+ * @brief Configuration of the read-ahead device
+ */
+typedef struct {
+    size_t window_size;                 /*!< Number of bytes read from the lower device when sequential access is detected.
+                                             Must be a multiple of the read size of the lower device. */
+} esp_blockdev_readahead_config_t;
+
+#define ESP_BLOCKDEV_READAHEAD_CONFIG_DEFAULT() { \
+    .window_size = 16 * 1024, \
+}
+
+/**
+ * @brief Create a read-ahead device on top of a lower device
+ *
+ * When a read starts where the previous one ended and it is smaller than the window, a whole window is read from
+ * the lower device and the following reads are served from it. Other reads are passed to the lower device directly.
+ * Writes update the window, erases invalidate it.
+ *
+ * @param lower Lower device handle
+ * @param config Read-ahead configuration
+ * @param[out] out_handle New device handle
+ *
+ * @return
+ *      - ESP_OK on success
+ *      - ESP_ERR_INVALID_ARG if a parameter is NULL or the configuration doesn't fit the lower device geometry
+ *      - ESP_ERR_NO_MEM if the memory for the window can't be allocated
+ */
+esp_err_t esp_blockdev_readahead_get_blockdev(esp_blockdev_handle_t lower, const esp_blockdev_readahead_config_t *config, esp_blockdev_handle_t *out_handle);
+
+/**
+ * @brief Configuration of the write-combining device
+ */
+typedef struct {
+    size_t buffer_size;                 /*!< Maximum number of bytes merged into a single write to the lower device.
+                                             Must be a multiple of the write size of the lower device. */
+} esp_blockdev_write_combine_config_t;
+
+#define ESP_BLOCKDEV_WRITE_COMBINE_CONFIG_DEFAULT() { \
+    .buffer_size = 4 * 1024, \
+}
+
+/**
+ * @brief Create a write-combining device on top of a lower device
+ *
+ * Consecutive writes are collected in a buffer and written to the lower device as one operation.
+ * The buffer is written before a read or erase of an overlapping range, a non-consecutive write, any ioctl command
+ * other than ESP_BLOCKDEV_CMD_GET_STATS, sync and release. Until then the data is not stored on the lower device,
+ * so the sync operation has to be called to make the writes persistent.
+ *
+ * @param lower Lower device handle
+ * @param config Write-combining configuration
+ * @param[out] out_handle New device handle
+ *
+ * @return
+ *      - ESP_OK on success
+ *      - ESP_ERR_INVALID_ARG if a parameter is NULL or the configuration doesn't fit the lower device geometry
+ *      - ESP_ERR_NO_MEM if the memory for the buffer can't be allocated
+ */
+esp_err_t esp_blockdev_write_combine_get_blockdev(esp_blockdev_handle_t lower, const esp_blockdev_write_combine_config_t *config, esp_blockdev_handle_t *out_handle);
+
+/**
+ * @brief Layout of the concatenation device
+ */
+typedef enum {
+    ESP_BLOCKDEV_CONCAT_LINEAR,         /*!< The second device follows the first one in the address space */
+    ESP_BLOCKDEV_CONCAT_STRIPED,        /*!< Stripes of stripe_size bytes alternate between the devices */
+} esp_blockdev_concat_mode_t;
+
+/**
+ * @brief Configuration of the concatenation device
+ */
+typedef struct {
+    esp_blockdev_concat_mode_t mode;    /*!< Address space layout */
+    size_t stripe_size;                 /*!< Stripe size in bytes for ESP_BLOCKDEV_CONCAT_STRIPED, ignored otherwise.
+                                             Must be a multiple of the erase sizes of both devices. */
+} esp_blockdev_concat_config_t;
+
+#define ESP_BLOCKDEV_CONCAT_CONFIG_DEFAULT() { \
+    .mode = ESP_BLOCKDEV_CONCAT_LINEAR, \
+    .stripe_size = 0, \
+}
+
+/**
+ * @brief Create a device combining the space of two lower devices
+ *
+ * In the linear mode the device size is the sum of both device sizes, the size of the first device has to be
+ * a multiple of the erase size of the combined device. In the striped mode, the device size is twice the size
+ * of the smaller device, rounded down to whole stripes, and consecutive accesses are spread over both devices.
+ *
+ * The read, write and erase sizes of the combined device are the larger of the sizes of both devices,
+ * which have to be multiples of the smaller ones. Both devices must have the same default_val_after_erase flag.
+ *
+ * @param first First lower device handle
+ * @param second Second lower device handle
+ * @param config Concatenation configuration
+ * @param[out] out_handle New device handle
+ *
+ * @return
+ *      - ESP_OK on success
+ *      - ESP_ERR_INVALID_ARG if a parameter is NULL or the devices can't be combined with given configuration
+ *      - ESP_ERR_NO_MEM if the memory for the device can't be allocated
+ */
+esp_err_t esp_blockdev_concat_get_blockdev(esp_blockdev_handle_t first, esp_blockdev_handle_t second, const esp_blockdev_concat_config_t *config, esp_blockdev_handle_t *out_handle);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
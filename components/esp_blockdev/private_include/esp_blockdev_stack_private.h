@@ -0,0 +1,112 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <string.h>
+#include "esp_err.h"
+#include "esp_blockdev.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Helpers shared by the stacking devices. Operations missing in the lower device ops table are reported as not supported,
+ * except for sync which is a no-op for devices without write caching. */
+
+static inline esp_err_t blockdev_lower_read(esp_blockdev_handle_t lower, esp_blockdev_cmd_arg_stats_t *stats, uint8_t *dst_buf, uint64_t src_addr, size_t len)
+{
+    if (lower->ops->read == NULL) {
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+    stats->lower_read_ops++;
+    return lower->ops->read(lower, dst_buf, len, src_addr, len);
+}
+
+static inline esp_err_t blockdev_lower_write(esp_blockdev_handle_t lower, esp_blockdev_cmd_arg_stats_t *stats, const uint8_t *src_buf, uint64_t dst_addr, size_t len)
+{
+    if (lower->ops->write == NULL) {
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+    stats->lower_write_ops++;
+    return lower->ops->write(lower, src_buf, dst_addr, len);
+}
+
+static inline esp_err_t blockdev_lower_erase(esp_blockdev_handle_t lower, esp_blockdev_cmd_arg_stats_t *stats, uint64_t start_addr, size_t len)
+{
+    if (lower->ops->erase == NULL) {
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+    stats->lower_erase_ops++;
+    return lower->ops->erase(lower, start_addr, len);
+}
+
+static inline esp_err_t blockdev_lower_sync(esp_blockdev_handle_t lower)
+{
+    if (lower->ops->sync == NULL) {
+        return ESP_OK;
+    }
+    return lower->ops->sync(lower);
+}
+
+static inline esp_err_t blockdev_lower_ioctl(esp_blockdev_handle_t lower, const uint8_t cmd, void *args)
+{
+    if (lower->ops->ioctl == NULL) {
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+    return lower->ops->ioctl(lower, cmd, args);
+}
+
+/* Check the range of an operation against the device size and the block size of the operation (0 if not supported) */
+static inline esp_err_t blockdev_check_range(esp_blockdev_handle_t dev_handle, uint64_t addr, size_t len, size_t block_size)
+{
+    if (block_size == 0) {
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+    if (addr > dev_handle->geometry.disk_size) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (len > dev_handle->geometry.disk_size - addr || addr % block_size != 0 || len % block_size != 0) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    return ESP_OK;
+}
+
+static inline bool blockdev_ranges_overlap(uint64_t addr1, size_t len1, uint64_t addr2, size_t len2)
+{
+    return addr1 < addr2 + len2 && addr2 < addr1 + len1;
+}
+
+/* Apply data written to the lower device to a copy of the same range, as the device itself would do */
+static inline void blockdev_apply_write(const esp_blockdev_t *lower, uint8_t *copy, const uint8_t *src_buf, size_t len)
+{
+    if (lower->device_flags.and_type_write) {
+        for (size_t i = 0; i < len; i++) {
+            copy[i] &= src_buf[i];
+        }
+    } else {
+        memcpy(copy, src_buf, len);
+    }
+}
+
+/* Update the part of a buffered range [buf_addr, buf_addr + buf_len) overlapped by a write */
+static inline void blockdev_update_overlap(const esp_blockdev_t *lower, uint8_t *buf, uint64_t buf_addr, size_t buf_len,
+                                           const uint8_t *src_buf, uint64_t dst_addr, size_t len)
+{
+    if (!blockdev_ranges_overlap(buf_addr, buf_len, dst_addr, len)) {
+        return;
+    }
+    uint64_t start = buf_addr > dst_addr ? buf_addr : dst_addr;
+    uint64_t end = (buf_addr + buf_len) < (dst_addr + len) ? (buf_addr + buf_len) : (dst_addr + len);
+    blockdev_apply_write(lower, buf + (start - buf_addr), src_buf + (start - dst_addr), (size_t)(end - start));
+}
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
@@ -0,0 +1,257 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include "esp_blockdev.h"
+#include "esp_blockdev_stack.h"
+#include "esp_blockdev_stack_private.h"
+
+typedef struct {
+    uint64_t addr;                      /* address of the cached block in the lower device */
+    uint32_t last_use;                  /* value of use_counter when the block was accessed for the last time */
+    bool valid;
+} cache_entry_t;
+
+typedef struct {
+    esp_blockdev_handle_t lower;
+    size_t block_size;
+    size_t block_count;
+    uint32_t use_counter;
+    cache_entry_t *entries;
+    uint8_t *data;                      /* block_count blocks, the block of entries[i] starts at data + i * block_size */
+    esp_blockdev_cmd_arg_stats_t stats;
+} blockdev_cache_t;
+
+static uint8_t *cache_block_data(blockdev_cache_t *cache, size_t index)
+{
+    return cache->data + index * cache->block_size;
+}
+
+/* Length of the block starting at block_addr, the last block of the device may be shorter */
+static size_t cache_block_len(esp_blockdev_handle_t dev_handle, blockdev_cache_t *cache, uint64_t block_addr)
+{
+    uint64_t remaining = dev_handle->geometry.disk_size - block_addr;
+    return remaining < cache->block_size ? (size_t)remaining : cache->block_size;
+}
+
+static int cache_find(blockdev_cache_t *cache, uint64_t block_addr)
+{
+    for (size_t i = 0; i < cache->block_count; i++) {
+        if (cache->entries[i].valid && cache->entries[i].addr == block_addr) {
+            return (int)i;
+        }
+    }
+    return -1;
+}
+
+static size_t cache_find_victim(blockdev_cache_t *cache)
+{
+    size_t victim = 0;
+    for (size_t i = 0; i < cache->block_count; i++) {
+        if (!cache->entries[i].valid) {
+            return i;
+        }
+        if (cache->entries[i].last_use < cache->entries[victim].last_use) {
+            victim = i;
+        }
+    }
+    return victim;
+}
+
+static void cache_invalidate_range(blockdev_cache_t *cache, uint64_t addr, size_t len)
+{
+    for (size_t i = 0; i < cache->block_count; i++) {
+        if (cache->entries[i].valid && blockdev_ranges_overlap(cache->entries[i].addr, cache->block_size, addr, len)) {
+            cache->entries[i].valid = false;
+        }
+    }
+}
+
+static esp_err_t blockdev_cache_read(esp_blockdev_handle_t dev_handle, uint8_t* dst_buf, size_t dst_buf_size, uint64_t src_addr, size_t data_read_len)
+{
+    blockdev_cache_t *cache = (blockdev_cache_t *)dev_handle->ctx;
+
+    esp_err_t res = blockdev_check_range(dev_handle, src_addr, data_read_len, dev_handle->geometry.read_size);
+    if (res != ESP_OK) {
+        return res;
+    }
+    if (dst_buf_size < data_read_len) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    cache->stats.read_ops++;
+    cache->stats.read_bytes += data_read_len;
+
+    // Reads of the size of the whole cache would only evict all the cached blocks
+    if (data_read_len >= cache->block_size * cache->block_count) {
+        return blockdev_lower_read(cache->lower, &cache->stats, dst_buf, src_addr, data_read_len);
+    }
+
+    while (data_read_len > 0) {
+        uint64_t block_addr = src_addr - src_addr % cache->block_size;
+        size_t offset = (size_t)(src_addr - block_addr);
+        size_t block_len = cache_block_len(dev_handle, cache, block_addr);
+        size_t chunk = block_len - offset < data_read_len ? block_len - offset : data_read_len;
+
+        int index = cache_find(cache, block_addr);
+        if (index >= 0) {
+            cache->stats.hits++;
+        } else {
+            index = (int)cache_find_victim(cache);
+            cache->entries[index].valid = false;
+            res = blockdev_lower_read(cache->lower, &cache->stats, cache_block_data(cache, index), block_addr, block_len);
+            if (res != ESP_OK) {
+                return res;
+            }
+            cache->entries[index].addr = block_addr;
+            cache->entries[index].valid = true;
+        }
+        cache->entries[index].last_use = ++cache->use_counter;
+        memcpy(dst_buf, cache_block_data(cache, index) + offset, chunk);
+
+        dst_buf += chunk;
+        src_addr += chunk;
+        data_read_len -= chunk;
+    }
+    return ESP_OK;
+}
+
+static esp_err_t blockdev_cache_write(esp_blockdev_handle_t dev_handle, const uint8_t* src_buf, uint64_t dst_addr, size_t data_write_len)
+{
+    blockdev_cache_t *cache = (blockdev_cache_t *)dev_handle->ctx;
+
+    if (dev_handle->device_flags.read_only) {
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+    esp_err_t res = blockdev_check_range(dev_handle, dst_addr, data_write_len, dev_handle->geometry.write_size);
+    if (res != ESP_OK) {
+        return res;
+    }
+    cache->stats.write_ops++;
+    cache->stats.write_bytes += data_write_len;
+
+    res = blockdev_lower_write(cache->lower, &cache->stats, src_buf, dst_addr, data_write_len);
+    if (res != ESP_OK) {
+        // The lower device contents are unknown now
+        cache_invalidate_range(cache, dst_addr, data_write_len);
+        return res;
+    }
+
+    for (size_t i = 0; i < cache->block_count; i++) {
+        if (cache->entries[i].valid) {
+            blockdev_update_overlap(cache->lower, cache_block_data(cache, i), cache->entries[i].addr,
+                                    cache_block_len(dev_handle, cache, cache->entries[i].addr), src_buf, dst_addr, data_write_len);
+        }
+    }
+    return ESP_OK;
+}
+
+static esp_err_t blockdev_cache_erase(esp_blockdev_handle_t dev_handle, uint64_t start_addr, size_t erase_len)
+{
+    blockdev_cache_t *cache = (blockdev_cache_t *)dev_handle->ctx;
+
+    if (dev_handle->device_flags.read_only) {
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+    esp_err_t res = blockdev_check_range(dev_handle, start_addr, erase_len, dev_handle->geometry.erase_size);
+    if (res != ESP_OK) {
+        return res;
+    }
+    cache->stats.erase_ops++;
+
+    cache_invalidate_range(cache, start_addr, erase_len);
+    return blockdev_lower_erase(cache->lower, &cache->stats, start_addr, erase_len);
+}
+
+static esp_err_t blockdev_cache_sync(esp_blockdev_handle_t dev_handle)
+{
+    blockdev_cache_t *cache = (blockdev_cache_t *)dev_handle->ctx;
+    return blockdev_lower_sync(cache->lower);
+}
+
+static esp_err_t blockdev_cache_ioctl(esp_blockdev_handle_t dev_handle, const uint8_t cmd, void* args)
+{
+    blockdev_cache_t *cache = (blockdev_cache_t *)dev_handle->ctx;
+
+    switch (cmd) {
+    case ESP_BLOCKDEV_CMD_GET_STATS:
+        if (args == NULL) {
+            return ESP_ERR_INVALID_ARG;
+        }
+        memcpy(args, &cache->stats, sizeof(cache->stats));
+        return ESP_OK;
+    case ESP_BLOCKDEV_CMD_MARK_DELETED:
+    case ESP_BLOCKDEV_CMD_ERASE_CONTENTS: {
+        if (args == NULL) {
+            return ESP_ERR_INVALID_ARG;
+        }
+        const esp_blockdev_cmd_arg_erase_t *erase = (const esp_blockdev_cmd_arg_erase_t *)args;
+        cache_invalidate_range(cache, erase->start_addr, erase->erase_len);
+        return blockdev_lower_ioctl(cache->lower, cmd, args);
+    }
+    default:
+        return blockdev_lower_ioctl(cache->lower, cmd, args);
+    }
+}
+
+static esp_err_t blockdev_cache_release(esp_blockdev_handle_t dev_handle)
+{
+    blockdev_cache_t *cache = (blockdev_cache_t *)dev_handle->ctx;
+    free(cache->data);
+    free(cache->entries);
+    free(cache);
+    free(dev_handle);
+    return ESP_OK;
+}
+
+static const esp_blockdev_ops_t s_cache_ops = {
+    .read = blockdev_cache_read,
+    .write = blockdev_cache_write,
+    .erase = blockdev_cache_erase,
+    .sync = blockdev_cache_sync,
+    .ioctl = blockdev_cache_ioctl,
+    .release = blockdev_cache_release,
+};
+
+esp_err_t esp_blockdev_cache_get_blockdev(esp_blockdev_handle_t lower, const esp_blockdev_cache_config_t *config, esp_blockdev_handle_t *out_handle)
+{
+    if (lower == NULL || config == NULL || out_handle == NULL || config->block_count == 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    size_t block_size = config->block_size != 0 ? config->block_size : lower->geometry.erase_size;
+    if (block_size == 0 || lower->geometry.read_size == 0 || block_size % lower->geometry.read_size != 0 ||
+            (lower->geometry.write_size != 0 && block_size % lower->geometry.write_size != 0)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    esp_blockdev_t *out = calloc(1, sizeof(esp_blockdev_t));
+    blockdev_cache_t *cache = calloc(1, sizeof(blockdev_cache_t));
+    cache_entry_t *entries = calloc(config->block_count, sizeof(cache_entry_t));
+    uint8_t *data = malloc(config->block_count * block_size);
+    if (out == NULL || cache == NULL || entries == NULL || data == NULL) {
+        free(data);
+        free(entries);
+        free(cache);
+        free(out);
+        return ESP_ERR_NO_MEM;
+    }
+
+    cache->lower = lower;
+    cache->block_size = block_size;
+    cache->block_count = config->block_count;
+    cache->entries = entries;
+    cache->data = data;
+
+    out->ctx = cache;
+    out->device_flags = lower->device_flags;
+    out->geometry = lower->geometry;
+    out->geometry.recommended_read_size = block_size;
+    out->ops = &s_cache_ops;
+
+    *out_handle = out;
+    return ESP_OK;
+}
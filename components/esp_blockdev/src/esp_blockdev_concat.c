@@ -0,0 +1,279 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "esp_blockdev.h"
+#include "esp_blockdev_stack.h"
+#include "esp_blockdev_stack_private.h"
+
+#define CONCAT_DEVICE_COUNT 2
+
+typedef struct {
+    esp_blockdev_handle_t lower[CONCAT_DEVICE_COUNT];
+    esp_blockdev_concat_mode_t mode;
+    size_t stripe_size;
+    esp_blockdev_cmd_arg_stats_t stats;
+} blockdev_concat_t;
+
+/* Map an address of the combined device to the lower device and the address in it.
+ * Returns the length of the contiguous range on the lower device, at most len. */
+static size_t concat_map(blockdev_concat_t *concat, uint64_t addr, size_t len, size_t *out_index, uint64_t *out_addr)
+{
+    if (concat->mode == ESP_BLOCKDEV_CONCAT_STRIPED) {
+        uint64_t stripe = addr / concat->stripe_size;
+        size_t offset = (size_t)(addr % concat->stripe_size);
+        *out_index = (size_t)(stripe % CONCAT_DEVICE_COUNT);
+        *out_addr = (stripe / CONCAT_DEVICE_COUNT) * concat->stripe_size + offset;
+        return concat->stripe_size - offset < len ? concat->stripe_size - offset : len;
+    }
+
+    uint64_t first_size = concat->lower[0]->geometry.disk_size;
+    if (addr < first_size) {
+        *out_index = 0;
+        *out_addr = addr;
+        return first_size - addr < len ? (size_t)(first_size - addr) : len;
+    }
+    *out_index = 1;
+    *out_addr = addr - first_size;
+    return len;
+}
+
+static esp_err_t blockdev_concat_read(esp_blockdev_handle_t dev_handle, uint8_t* dst_buf, size_t dst_buf_size, uint64_t src_addr, size_t data_read_len)
+{
+    blockdev_concat_t *concat = (blockdev_concat_t *)dev_handle->ctx;
+
+    esp_err_t res = blockdev_check_range(dev_handle, src_addr, data_read_len, dev_handle->geometry.read_size);
+    if (res != ESP_OK) {
+        return res;
+    }
+    if (dst_buf_size < data_read_len) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    concat->stats.read_ops++;
+    concat->stats.read_bytes += data_read_len;
+
+    while (data_read_len > 0) {
+        size_t index;
+        uint64_t lower_addr;
+        size_t chunk = concat_map(concat, src_addr, data_read_len, &index, &lower_addr);
+        res = blockdev_lower_read(concat->lower[index], &concat->stats, dst_buf, lower_addr, chunk);
+        if (res != ESP_OK) {
+            return res;
+        }
+        dst_buf += chunk;
+        src_addr += chunk;
+        data_read_len -= chunk;
+    }
+    return ESP_OK;
+}
+
+static esp_err_t blockdev_concat_write(esp_blockdev_handle_t dev_handle, const uint8_t* src_buf, uint64_t dst_addr, size_t data_write_len)
+{
+    blockdev_concat_t *concat = (blockdev_concat_t *)dev_handle->ctx;
+
+    if (dev_handle->device_flags.read_only) {
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+    esp_err_t res = blockdev_check_range(dev_handle, dst_addr, data_write_len, dev_handle->geometry.write_size);
+    if (res != ESP_OK) {
+        return res;
+    }
+    concat->stats.write_ops++;
+    concat->stats.write_bytes += data_write_len;
+
+    while (data_write_len > 0) {
+        size_t index;
+        uint64_t lower_addr;
+        size_t chunk = concat_map(concat, dst_addr, data_write_len, &index, &lower_addr);
+        res = blockdev_lower_write(concat->lower[index], &concat->stats, src_buf, lower_addr, chunk);
+        if (res != ESP_OK) {
+            return res;
+        }
+        src_buf += chunk;
+        dst_addr += chunk;
+        data_write_len -= chunk;
+    }
+    return ESP_OK;
+}
+
+static esp_err_t blockdev_concat_erase(esp_blockdev_handle_t dev_handle, uint64_t start_addr, size_t erase_len)
+{
+    blockdev_concat_t *concat = (blockdev_concat_t *)dev_handle->ctx;
+
+    if (dev_handle->device_flags.read_only) {
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+    esp_err_t res = blockdev_check_range(dev_handle, start_addr, erase_len, dev_handle->geometry.erase_size);
+    if (res != ESP_OK) {
+        return res;
+    }
+    concat->stats.erase_ops++;
+
+    while (erase_len > 0) {
+        size_t index;
+        uint64_t lower_addr;
+        size_t chunk = concat_map(concat, start_addr, erase_len, &index, &lower_addr);
+        res = blockdev_lower_erase(concat->lower[index], &concat->stats, lower_addr, chunk);
+        if (res != ESP_OK) {
+            return res;
+        }
+        start_addr += chunk;
+        erase_len -= chunk;
+    }
+    return ESP_OK;
+}
+
+static esp_err_t blockdev_concat_sync(esp_blockdev_handle_t dev_handle)
+{
+    blockdev_concat_t *concat = (blockdev_concat_t *)dev_handle->ctx;
+
+    for (size_t i = 0; i < CONCAT_DEVICE_COUNT; i++) {
+        esp_err_t res = blockdev_lower_sync(concat->lower[i]);
+        if (res != ESP_OK) {
+            return res;
+        }
+    }
+    return ESP_OK;
+}
+
+static esp_err_t blockdev_concat_ioctl(esp_blockdev_handle_t dev_handle, const uint8_t cmd, void* args)
+{
+    blockdev_concat_t *concat = (blockdev_concat_t *)dev_handle->ctx;
+
+    switch (cmd) {
+    case ESP_BLOCKDEV_CMD_GET_STATS:
+        if (args == NULL) {
+            return ESP_ERR_INVALID_ARG;
+        }
+        memcpy(args, &concat->stats, sizeof(concat->stats));
+        return ESP_OK;
+    case ESP_BLOCKDEV_CMD_MARK_DELETED:
+    case ESP_BLOCKDEV_CMD_ERASE_CONTENTS: {
+        if (args == NULL) {
+            return ESP_ERR_INVALID_ARG;
+        }
+        // Split the range between the devices
+        const esp_blockdev_cmd_arg_erase_t *erase = (const esp_blockdev_cmd_arg_erase_t *)args;
+        uint64_t addr = erase->start_addr;
+        size_t len = erase->erase_len;
+        esp_err_t res = blockdev_check_range(dev_handle, addr, len, dev_handle->geometry.erase_size);
+        while (res == ESP_OK && len > 0) {
+            esp_blockdev_cmd_arg_erase_t lower_erase;
+            size_t index;
+            lower_erase.erase_len = concat_map(concat, addr, len, &index, &lower_erase.start_addr);
+            res = blockdev_lower_ioctl(concat->lower[index], cmd, &lower_erase);
+            addr += lower_erase.erase_len;
+            len -= lower_erase.erase_len;
+        }
+        return res;
+    }
+    default:
+        // Other commands have no address range, so they can't be split
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+}
+
+static esp_err_t blockdev_concat_release(esp_blockdev_handle_t dev_handle)
+{
+    free(dev_handle->ctx);
+    free(dev_handle);
+    return ESP_OK;
+}
+
+static const esp_blockdev_ops_t s_concat_ops = {
+    .read = blockdev_concat_read,
+    .write = blockdev_concat_write,
+    .erase = blockdev_concat_erase,
+    .sync = blockdev_concat_sync,
+    .ioctl = blockdev_concat_ioctl,
+    .release = blockdev_concat_release,
+};
+
+/* Combine block sizes of both devices, the larger one must be a multiple of the smaller one (0 means not supported) */
+static bool concat_block_size(size_t size1, size_t size2, size_t *out_size)
+{
+    if (size1 == 0 || size2 == 0) {
+        *out_size = 0;
+        return true;
+    }
+    size_t larger = size1 > size2 ? size1 : size2;
+    size_t smaller = size1 > size2 ? size2 : size1;
+    *out_size = larger;
+    return larger % smaller == 0;
+}
+
+esp_err_t esp_blockdev_concat_get_blockdev(esp_blockdev_handle_t first, esp_blockdev_handle_t second, const esp_blockdev_concat_config_t *config, esp_blockdev_handle_t *out_handle)
+{
+    if (first == NULL || second == NULL || first == second || config == NULL || out_handle == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (first->device_flags.default_val_after_erase != second->device_flags.default_val_after_erase) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    esp_blockdev_geometry_t geometry = {0};
+    if (!concat_block_size(first->geometry.read_size, second->geometry.read_size, &geometry.read_size) ||
+            !concat_block_size(first->geometry.write_size, second->geometry.write_size, &geometry.write_size) ||
+            !concat_block_size(first->geometry.erase_size, second->geometry.erase_size, &geometry.erase_size) ||
+            geometry.read_size == 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    // The boundaries between the devices must not split any block of the combined device
+    size_t boundary_align = geometry.read_size;
+    if (geometry.write_size > boundary_align) {
+        boundary_align = geometry.write_size;
+    }
+    if (geometry.erase_size > boundary_align) {
+        boundary_align = geometry.erase_size;
+    }
+
+    if (config->mode == ESP_BLOCKDEV_CONCAT_STRIPED) {
+        if (config->stripe_size == 0 || config->stripe_size % boundary_align != 0) {
+            return ESP_ERR_INVALID_ARG;
+        }
+        uint64_t smaller_size = first->geometry.disk_size < second->geometry.disk_size ? first->geometry.disk_size : second->geometry.disk_size;
+        geometry.disk_size = (smaller_size / config->stripe_size) * config->stripe_size * CONCAT_DEVICE_COUNT;
+        if (geometry.disk_size == 0) {
+            return ESP_ERR_INVALID_ARG;
+        }
+    } else if (config->mode == ESP_BLOCKDEV_CONCAT_LINEAR) {
+        if (first->geometry.disk_size % boundary_align != 0) {
+            return ESP_ERR_INVALID_ARG;
+        }
+        geometry.disk_size = first->geometry.disk_size + second->geometry.disk_size;
+    } else {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    geometry.recommended_read_size = first->geometry.recommended_read_size > second->geometry.recommended_read_size ?
+                                     first->geometry.recommended_read_size : second->geometry.recommended_read_size;
+    geometry.recommended_write_size = first->geometry.recommended_write_size > second->geometry.recommended_write_size ?
+                                      first->geometry.recommended_write_size : second->geometry.recommended_write_size;
+    geometry.recommended_erase_size = first->geometry.recommended_erase_size > second->geometry.recommended_erase_size ?
+                                      first->geometry.recommended_erase_size : second->geometry.recommended_erase_size;
+
+    esp_blockdev_t *out = calloc(1, sizeof(esp_blockdev_t));
+    blockdev_concat_t *concat = calloc(1, sizeof(blockdev_concat_t));
+    if (out == NULL || concat == NULL) {
+        free(concat);
+        free(out);
+        return ESP_ERR_NO_MEM;
+    }
+
+    concat->lower[0] = first;
+    concat->lower[1] = second;
+    concat->mode = config->mode;
+    concat->stripe_size = config->stripe_size;
+
+    out->ctx = concat;
+    out->device_flags.val = first->device_flags.val | second->device_flags.val;
+    out->geometry = geometry;
+    out->ops = &s_concat_ops;
+
+    *out_handle = out;
+    return ESP_OK;
+}
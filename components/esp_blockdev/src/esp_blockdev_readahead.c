@@ -0,0 +1,195 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "esp_blockdev.h"
+#include "esp_blockdev_stack.h"
+#include "esp_blockdev_stack_private.h"
+
+typedef struct {
+    esp_blockdev_handle_t lower;
+    size_t window_size;
+    uint8_t *window;
+    uint64_t window_addr;               /* range [window_addr, window_addr + window_len) of the lower device is in the window */
+    size_t window_len;
+    uint64_t next_addr;                 /* address following the previous read, used to detect sequential access */
+    esp_blockdev_cmd_arg_stats_t stats;
+} blockdev_readahead_t;
+
+static void readahead_invalidate_range(blockdev_readahead_t *ra, uint64_t addr, size_t len)
+{
+    if (ra->window_len != 0 && blockdev_ranges_overlap(ra->window_addr, ra->window_len, addr, len)) {
+        ra->window_len = 0;
+    }
+}
+
+static esp_err_t blockdev_readahead_read(esp_blockdev_handle_t dev_handle, uint8_t* dst_buf, size_t dst_buf_size, uint64_t src_addr, size_t data_read_len)
+{
+    blockdev_readahead_t *ra = (blockdev_readahead_t *)dev_handle->ctx;
+
+    esp_err_t res = blockdev_check_range(dev_handle, src_addr, data_read_len, dev_handle->geometry.read_size);
+    if (res != ESP_OK) {
+        return res;
+    }
+    if (dst_buf_size < data_read_len) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    ra->stats.read_ops++;
+    ra->stats.read_bytes += data_read_len;
+
+    bool sequential = (src_addr == ra->next_addr);
+    ra->next_addr = src_addr + data_read_len;
+
+    while (data_read_len > 0) {
+        if (ra->window_len != 0 && src_addr >= ra->window_addr && src_addr < ra->window_addr + ra->window_len) {
+            size_t offset = (size_t)(src_addr - ra->window_addr);
+            size_t chunk = ra->window_len - offset < data_read_len ? ra->window_len - offset : data_read_len;
+            memcpy(dst_buf, ra->window + offset, chunk);
+            ra->stats.hits++;
+            dst_buf += chunk;
+            src_addr += chunk;
+            data_read_len -= chunk;
+            continue;
+        }
+        if (!sequential || data_read_len >= ra->window_size) {
+            return blockdev_lower_read(ra->lower, &ra->stats, dst_buf, src_addr, data_read_len);
+        }
+        uint64_t remaining = dev_handle->geometry.disk_size - src_addr;
+        size_t fetch_len = remaining < ra->window_size ? (size_t)remaining : ra->window_size;
+        ra->window_len = 0;
+        res = blockdev_lower_read(ra->lower, &ra->stats, ra->window, src_addr, fetch_len);
+        if (res != ESP_OK) {
+            return res;
+        }
+        ra->window_addr = src_addr;
+        ra->window_len = fetch_len;
+    }
+    return ESP_OK;
+}
+
+static esp_err_t blockdev_readahead_write(esp_blockdev_handle_t dev_handle, const uint8_t* src_buf, uint64_t dst_addr, size_t data_write_len)
+{
+    blockdev_readahead_t *ra = (blockdev_readahead_t *)dev_handle->ctx;
+
+    if (dev_handle->device_flags.read_only) {
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+    esp_err_t res = blockdev_check_range(dev_handle, dst_addr, data_write_len, dev_handle->geometry.write_size);
+    if (res != ESP_OK) {
+        return res;
+    }
+    ra->stats.write_ops++;
+    ra->stats.write_bytes += data_write_len;
+
+    res = blockdev_lower_write(ra->lower, &ra->stats, src_buf, dst_addr, data_write_len);
+    if (res != ESP_OK) {
+        readahead_invalidate_range(ra, dst_addr, data_write_len);
+        return res;
+    }
+    if (ra->window_len != 0) {
+        blockdev_update_overlap(ra->lower, ra->window, ra->window_addr, ra->window_len, src_buf, dst_addr, data_write_len);
+    }
+    return ESP_OK;
+}
+
+static esp_err_t blockdev_readahead_erase(esp_blockdev_handle_t dev_handle, uint64_t start_addr, size_t erase_len)
+{
+    blockdev_readahead_t *ra = (blockdev_readahead_t *)dev_handle->ctx;
+
+    if (dev_handle->device_flags.read_only) {
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+    esp_err_t res = blockdev_check_range(dev_handle, start_addr, erase_len, dev_handle->geometry.erase_size);
+    if (res != ESP_OK) {
+        return res;
+    }
+    ra->stats.erase_ops++;
+
+    readahead_invalidate_range(ra, start_addr, erase_len);
+    return blockdev_lower_erase(ra->lower, &ra->stats, start_addr, erase_len);
+}
+
+static esp_err_t blockdev_readahead_sync(esp_blockdev_handle_t dev_handle)
+{
+    blockdev_readahead_t *ra = (blockdev_readahead_t *)dev_handle->ctx;
+    return blockdev_lower_sync(ra->lower);
+}
+
+static esp_err_t blockdev_readahead_ioctl(esp_blockdev_handle_t dev_handle, const uint8_t cmd, void* args)
+{
+    blockdev_readahead_t *ra = (blockdev_readahead_t *)dev_handle->ctx;
+
+    switch (cmd) {
+    case ESP_BLOCKDEV_CMD_GET_STATS:
+        if (args == NULL) {
+            return ESP_ERR_INVALID_ARG;
+        }
+        memcpy(args, &ra->stats, sizeof(ra->stats));
+        return ESP_OK;
+    case ESP_BLOCKDEV_CMD_MARK_DELETED:
+    case ESP_BLOCKDEV_CMD_ERASE_CONTENTS: {
+        if (args == NULL) {
+            return ESP_ERR_INVALID_ARG;
+        }
+        const esp_blockdev_cmd_arg_erase_t *erase = (const esp_blockdev_cmd_arg_erase_t *)args;
+        readahead_invalidate_range(ra, erase->start_addr, erase->erase_len);
+        return blockdev_lower_ioctl(ra->lower, cmd, args);
+    }
+    default:
+        return blockdev_lower_ioctl(ra->lower, cmd, args);
+    }
+}
+
+static esp_err_t blockdev_readahead_release(esp_blockdev_handle_t dev_handle)
+{
+    blockdev_readahead_t *ra = (blockdev_readahead_t *)dev_handle->ctx;
+    free(ra->window);
+    free(ra);
+    free(dev_handle);
+    return ESP_OK;
+}
+
+static const esp_blockdev_ops_t s_readahead_ops = {
+    .read = blockdev_readahead_read,
+    .write = blockdev_readahead_write,
+    .erase = blockdev_readahead_erase,
+    .sync = blockdev_readahead_sync,
+    .ioctl = blockdev_readahead_ioctl,
+    .release = blockdev_readahead_release,
+};
+
+esp_err_t esp_blockdev_readahead_get_blockdev(esp_blockdev_handle_t lower, const esp_blockdev_readahead_config_t *config, esp_blockdev_handle_t *out_handle)
+{
+    if (lower == NULL || config == NULL || out_handle == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (config->window_size == 0 || lower->geometry.read_size == 0 || config->window_size % lower->geometry.read_size != 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    esp_blockdev_t *out = calloc(1, sizeof(esp_blockdev_t));
+    blockdev_readahead_t *ra = calloc(1, sizeof(blockdev_readahead_t));
+    uint8_t *window = malloc(config->window_size);
+    if (out == NULL || ra == NULL || window == NULL) {
+        free(window);
+        free(ra);
+        free(out);
+        return ESP_ERR_NO_MEM;
+    }
+
+    ra->lower = lower;
+    ra->window_size = config->window_size;
+    ra->window = window;
+
+    out->ctx = ra;
+    out->device_flags = lower->device_flags;
+    out->geometry = lower->geometry;
+    out->ops = &s_readahead_ops;
+
+    *out_handle = out;
+    return ESP_OK;
+}
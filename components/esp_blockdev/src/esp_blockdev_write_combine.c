@@ -0,0 +1,215 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "esp_blockdev.h"
+#include "esp_blockdev_stack.h"
+#include "esp_blockdev_stack_private.h"
+
+typedef struct {
+    esp_blockdev_handle_t lower;
+    size_t buffer_size;
+    uint8_t *buffer;
+    uint64_t pending_addr;              /* range [pending_addr, pending_addr + pending_len) is waiting in the buffer */
+    size_t pending_len;
+    esp_blockdev_cmd_arg_stats_t stats;
+} blockdev_write_combine_t;
+
+static esp_err_t write_combine_flush(blockdev_write_combine_t *wc)
+{
+    if (wc->pending_len == 0) {
+        return ESP_OK;
+    }
+    esp_err_t res = blockdev_lower_write(wc->lower, &wc->stats, wc->buffer, wc->pending_addr, wc->pending_len);
+    if (res != ESP_OK) {
+        // Keep the data, the write is retried on the next flush
+        return res;
+    }
+    wc->pending_len = 0;
+    return ESP_OK;
+}
+
+/* Write the buffer if it overlaps given range */
+static esp_err_t write_combine_flush_range(blockdev_write_combine_t *wc, uint64_t addr, size_t len)
+{
+    if (wc->pending_len != 0 && blockdev_ranges_overlap(wc->pending_addr, wc->pending_len, addr, len)) {
+        return write_combine_flush(wc);
+    }
+    return ESP_OK;
+}
+
+static esp_err_t blockdev_write_combine_read(esp_blockdev_handle_t dev_handle, uint8_t* dst_buf, size_t dst_buf_size, uint64_t src_addr, size_t data_read_len)
+{
+    blockdev_write_combine_t *wc = (blockdev_write_combine_t *)dev_handle->ctx;
+
+    esp_err_t res = blockdev_check_range(dev_handle, src_addr, data_read_len, dev_handle->geometry.read_size);
+    if (res != ESP_OK) {
+        return res;
+    }
+    if (dst_buf_size < data_read_len) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    wc->stats.read_ops++;
+    wc->stats.read_bytes += data_read_len;
+
+    res = write_combine_flush_range(wc, src_addr, data_read_len);
+    if (res != ESP_OK) {
+        return res;
+    }
+    return blockdev_lower_read(wc->lower, &wc->stats, dst_buf, src_addr, data_read_len);
+}
+
+static esp_err_t blockdev_write_combine_write(esp_blockdev_handle_t dev_handle, const uint8_t* src_buf, uint64_t dst_addr, size_t data_write_len)
+{
+    blockdev_write_combine_t *wc = (blockdev_write_combine_t *)dev_handle->ctx;
+
+    if (dev_handle->device_flags.read_only) {
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+    esp_err_t res = blockdev_check_range(dev_handle, dst_addr, data_write_len, dev_handle->geometry.write_size);
+    if (res != ESP_OK) {
+        return res;
+    }
+    wc->stats.write_ops++;
+    wc->stats.write_bytes += data_write_len;
+
+    if (data_write_len >= wc->buffer_size) {
+        // Pending data may be overwritten by this write, so it has to reach the device first
+        res = write_combine_flush(wc);
+        if (res != ESP_OK) {
+            return res;
+        }
+        return blockdev_lower_write(wc->lower, &wc->stats, src_buf, dst_addr, data_write_len);
+    }
+
+    if (wc->pending_len != 0) {
+        uint64_t pending_end = wc->pending_addr + wc->pending_len;
+        if (dst_addr >= wc->pending_addr && dst_addr <= pending_end && dst_addr + data_write_len <= wc->pending_addr + wc->buffer_size) {
+            // Rewrite of the pending data or append to it
+            blockdev_update_overlap(wc->lower, wc->buffer, wc->pending_addr, wc->pending_len, src_buf, dst_addr, data_write_len);
+            if (dst_addr + data_write_len > pending_end) {
+                size_t new_len = (size_t)(dst_addr + data_write_len - pending_end);
+                memcpy(wc->buffer + wc->pending_len, src_buf + (pending_end - dst_addr), new_len);
+                wc->pending_len += new_len;
+            }
+            wc->stats.hits++;
+            return ESP_OK;
+        }
+        res = write_combine_flush(wc);
+        if (res != ESP_OK) {
+            return res;
+        }
+    }
+    memcpy(wc->buffer, src_buf, data_write_len);
+    wc->pending_addr = dst_addr;
+    wc->pending_len = data_write_len;
+    return ESP_OK;
+}
+
+static esp_err_t blockdev_write_combine_erase(esp_blockdev_handle_t dev_handle, uint64_t start_addr, size_t erase_len)
+{
+    blockdev_write_combine_t *wc = (blockdev_write_combine_t *)dev_handle->ctx;
+
+    if (dev_handle->device_flags.read_only) {
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+    esp_err_t res = blockdev_check_range(dev_handle, start_addr, erase_len, dev_handle->geometry.erase_size);
+    if (res != ESP_OK) {
+        return res;
+    }
+    wc->stats.erase_ops++;
+
+    res = write_combine_flush_range(wc, start_addr, erase_len);
+    if (res != ESP_OK) {
+        return res;
+    }
+    return blockdev_lower_erase(wc->lower, &wc->stats, start_addr, erase_len);
+}
+
+static esp_err_t blockdev_write_combine_sync(esp_blockdev_handle_t dev_handle)
+{
+    blockdev_write_combine_t *wc = (blockdev_write_combine_t *)dev_handle->ctx;
+
+    esp_err_t res = write_combine_flush(wc);
+    if (res != ESP_OK) {
+        return res;
+    }
+    return blockdev_lower_sync(wc->lower);
+}
+
+static esp_err_t blockdev_write_combine_ioctl(esp_blockdev_handle_t dev_handle, const uint8_t cmd, void* args)
+{
+    blockdev_write_combine_t *wc = (blockdev_write_combine_t *)dev_handle->ctx;
+
+    if (cmd == ESP_BLOCKDEV_CMD_GET_STATS) {
+        if (args == NULL) {
+            return ESP_ERR_INVALID_ARG;
+        }
+        memcpy(args, &wc->stats, sizeof(wc->stats));
+        return ESP_OK;
+    }
+
+    esp_err_t res = write_combine_flush(wc);
+    if (res != ESP_OK) {
+        return res;
+    }
+    return blockdev_lower_ioctl(wc->lower, cmd, args);
+}
+
+static esp_err_t blockdev_write_combine_release(esp_blockdev_handle_t dev_handle)
+{
+    blockdev_write_combine_t *wc = (blockdev_write_combine_t *)dev_handle->ctx;
+
+    // The device is released even if the pending data can't be written, the error is reported to the caller
+    esp_err_t res = write_combine_flush(wc);
+    free(wc->buffer);
+    free(wc);
+    free(dev_handle);
+    return res;
+}
+
+static const esp_blockdev_ops_t s_write_combine_ops = {
+    .read = blockdev_write_combine_read,
+    .write = blockdev_write_combine_write,
+    .erase = blockdev_write_combine_erase,
+    .sync = blockdev_write_combine_sync,
+    .ioctl = blockdev_write_combine_ioctl,
+    .release = blockdev_write_combine_release,
+};
+
+esp_err_t esp_blockdev_write_combine_get_blockdev(esp_blockdev_handle_t lower, const esp_blockdev_write_combine_config_t *config, esp_blockdev_handle_t *out_handle)
+{
+    if (lower == NULL || config == NULL || out_handle == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (config->buffer_size == 0 || lower->geometry.write_size == 0 || config->buffer_size % lower->geometry.write_size != 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    esp_blockdev_t *out = calloc(1, sizeof(esp_blockdev_t));
+    blockdev_write_combine_t *wc = calloc(1, sizeof(blockdev_write_combine_t));
+    uint8_t *buffer = malloc(config->buffer_size);
+    if (out == NULL || wc == NULL || buffer == NULL) {
+        free(buffer);
+        free(wc);
+        free(out);
+        return ESP_ERR_NO_MEM;
+    }
+
+    wc->lower = lower;
+    wc->buffer_size = config->buffer_size;
+    wc->buffer = buffer;
+
+    out->ctx = wc;
+    out->device_flags = lower->device_flags;
+    out->geometry = lower->geometry;
+    out->geometry.recommended_write_size = config->buffer_size;
+    out->ops = &s_write_combine_ops;
+
+    *out_handle = out;
+    return ESP_OK;
+}
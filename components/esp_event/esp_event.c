@@ -36,11 +36,16 @@
                                         } while(0);
 #endif
 
+#define EVENT_POOL_NO_BLOCK           UINT16_MAX
+#define EVENT_POOL_TAKEN              (UINT16_MAX - 1)  // next index of a block which is not in the free list
+#define EVENT_DATA_ALIGN(size)        (((size) + 7) & ~((size_t) 7))
+
 /* ------------------------- Static Variables ------------------------------- */
 
 static const char* TAG = "event";
 static const char* esp_event_any_base = "any";
 static const char* esp_event_handler_cleanup = "cleanup";
+static const char* esp_event_batch = "batch";
 
 #ifdef CONFIG_ESP_EVENT_LOOP_PROFILING
 static SLIST_HEAD(esp_event_loop_instance_list_t, esp_event_loop_instance) s_event_loops =
@@ -439,254 +444,1050 @@ static void loop_node_remove_all_handler(esp_event_loop_node_t* loop_node)
     }
 }
 
-static void inline __attribute__((always_inline)) post_instance_delete(esp_event_post_instance_t* post)
+// Executes the handlers for the event by walking the lists of the loop
+static bool loop_nodes_execute(esp_event_loop_instance_t* loop, esp_event_post_instance_t post)
 {
-#if CONFIG_ESP_EVENT_POST_FROM_ISR
-    if (post->data_allocated)
-#endif
-    {
-        free(post->data.ptr);
-    }
-    memset(post, 0, sizeof(*post));
-}
+    bool exec = false;
 
-static esp_err_t find_and_unregister_handler(esp_event_remove_handler_context_t* ctx)
-{
-    esp_event_handler_node_t *handler_to_unregister = NULL;
-    esp_event_handler_node_t *handler;
-    esp_event_loop_node_t *loop_node;
-    esp_event_base_node_t *base_node;
-    esp_event_id_node_t *id_node;
+    esp_event_handler_node_t *handler, *temp_handler;
+    esp_event_loop_node_t *loop_node, *temp_node;
+    esp_event_base_node_t *base_node, *temp_base;
+    esp_event_id_node_t *id_node, *temp_id_node;
 
-    SLIST_FOREACH(loop_node, &(ctx->loop->loop_nodes), next) {
+    SLIST_FOREACH_SAFE(loop_node, &(loop->loop_nodes), next, temp_node) {
         // Execute loop level handlers
-        SLIST_FOREACH(handler, &(loop_node->handlers), next) {
-            if (ctx->legacy) {
-                if (handler->handler_ctx->handler == ctx->handler_ctx->handler) {
-                    handler_to_unregister = handler;
-                    break;
-                }
-            } else {
-                if (handler->handler_ctx == ctx->handler_ctx) {
-                    handler_to_unregister = handler;
-                    break;
-                }
+        SLIST_FOREACH_SAFE(handler, &(loop_node->handlers), next, temp_handler) {
+            if (!handler->unregistered) {
+                handler_execute(loop, handler, post);
+                exec |= true;
             }
         }
 
-        if (handler_to_unregister != NULL) {
-            break;
-        }
-
-        SLIST_FOREACH(base_node, &(loop_node->base_nodes), next) {
-            if (base_node->base == ctx->event_base) {
+        SLIST_FOREACH_SAFE(base_node, &(loop_node->base_nodes), next, temp_base) {
+            if (base_node->base == post.base) {
                 // Execute base level handlers
-                SLIST_FOREACH(handler, &(base_node->handlers), next) {
-                    if (ctx->legacy) {
-                        if (handler->handler_ctx->handler == ctx->handler_ctx->handler) {
-                            handler_to_unregister = handler;
-                            break;
-                        }
-                    } else {
-                        if (handler->handler_ctx == ctx->handler_ctx) {
-                            handler_to_unregister = handler;
-                            break;
-                        }
+                SLIST_FOREACH_SAFE(handler, &(base_node->handlers), next, temp_handler) {
+                    if (!handler->unregistered) {
+                        handler_execute(loop, handler, post);
+                        exec |= true;
                     }
                 }
 
-                if (handler_to_unregister != NULL) {
-                    break;
-                }
-
-                SLIST_FOREACH(id_node, &(base_node->id_nodes), next) {
-                    if (id_node->id == ctx->event_id) {
+                SLIST_FOREACH_SAFE(id_node, &(base_node->id_nodes), next, temp_id_node) {
+                    if (id_node->id == post.id) {
                         // Execute id level handlers
-                        SLIST_FOREACH(handler, &(id_node->handlers), next) {
-                            if (ctx->legacy) {
-                                if (handler->handler_ctx->handler == ctx->handler_ctx->handler) {
-                                    handler_to_unregister = handler;
-                                    break;
-                                }
-                            } else {
-                                if (handler->handler_ctx == ctx->handler_ctx) {
-                                    handler_to_unregister = handler;
-                                    break;
-                                }
+                        SLIST_FOREACH_SAFE(handler, &(id_node->handlers), next, temp_handler) {
+                            if (!handler->unregistered) {
+                                handler_execute(loop, handler, post);
+                                exec |= true;
                             }
                         }
+                        // Skip to next base node
+                        break;
                     }
                 }
             }
         }
     }
 
-    if (handler_to_unregister == NULL) {
-        /* handler not found in the lists, return */
-        return ESP_ERR_NOT_FOUND;
+    return exec;
+}
+
+static inline uint32_t dispatch_hash(esp_event_base_t base, int32_t id)
+{
+    uint32_t hash = (uint32_t)(uintptr_t) base ^ ((uint32_t) id * 0x9e3779b1U);
+    hash ^= hash >> 16;
+    hash *= 0x85ebca6bU;
+    hash ^= hash >> 13;
+    return hash;
+}
+
+// Index of the worker dispatching the events with this base and id, 0 for loops with a single task
+static inline uint32_t loop_worker_index(esp_event_loop_instance_t* loop, esp_event_base_t base, int32_t id)
+{
+    return (loop->worker_count > 1) ? dispatch_hash(base, id) % loop->worker_count : 0;
+}
+
+// Queue of the task dispatching the events with this base and id
+static inline QueueHandle_t loop_queue(esp_event_loop_instance_t* loop, esp_event_base_t base, int32_t id)
+{
+    return (loop->worker_count > 1) ? loop->workers[loop_worker_index(loop, base, id)].queue : loop->queue;
+}
+
+// Checks whether the current task dispatches the events of the loop, it may not block on its queues then
+static bool loop_task_is_current(esp_event_loop_instance_t* loop)
+{
+    TaskHandle_t current = xTaskGetCurrentTaskHandle();
+    if (loop->worker_count > 1) {
+        for (uint32_t i = 0; i < loop->worker_count; i++) {
+            if (loop->workers[i].task == current) {
+                return true;
+            }
+        }
+        return false;
     }
+    return loop->task == current;
+}
 
-    if (handler_to_unregister->unregistered) {
-        /* the handler was found in a list but has already be marked
-         * as unregistered. It means an event was already created to
-         * remove from the list. return OK but do nothing */
-        return ESP_OK;
+#if CONFIG_ESP_EVENT_DISPATCH_TABLE
+
+#define DISPATCH_NO_ENTRY   UINT32_MAX
+
+static esp_event_dispatch_entry_t* dispatch_find(const esp_event_dispatch_table_t* table, esp_event_base_t base, int32_t id)
+{
+    uint32_t i = dispatch_hash(base, id) & table->mask;
+    while (table->slots[i].base != NULL) {
+        if (table->slots[i].base == base && table->slots[i].id == id) {
+            return (esp_event_dispatch_entry_t*) &table->slots[i];
+        }
+        i = (i + 1) & table->mask;
     }
-    /* handler found in the lists and not already marked as unregistered. Mark it as unregistered
-     * and post an event to remove it from the lists */
-    handler_to_unregister->unregistered = true;
-    if (ctx->legacy) {
-        /* in case of legacy code, we have to copy the handler_ctx content since it was created in the calling function */
-        esp_event_handler_instance_context_t *handler_ctx_copy = esp_event_calloc(1, sizeof(esp_event_handler_instance_context_t));
-        if (!handler_ctx_copy) {
-            return ESP_ERR_NO_MEM;
+    return NULL;
+}
+
+// Returns the entry for (base, id), adding it if there is none yet. Entries with a specific id are chained to
+// the entry of their base with ESP_EVENT_ANY_ID, which has to be added first.
+static esp_event_dispatch_entry_t* dispatch_add_entry(esp_event_dispatch_table_t* table, esp_event_base_t base, int32_t id)
+{
+    esp_event_dispatch_entry_t* entry = dispatch_find(table, base, id);
+    if (entry != NULL) {
+        return entry;
+    }
+
+    uint32_t i = dispatch_hash(base, id) & table->mask;
+    while (table->slots[i].base != NULL) {
+        i = (i + 1) & table->mask;
+    }
+    entry = &table->slots[i];
+    entry->base = base;
+    entry->id = id;
+    entry->next_of_base = DISPATCH_NO_ENTRY;
+
+    if (id != ESP_EVENT_ANY_ID) {
+        esp_event_dispatch_entry_t* base_entry = dispatch_find(table, base, ESP_EVENT_ANY_ID);
+        entry->next_of_base = base_entry->next_of_base;
+        base_entry->next_of_base = i;
+    }
+    return entry;
+}
+
+// Appends the handlers to the entry and, if all_of_base is set, to all entries chained to it. With the handler
+// array not allocated yet, only counts them.
+static void dispatch_append(esp_event_dispatch_table_t* table, esp_event_dispatch_entry_t* entry, esp_event_handler_nodes_t* handlers, bool all_of_base)
+{
+    esp_event_handler_node_t *handler;
+    while (entry != NULL) {
+        SLIST_FOREACH(handler, handlers, next) {
+            if (handler->unregistered) {
+                continue;
+            }
+            if (table->handlers) {
+                table->handlers[entry->first + entry->count] = handler;
+            }
+            entry->count++;
         }
-        handler_ctx_copy->arg = ctx->handler_ctx->arg;
-        handler_ctx_copy->handler = ctx->handler_ctx->handler;
-        ctx->handler_ctx = handler_ctx_copy;
+        entry = (all_of_base && entry->next_of_base != DISPATCH_NO_ENTRY) ? &table->slots[entry->next_of_base] : NULL;
     }
-    return esp_event_post_to(ctx->loop, esp_event_handler_cleanup, 0, ctx, sizeof(esp_event_remove_handler_context_t), portMAX_DELAY);
 }
 
-/* ---------------------------- Public API --------------------------------- */
+// Assigns the handlers to the entries in the same order as the walk over the lists in loop_nodes_execute,
+// leaving out the unregistered ones. With the handler array not allocated yet, only counts them.
+static void dispatch_assign(esp_event_loop_instance_t* loop, esp_event_dispatch_table_t* table)
+{
+    esp_event_loop_node_t *loop_node;
+    esp_event_base_node_t *base_node;
+    esp_event_id_node_t *id_node;
 
-esp_err_t esp_event_loop_create(const esp_event_loop_args_t* event_loop_args, esp_event_loop_handle_t* event_loop)
+    for (uint32_t i = 0; i <= table->mask; i++) {
+        table->slots[i].count = 0;
+    }
+    table->loop_level_count = 0;
+
+    SLIST_FOREACH(loop_node, &(loop->loop_nodes), next) {
+        if (!SLIST_EMPTY(&(loop_node->handlers))) {
+            esp_event_handler_node_t *handler;
+            SLIST_FOREACH(handler, &(loop_node->handlers), next) {
+                if (handler->unregistered) {
+                    continue;
+                }
+                if (table->handlers) {
+                    table->handlers[table->loop_level_count] = handler;
+                }
+                table->loop_level_count++;
+            }
+            for (uint32_t i = 0; i <= table->mask; i++) {
+                if (table->slots[i].base != NULL) {
+                    dispatch_append(table, &table->slots[i], &(loop_node->handlers), false);
+                }
+            }
+        }
+
+        SLIST_FOREACH(base_node, &(loop_node->base_nodes), next) {
+            dispatch_append(table, dispatch_find(table, base_node->base, ESP_EVENT_ANY_ID), &(base_node->handlers), true);
+            SLIST_FOREACH(id_node, &(base_node->id_nodes), next) {
+                dispatch_append(table, dispatch_find(table, base_node->base, id_node->id), &(id_node->handlers), false);
+            }
+        }
+    }
+}
+
+static void dispatch_table_free(esp_event_dispatch_table_t* table)
 {
-    if (event_loop_args == NULL) {
-        ESP_LOGE(TAG, "event_loop_args was NULL");
-        return ESP_ERR_INVALID_ARG;
+    if (table) {
+        free(table->handlers);
+        free(table);
     }
+}
 
-    if (event_loop == NULL) {
-        ESP_LOGE(TAG, "event_loop was NULL");
-        return ESP_ERR_INVALID_ARG;
+static void dispatch_table_set(esp_event_loop_instance_t* loop, esp_event_dispatch_table_t* table)
+{
+    esp_event_dispatch_table_t* old = loop->dispatch_table;
+    loop->dispatch_table = table;
+
+    if (old == NULL) {
+        return;
     }
+    // the running dispatches still use the old table, it is freed by dispatch_finished once they are done
+    if (old->refs > 0 || loop->dispatch_depth > 0) {
+        old->next_retired = loop->retired_tables;
+        loop->retired_tables = old;
+    } else {
+        dispatch_table_free(old);
+    }
+}
 
-    esp_event_loop_instance_t* loop;
-    esp_err_t err = ESP_ERR_NO_MEM; // most likely error
+// Rebuilds the dispatch table of the loop from its loop nodes. Must be called with the loop mutex taken.
+// If memory is low, the table is dropped and events are dispatched by walking the lists.
+static void dispatch_table_rebuild(esp_event_loop_instance_t* loop)
+{
+    esp_event_loop_node_t *loop_node;
+    esp_event_base_node_t *base_node;
+    esp_event_id_node_t *id_node;
+    uint32_t seq = ++loop->dispatch_seq;
 
-    loop = esp_event_calloc(1, sizeof(*loop));
-    if (loop == NULL) {
-        ESP_LOGE(TAG, "alloc for event loop failed");
-        return err;
+    // every base node contributes an entry for its base and one for each of its id nodes, some may be duplicates
+    uint32_t keys = 0;
+    SLIST_FOREACH(loop_node, &(loop->loop_nodes), next) {
+        SLIST_FOREACH(base_node, &(loop_node->base_nodes), next) {
+            keys++;
+            SLIST_FOREACH(id_node, &(base_node->id_nodes), next) {
+                keys++;
+            }
+        }
     }
 
-#if CONFIG_ESP_EVENT_LOOP_IN_EXT_RAM && !CONFIG_ESP_EVENT_POST_FROM_IRAM_ISR
-    loop->queue = xQueueCreateWithCaps(event_loop_args->queue_size, sizeof(esp_event_post_instance_t), MALLOC_CAP_SPIRAM);
-#else
-    loop->queue = xQueueCreate(event_loop_args->queue_size, sizeof(esp_event_post_instance_t));
-#endif // CONFIG_ESP_EVENT_LOOP_IN_EXT_RAM && !CONFIG_ESP_EVENT_POST_FROM_IRAM_ISR
-    if (loop->queue == NULL) {
-        ESP_LOGE(TAG, "create event loop queue failed");
-        goto on_err;
+    // keep the load factor at or below 1/2
+    uint32_t slot_count = 4;
+    while (slot_count < 2 * keys) {
+        slot_count *= 2;
     }
 
-    loop->mutex = xSemaphoreCreateRecursiveMutex();
-    if (loop->mutex == NULL) {
-        ESP_LOGE(TAG, "create event loop mutex failed");
+    esp_event_dispatch_table_t* table = esp_event_calloc(1, sizeof(*table) + slot_count * sizeof(esp_event_dispatch_entry_t));
+    if (table == NULL) {
         goto on_err;
     }
+    table->mask = slot_count - 1;
+    table->seq = seq;
 
-    SLIST_INIT(&(loop->loop_nodes));
+    SLIST_FOREACH(loop_node, &(loop->loop_nodes), next) {
+        SLIST_FOREACH(base_node, &(loop_node->base_nodes), next) {
+            dispatch_add_entry(table, base_node->base, ESP_EVENT_ANY_ID);
+            SLIST_FOREACH(id_node, &(base_node->id_nodes), next) {
+                dispatch_add_entry(table, base_node->base, id_node->id);
+            }
+        }
+    }
 
-    // Create the loop task if requested
-    if (event_loop_args->task_name != NULL) {
-#if !CONFIG_ESP_EVENT_LOOP_IN_EXT_RAM
-        BaseType_t task_created = xTaskCreatePinnedToCore(esp_event_loop_run_task,
-                                                          event_loop_args->task_name,
-                                                          event_loop_args->task_stack_size,
-                                                          (void*) loop,
-                                                          event_loop_args->task_priority,
-                                                          &(loop->task),
-                                                          event_loop_args->task_core_id);
-#else
-        BaseType_t task_created = xTaskCreatePinnedToCoreWithCaps(esp_event_loop_run_task,
-                                                                  event_loop_args->task_name,
-                                                                  event_loop_args->task_stack_size,
-                                                                  (void*) loop,
-                                                                  event_loop_args->task_priority,
-                                                                  &(loop->task),
-                                                                  event_loop_args->task_core_id,
-                                                                  MALLOC_CAP_SPIRAM);
-#endif // !CONFIG_ESP_EVENT_LOOP_IN_EXT_RAM
+    // count the handlers of every entry, then place the entries one after another and fill them in
+    dispatch_assign(loop, table);
+    uint32_t total = table->loop_level_count;
+    for (uint32_t i = 0; i <= table->mask; i++) {
+        table->slots[i].first = total;
+        total += table->slots[i].count;
+    }
 
-        if (task_created != pdPASS) {
-            ESP_LOGE(TAG, "create task for loop failed");
-            err = ESP_FAIL;
+    if (total > 0) {
+        table->handlers = esp_event_calloc(total, sizeof(esp_event_handler_node_t*));
+        if (table->handlers == NULL) {
             goto on_err;
         }
+        dispatch_assign(loop, table);
+    }
 
-        loop->name = event_loop_args->task_name;
+    dispatch_table_set(loop, table);
+    return;
 
-        ESP_LOGD(TAG, "created task for loop %p", loop);
-    } else {
-        loop->name = "";
-        loop->task = NULL;
-    }
+on_err:
+    ESP_LOGW(TAG, "alloc for dispatch table of loop %p failed, walking handler lists", loop);
+    dispatch_table_free(table);
+    dispatch_table_set(loop, NULL);
+}
 
-    loop->running_task = NULL;
+static bool dispatch_table_execute(esp_event_loop_instance_t* loop, const esp_event_dispatch_table_t* table, esp_event_post_instance_t post)
+{
+    bool exec = false;
+    uint32_t first = 0;
+    uint32_t count = table->loop_level_count;
 
-#ifdef CONFIG_ESP_EVENT_LOOP_PROFILING
-    portENTER_CRITICAL(&s_event_loops_spinlock);
-    SLIST_INSERT_HEAD(&s_event_loops, loop, next);
-    portEXIT_CRITICAL(&s_event_loops_spinlock);
-#endif
+    const esp_event_dispatch_entry_t* entry = dispatch_find(table, post.base, post.id);
+    if (entry == NULL) {
+        entry = dispatch_find(table, post.base, ESP_EVENT_ANY_ID);
+    }
+    if (entry != NULL) {
+        first = entry->first;
+        count = entry->count;
+    }
 
-    *event_loop = (esp_event_loop_handle_t) loop;
+    for (uint32_t i = first; i < first + count; i++) {
+        esp_event_handler_node_t* handler = table->handlers[i];
+        if (!handler->unregistered) {
+            handler_execute(loop, handler, post);
+            exec = true;
+        }
+    }
 
-    ESP_LOGD(TAG, "created event loop %p", loop);
+    return exec;
+}
 
-    return ESP_OK;
+#endif // CONFIG_ESP_EVENT_DISPATCH_TABLE
 
-on_err:
-    if (loop->queue != NULL) {
-#if CONFIG_ESP_EVENT_LOOP_IN_EXT_RAM && !CONFIG_ESP_EVENT_POST_FROM_IRAM_ISR
-        vQueueDeleteWithCaps(loop->queue);
+// Table to dispatch the events with, NULL if the handler lists have to be walked. Must be called with the loop
+// mutex taken.
+static inline esp_event_dispatch_table_t* loop_dispatch_table(esp_event_loop_instance_t* loop)
+{
+#if CONFIG_ESP_EVENT_DISPATCH_TABLE
+    return loop->dispatch_table;
 #else
-        vQueueDelete(loop->queue);
+    return NULL;
 #endif
-    }
+}
 
-    if (loop->mutex != NULL) {
-        vSemaphoreDelete(loop->mutex);
+#if CONFIG_ESP_EVENT_DISPATCH_TABLE
+// Checks whether events are still dispatched with a table created before the rebuild seq, so possibly executing
+// the handlers unregistered before it. Must be called with the loop mutex taken.
+static bool dispatch_tables_in_use(esp_event_loop_instance_t* loop, uint32_t seq)
+{
+    for (esp_event_dispatch_table_t* retired = loop->retired_tables; retired != NULL; retired = retired->next_retired) {
+        if ((int32_t)(retired->seq - seq) < 0) {
+            return true;
+        }
     }
-
-    free(loop);
-
-    return err;
+    return false;
 }
+#endif
 
-// On event lookup performance: The library implements the event list as a linked list, which results to O(n)
-// lookup time. The test comparing this implementation to the O(lg n) performance of rbtrees
-// (https://github.com/freebsd/freebsd/blob/master/sys/sys/tree.h)
-// indicate that the difference is not that substantial, especially considering the additional
-// pointers per node of rbtrees. Code for the rbtree implementation of the event loop library is archived
-// in feature/esp_event_loop_library_rbtrees if needed.
-esp_err_t esp_event_loop_run(esp_event_loop_handle_t event_loop, TickType_t ticks_to_run)
+// Checks whether a task of the loop is dispatching an event. Must be called with the loop mutex taken.
+static bool loop_is_dispatching(esp_event_loop_instance_t* loop)
 {
-    assert(event_loop);
+#if CONFIG_ESP_EVENT_DISPATCH_TABLE
+    if ((loop->dispatch_table != NULL && loop->dispatch_table->refs > 0) || loop->retired_tables != NULL) {
+        return true;
+    }
+#endif
+    return loop->dispatch_depth > 0;
+}
 
-    esp_event_loop_instance_t* loop = (esp_event_loop_instance_t*) event_loop;
-    esp_event_post_instance_t post;
-    TickType_t marker = xTaskGetTickCount();
-    TickType_t end = 0;
+// Frees the replaced tables no event is dispatched with anymore and removes the handlers whose removal was
+// deferred, once they can't be executed anymore. Must be called with the loop mutex taken, after a dispatch.
+static void dispatch_finished(esp_event_loop_instance_t* loop)
+{
+    // the lists may be walked or the table used by a dispatch holding the mutex
+    if (loop->dispatch_depth > 0) {
+        return;
+    }
 
-#if (configUSE_16_BIT_TICKS == 1)
-    int32_t remaining_ticks = ticks_to_run;
-#else
-    int64_t remaining_ticks = ticks_to_run;
+#if CONFIG_ESP_EVENT_DISPATCH_TABLE
+    esp_event_dispatch_table_t** next = &(loop->retired_tables);
+    while (*next != NULL) {
+        esp_event_dispatch_table_t* retired = *next;
+        if (retired->refs == 0) {
+            *next = retired->next_retired;
+            dispatch_table_free(retired);
+        } else {
+            next = &(retired->next_retired);
+        }
+    }
 #endif
 
-    while (xQueueReceive(loop->queue, &post, remaining_ticks) == pdTRUE) {
-        // The event has already been unqueued, so ensure it gets executed.
-        xSemaphoreTakeRecursive(loop->mutex, portMAX_DELAY);
+    esp_event_deferred_removal_t *removal, *temp;
+    SLIST_FOREACH_SAFE(removal, &(loop->deferred_removals), next, temp) {
+#if CONFIG_ESP_EVENT_DISPATCH_TABLE
+        if (dispatch_tables_in_use(loop, removal->seq)) {
+            continue;
+        }
+#endif
+        SLIST_REMOVE(&(loop->deferred_removals), removal, esp_event_deferred_removal, next);
+        // the handler is not in the dispatch table anymore, the table doesn't have to be rebuilt
+        loop_remove_handler(&(removal->ctx));
+        if (removal->ctx.legacy) {
+            free(removal->ctx.handler_ctx);
+        }
+        free(removal);
+    }
+}
 
-        // check if the event retrieve from the queue is the internal event that is
+static esp_err_t event_pool_init(esp_event_loop_instance_t* loop, uint32_t size, uint32_t block_size)
+{
+    if (size == 0) {
+        return ESP_OK;
+    }
+    if (size >= EVENT_POOL_TAKEN || block_size == 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    // keep the blocks aligned for any type of event data, the free list follows the blocks
+    block_size = EVENT_DATA_ALIGN(block_size);
+    loop->pool = esp_event_calloc(size, block_size + sizeof(atomic_uint_least16_t));
+    if (loop->pool == NULL) {
+        return ESP_ERR_NO_MEM;
+    }
+    loop->pool_next = (atomic_uint_least16_t*)(loop->pool + size * block_size);
+    loop->pool_size = size;
+    loop->pool_block_size = block_size;
+
+    for (uint32_t i = 0; i < size; i++) {
+        atomic_init(&loop->pool_next[i], (i + 1 < size) ? i + 1 : EVENT_POOL_NO_BLOCK);
+    }
+    atomic_init(&loop->pool_head, 0);
+    atomic_init(&loop->pool_free, size);
+    return ESP_OK;
+}
+
+// Takes a block from the free list of the pool. Lock-free, so that any task can post without waiting for the loop.
+static void* event_pool_get(esp_event_loop_instance_t* loop)
+{
+    if (loop->pool == NULL) {
+        return NULL;
+    }
+
+    uint32_t head = atomic_load(&loop->pool_head);
+    uint32_t new_head;
+    do {
+        uint32_t index = head & 0xffff;
+        if (index == EVENT_POOL_NO_BLOCK) {
+            atomic_fetch_add(&loop->pool_exhausted, 1);
+            return NULL;
+        }
+        // the modification count in the upper bits makes the exchange fail if the block was taken and given back
+        // in the meantime, with another next block
+        new_head = ((head & 0xffff0000) + 0x10000) | atomic_load_explicit(&loop->pool_next[index], memory_order_relaxed);
+    } while (!atomic_compare_exchange_weak(&loop->pool_head, &head, new_head));
+    // a get which read this block as head before it was taken fails its exchange, so it never uses this value
+    atomic_store_explicit(&loop->pool_next[head & 0xffff], EVENT_POOL_TAKEN, memory_order_relaxed);
+
+    atomic_fetch_sub(&loop->pool_free, 1);
+    atomic_fetch_add(&loop->pool_allocs, 1);
+    return loop->pool + (head & 0xffff) * loop->pool_block_size;
+}
+
+// Returns true if ptr is the start of a block of the pool
+static bool event_pool_owns(esp_event_loop_instance_t* loop, const void* ptr)
+{
+    const uint8_t* block = (const uint8_t*) ptr;
+    return loop->pool != NULL && block >= loop->pool && block < loop->pool + loop->pool_size * loop->pool_block_size &&
+           (block - loop->pool) % loop->pool_block_size == 0;
+}
+
+static bool event_pool_is_taken(esp_event_loop_instance_t* loop, const void* ptr)
+{
+    uint32_t index = ((const uint8_t*) ptr - loop->pool) / loop->pool_block_size;
+    return atomic_load(&loop->pool_next[index]) == EVENT_POOL_TAKEN;
+}
+
+// Gives a block back to the free list of the pool, returns false if the block is already free
+static bool event_pool_put(esp_event_loop_instance_t* loop, void* ptr)
+{
+    uint32_t index = ((uint8_t*) ptr - loop->pool) / loop->pool_block_size;
+
+    uint_least16_t taken = EVENT_POOL_TAKEN;
+    if (!atomic_compare_exchange_strong(&loop->pool_next[index], &taken, EVENT_POOL_NO_BLOCK)) {
+        return false;
+    }
+
+    uint32_t head = atomic_load(&loop->pool_head);
+    do {
+        atomic_store_explicit(&loop->pool_next[index], head & 0xffff, memory_order_relaxed);
+    } while (!atomic_compare_exchange_weak(&loop->pool_head, &head, ((head & 0xffff0000) + 0x10000) | index));
+
+    atomic_fetch_add(&loop->pool_free, 1);
+    return true;
+}
+
+// Allocates memory for a copy of event data, from the pool of the loop if the data fits into a block
+static void* event_data_alloc(esp_event_loop_instance_t* loop, size_t size)
+{
+    void* data = NULL;
+    if (size <= loop->pool_block_size) {
+        data = event_pool_get(loop);
+    }
+    if (data == NULL) {
+        data = esp_event_calloc(1, size);
+        if (data != NULL) {
+            atomic_fetch_add(&loop->heap_allocs, 1);
+        }
+    }
+    return data;
+}
+
+static void event_data_free(esp_event_loop_instance_t* loop, void* data)
+{
+    if (event_pool_owns(loop, data)) {
+        bool released = event_pool_put(loop, data);
+        assert(released);
+        (void) released;
+    } else {
+        free(data);
+    }
+}
+
+static void inline __attribute__((always_inline)) post_instance_delete(esp_event_loop_instance_t* loop, esp_event_post_instance_t* post)
+{
+    // a batch posted to several workers is freed by the last of them
+    if (post->base == esp_event_batch &&
+            atomic_fetch_sub(&((esp_event_batch_t*) post->data.ptr)->refs, 1) > 1) {
+        memset(post, 0, sizeof(*post));
+        return;
+    }
+#if CONFIG_ESP_EVENT_POST_FROM_ISR
+    if (post->data_allocated)
+#endif
+    {
+        event_data_free(loop, post->data.ptr);
+    }
+    memset(post, 0, sizeof(*post));
+}
+
+// Queues the post, which carries event_count events. Does not free the event data if the queue is full.
+static esp_err_t post_instance_send(esp_event_loop_instance_t* loop, QueueHandle_t queue, esp_event_post_instance_t* post, TickType_t ticks_to_wait, uint32_t event_count)
+{
+    BaseType_t result = pdFALSE;
+
+    // Find the task that currently executes the loop. It is safe to query loop->task since it is
+    // not mutated since loop creation. ENSURE THIS REMAINS TRUE.
+    if (loop->task == NULL) {
+        // The loop has no dedicated task. Find out what task is currently running it.
+        result = xSemaphoreTakeRecursive(loop->mutex, ticks_to_wait);
+
+        if (result == pdTRUE) {
+            if (loop->running_task != xTaskGetCurrentTaskHandle()) {
+                xSemaphoreGiveRecursive(loop->mutex);
+                result = xQueueSendToBack(queue, post, ticks_to_wait);
+            } else {
+                xSemaphoreGiveRecursive(loop->mutex);
+                result = xQueueSendToBack(queue, post, 0);
+            }
+        }
+    } else {
+        // The loop has dedicated tasks.
+        if (!loop_task_is_current(loop)) {
+            result = xQueueSendToBack(queue, post, ticks_to_wait);
+        } else {
+            result = xQueueSendToBack(queue, post, 0);
+        }
+    }
+
+    if (result != pdTRUE) {
+#ifdef CONFIG_ESP_EVENT_LOOP_PROFILING
+        atomic_fetch_add(&loop->events_dropped, event_count);
+#endif
+        return ESP_ERR_TIMEOUT;
+    }
+
+#ifdef CONFIG_ESP_EVENT_LOOP_PROFILING
+    atomic_fetch_add(&loop->events_received, event_count);
+#endif
+
+    return ESP_OK;
+}
+
+static bool post_instance_dispatch(esp_event_loop_instance_t* loop, const esp_event_dispatch_table_t* table, esp_event_post_instance_t post)
+{
+#if CONFIG_ESP_EVENT_DISPATCH_TABLE
+    if (table != NULL) {
+        return dispatch_table_execute(loop, table, post);
+    }
+#endif
+    return loop_nodes_execute(loop, post);
+}
+
+// Dispatches the events of a batch routed to the worker one after another
+static bool batch_dispatch(esp_event_loop_instance_t* loop, const esp_event_dispatch_table_t* table, esp_event_batch_t* batch, uint32_t worker)
+{
+    bool exec = false;
+
+    for (size_t i = 0; i < batch->count; i++) {
+        if (loop_worker_index(loop, batch->items[i].base, batch->items[i].id) != worker) {
+            continue;
+        }
+        esp_event_post_instance_t item;
+        memset(&item, 0, sizeof(item));
+        item.base = batch->items[i].base;
+        item.id = batch->items[i].id;
+        item.data.ptr = batch->items[i].data;
+#if CONFIG_ESP_EVENT_POST_FROM_ISR
+        item.data_allocated = true;
+        item.data_set = (item.data.ptr != NULL);
+#endif
+        exec |= post_instance_dispatch(loop, table, item);
+    }
+
+    return exec;
+}
+
+static bool post_dispatch(esp_event_loop_instance_t* loop, const esp_event_dispatch_table_t* table, esp_event_post_instance_t post, uint32_t worker)
+{
+    if (post.base == esp_event_batch) {
+        return batch_dispatch(loop, table, (esp_event_batch_t*) post.data.ptr, worker);
+    }
+    return post_instance_dispatch(loop, table, post);
+}
+
+// Removes an unregistered handler of a loop with several tasks. The tasks execute handlers without the mutex, with
+// the dispatch table taken when they started the dispatch, which may still contain the handler. Waits until no
+// event is dispatched with such a table anymore, so that the handler is not executed once unregistered. Called
+// by a handler of the loop, which may itself dispatch with such a table, the removal is deferred instead and
+// the handler may still be running on other tasks when the call returns. Must be called with the loop mutex taken.
+static esp_err_t workers_remove_handler(esp_event_remove_handler_context_t* ctx)
+{
+    esp_event_loop_instance_t* loop = ctx->loop;
+
+#if CONFIG_ESP_EVENT_DISPATCH_TABLE
+    // tables built from now on leave the handler out
+    dispatch_table_rebuild(loop);
+    uint32_t seq = loop->dispatch_seq;
+#endif
+
+    if (loop_task_is_current(loop)) {
+        esp_event_deferred_removal_t* removal = esp_event_calloc(1, sizeof(*removal));
+        if (removal == NULL) {
+            if (ctx->legacy) {
+                free(ctx->handler_ctx);
+            }
+            return ESP_ERR_NO_MEM;
+        }
+        removal->ctx = *ctx;
+#if CONFIG_ESP_EVENT_DISPATCH_TABLE
+        removal->seq = seq;
+#endif
+        SLIST_INSERT_HEAD(&(loop->deferred_removals), removal, next);
+        return ESP_OK;
+    }
+
+#if CONFIG_ESP_EVENT_DISPATCH_TABLE
+    while (dispatch_tables_in_use(loop, seq)) {
+        xSemaphoreGiveRecursive(loop->mutex);
+        vTaskDelay(1);
+        xSemaphoreTakeRecursive(loop->mutex, portMAX_DELAY);
+    }
+#endif
+
+    // without a table, events are dispatched with the mutex taken
+    esp_err_t res = loop_remove_handler(ctx);
+    if (ctx->legacy) {
+        free(ctx->handler_ctx);
+    }
+    return res;
+}
+
+static esp_err_t find_and_unregister_handler(esp_event_remove_handler_context_t* ctx)
+{
+    esp_event_handler_node_t *handler_to_unregister = NULL;
+    esp_event_handler_node_t *handler;
+    esp_event_loop_node_t *loop_node;
+    esp_event_base_node_t *base_node;
+    esp_event_id_node_t *id_node;
+
+    SLIST_FOREACH(loop_node, &(ctx->loop->loop_nodes), next) {
+        // Execute loop level handlers
+        SLIST_FOREACH(handler, &(loop_node->handlers), next) {
+            if (ctx->legacy) {
+                if (handler->handler_ctx->handler == ctx->handler_ctx->handler) {
+                    handler_to_unregister = handler;
+                    break;
+                }
+            } else {
+                if (handler->handler_ctx == ctx->handler_ctx) {
+                    handler_to_unregister = handler;
+                    break;
+                }
+            }
+        }
+
+        if (handler_to_unregister != NULL) {
+            break;
+        }
+
+        SLIST_FOREACH(base_node, &(loop_node->base_nodes), next) {
+            if (base_node->base == ctx->event_base) {
+                // Execute base level handlers
+                SLIST_FOREACH(handler, &(base_node->handlers), next) {
+                    if (ctx->legacy) {
+                        if (handler->handler_ctx->handler == ctx->handler_ctx->handler) {
+                            handler_to_unregister = handler;
+                            break;
+                        }
+                    } else {
+                        if (handler->handler_ctx == ctx->handler_ctx) {
+                            handler_to_unregister = handler;
+                            break;
+                        }
+                    }
+                }
+
+                if (handler_to_unregister != NULL) {
+                    break;
+                }
+
+                SLIST_FOREACH(id_node, &(base_node->id_nodes), next) {
+                    if (id_node->id == ctx->event_id) {
+                        // Execute id level handlers
+                        SLIST_FOREACH(handler, &(id_node->handlers), next) {
+                            if (ctx->legacy) {
+                                if (handler->handler_ctx->handler == ctx->handler_ctx->handler) {
+                                    handler_to_unregister = handler;
+                                    break;
+                                }
+                            } else {
+                                if (handler->handler_ctx == ctx->handler_ctx) {
+                                    handler_to_unregister = handler;
+                                    break;
+                                }
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    if (handler_to_unregister == NULL) {
+        /* handler not found in the lists, return */
+        return ESP_ERR_NOT_FOUND;
+    }
+
+    if (handler_to_unregister->unregistered) {
+        /* the handler was found in a list but has already be marked
+         * as unregistered. It means an event was already created to
+         * remove from the list. return OK but do nothing */
+        return ESP_OK;
+    }
+    /* handler found in the lists and not already marked as unregistered. Mark it as unregistered
+     * and post an event to remove it from the lists */
+    handler_to_unregister->unregistered = true;
+    if (ctx->legacy) {
+        /* in case of legacy code, we have to copy the handler_ctx content since it was created in the calling function */
+        esp_event_handler_instance_context_t *handler_ctx_copy = esp_event_calloc(1, sizeof(esp_event_handler_instance_context_t));
+        if (!handler_ctx_copy) {
+            return ESP_ERR_NO_MEM;
+        }
+        handler_ctx_copy->arg = ctx->handler_ctx->arg;
+        handler_ctx_copy->handler = ctx->handler_ctx->handler;
+        ctx->handler_ctx = handler_ctx_copy;
+    }
+    if (ctx->loop->worker_count > 1) {
+        // workers dispatch events without holding the mutex, the cleanup event would race with them
+        return workers_remove_handler(ctx);
+    }
+    return esp_event_post_to(ctx->loop, esp_event_handler_cleanup, 0, ctx, sizeof(esp_event_remove_handler_context_t), portMAX_DELAY);
+}
+
+static void esp_event_loop_run_worker(void* args)
+{
+    esp_event_loop_worker_t* worker = (esp_event_loop_worker_t*) args;
+    esp_event_loop_instance_t* loop = worker->loop;
+    esp_event_post_instance_t post;
+
+    ESP_LOGD(TAG, "running worker %"PRIu32" for loop %p", worker->index, loop);
+
+    while (1) {
+        if (xQueueReceive(worker->queue, &post, portMAX_DELAY) != pdTRUE) {
+            continue;
+        }
+
+        xSemaphoreTakeRecursive(loop->mutex, portMAX_DELAY);
+
+        // With a dispatch table, the workers execute handlers concurrently. The table and the handlers it refers
+        // to stay valid as long as the table is referenced. Without one, the handler lists are walked with the
+        // mutex taken, one worker at a time.
+        esp_event_dispatch_table_t* table = loop_dispatch_table(loop);
+        if (table != NULL) {
+            table->refs++;
+            xSemaphoreGiveRecursive(loop->mutex);
+        } else {
+            loop->dispatch_depth++;
+        }
+
+        bool exec = post_dispatch(loop, table, post, worker->index);
+
+        if (table != NULL) {
+            xSemaphoreTakeRecursive(loop->mutex, portMAX_DELAY);
+            table->refs--;
+        } else {
+            loop->dispatch_depth--;
+        }
+        dispatch_finished(loop);
+
+        esp_event_base_t base = post.base;
+        int32_t id = post.id;
+
+        post_instance_delete(loop, &post);
+
+        xSemaphoreGiveRecursive(loop->mutex);
+
+        if (!exec) {
+            ESP_LOGD(TAG, "no handlers have been registered for event %s:%"PRIu32" posted to loop %p", base, id, loop);
+        }
+    }
+}
+
+static QueueHandle_t loop_queue_create(int32_t queue_size)
+{
+#if CONFIG_ESP_EVENT_LOOP_IN_EXT_RAM && !CONFIG_ESP_EVENT_POST_FROM_IRAM_ISR
+    return xQueueCreateWithCaps(queue_size, sizeof(esp_event_post_instance_t), MALLOC_CAP_SPIRAM);
+#else
+    return xQueueCreate(queue_size, sizeof(esp_event_post_instance_t));
+#endif // CONFIG_ESP_EVENT_LOOP_IN_EXT_RAM && !CONFIG_ESP_EVENT_POST_FROM_IRAM_ISR
+}
+
+static void loop_queue_delete(esp_event_loop_instance_t* loop, QueueHandle_t queue)
+{
+    // Drop existing posts on the queue
+    esp_event_post_instance_t post;
+    while (xQueueReceive(queue, &post, 0) == pdTRUE) {
+        post_instance_delete(loop, &post);
+    }
+
+#if CONFIG_ESP_EVENT_LOOP_IN_EXT_RAM && !CONFIG_ESP_EVENT_POST_FROM_IRAM_ISR
+    vQueueDeleteWithCaps(queue);
+#else
+    vQueueDelete(queue);
+#endif
+}
+
+static BaseType_t loop_task_create(TaskFunction_t function, void* arg, const esp_event_loop_args_t* event_loop_args, TaskHandle_t* task)
+{
+#if !CONFIG_ESP_EVENT_LOOP_IN_EXT_RAM
+    return xTaskCreatePinnedToCore(function,
+                                   event_loop_args->task_name,
+                                   event_loop_args->task_stack_size,
+                                   arg,
+                                   event_loop_args->task_priority,
+                                   task,
+                                   event_loop_args->task_core_id);
+#else
+    return xTaskCreatePinnedToCoreWithCaps(function,
+                                           event_loop_args->task_name,
+                                           event_loop_args->task_stack_size,
+                                           arg,
+                                           event_loop_args->task_priority,
+                                           task,
+                                           event_loop_args->task_core_id,
+                                           MALLOC_CAP_SPIRAM);
+#endif // !CONFIG_ESP_EVENT_LOOP_IN_EXT_RAM
+}
+
+static void loop_task_delete(TaskHandle_t task)
+{
+#if CONFIG_ESP_EVENT_LOOP_IN_EXT_RAM
+    vTaskDeleteWithCaps(task);
+#else
+    vTaskDelete(task);
+#endif
+}
+
+// Creates the queues and tasks of a loop with several tasks. The first worker uses the queue of the loop.
+static esp_err_t loop_workers_create(esp_event_loop_instance_t* loop, const esp_event_loop_args_t* event_loop_args)
+{
+    loop->workers = esp_event_calloc(event_loop_args->task_count, sizeof(esp_event_loop_worker_t));
+    if (loop->workers == NULL) {
+        ESP_LOGE(TAG, "alloc for event loop workers failed");
+        return ESP_ERR_NO_MEM;
+    }
+    loop->worker_count = event_loop_args->task_count;
+
+    for (uint32_t i = 0; i < loop->worker_count; i++) {
+        esp_event_loop_worker_t* worker = &(loop->workers[i]);
+        worker->loop = loop;
+        worker->index = i;
+        worker->queue = (i == 0) ? loop->queue : loop_queue_create(event_loop_args->queue_size);
+        if (worker->queue == NULL) {
+            ESP_LOGE(TAG, "create event loop queue failed");
+            return ESP_ERR_NO_MEM;
+        }
+    }
+
+    for (uint32_t i = 0; i < loop->worker_count; i++) {
+        esp_event_loop_worker_t* worker = &(loop->workers[i]);
+        if (loop_task_create(esp_event_loop_run_worker, worker, event_loop_args, &(worker->task)) != pdPASS) {
+            ESP_LOGE(TAG, "create task for loop failed");
+            return ESP_FAIL;
+        }
+    }
+
+    loop->task = loop->workers[0].task;
+
+    return ESP_OK;
+}
+
+static void loop_workers_delete(esp_event_loop_instance_t* loop)
+{
+    if (loop->workers == NULL) {
+        return;
+    }
+
+    for (uint32_t i = 0; i < loop->worker_count; i++) {
+        if (loop->workers[i].task != NULL) {
+            loop_task_delete(loop->workers[i].task);
+        }
+    }
+
+    // the queue of the first worker is the queue of the loop
+    for (uint32_t i = 1; i < loop->worker_count; i++) {
+        if (loop->workers[i].queue != NULL) {
+            loop_queue_delete(loop, loop->workers[i].queue);
+        }
+    }
+
+    free(loop->workers);
+    loop->workers = NULL;
+    loop->worker_count = 0;
+    loop->task = NULL;
+}
+
+/* ---------------------------- Public API --------------------------------- */
+
+esp_err_t esp_event_loop_create(const esp_event_loop_args_t* event_loop_args, esp_event_loop_handle_t* event_loop)
+{
+    if (event_loop_args == NULL) {
+        ESP_LOGE(TAG, "event_loop_args was NULL");
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    if (event_loop == NULL) {
+        ESP_LOGE(TAG, "event_loop was NULL");
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    esp_event_loop_instance_t* loop;
+    esp_err_t err = ESP_ERR_NO_MEM; // most likely error
+
+    loop = esp_event_calloc(1, sizeof(*loop));
+    if (loop == NULL) {
+        ESP_LOGE(TAG, "alloc for event loop failed");
+        return err;
+    }
+
+    loop->queue = loop_queue_create(event_loop_args->queue_size);
+    if (loop->queue == NULL) {
+        ESP_LOGE(TAG, "create event loop queue failed");
+        goto on_err;
+    }
+
+    loop->mutex = xSemaphoreCreateRecursiveMutex();
+    if (loop->mutex == NULL) {
+        ESP_LOGE(TAG, "create event loop mutex failed");
+        goto on_err;
+    }
+
+    err = event_pool_init(loop, event_loop_args->event_pool_size, event_loop_args->event_pool_block_size);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "create event data pool failed");
+        goto on_err;
+    }
+    err = ESP_ERR_NO_MEM;
+
+    SLIST_INIT(&(loop->loop_nodes));
+    SLIST_INIT(&(loop->deferred_removals));
+
+    // Create the loop task if requested
+    if (event_loop_args->task_name != NULL) {
+        if (event_loop_args->task_count > 1) {
+            err = loop_workers_create(loop, event_loop_args);
+            if (err != ESP_OK) {
+                goto on_err;
+            }
+        } else if (loop_task_create(esp_event_loop_run_task, (void*) loop, event_loop_args, &(loop->task)) != pdPASS) {
+            ESP_LOGE(TAG, "create task for loop failed");
+            err = ESP_FAIL;
+            goto on_err;
+        }
+
+        loop->name = event_loop_args->task_name;
+
+        ESP_LOGD(TAG, "created task for loop %p", loop);
+    } else {
+        loop->name = "";
+        loop->task = NULL;
+    }
+
+    loop->running_task = NULL;
+
+#ifdef CONFIG_ESP_EVENT_LOOP_PROFILING
+    portENTER_CRITICAL(&s_event_loops_spinlock);
+    SLIST_INSERT_HEAD(&s_event_loops, loop, next);
+    portEXIT_CRITICAL(&s_event_loops_spinlock);
+#endif
+
+    *event_loop = (esp_event_loop_handle_t) loop;
+
+    ESP_LOGD(TAG, "created event loop %p", loop);
+
+    return ESP_OK;
+
+on_err:
+    loop_workers_delete(loop);
+
+    if (loop->queue != NULL) {
+        loop_queue_delete(loop, loop->queue);
+    }
+
+    if (loop->mutex != NULL) {
+        vSemaphoreDelete(loop->mutex);
+    }
+
+    free(loop->pool);
+    free(loop);
+
+    return err;
+}
+
+// On event lookup performance: The library implements the event list as a linked list, which results to O(n)
+// lookup time. The test comparing this implementation to the O(lg n) performance of rbtrees
+// (https://github.com/freebsd/freebsd/blob/master/sys/sys/tree.h)
+// indicate that the difference is not that substantial, especially considering the additional
+// pointers per node of rbtrees. Code for the rbtree implementation of the event loop library is archived
+// in feature/esp_event_loop_library_rbtrees if needed.
+// With CONFIG_ESP_EVENT_DISPATCH_TABLE, the lists are only walked when handlers are registered or removed,
+// to build a hash table holding the handlers of each (base, id) pair. Events are then dispatched in constant time.
+esp_err_t esp_event_loop_run(esp_event_loop_handle_t event_loop, TickType_t ticks_to_run)
+{
+    assert(event_loop);
+
+    esp_event_loop_instance_t* loop = (esp_event_loop_instance_t*) event_loop;
+    esp_event_post_instance_t post;
+    TickType_t marker = xTaskGetTickCount();
+    TickType_t end = 0;
+
+#if (configUSE_16_BIT_TICKS == 1)
+    int32_t remaining_ticks = ticks_to_run;
+#else
+    int64_t remaining_ticks = ticks_to_run;
+#endif
+
+    while (xQueueReceive(loop->queue, &post, remaining_ticks) == pdTRUE) {
+        // The event has already been unqueued, so ensure it gets executed.
+        xSemaphoreTakeRecursive(loop->mutex, portMAX_DELAY);
+
+        // check if the event retrieve from the queue is the internal event that is
         // triggered when a handler needs to be removed..
         if (post.base == esp_event_handler_cleanup) {
             assert(post.data.ptr != NULL);
             esp_event_remove_handler_context_t* ctx = (esp_event_remove_handler_context_t*)post.data.ptr;
-            loop_remove_handler(ctx);
+            if (loop_remove_handler(ctx) == ESP_OK) {
+#if CONFIG_ESP_EVENT_DISPATCH_TABLE
+                dispatch_table_rebuild(loop);
+#endif
+            }
 
             // if the handler unregistration request came from legacy code,
             // we have to free handler_ctx pointer since it points to memory
@@ -698,53 +1499,17 @@ esp_err_t esp_event_loop_run(esp_event_loop_handle_t event_loop, TickType_t tick
 
         loop->running_task = xTaskGetCurrentTaskHandle();
 
-        bool exec = false;
-
-        esp_event_handler_node_t *handler, *temp_handler;
-        esp_event_loop_node_t *loop_node, *temp_node;
-        esp_event_base_node_t *base_node, *temp_base;
-        esp_event_id_node_t *id_node, *temp_id_node;
-
-        SLIST_FOREACH_SAFE(loop_node, &(loop->loop_nodes), next, temp_node) {
-            // Execute loop level handlers
-            SLIST_FOREACH_SAFE(handler, &(loop_node->handlers), next, temp_handler) {
-                if (!handler->unregistered) {
-                    handler_execute(loop, handler, post);
-                    exec |= true;
-                }
-            }
-
-            SLIST_FOREACH_SAFE(base_node, &(loop_node->base_nodes), next, temp_base) {
-                if (base_node->base == post.base) {
-                    // Execute base level handlers
-                    SLIST_FOREACH_SAFE(handler, &(base_node->handlers), next, temp_handler) {
-                        if (!handler->unregistered) {
-                            handler_execute(loop, handler, post);
-                            exec |= true;
-                        }
-                    }
-
-                    SLIST_FOREACH_SAFE(id_node, &(base_node->id_nodes), next, temp_id_node) {
-                        if (id_node->id == post.id) {
-                            // Execute id level handlers
-                            SLIST_FOREACH_SAFE(handler, &(id_node->handlers), next, temp_handler) {
-                                if (!handler->unregistered) {
-                                    handler_execute(loop, handler, post);
-                                    exec |= true;
-                                }
-                            }
-                            // Skip to next base node
-                            break;
-                        }
-                    }
-                }
-            }
+        loop->dispatch_depth++;
+        bool exec = post_dispatch(loop, loop_dispatch_table(loop), post, 0);
+        loop->dispatch_depth--;
+        if (loop->dispatch_depth == 0) {
+            dispatch_finished(loop);
         }
 
         esp_event_base_t base = post.base;
         int32_t id = post.id;
 
-        post_instance_delete(&post);
+        post_instance_delete(loop, &post);
 
         if (ticks_to_run != portMAX_DELAY) {
             end = xTaskGetTickCount();
@@ -781,19 +1546,24 @@ esp_err_t esp_event_loop_delete(esp_event_loop_handle_t event_loop)
 
     xSemaphoreTakeRecursive(loop->mutex, portMAX_DELAY);
 
+    // Workers execute handlers without holding the mutex, wait for them to finish
+    while (loop_is_dispatching(loop)) {
+        xSemaphoreGiveRecursive(loop->mutex);
+        vTaskDelay(1);
+        xSemaphoreTakeRecursive(loop->mutex, portMAX_DELAY);
+    }
+
 #ifdef CONFIG_ESP_EVENT_LOOP_PROFILING
     portENTER_CRITICAL(&s_event_loops_spinlock);
     SLIST_REMOVE(&s_event_loops, loop, esp_event_loop_instance, next);
     portEXIT_CRITICAL(&s_event_loops_spinlock);
 #endif
 
-    // Delete the task if it was created
-    if (loop->task != NULL) {
-#if CONFIG_ESP_EVENT_LOOP_IN_EXT_RAM
-        vTaskDeleteWithCaps(loop->task);
-#else
-        vTaskDelete(loop->task);
-#endif
+    // Delete the tasks if they were created
+    if (loop->workers != NULL) {
+        loop_workers_delete(loop);
+    } else if (loop->task != NULL) {
+        loop_task_delete(loop->task);
         loop->task = NULL;
     }
 
@@ -805,18 +1575,18 @@ esp_err_t esp_event_loop_delete(esp_event_loop_handle_t event_loop)
         free(it);
     }
 
-    // Drop existing posts on the queue
-    esp_event_post_instance_t post;
-    while (xQueueReceive(loop->queue, &post, 0) == pdTRUE) {
-        post_instance_delete(&post);
+#if CONFIG_ESP_EVENT_DISPATCH_TABLE
+    dispatch_table_free(loop->dispatch_table);
+    while (loop->retired_tables) {
+        esp_event_dispatch_table_t* retired = loop->retired_tables;
+        loop->retired_tables = retired->next_retired;
+        dispatch_table_free(retired);
     }
+#endif
 
     // Cleanup loop
-#if CONFIG_ESP_EVENT_LOOP_IN_EXT_RAM && !CONFIG_ESP_EVENT_POST_FROM_IRAM_ISR
-    vQueueDeleteWithCaps(loop->queue);
-#else
-    vQueueDelete(loop->queue);
-#endif
+    loop_queue_delete(loop, loop->queue);
+    free(loop->pool);
     free(loop);
     // Free loop mutex before deleting
     xSemaphoreGiveRecursive(loop_mutex);
@@ -883,6 +1653,12 @@ esp_err_t esp_event_handler_register_with_internal(esp_event_loop_handle_t event
         err = loop_node_add_handler(last_loop_node, event_base, event_id, event_handler, event_handler_arg, handler_ctx_arg, legacy);
     }
 
+#if CONFIG_ESP_EVENT_DISPATCH_TABLE
+    if (err == ESP_OK) {
+        dispatch_table_rebuild(loop);
+    }
+#endif
+
 on_err:
     xSemaphoreGiveRecursive(loop->mutex);
     return err;
@@ -919,18 +1695,29 @@ esp_err_t esp_event_handler_unregister_with_internal(esp_event_loop_handle_t eve
     esp_event_loop_instance_t* loop = (esp_event_loop_instance_t*) event_loop;
     esp_event_remove_handler_context_t remove_handler_ctx = {loop, event_base, event_id, handler_ctx, legacy};
 
-    /* remove the handler if the mutex is taken successfully.
+    /* remove the handler if the mutex is taken successfully and no event is dispatched.
      * otherwise it will be removed from the list later */
     esp_err_t res = ESP_FAIL;
     if (xSemaphoreTake(loop->mutex, 0) == pdTRUE) {
-        res = loop_remove_handler(&remove_handler_ctx);
+        if (!loop_is_dispatching(loop)) {
+            res = loop_remove_handler(&remove_handler_ctx);
+#if CONFIG_ESP_EVENT_DISPATCH_TABLE
+            if (res == ESP_OK) {
+                dispatch_table_rebuild(loop);
+            }
+#endif
+            xSemaphoreGive(loop->mutex);
+            return res;
+        }
+        // workers of the loop are dispatching events without holding the mutex, removing the handler may wait
+        // for them with the mutex given back in the meantime
         xSemaphoreGive(loop->mutex);
-    } else {
-        xSemaphoreTakeRecursive(loop->mutex, portMAX_DELAY);
-        res = find_and_unregister_handler(&remove_handler_ctx);
-        xSemaphoreGiveRecursive(loop->mutex);
     }
 
+    xSemaphoreTakeRecursive(loop->mutex, portMAX_DELAY);
+    res = find_and_unregister_handler(&remove_handler_ctx);
+    xSemaphoreGiveRecursive(loop->mutex);
+
     return res;
 }
 
@@ -971,7 +1758,7 @@ esp_err_t esp_event_post_to(esp_event_loop_handle_t event_loop, esp_event_base_t
     if (event_data != NULL && event_data_size != 0) {
 #if CONFIG_ESP_EVENT_POST_FROM_ISR
         if (event_data_size > sizeof(post.data.val)) {
-            post.data.ptr = calloc(1, event_data_size);
+            post.data.ptr = event_data_alloc(loop, event_data_size);
             if (post.data.ptr == NULL) {
                 return ESP_ERR_NO_MEM;
             }
@@ -982,8 +1769,8 @@ esp_err_t esp_event_post_to(esp_event_loop_handle_t event_loop, esp_event_base_t
         }
         post.data_set = true;
 #else // !CONFIG_ESP_EVENT_POST_FROM_ISR
-        // Make persistent copy of event data on heap.
-        void* event_data_copy = esp_event_calloc(1, event_data_size);
+        // Make persistent copy of event data, in the pool of the loop or on heap.
+        void* event_data_copy = event_data_alloc(loop, event_data_size);
 
         if (event_data_copy == NULL) {
             return ESP_ERR_NO_MEM;
@@ -996,44 +1783,187 @@ esp_err_t esp_event_post_to(esp_event_loop_handle_t event_loop, esp_event_base_t
     post.base = event_base;
     post.id = event_id;
 
-    BaseType_t result = pdFALSE;
+    esp_err_t err = post_instance_send(loop, loop_queue(loop, event_base, event_id), &post, ticks_to_wait, 1);
+    if (err != ESP_OK) {
+        post_instance_delete(loop, &post);
+    }
 
-    // Find the task that currently executes the loop. It is safe to query loop->task since it is
-    // not mutated since loop creation. ENSURE THIS REMAINS TRUE.
-    if (loop->task == NULL) {
-        // The loop has no dedicated task. Find out what task is currently running it.
-        result = xSemaphoreTakeRecursive(loop->mutex, ticks_to_wait);
+    return err;
+}
 
-        if (result == pdTRUE) {
-            if (loop->running_task != xTaskGetCurrentTaskHandle()) {
-                xSemaphoreGiveRecursive(loop->mutex);
-                result = xQueueSendToBack(loop->queue, &post, ticks_to_wait);
-            } else {
-                xSemaphoreGiveRecursive(loop->mutex);
-                result = xQueueSendToBack(loop->queue, &post, 0);
-            }
+esp_err_t esp_event_buffer_get(esp_event_loop_handle_t event_loop, size_t size, void** buffer)
+{
+    assert(event_loop);
+
+    esp_event_loop_instance_t* loop = (esp_event_loop_instance_t*) event_loop;
+
+    if (buffer == NULL || loop->pool == NULL || size > loop->pool_block_size) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    *buffer = event_pool_get(loop);
+
+    return (*buffer != NULL) ? ESP_OK : ESP_ERR_NO_MEM;
+}
+
+esp_err_t esp_event_buffer_post_to(esp_event_loop_handle_t event_loop, esp_event_base_t event_base, int32_t event_id,
+                                   void* buffer, TickType_t ticks_to_wait)
+{
+    assert(event_loop);
+
+    if (event_base == ESP_EVENT_ANY_BASE || event_id == ESP_EVENT_ANY_ID) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    esp_event_loop_instance_t* loop = (esp_event_loop_instance_t*) event_loop;
+
+    if (!event_pool_owns(loop, buffer)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (!event_pool_is_taken(loop, buffer)) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    esp_event_post_instance_t post;
+    memset((void*)(&post), 0, sizeof(post));
+
+    post.data.ptr = buffer;
+#if CONFIG_ESP_EVENT_POST_FROM_ISR
+    post.data_allocated = true;
+    post.data_set = true;
+#endif
+    post.base = event_base;
+    post.id = event_id;
+
+    // on failure, the caller keeps the buffer
+    return post_instance_send(loop, loop_queue(loop, event_base, event_id), &post, ticks_to_wait, 1);
+}
+
+esp_err_t esp_event_buffer_release(esp_event_loop_handle_t event_loop, void* buffer)
+{
+    assert(event_loop);
+
+    esp_event_loop_instance_t* loop = (esp_event_loop_instance_t*) event_loop;
+
+    if (!event_pool_owns(loop, buffer)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    return event_pool_put(loop, buffer) ? ESP_OK : ESP_ERR_INVALID_STATE;
+}
+
+esp_err_t esp_event_post_batch_to(esp_event_loop_handle_t event_loop, const esp_event_post_item_t* events, size_t count,
+                                  TickType_t ticks_to_wait)
+{
+    assert(event_loop);
+
+    if (events == NULL || count == 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    esp_event_loop_instance_t* loop = (esp_event_loop_instance_t*) event_loop;
+
+    // the items are followed by the data of all events
+    size_t size = sizeof(esp_event_batch_t) + count * sizeof(esp_event_batch_item_t);
+    for (size_t i = 0; i < count; i++) {
+        if (events[i].event_base == ESP_EVENT_ANY_BASE || events[i].event_id == ESP_EVENT_ANY_ID) {
+            return ESP_ERR_INVALID_ARG;
         }
-    } else {
-        // The loop has a dedicated task.
-        if (loop->task != xTaskGetCurrentTaskHandle()) {
-            result = xQueueSendToBack(loop->queue, &post, ticks_to_wait);
-        } else {
-            result = xQueueSendToBack(loop->queue, &post, 0);
+        if (events[i].event_data != NULL && events[i].event_data_size != 0) {
+            size = EVENT_DATA_ALIGN(size) + events[i].event_data_size;
         }
     }
 
-    if (result != pdTRUE) {
-        post_instance_delete(&post);
+    esp_event_batch_t* batch = event_data_alloc(loop, size);
+    if (batch == NULL) {
+        return ESP_ERR_NO_MEM;
+    }
 
-#ifdef CONFIG_ESP_EVENT_LOOP_PROFILING
-        atomic_fetch_add(&loop->events_dropped, 1);
-#endif
-        return ESP_ERR_TIMEOUT;
+    batch->count = count;
+    size_t offset = sizeof(esp_event_batch_t) + count * sizeof(esp_event_batch_item_t);
+    for (size_t i = 0; i < count; i++) {
+        batch->items[i].base = events[i].event_base;
+        batch->items[i].id = events[i].event_id;
+        batch->items[i].data = NULL;
+        if (events[i].event_data != NULL && events[i].event_data_size != 0) {
+            offset = EVENT_DATA_ALIGN(offset);
+            batch->items[i].data = (uint8_t*) batch + offset;
+            memcpy(batch->items[i].data, events[i].event_data, events[i].event_data_size);
+            offset += events[i].event_data_size;
+        }
     }
 
-#ifdef CONFIG_ESP_EVENT_LOOP_PROFILING
-    atomic_fetch_add(&loop->events_received, 1);
+    esp_event_post_instance_t post;
+    memset((void*)(&post), 0, sizeof(post));
+
+    post.data.ptr = batch;
+#if CONFIG_ESP_EVENT_POST_FROM_ISR
+    post.data_allocated = true;
+    post.data_set = true;
 #endif
+    post.base = esp_event_batch;
+    post.id = 0;
+
+    if (loop->worker_count <= 1) {
+        atomic_init(&batch->refs, 1);
+        esp_err_t err = post_instance_send(loop, loop->queue, &post, ticks_to_wait, count);
+        if (err != ESP_OK) {
+            post_instance_delete(loop, &post);
+        }
+        return err;
+    }
+
+    // the batch is posted to each worker with events routed to it, every worker holds a reference
+    uint32_t refs = 0;
+    for (uint32_t w = 0; w < loop->worker_count; w++) {
+        for (size_t i = 0; i < count; i++) {
+            if (loop_worker_index(loop, events[i].event_base, events[i].event_id) == w) {
+                refs++;
+                break;
+            }
+        }
+    }
+    atomic_init(&batch->refs, refs);
+
+    esp_err_t err = ESP_OK;
+    for (uint32_t w = 0; w < loop->worker_count; w++) {
+        uint32_t routed = 0;
+        for (size_t i = 0; i < count; i++) {
+            if (loop_worker_index(loop, events[i].event_base, events[i].event_id) == w) {
+                routed++;
+            }
+        }
+        if (routed == 0) {
+            continue;
+        }
+
+        esp_event_post_instance_t worker_post = post;
+        if (err == ESP_OK) {
+            err = post_instance_send(loop, loop->workers[w].queue, &worker_post, ticks_to_wait, routed);
+        }
+        if (err != ESP_OK) {
+            // drop the references of the workers the batch is not posted to
+            post_instance_delete(loop, &worker_post);
+        }
+    }
+
+    return err;
+}
+
+esp_err_t esp_event_loop_get_alloc_stats(esp_event_loop_handle_t event_loop, esp_event_alloc_stats_t* stats)
+{
+    assert(event_loop);
+
+    if (stats == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    esp_event_loop_instance_t* loop = (esp_event_loop_instance_t*) event_loop;
+
+    stats->heap_allocs = atomic_load(&loop->heap_allocs);
+    stats->pool_allocs = atomic_load(&loop->pool_allocs);
+    stats->pool_exhausted = atomic_load(&loop->pool_exhausted);
+    stats->pool_free = atomic_load(&loop->pool_free);
 
     return ESP_OK;
 }
@@ -1068,10 +1998,10 @@ esp_err_t esp_event_isr_post_to(esp_event_loop_handle_t event_loop, esp_event_ba
     BaseType_t result = pdFALSE;
 
     // Post the event from an ISR,
-    result = xQueueSendToBackFromISR(loop->queue, &post, task_unblocked);
+    result = xQueueSendToBackFromISR(loop_queue(loop, event_base, event_id), &post, task_unblocked);
 
     if (result != pdTRUE) {
-        post_instance_delete(&post);
+        post_instance_delete(loop, &post);
 
 #ifdef CONFIG_ESP_EVENT_LOOP_PROFILING
         atomic_fetch_add(&loop->events_dropped, 1);
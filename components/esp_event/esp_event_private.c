@@ -1,5 +1,5 @@
 /*
- * SPDX-FileCopyrightText: 2018-2024 Espressif Systems (Shanghai) CO LTD
+ * SPDX-FileCopyrightText: 2018-2026 Espressif Systems (Shanghai) CO LTD
  *
  * SPDX-License-Identifier: Apache-2.0
  */
@@ -55,3 +55,17 @@ out:
     xSemaphoreGive(loop->mutex);
     return result;
 }
+
+bool esp_event_loop_has_deferred_cleanup(esp_event_loop_handle_t event_loop)
+{
+    esp_event_loop_instance_t* loop = (esp_event_loop_instance_t*) event_loop;
+
+    xSemaphoreTakeRecursive(loop->mutex, portMAX_DELAY);
+    bool result = !SLIST_EMPTY(&(loop->deferred_removals));
+#if CONFIG_ESP_EVENT_DISPATCH_TABLE
+    result |= (loop->retired_tables != NULL);
+#endif
+    xSemaphoreGiveRecursive(loop->mutex);
+
+    return result;
+}
@@ -8,6 +8,11 @@
 */
 
 #include <stdio.h>
+#include <inttypes.h>
+#include <chrono>
+#include <cstring>
+#include <deque>
+#include <vector>
 #include "esp_event.h"
 
 #include <catch2/catch_test_macros.hpp>
@@ -40,6 +45,107 @@ static esp_event_loop_args_t test_event_get_default_loop_args(void)
 
 void dummy_handler(void* event_handler_arg, esp_event_base_t event_base, int32_t event_id, void* event_data) { }
 
+/*
+ * Event queue emulated with CMock callbacks, so that events can be posted to and dispatched from a loop without task.
+ */
+const QueueHandle_t s_event_queue = reinterpret_cast<QueueHandle_t>(0xdeadbeef);
+const QueueHandle_t s_loop_mutex = reinterpret_cast<QueueHandle_t>(0xcafe);
+UBaseType_t s_event_size;
+std::deque<std::vector<uint8_t>> s_events;
+
+QueueHandle_t emulated_queue_create(const UBaseType_t length, const UBaseType_t item_size, const uint8_t type, int cmock_num_calls)
+{
+    s_event_size = item_size;
+    s_events.clear();
+    return s_event_queue;
+}
+
+BaseType_t emulated_queue_send(QueueHandle_t queue, const void* const item, TickType_t ticks, const BaseType_t position, int cmock_num_calls)
+{
+    if (queue == s_event_queue) {
+        const uint8_t* bytes = static_cast<const uint8_t*>(item);
+        s_events.emplace_back(bytes, bytes + s_event_size);
+    }
+    return pdTRUE;
+}
+
+BaseType_t emulated_queue_receive(QueueHandle_t queue, void* const item, TickType_t ticks, int cmock_num_calls)
+{
+    if (s_events.empty()) {
+        return pdFALSE;
+    }
+    memcpy(item, s_events.front().data(), s_event_size);
+    s_events.pop_front();
+    return pdTRUE;
+}
+
+struct EmulatedLoop {
+    EmulatedLoop(uint32_t pool_size = 0, uint32_t pool_block_size = 0)
+    {
+        xQueueGenericCreate_Stub(emulated_queue_create);
+        xQueueGenericSend_Stub(emulated_queue_send);
+        xQueueReceive_Stub(emulated_queue_receive);
+        xQueueCreateMutex_IgnoreAndReturn(s_loop_mutex);
+        xQueueTakeMutexRecursive_IgnoreAndReturn(pdTRUE);
+        xQueueGiveMutexRecursive_IgnoreAndReturn(pdTRUE);
+        xTaskGetCurrentTaskHandle_IgnoreAndReturn(reinterpret_cast<TaskHandle_t>(1));
+        vQueueDelete_Ignore();
+
+        esp_event_loop_args_t loop_args = test_event_get_default_loop_args();
+        loop_args.task_name = nullptr;
+        loop_args.event_pool_size = pool_size;
+        loop_args.event_pool_block_size = pool_block_size;
+        REQUIRE(esp_event_loop_create(&loop_args, &loop) == ESP_OK);
+    }
+
+    ~EmulatedLoop()
+    {
+        esp_event_loop_delete(loop);
+
+        xQueueGenericCreate_Stub(nullptr);
+        xQueueGenericSend_Stub(nullptr);
+        xQueueReceive_Stub(nullptr);
+        xQueueCreateMutex_StopIgnore();
+        xQueueTakeMutexRecursive_StopIgnore();
+        xQueueGiveMutexRecursive_StopIgnore();
+        xTaskGetCurrentTaskHandle_StopIgnore();
+        vQueueDelete_StopIgnore();
+    }
+
+    esp_event_loop_handle_t loop;
+};
+
+ESP_EVENT_DEFINE_BASE(s_bench_base1);
+ESP_EVENT_DEFINE_BASE(s_bench_base2);
+ESP_EVENT_DEFINE_BASE(s_bench_base3);
+ESP_EVENT_DEFINE_BASE(s_bench_base4);
+
+struct SensorSample {
+    uint32_t seq;
+    int32_t values[3];
+};
+
+void sample_handler(void* event_handler_arg, esp_event_base_t event_base, int32_t event_id, void* event_data)
+{
+    uint32_t* next_seq = static_cast<uint32_t*>(event_handler_arg);
+    const SensorSample* sample = static_cast<const SensorSample*>(event_data);
+    CHECK(sample->seq == *next_seq);
+    CHECK(sample->values[2] == static_cast<int32_t>(sample->seq * 3));
+    (*next_seq)++;
+}
+
+esp_event_alloc_stats_t get_alloc_stats(esp_event_loop_handle_t loop)
+{
+    esp_event_alloc_stats_t stats;
+    REQUIRE(esp_event_loop_get_alloc_stats(loop, &stats) == ESP_OK);
+    return stats;
+}
+
+void counting_handler(void* event_handler_arg, esp_event_base_t event_base, int32_t event_id, void* event_data)
+{
+    (*static_cast<size_t*>(event_handler_arg))++;
+}
+
 }
 
 // TODO: IDF-2693, function definition just to satisfy linker, implement esp_common instead
@@ -149,3 +255,145 @@ TEST_CASE("registering with ANY_BASE but specific ID fails")
                                           dummy_handler,
                                           nullptr) == ESP_ERR_INVALID_ARG);
 }
+
+TEST_CASE("benchmark dispatch time against the number of registered event ids")
+{
+    CMockFix fix;
+    const esp_event_base_t bases[] = {s_bench_base1, s_bench_base2, s_bench_base3, s_bench_base4};
+    const size_t base_count = sizeof(bases) / sizeof(bases[0]);
+    const size_t EVENTS = 20000;
+
+    for (size_t ids = 4; ids <= 1024; ids *= 4) {
+        EmulatedLoop emulated;
+        size_t id_calls = 0;
+        size_t base_calls = 0;
+
+        for (size_t i = 0; i < base_count; i++) {
+            REQUIRE(esp_event_handler_register_with(emulated.loop, bases[i], ESP_EVENT_ANY_ID, counting_handler, &base_calls) == ESP_OK);
+        }
+        for (size_t i = 0; i < ids; i++) {
+            REQUIRE(esp_event_handler_register_with(emulated.loop, bases[i % base_count], i, counting_handler, &id_calls) == ESP_OK);
+        }
+
+        for (size_t i = 0; i < EVENTS; i++) {
+            REQUIRE(esp_event_post_to(emulated.loop, bases[i % base_count], i % ids, nullptr, 0, 0) == ESP_OK);
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        REQUIRE(esp_event_loop_run(emulated.loop, portMAX_DELAY) == ESP_OK);
+        auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+
+        CHECK(base_calls == EVENTS);
+        CHECK(id_calls == EVENTS);
+        printf("%4zu event ids: %lld ns per event\n", ids, static_cast<long long>(elapsed.count() / EVENTS));
+    }
+}
+
+TEST_CASE("event data pool, zero-copy and batch posting save heap allocations")
+{
+    CMockFix fix;
+    const uint32_t EVENTS = 256;
+    const size_t BATCH = 8;
+    uint32_t next_seq = 0;
+
+    SECTION("copy to heap") {
+        EmulatedLoop emulated;
+        REQUIRE(esp_event_handler_register_with(emulated.loop, s_bench_base1, 1, sample_handler, &next_seq) == ESP_OK);
+
+        for (uint32_t i = 0; i < EVENTS; i++) {
+            SensorSample sample = {i, {0, 0, static_cast<int32_t>(i * 3)}};
+            REQUIRE(esp_event_post_to(emulated.loop, s_bench_base1, 1, &sample, sizeof(sample), 0) == ESP_OK);
+        }
+        REQUIRE(esp_event_loop_run(emulated.loop, portMAX_DELAY) == ESP_OK);
+
+        esp_event_alloc_stats_t stats = get_alloc_stats(emulated.loop);
+        CHECK(next_seq == EVENTS);
+        CHECK(stats.heap_allocs == EVENTS);
+        CHECK(stats.pool_allocs == 0);
+        printf("copy to heap: %" PRIu32 " heap allocations, %" PRIu32 " pool blocks for %" PRIu32 " events\n",
+               stats.heap_allocs, stats.pool_allocs, EVENTS);
+    }
+
+    SECTION("copy to pool") {
+        EmulatedLoop emulated(QUEUE_SIZE, sizeof(SensorSample));
+        REQUIRE(esp_event_handler_register_with(emulated.loop, s_bench_base1, 1, sample_handler, &next_seq) == ESP_OK);
+
+        // more events than blocks are posted before the loop runs, those are copied to the heap
+        for (uint32_t i = 0; i < EVENTS; i++) {
+            SensorSample sample = {i, {0, 0, static_cast<int32_t>(i * 3)}};
+            REQUIRE(esp_event_post_to(emulated.loop, s_bench_base1, 1, &sample, sizeof(sample), 0) == ESP_OK);
+        }
+        REQUIRE(esp_event_loop_run(emulated.loop, portMAX_DELAY) == ESP_OK);
+
+        esp_event_alloc_stats_t stats = get_alloc_stats(emulated.loop);
+        CHECK(next_seq == EVENTS);
+        CHECK(stats.pool_allocs == QUEUE_SIZE);
+        CHECK(stats.heap_allocs == EVENTS - QUEUE_SIZE);
+        CHECK(stats.pool_exhausted == EVENTS - QUEUE_SIZE);
+        CHECK(stats.pool_free == QUEUE_SIZE);
+    }
+
+    SECTION("zero-copy") {
+        EmulatedLoop emulated(QUEUE_SIZE, sizeof(SensorSample));
+        REQUIRE(esp_event_handler_register_with(emulated.loop, s_bench_base1, 1, sample_handler, &next_seq) == ESP_OK);
+
+        for (uint32_t i = 0; i < EVENTS; i++) {
+            void* buffer;
+            REQUIRE(esp_event_buffer_get(emulated.loop, sizeof(SensorSample), &buffer) == ESP_OK);
+            SensorSample* sample = static_cast<SensorSample*>(buffer);
+            sample->seq = i;
+            sample->values[2] = i * 3;
+            REQUIRE(esp_event_buffer_post_to(emulated.loop, s_bench_base1, 1, buffer, 0) == ESP_OK);
+
+            // a producer which gets ahead of the loop runs out of blocks
+            if (i % QUEUE_SIZE == QUEUE_SIZE - 1) {
+                CHECK(esp_event_buffer_get(emulated.loop, sizeof(SensorSample), &buffer) == ESP_ERR_NO_MEM);
+                REQUIRE(esp_event_loop_run(emulated.loop, portMAX_DELAY) == ESP_OK);
+            }
+        }
+
+        esp_event_alloc_stats_t stats = get_alloc_stats(emulated.loop);
+        CHECK(next_seq == EVENTS);
+        CHECK(stats.heap_allocs == 0);
+        CHECK(stats.pool_allocs == EVENTS);
+        CHECK(stats.pool_free == QUEUE_SIZE);
+        printf("zero-copy: %" PRIu32 " heap allocations, %" PRIu32 " pool blocks for %" PRIu32 " events\n",
+               stats.heap_allocs, stats.pool_allocs, EVENTS);
+
+        void* buffer;
+        CHECK(esp_event_buffer_get(emulated.loop, sizeof(SensorSample) + 8, &buffer) == ESP_ERR_INVALID_ARG);
+        REQUIRE(esp_event_buffer_get(emulated.loop, sizeof(SensorSample), &buffer) == ESP_OK);
+        CHECK(esp_event_buffer_release(emulated.loop, &next_seq) == ESP_ERR_INVALID_ARG);
+        CHECK(esp_event_buffer_release(emulated.loop, buffer) == ESP_OK);
+        CHECK(get_alloc_stats(emulated.loop).pool_free == QUEUE_SIZE);
+    }
+
+    SECTION("batch") {
+        EmulatedLoop emulated;
+        REQUIRE(esp_event_handler_register_with(emulated.loop, s_bench_base1, 1, sample_handler, &next_seq) == ESP_OK);
+
+        size_t queue_operations = 0;
+        for (uint32_t i = 0; i < EVENTS; i += BATCH) {
+            SensorSample samples[BATCH];
+            esp_event_post_item_t items[BATCH];
+            for (size_t j = 0; j < BATCH; j++) {
+                samples[j] = {static_cast<uint32_t>(i + j), {0, 0, static_cast<int32_t>((i + j) * 3)}};
+                items[j] = {s_bench_base1, 1, &samples[j], sizeof(samples[j])};
+            }
+            REQUIRE(esp_event_post_batch_to(emulated.loop, items, BATCH, 0) == ESP_OK);
+            queue_operations++;
+        }
+        CHECK(s_events.size() == queue_operations);
+        REQUIRE(esp_event_loop_run(emulated.loop, portMAX_DELAY) == ESP_OK);
+
+        esp_event_alloc_stats_t stats = get_alloc_stats(emulated.loop);
+        CHECK(next_seq == EVENTS);
+        CHECK(stats.heap_allocs == EVENTS / BATCH);
+        printf("batch of %zu: %" PRIu32 " heap allocations, %zu queue items for %" PRIu32 " events\n",
+               BATCH, stats.heap_allocs, queue_operations, EVENTS);
+
+        esp_event_post_item_t invalid = {s_bench_base1, ESP_EVENT_ANY_ID, nullptr, 0};
+        CHECK(esp_event_post_batch_to(emulated.loop, &invalid, 1, 0) == ESP_ERR_INVALID_ARG);
+        CHECK(esp_event_post_batch_to(emulated.loop, nullptr, 1, 0) == ESP_ERR_INVALID_ARG);
+    }
+}
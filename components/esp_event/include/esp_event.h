@@ -1,5 +1,5 @@
 /*
- * SPDX-FileCopyrightText: 2018-2024 Espressif Systems (Shanghai) CO LTD
+ * SPDX-FileCopyrightText: 2018-2026 Espressif Systems (Shanghai) CO LTD
  *
  * SPDX-License-Identifier: Apache-2.0
  */
@@ -27,8 +27,32 @@ typedef struct {
     uint32_t task_stack_size;                   /**< stack size of the event loop task, ignored if task name is NULL */
     BaseType_t task_core_id;                    /**< core to which the event loop task is pinned to,
                                                         ignored if task name is NULL */
+    uint32_t task_count;                        /**< number of tasks dispatching the events of the loop; if 0 or 1,
+                                                        a single task is created. Events with the same base and ID
+                                                        are always dispatched by the same task, in the order they
+                                                        were posted. Ignored if task name is NULL */
+    uint32_t event_pool_size;                   /**< number of blocks in the event data pool of the loop; if 0,
+                                                        event data is always copied to the heap */
+    uint32_t event_pool_block_size;             /**< size of each block of the event data pool, in bytes */
 } esp_event_loop_args_t;
 
+/// Event posted as part of a batch, see esp_event_post_batch_to
+typedef struct {
+    esp_event_base_t event_base;                /**< the event base that identifies the event */
+    int32_t event_id;                           /**< the event ID that identifies the event */
+    const void *event_data;                     /**< the data, specific to the event occurrence, that gets passed
+                                                        to the handler */
+    size_t event_data_size;                     /**< the size of the event data */
+} esp_event_post_item_t;
+
+/// Counters of the memory used for event data by an event loop
+typedef struct {
+    uint32_t heap_allocs;                       /**< number of event data copies allocated from the heap */
+    uint32_t pool_allocs;                       /**< number of blocks taken from the event data pool */
+    uint32_t pool_exhausted;                    /**< number of times no block of the pool was free */
+    uint32_t pool_free;                         /**< number of blocks of the pool currently free */
+} esp_event_alloc_stats_t;
+
 /**
  * @brief Create a new event loop.
  *
@@ -279,6 +303,10 @@ esp_err_t esp_event_handler_unregister(esp_event_base_t event_base,
  * This function behaves in the same manner as esp_event_handler_unregister, except the additional specification of
  * the event loop to unregister the handler with.
  *
+ * @note For a loop with several tasks (see task_count in esp_event_loop_args_t), waits until no task executes the
+ *       handler anymore. Called from a handler of the same loop, it doesn't wait and the handler may still be
+ *       running on another task when it returns.
+ *
  * @param[in] event_loop the event loop with which to unregister this handler function, must not be NULL
  * @param[in] event_base the base of the event with which to unregister the handler
  * @param[in] event_id the ID of the event with which to unregister the handler
@@ -308,6 +336,10 @@ esp_err_t esp_event_handler_unregister_with(esp_event_loop_handle_t event_loop,
  *       unregistered. When using ESP_EVENT_ANY_BASE, events registered to specific bases will also not be
  *       unregistered. This avoids accidental unregistration of handlers registered by other users or components.
  *
+ * @note For a loop with several tasks (see task_count in esp_event_loop_args_t), waits until no task executes the
+ *       handler anymore. Called from a handler of the same loop, it doesn't wait and the handler may still be
+ *       running on another task when it returns.
+ *
  * @param[in] event_loop the event loop with which to unregister this handler function, must not be NULL
  * @param[in] event_base the base of the event with which to unregister the handler
  * @param[in] event_id the ID of the event with which to unregister the handler
@@ -372,7 +404,8 @@ esp_err_t esp_event_post(esp_event_base_t event_base,
  * handler receives is always valid.
  *
  * This function behaves in the same manner as esp_event_post, except the additional specification of the event loop
- * to post the event to.
+ * to post the event to. If the loop has an event data pool and the data fits into a block, the copy is stored in
+ * a block of the pool instead of the heap.
  *
  * @param[in] event_loop the event loop to post to, must not be NULL
  * @param[in] event_base the event base that identifies the event
@@ -395,6 +428,108 @@ esp_err_t esp_event_post_to(esp_event_loop_handle_t event_loop,
                             size_t event_data_size,
                             TickType_t ticks_to_wait);
 
+/**
+ * @brief Gets a block of the event data pool of an event loop, to be filled with event data and posted with
+ * esp_event_buffer_post_to without copying it.
+ *
+ * The event loop must have been created with a non-zero event_pool_size. This function does not block and
+ * may be called from any task.
+ *
+ * @param[in] event_loop the event loop whose pool to take the block from, must not be NULL
+ * @param[in] size the size of the event data, at most event_pool_block_size
+ * @param[out] buffer the block
+ *
+ * @return
+ *  - ESP_OK: Success
+ *  - ESP_ERR_INVALID_ARG: The loop has no pool, size is larger than a block or buffer is NULL
+ *  - ESP_ERR_NO_MEM: No block of the pool is free
+ */
+esp_err_t esp_event_buffer_get(esp_event_loop_handle_t event_loop, size_t size, void **buffer);
+
+/**
+ * @brief Posts an event whose data is a block of the event data pool of the loop, without copying the data.
+ *
+ * On success, the block is owned by the event loop and returned to the pool once the event has been dispatched.
+ * Otherwise, the caller keeps the block and may post it again or give it back with esp_event_buffer_release.
+ *
+ * @param[in] event_loop the event loop to post to, must not be NULL
+ * @param[in] event_base the event base that identifies the event
+ * @param[in] event_id the event ID that identifies the event
+ * @param[in] buffer the event data, a block obtained from esp_event_buffer_get for the same loop
+ * @param[in] ticks_to_wait number of ticks to block on a full event queue
+ *
+ * @return
+ *  - ESP_OK: Success
+ *  - ESP_ERR_TIMEOUT: Time to wait for event queue to unblock expired
+ *  - ESP_ERR_INVALID_ARG: Invalid combination of event base and event ID, buffer is not the start of a block of the pool
+ *  - ESP_ERR_INVALID_STATE: The block is free, it was already released
+ *  - Others: Fail
+ */
+esp_err_t esp_event_buffer_post_to(esp_event_loop_handle_t event_loop,
+                                   esp_event_base_t event_base,
+                                   int32_t event_id,
+                                   void *buffer,
+                                   TickType_t ticks_to_wait);
+
+/**
+ * @brief Gives a block obtained from esp_event_buffer_get back to the event data pool without posting it.
+ *
+ * @param[in] event_loop the event loop the block was obtained from, must not be NULL
+ * @param[in] buffer the block
+ *
+ * @return
+ *  - ESP_OK: Success
+ *  - ESP_ERR_INVALID_ARG: buffer is not the start of a block of the pool
+ *  - ESP_ERR_INVALID_STATE: The block is already free
+ */
+esp_err_t esp_event_buffer_release(esp_event_loop_handle_t event_loop, void *buffer);
+
+/**
+ * @brief Posts several events to the specified event loop with a single queue operation.
+ *
+ * The data of all events is copied to one buffer, taken from the event data pool of the loop if it fits into
+ * a block and from the heap otherwise. The events occupy one slot of the event queue and are dispatched one after
+ * another, in the order of the array, without events posted by other tasks in between.
+ *
+ * @note For a loop with several tasks, each task dispatches the events of the batch routed to it, so only events
+ *       dispatched by the same task keep their relative order. The batch occupies one slot of the queue of each
+ *       of these tasks, and if ESP_ERR_TIMEOUT is returned, the events routed to some of them may have been posted.
+ *
+ * @param[in] event_loop the event loop to post to, must not be NULL
+ * @param[in] events the events to post
+ * @param[in] count the number of events, at least 1
+ * @param[in] ticks_to_wait number of ticks to block on a full event queue
+ *
+ * @return
+ *  - ESP_OK: Success
+ *  - ESP_ERR_TIMEOUT: Time to wait for event queue to unblock expired, none of the events has been posted
+ *                     (see the note on loops with several tasks)
+ *  - ESP_ERR_INVALID_ARG: events is NULL, count is 0 or an event has an invalid combination of event base
+ *                         and event ID
+ *  - ESP_ERR_NO_MEM: Cannot allocate memory for the event data
+ *  - Others: Fail
+ */
+esp_err_t esp_event_post_batch_to(esp_event_loop_handle_t event_loop,
+                                  const esp_event_post_item_t *events,
+                                  size_t count,
+                                  TickType_t ticks_to_wait);
+
+/**
+ * @brief Gets the counters of the memory used for event data by an event loop.
+ *
+ * Events posted with esp_event_post_to, esp_event_post_batch_to and esp_event_buffer_get count as pool
+ * allocations if a block of the pool was used, and as heap allocations otherwise. Events without data and data
+ * stored inline in the event when CONFIG_ESP_EVENT_POST_FROM_ISR is enabled are not counted.
+ *
+ * @param[in] event_loop the event loop, must not be NULL
+ * @param[out] stats the counters
+ *
+ * @return
+ *  - ESP_OK: Success
+ *  - ESP_ERR_INVALID_ARG: stats is NULL
+ */
+esp_err_t esp_event_loop_get_alloc_stats(esp_event_loop_handle_t event_loop, esp_event_alloc_stats_t *stats);
+
 #if CONFIG_ESP_EVENT_POST_FROM_ISR
 /**
  * @brief Special variant of esp_event_post for posting events from interrupt handlers.
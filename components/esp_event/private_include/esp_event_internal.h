@@ -1,5 +1,5 @@
 /*
- * SPDX-FileCopyrightText: 2018-2025 Espressif Systems (Shanghai) CO LTD
+ * SPDX-FileCopyrightText: 2018-2026 Espressif Systems (Shanghai) CO LTD
  *
  * SPDX-License-Identifier: Apache-2.0
  */
@@ -31,7 +31,8 @@ typedef struct esp_event_handler_node {
     int64_t time;                                                   /**< total runtime of this handler across all calls */
 #endif
     SLIST_ENTRY(esp_event_handler_node) next;                   /**< next event handler in the list */
-    bool unregistered;
+    atomic_bool unregistered;                                       /**< set when the handler is unregistered, read
+                                                                            without the mutex by the tasks of a loop */
 } esp_event_handler_node_t;
 
 typedef SLIST_HEAD(esp_event_handler_instances, esp_event_handler_node) esp_event_handler_nodes_t;
@@ -66,6 +67,39 @@ typedef struct esp_event_loop_node {
 
 typedef SLIST_HEAD(esp_event_loop_nodes, esp_event_loop_node) esp_event_loop_nodes_t;
 
+/// Handlers executed for one (base, id) pair
+typedef struct esp_event_dispatch_entry {
+    esp_event_base_t base;                                          /**< event base, NULL for an unused slot */
+    int32_t id;                                                     /**< event id, ESP_EVENT_ANY_ID for the events of the base
+                                                                            which have no id level handlers */
+    uint32_t first;                                                 /**< index of the first handler in the handler array */
+    uint32_t count;                                                 /**< number of handlers */
+    uint32_t next_of_base;                                          /**< slot of the next entry with the same base,
+                                                                            chained to the ESP_EVENT_ANY_ID entry */
+} esp_event_dispatch_entry_t;
+
+/// Hash table of the handlers to execute for each (base, id) pair registered to a loop, in execution order.
+/// Rebuilt from the loop nodes whenever handlers are registered or removed.
+typedef struct esp_event_dispatch_table {
+    struct esp_event_dispatch_table* next_retired;                  /**< next table replaced while events were dispatched */
+    uint32_t refs;                                                  /**< number of tasks dispatching an event with the
+                                                                            table without holding the mutex */
+    uint32_t seq;                                                   /**< number of the rebuild which created the table */
+    esp_event_handler_node_t** handlers;                            /**< handlers of all entries, the loop level handlers first */
+    uint32_t loop_level_count;                                      /**< number of handlers executed for events of bases
+                                                                            without handlers */
+    uint32_t mask;                                                  /**< number of slots minus one */
+    esp_event_dispatch_entry_t slots[];                             /**< open addressing table with linear probing */
+} esp_event_dispatch_table_t;
+
+/// Task of a loop created with several tasks, dispatching the events routed to its queue
+typedef struct esp_event_loop_worker {
+    struct esp_event_loop_instance* loop;                           /**< the loop of the task */
+    QueueHandle_t queue;                                            /**< events routed to the task */
+    TaskHandle_t task;                                              /**< the task */
+    uint32_t index;                                                 /**< index of the task in the workers of the loop */
+} esp_event_loop_worker_t;
+
 /// Event loop
 typedef struct esp_event_loop_instance {
     const char* name;                                               /**< name of this event loop */
@@ -76,6 +110,32 @@ typedef struct esp_event_loop_instance {
     SemaphoreHandle_t mutex;                                        /**< mutex for updating the events linked list */
     esp_event_loop_nodes_t loop_nodes;                              /**< set of linked lists containing the
                                                                             registered handlers for the loop */
+#if CONFIG_ESP_EVENT_DISPATCH_TABLE
+    esp_event_dispatch_table_t* dispatch_table;                     /**< handlers by (base, id), NULL before the first
+                                                                            registration or if it couldn't be allocated,
+                                                                            the lists are walked then */
+    esp_event_dispatch_table_t* retired_tables;                     /**< replaced tables, each freed once no event is
+                                                                            dispatched with it */
+    uint32_t dispatch_seq;                                          /**< number of dispatch table rebuilds */
+#endif
+    uint32_t dispatch_depth;                                        /**< number of events being dispatched with the
+                                                                            mutex taken */
+    esp_event_loop_worker_t* workers;                               /**< tasks of a loop with several tasks, NULL otherwise */
+    uint32_t worker_count;                                          /**< number of tasks of a loop with several tasks */
+    SLIST_HEAD(esp_event_deferred_removals, esp_event_deferred_removal) deferred_removals; /**< handlers to remove
+                                                                            once no worker can execute them */
+    uint8_t* pool;                                                  /**< blocks of the event data pool, NULL if the
+                                                                            loop has no pool */
+    atomic_uint_least16_t* pool_next;                               /**< index of the next free block of each free block */
+    uint32_t pool_size;                                             /**< number of blocks in the pool */
+    uint32_t pool_block_size;                                       /**< size of a block */
+    atomic_uint_least32_t pool_head;                                /**< index of the first free block in the lower
+                                                                            16 bits, a modification count in the upper
+                                                                            16 bits to detect concurrent changes */
+    atomic_uint_least32_t pool_free;                                /**< number of free blocks */
+    atomic_uint_least32_t heap_allocs;                              /**< number of event data copies allocated from the heap */
+    atomic_uint_least32_t pool_allocs;                              /**< number of blocks taken from the pool */
+    atomic_uint_least32_t pool_exhausted;                           /**< number of times no block was free */
 #ifdef CONFIG_ESP_EVENT_LOOP_PROFILING
     atomic_uint_least32_t events_received;                          /**< number of events successfully posted to the loop */
     atomic_uint_least32_t events_dropped;                           /**< number of events dropped due to queue being full */
@@ -91,6 +151,16 @@ typedef struct esp_event_remove_handler_context_t {
     bool legacy;                                                    /**< Set to true when the handler unregistration request was made from legacy code */
 } esp_event_remove_handler_context_t;
 
+/// Handler unregistered by a handler of a loop with several tasks, while it may still be executed
+typedef struct esp_event_deferred_removal {
+    esp_event_remove_handler_context_t ctx;                         /**< the handler to remove */
+#if CONFIG_ESP_EVENT_DISPATCH_TABLE
+    uint32_t seq;                                                   /**< first dispatch table rebuild without the handler,
+                                                                            older tables may still execute it */
+#endif
+    SLIST_ENTRY(esp_event_deferred_removal) next;                   /**< next handler to remove */
+} esp_event_deferred_removal_t;
+
 typedef union esp_event_post_data {
 #if CONFIG_ESP_EVENT_POST_FROM_ISR_SIZE
     uint8_t val[CONFIG_ESP_EVENT_POST_FROM_ISR_SIZE];
@@ -100,6 +170,21 @@ typedef union esp_event_post_data {
     void *ptr;
 } esp_event_post_data_t;
 
+/// Event of a batch posted with esp_event_post_batch_to
+typedef struct esp_event_batch_item {
+    esp_event_base_t base;                                           /**< the event base */
+    int32_t id;                                                      /**< the event id */
+    void* data;                                                      /**< data associated with the event, stored after
+                                                                            the items of the batch */
+} esp_event_batch_item_t;
+
+/// Events posted with esp_event_post_batch_to, queued as a single event of the internal batch base
+typedef struct esp_event_batch {
+    atomic_uint_least32_t refs;                                      /**< number of queues the batch is posted to */
+    size_t count;                                                    /**< number of events */
+    esp_event_batch_item_t items[];                                  /**< the events, in the order they were posted */
+} esp_event_batch_t;
+
 /// Event posted to the event queue
 typedef struct esp_event_post_instance {
 #if CONFIG_ESP_EVENT_POST_FROM_ISR
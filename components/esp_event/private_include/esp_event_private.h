@@ -1,5 +1,5 @@
 /*
- * SPDX-FileCopyrightText: 2018-2024 Espressif Systems (Shanghai) CO LTD
+ * SPDX-FileCopyrightText: 2018-2026 Espressif Systems (Shanghai) CO LTD
  *
  * SPDX-License-Identifier: Apache-2.0
  */
@@ -31,6 +31,17 @@ extern "C" {
  */
 bool esp_event_is_handler_registered(esp_event_loop_handle_t event_loop, esp_event_base_t event_base, int32_t event_id, esp_event_handler_t event_handler);
 
+/**
+ * @brief Checks whether handlers removed or dispatch tables replaced while events were dispatched are still to be freed
+ *
+ * @param[in] event_loop the loop to check
+ *
+ * @return
+ *  - true: Handlers or dispatch tables are still to be freed
+ *  - false: Nothing is left to free
+ */
+bool esp_event_loop_has_deferred_cleanup(esp_event_loop_handle_t event_loop);
+
 /**
  * @brief Deinitializes the event loop library
  *
@@ -8,10 +8,13 @@
 
 #include <stdio.h>
 #include <string.h>
+#include <inttypes.h>
+#include <atomic>
 #include "sdkconfig.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include "esp_event.h"
+#include "esp_event_private.h"
 #include "unity.h"
 
 ESP_EVENT_DECLARE_BASE(s_test_base1);
@@ -1077,6 +1080,67 @@ TEST_CASE("events handlers for any base are dispatched in the order they are reg
     TEST_ASSERT_EQUAL_INT_ARRAY(ref_arr, test_data.test_data, 4);
 }
 
+TEST_CASE("events handlers for all levels are dispatched in the order they are registered", "[event][linux]")
+{
+    EV_LoopFix loop_fix;
+
+    ordered_dispatch_test_data_t test_data = {
+        .counter = 0,
+        .test_data = {},
+    };
+
+    TEST_ESP_OK(esp_event_handler_register_with(loop_fix.loop,
+                                                s_test_base1,
+                                                TEST_EVENT_BASE1_EV1,
+                                                test_event_ordered_dispatch_0,
+                                                &test_data));
+    TEST_ESP_OK(esp_event_handler_register_with(loop_fix.loop,
+                                                ESP_EVENT_ANY_BASE,
+                                                ESP_EVENT_ANY_ID,
+                                                test_event_ordered_dispatch_1,
+                                                &test_data));
+    TEST_ESP_OK(esp_event_handler_register_with(loop_fix.loop,
+                                                s_test_base1,
+                                                ESP_EVENT_ANY_ID,
+                                                test_event_ordered_dispatch_2,
+                                                &test_data));
+    TEST_ESP_OK(esp_event_handler_register_with(loop_fix.loop,
+                                                s_test_base1,
+                                                TEST_EVENT_BASE1_EV1,
+                                                test_event_ordered_dispatch_3,
+                                                &test_data));
+
+    TEST_ESP_OK(esp_event_post_to(loop_fix.loop, s_test_base1, TEST_EVENT_BASE1_EV1, NULL, 0, portMAX_DELAY));
+    TEST_ESP_OK(esp_event_loop_run(loop_fix.loop, ZERO_DELAY));
+
+    size_t ref_arr[4] = {0, 1, 2, 3};
+    TEST_ASSERT_EQUAL_INT_ARRAY(ref_arr, test_data.test_data, 4);
+
+    // After an unregistration, the remaining handlers keep their order
+    TEST_ESP_OK(esp_event_handler_unregister_with(loop_fix.loop,
+                                                  ESP_EVENT_ANY_BASE,
+                                                  ESP_EVENT_ANY_ID,
+                                                  test_event_ordered_dispatch_1));
+    test_data.counter = 0;
+    memset(test_data.test_data, 0xff, sizeof(test_data.test_data));
+
+    TEST_ESP_OK(esp_event_post_to(loop_fix.loop, s_test_base1, TEST_EVENT_BASE1_EV1, NULL, 0, portMAX_DELAY));
+    TEST_ESP_OK(esp_event_loop_run(loop_fix.loop, ZERO_DELAY));
+
+    TEST_ASSERT_EQUAL(0, test_data.test_data[0]);
+    TEST_ASSERT_EQUAL(1, test_data.test_data[2]);
+    TEST_ASSERT_EQUAL(2, test_data.test_data[3]);
+    TEST_ASSERT_EQUAL(3, test_data.counter);
+
+    // Events without id level handlers are dispatched to the base level handlers only
+    test_data.counter = 0;
+    TEST_ESP_OK(esp_event_post_to(loop_fix.loop, s_test_base1, TEST_EVENT_BASE1_EV2, NULL, 0, portMAX_DELAY));
+    TEST_ESP_OK(esp_event_loop_run(loop_fix.loop, ZERO_DELAY));
+
+    TEST_ASSERT_EQUAL(0, test_data.test_data[2]);
+    TEST_ASSERT_EQUAL(1, test_data.counter);
+}
+
 static void test_create_loop_handler(void* handler_args, esp_event_base_t base, int32_t id, void* event_data)
 {
     esp_event_loop_args_t loop_args = test_event_get_default_loop_args();
@@ -1532,6 +1596,320 @@ TEST_CASE("event data many bytes are copied on post", "[event][linux]")
     TEST_ASSERT_EQUAL_HEX8_ARRAY(ev_data_expected, saved_ev_data.event_data, EventData::MAX_SIZE);
 }
 
+TEST_CASE("event data from the event pool is passed without copy", "[event][linux]")
+{
+    esp_event_loop_args_t loop_args = test_event_get_default_loop_args();
+    loop_args.task_name = NULL;
+    loop_args.event_pool_size = 2;
+    loop_args.event_pool_block_size = EventData::MAX_SIZE;
+    esp_event_loop_handle_t loop;
+    TEST_ESP_OK(esp_event_loop_create(&loop_args, &loop));
+
+    EventData saved_ev_data(EventData::MAX_SIZE);
+    TEST_ESP_OK(esp_event_handler_register_with(loop, s_test_base1, TEST_EVENT_BASE1_EV1, save_ev_data, &saved_ev_data));
+
+    void *buffer;
+    void *other_buffer;
+    TEST_ESP_OK(esp_event_buffer_get(loop, EventData::MAX_SIZE, &buffer));
+    TEST_ESP_OK(esp_event_buffer_get(loop, EventData::MAX_SIZE, &other_buffer));
+    TEST_ESP_OK(esp_event_buffer_release(loop, other_buffer));
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_STATE, esp_event_buffer_release(loop, other_buffer));
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_STATE, esp_event_buffer_post_to(loop, s_test_base1, TEST_EVENT_BASE1_EV1, other_buffer, portMAX_DELAY));
+    TEST_ESP_OK(esp_event_buffer_get(loop, EventData::MAX_SIZE, &other_buffer));
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, esp_event_buffer_release(loop, (uint8_t *) other_buffer + 1));
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, esp_event_buffer_post_to(loop, s_test_base1, TEST_EVENT_BASE1_EV1, (uint8_t *) buffer + 4, portMAX_DELAY));
+    TEST_ASSERT_EQUAL(ESP_ERR_NO_MEM, esp_event_buffer_get(loop, EventData::MAX_SIZE, &other_buffer));
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, esp_event_buffer_get(loop, EventData::MAX_SIZE + 1, &other_buffer));
+
+    memset(buffer, 0x5a, EventData::MAX_SIZE);
+    TEST_ESP_OK(esp_event_buffer_post_to(loop, s_test_base1, TEST_EVENT_BASE1_EV1, buffer, portMAX_DELAY));
+    TEST_ESP_OK(esp_event_loop_run(loop, ZERO_DELAY));
+
+    uint8_t ev_data_expected[EventData::MAX_SIZE];
+    memset(ev_data_expected, 0x5a, sizeof(ev_data_expected));
+    TEST_ASSERT_EQUAL_PTR(buffer, saved_ev_data.event_arg);
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(ev_data_expected, saved_ev_data.event_data, EventData::MAX_SIZE);
+
+    esp_event_alloc_stats_t stats;
+    TEST_ESP_OK(esp_event_loop_get_alloc_stats(loop, &stats));
+    TEST_ASSERT_EQUAL(0, stats.heap_allocs);
+    TEST_ASSERT_EQUAL(3, stats.pool_allocs);
+    TEST_ASSERT_EQUAL(1, stats.pool_exhausted);
+    TEST_ASSERT_EQUAL(1, stats.pool_free);
+
+    TEST_ESP_OK(esp_event_loop_delete(loop));
+}
+
+static void save_ev_id(void* handler_arg, esp_event_base_t base, int32_t id, void* event_arg)
+{
+    ordered_dispatch_test_data_t *test_data = (ordered_dispatch_test_data_t*) handler_arg;
+    test_data->test_data[test_data->counter] = (base == s_test_base2 ? 10 : 0) + id + (event_arg ? *(uint8_t*) event_arg : 0);
+    (test_data->counter)++;
+}
+
+TEST_CASE("events posted as a batch are dispatched in order", "[event][linux]")
+{
+    EV_LoopFix loop_fix;
+    ordered_dispatch_test_data_t test_data = {
+        .counter = 0,
+        .test_data = {},
+    };
+
+    TEST_ESP_OK(esp_event_handler_register_with(loop_fix.loop, ESP_EVENT_ANY_BASE, ESP_EVENT_ANY_ID, save_ev_id, &test_data));
+
+    uint8_t data[2] = {100, 200};
+    esp_event_post_item_t events[] = {
+        {s_test_base1, TEST_EVENT_BASE1_EV2, &data[0], sizeof(data[0])},
+        {s_test_base2, TEST_EVENT_BASE2_EV1, NULL, 0},
+        {s_test_base1, TEST_EVENT_BASE1_EV1, &data[1], sizeof(data[1])},
+    };
+    TEST_ESP_OK(esp_event_post_batch_to(loop_fix.loop, events, 3, portMAX_DELAY));
+    TEST_ESP_OK(esp_event_post_to(loop_fix.loop, s_test_base1, TEST_EVENT_BASE1_EV1, NULL, 0, portMAX_DELAY));
+    memset(data, 0, sizeof(data));
+
+    // the batch takes a single item of the queue
+    TEST_ESP_OK(esp_event_loop_run(loop_fix.loop, ZERO_DELAY));
+    TEST_ASSERT_EQUAL(3, test_data.counter);
+    TEST_ESP_OK(esp_event_loop_run(loop_fix.loop, ZERO_DELAY));
+
+    size_t ref_arr[4] = {101, 10, 200, 0};
+    TEST_ASSERT_EQUAL(4, test_data.counter);
+    TEST_ASSERT_EQUAL_INT_ARRAY(ref_arr, test_data.test_data, 4);
+
+    events[1].event_id = ESP_EVENT_ANY_ID;
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, esp_event_post_batch_to(loop_fix.loop, events, 3, portMAX_DELAY));
+}
+
+#define TEST_WORKER_COUNT     4
+#define TEST_WORKER_EVENTS    64
+
+typedef struct {
+    int last_seq[2][TEST_EVENT_BASE1_MAX];
+    int order_errors[2][TEST_EVENT_BASE1_MAX];
+    SemaphoreHandle_t done;
+} worker_order_test_data_t;
+
+// each (base, id) pair is only dispatched by one of the tasks, so its entries are not accessed concurrently
+static void save_ev_seq(void* handler_arg, esp_event_base_t base, int32_t id, void* event_arg)
+{
+    worker_order_test_data_t *test_data = (worker_order_test_data_t*) handler_arg;
+    int b = (base == s_test_base2) ? 1 : 0;
+    int seq = *(int*) event_arg;
+    if (seq != test_data->last_seq[b][id] + 1) {
+        test_data->order_errors[b][id]++;
+    }
+    test_data->last_seq[b][id] = seq;
+    xSemaphoreGive(test_data->done);
+}
+
+TEST_CASE("events with the same base and id are dispatched in order by a loop with several tasks", "[event][linux]")
+{
+    esp_event_loop_args_t loop_args = test_event_get_default_loop_args();
+    loop_args.task_count = TEST_WORKER_COUNT;
+    esp_event_loop_handle_t loop;
+    TEST_ESP_OK(esp_event_loop_create(&loop_args, &loop));
+
+    worker_order_test_data_t test_data = {};
+    test_data.done = xSemaphoreCreateCounting(3 * (TEST_WORKER_EVENTS + 1), 0);
+    TEST_ASSERT(test_data.done);
+
+    TEST_ESP_OK(esp_event_handler_register_with(loop, ESP_EVENT_ANY_BASE, ESP_EVENT_ANY_ID, save_ev_seq, &test_data));
+
+    for (int seq = 1; seq <= TEST_WORKER_EVENTS; seq++) {
+        TEST_ESP_OK(esp_event_post_to(loop, s_test_base1, TEST_EVENT_BASE1_EV1, &seq, sizeof(seq), portMAX_DELAY));
+        TEST_ESP_OK(esp_event_post_to(loop, s_test_base1, TEST_EVENT_BASE1_EV2, &seq, sizeof(seq), portMAX_DELAY));
+        TEST_ESP_OK(esp_event_post_to(loop, s_test_base2, TEST_EVENT_BASE2_EV1, &seq, sizeof(seq), portMAX_DELAY));
+    }
+
+    int last = TEST_WORKER_EVENTS + 1;
+    esp_event_post_item_t events[] = {
+        {s_test_base1, TEST_EVENT_BASE1_EV1, &last, sizeof(last)},
+        {s_test_base1, TEST_EVENT_BASE1_EV2, &last, sizeof(last)},
+        {s_test_base2, TEST_EVENT_BASE2_EV1, &last, sizeof(last)},
+    };
+    TEST_ESP_OK(esp_event_post_batch_to(loop, events, 3, portMAX_DELAY));
+
+    for (int i = 0; i < 3 * (TEST_WORKER_EVENTS + 1); i++) {
+        TEST_ASSERT_EQUAL(pdTRUE, xSemaphoreTake(test_data.done, portMAX_DELAY));
+    }
+
+    TEST_ASSERT_EQUAL(last, test_data.last_seq[0][TEST_EVENT_BASE1_EV1]);
+    TEST_ASSERT_EQUAL(last, test_data.last_seq[0][TEST_EVENT_BASE1_EV2]);
+    TEST_ASSERT_EQUAL(last, test_data.last_seq[1][TEST_EVENT_BASE2_EV1]);
+    TEST_ASSERT_EQUAL(0, test_data.order_errors[0][TEST_EVENT_BASE1_EV1]);
+    TEST_ASSERT_EQUAL(0, test_data.order_errors[0][TEST_EVENT_BASE1_EV2]);
+    TEST_ASSERT_EQUAL(0, test_data.order_errors[1][TEST_EVENT_BASE2_EV1]);
+
+    TEST_ESP_OK(esp_event_loop_delete(loop));
+    vSemaphoreDelete(test_data.done);
+}
+
+TEST_CASE("handler can unregister itself on a loop with several tasks", "[event][linux]")
+{
+    esp_event_loop_args_t loop_args = test_event_get_default_loop_args();
+    loop_args.task_count = TEST_WORKER_COUNT;
+    esp_event_loop_handle_t loop;
+    TEST_ESP_OK(esp_event_loop_create(&loop_args, &loop));
+
+    unregister_test_data_t test_data = {
+        .context = NULL,
+        .loop = loop,
+        .count = 0,
+    };
+
+    TEST_ESP_OK(esp_event_handler_register_with(loop,
+                                                s_test_base1,
+                                                TEST_EVENT_BASE1_EV1,
+                                                test_handler_unregister_itself, &test_data));
+
+    // both events are dispatched by the same task, the handler is removed once the first one has been dispatched
+    TEST_ESP_OK(esp_event_post_to(loop, s_test_base1, TEST_EVENT_BASE1_EV1, NULL, 0, portMAX_DELAY));
+    TEST_ESP_OK(esp_event_post_to(loop, s_test_base1, TEST_EVENT_BASE1_EV1, NULL, 0, portMAX_DELAY));
+    vTaskDelay(pdMS_TO_TICKS(10));
+
+    // deleting the loop waits for its tasks to return from the handlers
+    TEST_ESP_OK(esp_event_loop_delete(loop));
+
+    TEST_ASSERT_EQUAL(1, test_data.count);
+}
+
+#define TEST_UNREGISTER_ROUNDS    50
+#define TEST_UNREGISTER_IDS       8
+
+typedef struct {
+    std::atomic<bool> unregistered;     // set once the unregistration has returned
+    std::atomic<int> calls;
+    std::atomic<int> late_calls;        // calls made after the unregistration returned
+} unregister_wait_test_arg_t;
+
+typedef struct {
+    esp_event_loop_handle_t loop;
+    std::atomic<bool> stop;
+    SemaphoreHandle_t done;
+} unregister_wait_test_poster_t;
+
+static void test_handler_count_late_calls(void* handler_arg, esp_event_base_t base, int32_t id, void* event_arg)
+{
+    unregister_wait_test_arg_t *arg = (unregister_wait_test_arg_t*) handler_arg;
+    if (arg->unregistered) {
+        arg->late_calls++;
+    }
+    arg->calls++;
+}
+
+static void test_post_until_stopped_task(void* args)
+{
+    unregister_wait_test_poster_t *poster = (unregister_wait_test_poster_t*) args;
+    for (int32_t id = 0; !poster->stop; id = (id + 1) % TEST_UNREGISTER_IDS) {
+        esp_event_post_to(poster->loop, s_test_base1, id, NULL, 0, portMAX_DELAY);
+    }
+    xSemaphoreGive(poster->done);
+    vTaskDelete(NULL);
+}
+
+TEST_CASE("unregistering a handler of a loop with several tasks waits until it is not executed anymore", "[event][linux]")
+{
+    esp_event_loop_args_t loop_args = test_event_get_default_loop_args();
+    loop_args.task_count = TEST_WORKER_COUNT;
+    esp_event_loop_handle_t loop;
+    TEST_ESP_OK(esp_event_loop_create(&loop_args, &loop));
+
+    unregister_wait_test_poster_t poster;
+    poster.loop = loop;
+    poster.stop = false;
+    poster.done = xSemaphoreCreateBinary();
+    TEST_ASSERT(poster.done);
+    TEST_ASSERT_EQUAL(pdPASS, xTaskCreate(test_post_until_stopped_task, "poster", 4096, &poster, uxTaskPriorityGet(NULL), NULL));
+
+    // handlers which unregister themselves, their removal is deferred until no task can execute them anymore
+    static unregister_test_data_t self_unregister[TEST_UNREGISTER_ROUNDS];
+
+    for (int i = 0; i < TEST_UNREGISTER_ROUNDS; i++) {
+        unregister_wait_test_arg_t *arg = new unregister_wait_test_arg_t();
+        esp_event_handler_instance_t instance;
+        TEST_ESP_OK(esp_event_handler_instance_register_with(loop, s_test_base1, ESP_EVENT_ANY_ID,
+                                                             test_handler_count_late_calls, arg, &instance));
+
+        self_unregister[i].loop = loop;
+        self_unregister[i].count = 0;
+        TEST_ESP_OK(esp_event_handler_instance_register_with(loop, s_test_base1, i % TEST_UNREGISTER_IDS,
+                                                             test_handler_instance_unregister_itself,
+                                                             &self_unregister[i], &self_unregister[i].context));
+
+        while (arg->calls == 0) {
+            vTaskDelay(1);
+        }
+        TEST_ESP_OK(esp_event_handler_instance_unregister_with(loop, s_test_base1, ESP_EVENT_ANY_ID, instance));
+        arg->unregistered = true;
+
+        // the events posted meanwhile must not reach the handler
+        vTaskDelay(2);
+        TEST_ASSERT_EQUAL(0, arg->late_calls);
+        delete arg;
+    }
+
+    poster.stop = true;
+    TEST_ASSERT_EQUAL(pdTRUE, xSemaphoreTake(poster.done, portMAX_DELAY));
+    vTaskDelay(pdMS_TO_TICKS(10));
+
+    for (int i = 0; i < TEST_UNREGISTER_ROUNDS; i++) {
+        TEST_ASSERT_EQUAL(1, self_unregister[i].count);
+    }
+    // the removed handlers and the dispatch tables replaced while events were dispatched are freed
+    TEST_ASSERT_FALSE(esp_event_loop_has_deferred_cleanup(loop));
+
+    TEST_ESP_OK(esp_event_loop_delete(loop));
+    vSemaphoreDelete(poster.done);
+}
+
+#if CONFIG_ESP_EVENT_DISPATCH_TABLE
+// without the dispatch table, the tasks walk the handler lists one at a time
+static void test_handler_slow(void* handler_arg, esp_event_base_t base, int32_t id, void* event_arg)
+{
+    vTaskDelay(2);
+    xSemaphoreGive((SemaphoreHandle_t) handler_arg);
+}
+
+// Posts events of different bases and ids with handlers that block, returns the ticks taken to dispatch them
+static TickType_t test_dispatch_slow_events(uint32_t task_count)
+{
+    esp_event_loop_args_t loop_args = test_event_get_default_loop_args();
+    loop_args.task_count = task_count;
+    esp_event_loop_handle_t loop;
+    TEST_ESP_OK(esp_event_loop_create(&loop_args, &loop));
+
+    const int event_count = 32;
+    SemaphoreHandle_t done = xSemaphoreCreateCounting(event_count, 0);
+    TEST_ASSERT(done);
+    TEST_ESP_OK(esp_event_handler_register_with(loop, ESP_EVENT_ANY_BASE, ESP_EVENT_ANY_ID, test_handler_slow, done));
+
+    TickType_t start = xTaskGetTickCount();
+    for (int i = 0; i < event_count / 2; i++) {
+        TEST_ESP_OK(esp_event_post_to(loop, s_test_base1, i, NULL, 0, portMAX_DELAY));
+        TEST_ESP_OK(esp_event_post_to(loop, s_test_base2, i, NULL, 0, portMAX_DELAY));
+    }
+    for (int i = 0; i < event_count; i++) {
+        TEST_ASSERT_EQUAL(pdTRUE, xSemaphoreTake(done, portMAX_DELAY));
+    }
+    TickType_t elapsed = xTaskGetTickCount() - start;
+
+    TEST_ESP_OK(esp_event_loop_delete(loop));
+    vSemaphoreDelete(done);
+
+    return elapsed;
+}
+
+TEST_CASE("loop with several tasks dispatches events of blocking handlers in parallel", "[event][linux]")
+{
+    TickType_t single = test_dispatch_slow_events(1);
+    TickType_t workers = test_dispatch_slow_events(TEST_WORKER_COUNT);
+
+    printf("dispatched 32 events in %" PRIu32 " ticks with 1 task, %" PRIu32 " ticks with %d tasks\n",
+           (uint32_t) single, (uint32_t) workers, TEST_WORKER_COUNT);
+    TEST_ASSERT_LESS_THAN(single, workers);
+}
+#endif // CONFIG_ESP_EVENT_DISPATCH_TABLE
+
 TEST_CASE("default loop: registering fails on uninitialized default loop", "[event][default][linux]")
 {
     esp_event_handler_instance_t instance;
@@ -0,0 +1,225 @@
+/*
+ * SPDX-FileCopyrightText: 2026 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_http_server.h"
+#include "unity.h"
+
+#define TEST_RESP_BODY      "Hello World!"
+#define TEST_RESP           "HTTP/1.1 200 OK\r\n" \
+                            "Content-Type: text/html\r\n" \
+                            "Content-Length: 12\r\n" \
+                            "\r\n" \
+                            TEST_RESP_BODY
+
+/* Without LwIP, the select() backend is limited to HTTPD_MAX_SOCKETS - 3 sessions */
+#if CONFIG_HTTPD_POLL_BACKEND_SELECT
+#define TEST_CLIENTS        12
+#else
+#define TEST_CLIENTS        256
+#endif
+
+static esp_err_t hello_handler(httpd_req_t *req)
+{
+    return httpd_resp_send(req, TEST_RESP_BODY, HTTPD_RESP_USE_STRLEN);
+}
+
+static void async_resp_task(void *arg)
+{
+    httpd_req_t *req = (httpd_req_t *) arg;
+    vTaskDelay(1);
+    httpd_resp_send(req, TEST_RESP_BODY, HTTPD_RESP_USE_STRLEN);
+    httpd_req_async_handler_complete(req);
+    vTaskDelete(NULL);
+}
+
+static esp_err_t async_handler(httpd_req_t *req)
+{
+    httpd_req_t *copy;
+    if (httpd_req_async_handler_begin(req, &copy) != ESP_OK) {
+        return ESP_FAIL;
+    }
+    if (xTaskCreate(async_resp_task, "async_resp", 4096, copy, 5, NULL) != pdPASS) {
+        httpd_req_async_handler_complete(copy);
+        return ESP_FAIL;
+    }
+    return ESP_OK;
+}
+
+static httpd_handle_t test_server_start(void)
+{
+    httpd_handle_t hd;
+    httpd_config_t config = HTTPD_DEFAULT_CONFIG();
+    config.server_port = 8001;
+    config.max_open_sockets = TEST_CLIENTS;
+    config.backlog_conn = TEST_CLIENTS;
+    TEST_ASSERT_EQUAL(ESP_OK, httpd_start(&hd, &config));
+
+    httpd_uri_t uri = {
+        .uri      = "/hello",
+        .method   = HTTP_GET,
+        .handler  = hello_handler,
+    };
+    TEST_ASSERT_EQUAL(ESP_OK, httpd_register_uri_handler(hd, &uri));
+    uri.uri = "/async";
+    uri.handler = async_handler;
+    TEST_ASSERT_EQUAL(ESP_OK, httpd_register_uri_handler(hd, &uri));
+    return hd;
+}
+
+static int client_connect(void)
+{
+    int sock = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    TEST_ASSERT(sock >= 0);
+    int nodelay = 1;
+    setsockopt(sock, IPPROTO_TCP, TCP_NODELAY, &nodelay, sizeof(nodelay));
+    struct timeval timeout = { .tv_sec = 5 };
+    setsockopt(sock, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+    struct sockaddr_in addr = {
+        .sin_family = AF_INET,
+        .sin_port   = htons(8001),
+        .sin_addr.s_addr = htonl(INADDR_LOOPBACK),
+    };
+    int ret;
+    do {
+        ret = connect(sock, (struct sockaddr *) &addr, sizeof(addr));
+    } while (ret < 0 && errno == EINTR);
+    TEST_ASSERT_EQUAL(0, ret);
+    return sock;
+}
+
+/* Sends `count` back to back GET requests for the URI */
+static void client_request(int sock, const char *uri, int count)
+{
+    char buf[256];
+    size_t len = 0;
+    for (int i = 0; i < count; i++) {
+        len += snprintf(buf + len, sizeof(buf) - len, "GET %s HTTP/1.1\r\nHost: localhost\r\n\r\n", uri);
+        TEST_ASSERT(len < sizeof(buf));
+    }
+    for (size_t sent = 0; sent < len;) {
+        int ret = send(sock, buf + sent, len - sent, 0);
+        if (ret < 0 && errno == EINTR) {
+            continue;
+        }
+        TEST_ASSERT(ret > 0);
+        sent += ret;
+    }
+}
+
+/* Receives `count` responses and checks that each is the expected one */
+static void client_expect(int sock, int count)
+{
+    char buf[512];
+    const size_t resp_len = strlen(TEST_RESP);
+    TEST_ASSERT(resp_len * count < sizeof(buf));
+    for (size_t received = 0; received < resp_len * count;) {
+        int ret = recv(sock, buf + received, resp_len * count - received, 0);
+        if (ret < 0 && errno == EINTR) {
+            continue;
+        }
+        TEST_ASSERT(ret > 0);
+        received += ret;
+    }
+    for (int i = 0; i < count; i++) {
+        TEST_ASSERT_EQUAL_MEMORY(TEST_RESP, buf + i * resp_len, resp_len);
+    }
+}
+
+static int64_t time_us(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000000LL + ts.tv_nsec / 1000;
+}
+
+/* Opens TEST_CLIENTS keep-alive connections and runs `rounds` rounds in which
+ * each of the first `active` clients sends a request and waits for the response */
+static void run_load(int active, int rounds)
+{
+    static int clients[TEST_CLIENTS];
+    httpd_handle_t hd = test_server_start();
+
+    for (int i = 0; i < TEST_CLIENTS; i++) {
+        clients[i] = client_connect();
+    }
+
+    int64_t start = time_us();
+    for (int r = 0; r < rounds; r++) {
+        for (int i = 0; i < active; i++) {
+            client_request(clients[i], "/hello", 1);
+        }
+        for (int i = 0; i < active; i++) {
+            client_expect(clients[i], 1);
+        }
+    }
+    int64_t elapsed = time_us() - start;
+    printf("%d clients, %d active: %lld requests/s\n", TEST_CLIENTS, active,
+           (long long) active * rounds * 1000000LL / (elapsed ? elapsed : 1));
+
+    for (int i = 0; i < TEST_CLIENTS; i++) {
+        close(clients[i]);
+    }
+    TEST_ASSERT_EQUAL(ESP_OK, httpd_stop(hd));
+}
+
+TEST_CASE("All keep-alive clients active", "[httpd_poll]")
+{
+    run_load(TEST_CLIENTS, 50);
+}
+
+TEST_CASE("One active client among idle keep-alive clients", "[httpd_poll]")
+{
+    run_load(1, 5000);
+}
+
+TEST_CASE("Pipelined requests are served from the pending buffer", "[httpd_poll]")
+{
+    httpd_handle_t hd = test_server_start();
+    int sock = client_connect();
+
+    /* Both requests arrive in the same segment, the second one is left in the
+     * session's pending buffer and is not reported by the socket anymore */
+    for (int i = 0; i < 10; i++) {
+        client_request(sock, "/hello", 2);
+        client_expect(sock, 2);
+    }
+
+    close(sock);
+    TEST_ASSERT_EQUAL(ESP_OK, httpd_stop(hd));
+}
+
+TEST_CASE("Session is resumed after an async handler completes", "[httpd_poll]")
+{
+    httpd_handle_t hd = test_server_start();
+    int sock = client_connect();
+
+    for (int i = 0; i < 10; i++) {
+        client_request(sock, "/async", 1);
+        client_expect(sock, 1);
+        client_request(sock, "/hello", 1);
+        client_expect(sock, 1);
+    }
+
+    close(sock);
+    TEST_ASSERT_EQUAL(ESP_OK, httpd_stop(hd));
+}
+
+void app_main(void)
+{
+    unity_run_menu();
+}
@@ -0,0 +1,227 @@
+/*
+ * SPDX-FileCopyrightText: 2026 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include "esp_http_server.h"
+#include "unity.h"
+
+#define SEND_TEST_PORT          8004
+#define SEND_TEST_BENCH_REQS    5000
+#define SEND_TEST_BODY          "Hello World! Hello World! Hello World!"
+#define SEND_TEST_HDRS          "Cache-Control: no-cache\r\n" \
+                                "Server: esp-httpd\r\n" \
+                                "X-Frame-Options: DENY\r\n" \
+                                "X-Content-Type-Options: nosniff\r\n" \
+                                "Connection: keep-alive\r\n"
+
+enum send_test_mode {
+    SEND_TEST_DEFAULT,          /* no override, the socket is written with sendmsg() */
+    SEND_TEST_SEND_OVERRIDE,    /* only send_fn is overridden, buffers are sent one by one */
+    SEND_TEST_SENDV_OVERRIDE,   /* send_fn and sendv_fn are overridden */
+};
+
+static enum send_test_mode send_test_mode;
+static volatile int send_test_server_fd = -1;
+static volatile unsigned send_test_calls;
+
+/* send() and sendmsg() are interposed to count the socket writes of the server
+ * in every mode, including the default transport which has no hook for it */
+ssize_t send(int sockfd, const void *buf, size_t len, int flags)
+{
+    if (sockfd == send_test_server_fd) {
+        send_test_calls++;
+    }
+    return syscall(SYS_sendto, sockfd, buf, len, flags, NULL, 0);
+}
+
+ssize_t sendmsg(int sockfd, const struct msghdr *msg, int flags)
+{
+    if (sockfd == send_test_server_fd) {
+        send_test_calls++;
+    }
+    return syscall(SYS_sendmsg, sockfd, msg, flags);
+}
+
+static int send_test_send(httpd_handle_t hd, int sockfd, const char *buf, size_t buf_len, int flags)
+{
+    int ret = send(sockfd, buf, buf_len, flags);
+    return (ret < 0) ? HTTPD_SOCK_ERR_FAIL : ret;
+}
+
+static int send_test_sendv(httpd_handle_t hd, int sockfd, const struct iovec *iov, int iovcnt, int flags)
+{
+    struct msghdr msg = {
+        .msg_iov    = (struct iovec *) iov,
+        .msg_iovlen = iovcnt,
+    };
+    int ret = sendmsg(sockfd, &msg, flags);
+    return (ret < 0) ? HTTPD_SOCK_ERR_FAIL : ret;
+}
+
+/* Without TCP_NODELAY, the separate writes of the send_fn only mode stall on delayed ACKs */
+static esp_err_t send_test_open(httpd_handle_t hd, int sockfd)
+{
+    int one = 1;
+    setsockopt(sockfd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    if (send_test_mode != SEND_TEST_DEFAULT) {
+        httpd_sess_set_send_override(hd, sockfd, send_test_send);
+    }
+    if (send_test_mode == SEND_TEST_SENDV_OVERRIDE) {
+        httpd_sess_set_sendv_override(hd, sockfd, send_test_sendv);
+    }
+    send_test_server_fd = sockfd;
+    return ESP_OK;
+}
+
+static esp_err_t send_test_handler(httpd_req_t *req)
+{
+    httpd_resp_set_hdr(req, "Cache-Control", "no-cache");
+    httpd_resp_set_hdr(req, "Server", "esp-httpd");
+    httpd_resp_set_hdr(req, "X-Frame-Options", "DENY");
+    httpd_resp_set_hdr(req, "X-Content-Type-Options", "nosniff");
+    httpd_resp_set_hdr(req, "Connection", "keep-alive");
+    if (strcmp(req->uri, "/chunk") == 0) {
+        httpd_resp_send_chunk(req, SEND_TEST_BODY, HTTPD_RESP_USE_STRLEN);
+        httpd_resp_send_chunk(req, SEND_TEST_BODY, HTTPD_RESP_USE_STRLEN);
+        return httpd_resp_send_chunk(req, NULL, 0);
+    }
+    return httpd_resp_send(req, SEND_TEST_BODY, HTTPD_RESP_USE_STRLEN);
+}
+
+static httpd_handle_t send_test_start(enum send_test_mode mode)
+{
+    httpd_handle_t hd;
+    httpd_config_t config = HTTPD_DEFAULT_CONFIG();
+    config.server_port = SEND_TEST_PORT;
+    config.open_fn = send_test_open;
+    send_test_mode = mode;
+    TEST_ASSERT_EQUAL(ESP_OK, httpd_start(&hd, &config));
+
+    httpd_uri_t uri = {
+        .uri      = "/plain",
+        .method   = HTTP_GET,
+        .handler  = send_test_handler,
+    };
+    TEST_ASSERT_EQUAL(ESP_OK, httpd_register_uri_handler(hd, &uri));
+    uri.uri = "/chunk";
+    TEST_ASSERT_EQUAL(ESP_OK, httpd_register_uri_handler(hd, &uri));
+    return hd;
+}
+
+static int send_client_connect(void)
+{
+    int sock = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    TEST_ASSERT(sock >= 0);
+    int nodelay = 1;
+    setsockopt(sock, IPPROTO_TCP, TCP_NODELAY, &nodelay, sizeof(nodelay));
+    struct timeval timeout = { .tv_sec = 5 };
+    setsockopt(sock, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+    struct sockaddr_in addr = {
+        .sin_family = AF_INET,
+        .sin_port   = htons(SEND_TEST_PORT),
+        .sin_addr.s_addr = htonl(INADDR_LOOPBACK),
+    };
+    int ret;
+    do {
+        ret = connect(sock, (struct sockaddr *) &addr, sizeof(addr));
+    } while (ret < 0 && errno == EINTR);
+    TEST_ASSERT_EQUAL(0, ret);
+    return sock;
+}
+
+/* Sends a request over the client socket and checks that the response
+ * received is exactly the expected one */
+static void send_client_request(int sock, const char *uri, const char *expected)
+{
+    char buf[512];
+    size_t expected_len = strlen(expected);
+    size_t len = snprintf(buf, sizeof(buf), "GET %s HTTP/1.1\r\nHost: localhost\r\n\r\n", uri);
+
+    TEST_ASSERT_EQUAL(len, send(sock, buf, len, 0));
+    TEST_ASSERT(expected_len < sizeof(buf));
+    for (len = 0; len < expected_len;) {
+        int ret = recv(sock, buf + len, expected_len - len, 0);
+        if (ret < 0 && errno == EINTR) {
+            continue;
+        }
+        TEST_ASSERT(ret > 0);
+        len += ret;
+    }
+    TEST_ASSERT_EQUAL_MEMORY(expected, buf, expected_len);
+}
+
+static int64_t send_time_us(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000000LL + ts.tv_nsec / 1000;
+}
+
+TEST_CASE("Response send calls and request rate per transport", "[httpd_send]")
+{
+    static const char *expected_plain =
+        "HTTP/1.1 200 OK\r\n"
+        "Content-Type: text/html\r\n"
+        "Content-Length: 38\r\n"
+        SEND_TEST_HDRS
+        "\r\n"
+        SEND_TEST_BODY;
+    static const char *expected_chunk =
+        "HTTP/1.1 200 OK\r\n"
+        "Content-Type: text/html\r\n"
+        "Transfer-Encoding: chunked\r\n"
+        SEND_TEST_HDRS
+        "\r\n"
+        "26\r\n" SEND_TEST_BODY "\r\n"
+        "26\r\n" SEND_TEST_BODY "\r\n"
+        "0\r\n\r\n";
+    static const char *mode_names[] = { "default", "send override", "sendv override" };
+
+    for (int mode = SEND_TEST_DEFAULT; mode <= SEND_TEST_SENDV_OVERRIDE; mode++) {
+        httpd_handle_t hd = send_test_start(mode);
+        int sock = send_client_connect();
+
+        /* One write per httpd_resp_send() and per httpd_resp_send_chunk(),
+         * unless only send_fn is available */
+        send_test_calls = 0;
+        send_client_request(sock, "/plain", expected_plain);
+        unsigned plain_calls = send_test_calls;
+        send_test_calls = 0;
+        send_client_request(sock, "/chunk", expected_chunk);
+        unsigned chunk_calls = send_test_calls;
+        if (mode == SEND_TEST_SEND_OVERRIDE) {
+            TEST_ASSERT(plain_calls > 1);
+            TEST_ASSERT(chunk_calls > 3);
+        } else {
+            TEST_ASSERT_EQUAL(1, plain_calls);
+            TEST_ASSERT_EQUAL(3, chunk_calls);
+        }
+
+        int64_t start = send_time_us();
+        for (int i = 0; i < SEND_TEST_BENCH_REQS; i++) {
+            send_client_request(sock, "/plain", expected_plain);
+        }
+        int64_t elapsed = send_time_us() - start;
+        printf("%s: %u send calls per response, %u per chunked response, %lld requests/s\n",
+               mode_names[mode], plain_calls, chunk_calls,
+               (long long) SEND_TEST_BENCH_REQS * 1000000LL / (elapsed ? elapsed : 1));
+
+        close(sock);
+        TEST_ASSERT_EQUAL(ESP_OK, httpd_stop(hd));
+        send_test_server_fd = -1;
+    }
+}
@@ -0,0 +1,433 @@
+/*
+ * SPDX-FileCopyrightText: 2026 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/param.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include "esp_http_server.h"
+#include "unity.h"
+
+#define STATIC_TEST_PORT        8003
+#define STATIC_TEST_BIG_SIZE    100000
+#define STATIC_TEST_BENCH_SIZE  (1024 * 1024)
+#define STATIC_TEST_BENCH_REQS  20
+
+static const char static_test_index[] = "<html>index</html>";
+static const char static_test_js[] = "console.log('plain');";
+static const char static_test_js_gz[] = "\x1f\x8b compressed";
+static const char static_test_mapped[] = "mapped content";
+
+static const httpd_static_file_t static_test_files[] = {
+    { .path = "/mapped.txt", .data = static_test_mapped, .size = sizeof(static_test_mapped) - 1, .etag = "\"m1\"" },
+};
+
+struct static_resp {
+    int status;
+    char hdrs[1024];
+    char *body;
+    size_t body_len;
+};
+
+static char static_test_dir[] = "/tmp/httpd_static_XXXXXX";
+
+static void static_test_write(const char *name, const void *data, size_t len)
+{
+    char path[128];
+    snprintf(path, sizeof(path), "%s/%s", static_test_dir, name);
+    FILE *f = fopen(path, "wb");
+    TEST_ASSERT_NOT_NULL(f);
+    TEST_ASSERT_EQUAL(len, fwrite(data, 1, len, f));
+    fclose(f);
+}
+
+static char *static_test_pattern(size_t len)
+{
+    char *data = malloc(len);
+    TEST_ASSERT_NOT_NULL(data);
+    for (size_t i = 0; i < len; i++) {
+        data[i] = (char) (i * 7 + i / 251);
+    }
+    return data;
+}
+
+static int static_client_connect(void)
+{
+    int sock = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    TEST_ASSERT(sock >= 0);
+    struct timeval timeout = { .tv_sec = 5 };
+    setsockopt(sock, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+    struct sockaddr_in addr = {
+        .sin_family = AF_INET,
+        .sin_port   = htons(STATIC_TEST_PORT),
+        .sin_addr.s_addr = htonl(INADDR_LOOPBACK),
+    };
+    int ret;
+    do {
+        ret = connect(sock, (struct sockaddr *) &addr, sizeof(addr));
+    } while (ret < 0 && errno == EINTR);
+    TEST_ASSERT_EQUAL(0, ret);
+    return sock;
+}
+
+static void static_client_recv_all(int sock, char *buf, size_t len)
+{
+    while (len > 0) {
+        int ret = recv(sock, buf, len, 0);
+        if (ret < 0 && errno == EINTR) {
+            continue;
+        }
+        TEST_ASSERT(ret > 0);
+        buf += ret;
+        len -= ret;
+    }
+}
+
+/* Returns the value of the response header, NULL if absent */
+static const char *static_resp_hdr(const struct static_resp *resp, const char *field, char *val, size_t val_size)
+{
+    size_t field_len = strlen(field);
+    for (const char *line = strstr(resp->hdrs, "\r\n"); line && line[2]; line = strstr(line + 2, "\r\n")) {
+        line += 2;
+        if (strncasecmp(line, field, field_len) == 0 && line[field_len] == ':') {
+            const char *start = line + field_len + 1 + strspn(line + field_len + 1, " ");
+            size_t len = strcspn(start, "\r");
+            TEST_ASSERT(len < val_size);
+            memcpy(val, start, len);
+            val[len] = '\0';
+            return val;
+        }
+    }
+    return NULL;
+}
+
+/* Sends a request with the extra header lines and receives the response on the
+ * keep-alive connection */
+static void static_request(int sock, const char *method, const char *uri, const char *extra_hdrs,
+                           struct static_resp *resp)
+{
+    char req[512];
+    int len = snprintf(req, sizeof(req), "%s %s HTTP/1.1\r\nHost: localhost\r\n%s\r\n",
+                       method, uri, extra_hdrs ? extra_hdrs : "");
+    TEST_ASSERT_EQUAL(len, send(sock, req, len, 0));
+
+    /* The header section is received one byte at a time not to read into the body */
+    size_t hdrs_len = 0;
+    while (hdrs_len < 4 || memcmp(resp->hdrs + hdrs_len - 4, "\r\n\r\n", 4) != 0) {
+        TEST_ASSERT(hdrs_len < sizeof(resp->hdrs) - 1);
+        static_client_recv_all(sock, resp->hdrs + hdrs_len, 1);
+        hdrs_len++;
+    }
+    resp->hdrs[hdrs_len] = '\0';
+    TEST_ASSERT_EQUAL(1, sscanf(resp->hdrs, "HTTP/1.1 %d", &resp->status));
+
+    char val[32];
+    TEST_ASSERT_NOT_NULL(static_resp_hdr(resp, "Content-Length", val, sizeof(val)));
+    resp->body_len = strtoul(val, NULL, 10);
+    if (strcmp(method, "HEAD") == 0 || resp->status == 304) {
+        resp->body_len = 0;
+    }
+    resp->body = malloc(resp->body_len + 1);
+    TEST_ASSERT_NOT_NULL(resp->body);
+    static_client_recv_all(sock, resp->body, resp->body_len);
+    resp->body[resp->body_len] = '\0';
+}
+
+static void static_resp_free(struct static_resp *resp)
+{
+    free(resp->body);
+    resp->body = NULL;
+}
+
+static void static_assert_hdr(const struct static_resp *resp, const char *field, const char *expected)
+{
+    char val[128];
+    const char *actual = static_resp_hdr(resp, field, val, sizeof(val));
+    if (expected) {
+        TEST_ASSERT_NOT_NULL(actual);
+        TEST_ASSERT_EQUAL_STRING(expected, actual);
+    } else {
+        TEST_ASSERT_NULL(actual);
+    }
+}
+
+/* Without TCP_NODELAY, delayed ACKs on the loopback interface dominate the throughput */
+static esp_err_t static_open_fn(httpd_handle_t hd, int fd)
+{
+    int one = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    return ESP_OK;
+}
+
+static httpd_handle_t static_test_start(const httpd_static_config_t *static_config)
+{
+    httpd_handle_t hd;
+    httpd_config_t config = HTTPD_DEFAULT_CONFIG();
+    config.server_port = STATIC_TEST_PORT;
+    config.uri_match_fn = httpd_uri_match_wildcard;
+    config.open_fn = static_open_fn;
+    TEST_ASSERT_EQUAL(ESP_OK, httpd_start(&hd, &config));
+
+    httpd_uri_t uri = {
+        .uri = "/www/*",
+        .method = HTTP_GET,
+        .handler = httpd_static_handler,
+        .user_ctx = (void *) static_config,
+    };
+    TEST_ASSERT_EQUAL(ESP_OK, httpd_register_uri_handler(hd, &uri));
+    uri.method = HTTP_HEAD;
+    TEST_ASSERT_EQUAL(ESP_OK, httpd_register_uri_handler(hd, &uri));
+    return hd;
+}
+
+static void static_test_cleanup(void)
+{
+    const char *names[] = { "index.html", "big.bin", "app.js", "app.js.gz", "bench.bin" };
+    char path[128];
+    for (int i = 0; i < sizeof(names) / sizeof(names[0]); i++) {
+        snprintf(path, sizeof(path), "%s/%s", static_test_dir, names[i]);
+        unlink(path);
+    }
+    rmdir(static_test_dir);
+    strcpy(static_test_dir, "/tmp/httpd_static_XXXXXX");
+}
+
+TEST_CASE("Static handler serves files, ranges and precompressed files", "[httpd_static]")
+{
+    TEST_ASSERT_NOT_NULL(mkdtemp(static_test_dir));
+    char *big = static_test_pattern(STATIC_TEST_BIG_SIZE);
+    static_test_write("index.html", static_test_index, strlen(static_test_index));
+    static_test_write("big.bin", big, STATIC_TEST_BIG_SIZE);
+    static_test_write("app.js", static_test_js, strlen(static_test_js));
+    static_test_write("app.js.gz", static_test_js_gz, strlen(static_test_js_gz));
+
+    httpd_static_config_t static_config = HTTPD_STATIC_DEFAULT_CONFIG();
+    static_config.uri_prefix = "/www";
+    static_config.base_path = static_test_dir;
+    static_config.files = static_test_files;
+    static_config.files_count = sizeof(static_test_files) / sizeof(static_test_files[0]);
+    static_config.cache_control = "max-age=60";
+    httpd_handle_t hd = static_test_start(&static_config);
+    int sock = static_client_connect();
+    struct static_resp resp;
+    char etag[64];
+    char extra[128];
+
+    /* Index file, with the headers set for all files */
+    static_request(sock, "GET", "/www/", NULL, &resp);
+    TEST_ASSERT_EQUAL(200, resp.status);
+    TEST_ASSERT_EQUAL_STRING(static_test_index, resp.body);
+    static_assert_hdr(&resp, "Content-Type", "text/html");
+    static_assert_hdr(&resp, "Cache-Control", "max-age=60");
+    static_assert_hdr(&resp, "Accept-Ranges", "bytes");
+    static_assert_hdr(&resp, "Content-Encoding", NULL);
+    static_resp_free(&resp);
+
+    /* Whole file, larger than the read buffer */
+    static_request(sock, "GET", "/www/big.bin?v=1", NULL, &resp);
+    TEST_ASSERT_EQUAL(200, resp.status);
+    TEST_ASSERT_EQUAL(STATIC_TEST_BIG_SIZE, resp.body_len);
+    TEST_ASSERT(memcmp(big, resp.body, STATIC_TEST_BIG_SIZE) == 0);
+    TEST_ASSERT_NOT_NULL(static_resp_hdr(&resp, "ETag", etag, sizeof(etag)));
+    static_resp_free(&resp);
+
+    /* HEAD only sends the headers, the next request on the connection still works */
+    static_request(sock, "HEAD", "/www/big.bin", NULL, &resp);
+    TEST_ASSERT_EQUAL(200, resp.status);
+    static_assert_hdr(&resp, "Content-Length", "100000");
+    static_resp_free(&resp);
+
+    /* Range starting at an unaligned offset and spanning several reads */
+    static_request(sock, "GET", "/www/big.bin", "Range: bytes=1000-70999\r\n", &resp);
+    TEST_ASSERT_EQUAL(206, resp.status);
+    static_assert_hdr(&resp, "Content-Range", "bytes 1000-70999/100000");
+    TEST_ASSERT_EQUAL(70000, resp.body_len);
+    TEST_ASSERT(memcmp(big + 1000, resp.body, 70000) == 0);
+    static_resp_free(&resp);
+
+    static_request(sock, "GET", "/www/big.bin", "Range: bytes=-10\r\n", &resp);
+    TEST_ASSERT_EQUAL(206, resp.status);
+    static_assert_hdr(&resp, "Content-Range", "bytes 99990-99999/100000");
+    TEST_ASSERT(memcmp(big + 99990, resp.body, 10) == 0);
+    static_resp_free(&resp);
+
+    static_request(sock, "GET", "/www/big.bin", "Range: bytes=99999-200000\r\n", &resp);
+    TEST_ASSERT_EQUAL(206, resp.status);
+    TEST_ASSERT_EQUAL(1, resp.body_len);
+    static_resp_free(&resp);
+
+    static_request(sock, "GET", "/www/big.bin", "Range: bytes=100000-\r\n", &resp);
+    TEST_ASSERT_EQUAL(416, resp.status);
+    static_assert_hdr(&resp, "Content-Range", "bytes */100000");
+    static_resp_free(&resp);
+
+    /* Several ranges are answered with the whole file */
+    static_request(sock, "GET", "/www/big.bin", "Range: bytes=0-1,5-6\r\n", &resp);
+    TEST_ASSERT_EQUAL(200, resp.status);
+    TEST_ASSERT_EQUAL(STATIC_TEST_BIG_SIZE, resp.body_len);
+    static_resp_free(&resp);
+
+    /* Conditional request */
+    snprintf(extra, sizeof(extra), "If-None-Match: \"other\", W/%s\r\n", etag);
+    static_request(sock, "GET", "/www/big.bin", extra, &resp);
+    TEST_ASSERT_EQUAL(304, resp.status);
+    static_assert_hdr(&resp, "ETag", etag);
+    static_resp_free(&resp);
+
+    /* Precompressed file */
+    static_request(sock, "GET", "/www/app.js", "Accept-Encoding: deflate, gzip;q=0.8\r\n", &resp);
+    TEST_ASSERT_EQUAL(200, resp.status);
+    TEST_ASSERT_EQUAL_STRING(static_test_js_gz, resp.body);
+    static_assert_hdr(&resp, "Content-Type", "application/javascript");
+    static_assert_hdr(&resp, "Content-Encoding", "gzip");
+    static_assert_hdr(&resp, "Vary", "Accept-Encoding");
+    static_resp_free(&resp);
+
+    static_request(sock, "GET", "/www/app.js", "Accept-Encoding: gzip;q=0, deflate\r\n", &resp);
+    TEST_ASSERT_EQUAL(200, resp.status);
+    TEST_ASSERT_EQUAL_STRING(static_test_js, resp.body);
+    static_assert_hdr(&resp, "Content-Encoding", NULL);
+    static_assert_hdr(&resp, "Vary", "Accept-Encoding");
+    static_resp_free(&resp);
+
+    /* File in memory */
+    static_request(sock, "GET", "/www/mapped.txt", NULL, &resp);
+    TEST_ASSERT_EQUAL(200, resp.status);
+    TEST_ASSERT_EQUAL_STRING(static_test_mapped, resp.body);
+    static_assert_hdr(&resp, "Content-Type", "text/plain");
+    static_assert_hdr(&resp, "ETag", "\"m1\"");
+    static_resp_free(&resp);
+
+    static_request(sock, "GET", "/www/mapped.txt", "Range: bytes=2-4\r\n", &resp);
+    TEST_ASSERT_EQUAL(206, resp.status);
+    TEST_ASSERT_EQUAL_STRING("ppe", resp.body);
+    static_resp_free(&resp);
+
+    static_request(sock, "GET", "/www/mapped.txt", "If-None-Match: \"m1\"\r\n", &resp);
+    TEST_ASSERT_EQUAL(304, resp.status);
+    static_resp_free(&resp);
+
+    /* Missing files and paths leaving the base directory */
+    const char *missing[] = { "/www/missing", "/www/../www/index.html", "/www/%2e%2E/index.html" };
+    for (int i = 0; i < sizeof(missing) / sizeof(missing[0]); i++) {
+        static_request(sock, "GET", missing[i], NULL, &resp);
+        TEST_ASSERT_EQUAL(404, resp.status);
+        static_resp_free(&resp);
+    }
+
+    static_request(sock, "GET", "/www/%61pp.js", NULL, &resp);
+    TEST_ASSERT_EQUAL(200, resp.status);
+    TEST_ASSERT_EQUAL_STRING(static_test_js, resp.body);
+    static_resp_free(&resp);
+
+    /* Not below the URI prefix, the server closes the connection after this one */
+    static_request(sock, "GET", "/wwwindex.html", NULL, &resp);
+    TEST_ASSERT_EQUAL(404, resp.status);
+    static_resp_free(&resp);
+
+    close(sock);
+    httpd_stop(hd);
+    free(big);
+    static_test_cleanup();
+}
+
+/* Serves files the way applications did without the static handler */
+static esp_err_t static_test_chunked_handler(httpd_req_t *req)
+{
+    char path[128];
+    snprintf(path, sizeof(path), "%s/bench.bin", static_test_dir);
+    FILE *f = fopen(path, "rb");
+    if (!f) {
+        return httpd_resp_send_404(req);
+    }
+    char buf[4096];
+    size_t len;
+    esp_err_t ret = ESP_OK;
+    while (ret == ESP_OK && (len = fread(buf, 1, sizeof(buf), f)) > 0) {
+        ret = httpd_resp_send_chunk(req, buf, len);
+    }
+    fclose(f);
+    return (ret == ESP_OK) ? httpd_resp_send_chunk(req, NULL, 0) : ret;
+}
+
+static int64_t static_time_us(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000000LL + ts.tv_nsec / 1000;
+}
+
+static double static_bench(int sock, const char *uri, bool chunked)
+{
+    char req[128];
+    int len = snprintf(req, sizeof(req), "GET %s HTTP/1.1\r\nHost: localhost\r\n\r\n", uri);
+    static char buf[65536];
+    int64_t start = static_time_us();
+
+    for (int i = 0; i < STATIC_TEST_BENCH_REQS; i++) {
+        TEST_ASSERT_EQUAL(len, send(sock, req, len, 0));
+        /* Receive until the end of the content, which is the last in the file */
+        size_t received = 0;
+        const char *tail = chunked ? "\r\n0\r\n\r\n" : "\xff";
+        size_t tail_len = strlen(tail);
+        char last[8] = { 0 };
+        while (true) {
+            int ret = recv(sock, buf, sizeof(buf), 0);
+            TEST_ASSERT(ret > 0);
+            received += ret;
+            size_t keep = MIN((size_t) ret, tail_len);
+            memmove(last, last + keep, tail_len - keep);
+            memcpy(last + tail_len - keep, buf + ret - keep, keep);
+            if (received > STATIC_TEST_BENCH_SIZE && memcmp(last, tail, tail_len) == 0) {
+                break;
+            }
+        }
+    }
+    int64_t elapsed = static_time_us() - start;
+    return (double) STATIC_TEST_BENCH_SIZE * STATIC_TEST_BENCH_REQS / elapsed;
+}
+
+TEST_CASE("Static handler throughput", "[httpd_static]")
+{
+    TEST_ASSERT_NOT_NULL(mkdtemp(static_test_dir));
+    char *data = static_test_pattern(STATIC_TEST_BENCH_SIZE);
+    /* Ends with a byte only found there, so that the client knows the response is complete */
+    memset(data, 0, STATIC_TEST_BENCH_SIZE);
+    data[STATIC_TEST_BENCH_SIZE - 1] = '\xff';
+    static_test_write("bench.bin", data, STATIC_TEST_BENCH_SIZE);
+    free(data);
+
+    httpd_static_config_t static_config = HTTPD_STATIC_DEFAULT_CONFIG();
+    static_config.uri_prefix = "/www";
+    static_config.base_path = static_test_dir;
+    static_config.read_size = 16384;
+    httpd_handle_t hd = static_test_start(&static_config);
+    httpd_uri_t uri = {
+        .uri = "/chunked",
+        .method = HTTP_GET,
+        .handler = static_test_chunked_handler,
+    };
+    TEST_ASSERT_EQUAL(ESP_OK, httpd_register_uri_handler(hd, &uri));
+
+    int sock = static_client_connect();
+    double chunked = static_bench(sock, "/chunked", true);
+    double direct = static_bench(sock, "/www/bench.bin", false);
+    printf("fread + httpd_resp_send_chunk: %.1f MB/s\n", chunked);
+    printf("httpd_static_handler: %.1f MB/s\n", direct);
+
+    close(sock);
+    httpd_stop(hd);
+    static_test_cleanup();
+}
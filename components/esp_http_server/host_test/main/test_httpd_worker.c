@@ -0,0 +1,362 @@
+/*
+ * SPDX-FileCopyrightText: 2026 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <signal.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_http_server.h"
+#include "unity.h"
+
+#define WORKER_TEST_PORT            8002
+#define WORKER_TEST_WORKERS         4
+#define WORKER_TEST_SLOW_MS         20
+#define WORKER_TEST_SLOW_CLIENTS    2
+#define WORKER_TEST_FAST_CLIENTS    4
+#define WORKER_TEST_FAST_REQUESTS   50
+#define WORKER_TEST_PIPELINED       8
+
+static esp_err_t fast_handler(httpd_req_t *req)
+{
+    return httpd_resp_send(req, "fast", HTTPD_RESP_USE_STRLEN);
+}
+
+static esp_err_t slow_handler(httpd_req_t *req)
+{
+    vTaskDelay(pdMS_TO_TICKS(WORKER_TEST_SLOW_MS));
+    return httpd_resp_send(req, "slow", HTTPD_RESP_USE_STRLEN);
+}
+
+/* Responds with the number of requests received on the session so far,
+ * taking longer for every other request */
+static esp_err_t seq_handler(httpd_req_t *req)
+{
+    int *count = req->sess_ctx;
+    if (!count) {
+        count = calloc(1, sizeof(int));
+        TEST_ASSERT_NOT_NULL(count);
+        req->sess_ctx = count;
+        req->free_ctx = free;
+    }
+    if (++*count % 2) {
+        vTaskDelay(pdMS_TO_TICKS(5));
+    }
+    char buf[16];
+    snprintf(buf, sizeof(buf), "%d", *count);
+    return httpd_resp_send(req, buf, HTTPD_RESP_USE_STRLEN);
+}
+
+/* Same as seq_handler, but keeps the count with httpd_sess_set_ctx() */
+static esp_err_t sess_ctx_handler(httpd_req_t *req)
+{
+    int fd = httpd_req_to_sockfd(req);
+    int *count = httpd_sess_get_ctx(req->handle, fd);
+    if (!count) {
+        count = calloc(1, sizeof(int));
+        TEST_ASSERT_NOT_NULL(count);
+        httpd_sess_set_ctx(req->handle, fd, count, free);
+    }
+    char buf[16];
+    snprintf(buf, sizeof(buf), "%d", ++*count);
+    return httpd_resp_send(req, buf, HTTPD_RESP_USE_STRLEN);
+}
+
+static esp_err_t fail_handler(httpd_req_t *req)
+{
+    return ESP_FAIL;
+}
+
+static void nested_async_task(void *arg)
+{
+    httpd_req_t *req = (httpd_req_t *) arg;
+    vTaskDelay(1);
+    httpd_resp_send(req, "async", HTTPD_RESP_USE_STRLEN);
+    httpd_req_async_handler_complete(req);
+    vTaskDelete(NULL);
+}
+
+/* Takes its own asynchronous copy of a request already running on a worker */
+static esp_err_t nested_async_handler(httpd_req_t *req)
+{
+    httpd_req_t *copy;
+    if (httpd_req_async_handler_begin(req, &copy) != ESP_OK) {
+        return ESP_FAIL;
+    }
+    if (xTaskCreate(nested_async_task, "nested_async", 4096, copy, 5, NULL) != pdPASS) {
+        httpd_req_async_handler_complete(copy);
+        return ESP_FAIL;
+    }
+    return ESP_OK;
+}
+
+static httpd_handle_t worker_test_start(uint16_t worker_count)
+{
+    httpd_handle_t hd;
+    httpd_config_t config = HTTPD_DEFAULT_CONFIG();
+    config.server_port = WORKER_TEST_PORT;
+    config.max_uri_handlers = 6;
+    config.worker_count = worker_count;
+    TEST_ASSERT_EQUAL(ESP_OK, httpd_start(&hd, &config));
+
+    const httpd_uri_t uris[] = {
+        { .uri = "/fast", .method = HTTP_GET, .handler = fast_handler },
+        { .uri = "/slow", .method = HTTP_GET, .handler = slow_handler },
+        { .uri = "/seq", .method = HTTP_GET, .handler = seq_handler },
+        { .uri = "/sess_ctx", .method = HTTP_GET, .handler = sess_ctx_handler },
+        { .uri = "/fail", .method = HTTP_GET, .handler = fail_handler },
+        { .uri = "/async", .method = HTTP_GET, .handler = nested_async_handler },
+    };
+    for (int i = 0; i < sizeof(uris) / sizeof(uris[0]); i++) {
+        TEST_ASSERT_EQUAL(ESP_OK, httpd_register_uri_handler(hd, &uris[i]));
+    }
+    return hd;
+}
+
+static int64_t time_us(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000000LL + ts.tv_nsec / 1000;
+}
+
+static int worker_client_connect(void)
+{
+    int sock = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    TEST_ASSERT(sock >= 0);
+    int nodelay = 1;
+    setsockopt(sock, IPPROTO_TCP, TCP_NODELAY, &nodelay, sizeof(nodelay));
+    struct timeval timeout = { .tv_sec = 5 };
+    setsockopt(sock, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+    struct sockaddr_in addr = {
+        .sin_family = AF_INET,
+        .sin_port   = htons(WORKER_TEST_PORT),
+        .sin_addr.s_addr = htonl(INADDR_LOOPBACK),
+    };
+    int ret;
+    do {
+        ret = connect(sock, (struct sockaddr *) &addr, sizeof(addr));
+    } while (ret < 0 && errno == EINTR);
+    TEST_ASSERT_EQUAL(0, ret);
+    return sock;
+}
+
+static void worker_client_send(int sock, const char *uri, int count)
+{
+    char buf[512];
+    size_t len = 0;
+    for (int i = 0; i < count; i++) {
+        len += snprintf(buf + len, sizeof(buf) - len, "GET %s HTTP/1.1\r\nHost: localhost\r\n\r\n", uri);
+        TEST_ASSERT(len < sizeof(buf));
+    }
+    for (size_t sent = 0; sent < len;) {
+        int ret = send(sock, buf + sent, len - sent, 0);
+        if (ret < 0 && errno == EINTR) {
+            continue;
+        }
+        TEST_ASSERT(ret > 0);
+        sent += ret;
+    }
+}
+
+/* Client connection, with the data received beyond the last response */
+struct worker_conn {
+    int sock;
+    char buf[512];
+    size_t len;
+};
+
+/* Receives one response and copies its body to `body`. Returns false if the
+ * server closed the connection instead. */
+static bool worker_client_recv(struct worker_conn *conn, char *body, size_t body_size)
+{
+    size_t total = 0;
+    char *end = NULL;
+    while (!end || conn->len < total) {
+        if (!end) {
+            conn->buf[conn->len] = '\0';
+            if ((end = strstr(conn->buf, "\r\n\r\n")) != NULL) {
+                char *cl = strstr(conn->buf, "Content-Length: ");
+                TEST_ASSERT_NOT_NULL(cl);
+                total = end + 4 - conn->buf + atoi(cl + strlen("Content-Length: "));
+                TEST_ASSERT(total < sizeof(conn->buf));
+                continue;
+            }
+        }
+        int ret = recv(conn->sock, conn->buf + conn->len, sizeof(conn->buf) - 1 - conn->len, 0);
+        if (ret < 0 && errno == EINTR) {
+            continue;
+        }
+        if (ret == 0 && conn->len == 0) {
+            return false;
+        }
+        TEST_ASSERT(ret > 0);
+        conn->len += ret;
+    }
+    size_t body_len = total - (end + 4 - conn->buf);
+    TEST_ASSERT(body_len < body_size);
+    memcpy(body, end + 4, body_len);
+    body[body_len] = '\0';
+    conn->len -= total;
+    memmove(conn->buf, conn->buf + total, conn->len);
+    return true;
+}
+
+struct worker_client {
+    pthread_t thread;
+    const char *uri;
+    int requests;                   /* Number of requests to send, 0 to send until stopped */
+    int64_t *latencies;             /* Latency of each request in microseconds */
+};
+
+static volatile bool worker_clients_stop;
+
+static void *worker_client_thread(void *arg)
+{
+    struct worker_client *client = arg;
+
+    /* Leave the signals used by the FreeRTOS port to its tasks */
+    sigset_t set;
+    sigfillset(&set);
+    pthread_sigmask(SIG_BLOCK, &set, NULL);
+
+    struct worker_conn conn = { .sock = worker_client_connect() };
+    for (int i = 0; client->requests ? i < client->requests : !worker_clients_stop; i++) {
+        char body[16];
+        int64_t start = time_us();
+        worker_client_send(conn.sock, client->uri, 1);
+        TEST_ASSERT(worker_client_recv(&conn, body, sizeof(body)));
+        if (client->latencies) {
+            client->latencies[i] = time_us() - start;
+        }
+        TEST_ASSERT_EQUAL_STRING(client->uri + 1, body);
+    }
+    close(conn.sock);
+    return NULL;
+}
+
+static int compare_latency(const void *a, const void *b)
+{
+    int64_t x = *(const int64_t *) a;
+    int64_t y = *(const int64_t *) b;
+    return (x > y) - (x < y);
+}
+
+/* Runs fast requests while other clients keep the slow handler busy, and
+ * returns the 99th percentile latency of the fast requests */
+static int64_t run_mixed_load(uint16_t worker_count)
+{
+    static int64_t latencies[WORKER_TEST_FAST_CLIENTS * WORKER_TEST_FAST_REQUESTS];
+    struct worker_client slow[WORKER_TEST_SLOW_CLIENTS] = {};
+    struct worker_client fast[WORKER_TEST_FAST_CLIENTS] = {};
+    httpd_handle_t hd = worker_test_start(worker_count);
+
+    worker_clients_stop = false;
+    for (int i = 0; i < WORKER_TEST_SLOW_CLIENTS; i++) {
+        slow[i].uri = "/slow";
+        TEST_ASSERT_EQUAL(0, pthread_create(&slow[i].thread, NULL, worker_client_thread, &slow[i]));
+    }
+    for (int i = 0; i < WORKER_TEST_FAST_CLIENTS; i++) {
+        fast[i].uri = "/fast";
+        fast[i].requests = WORKER_TEST_FAST_REQUESTS;
+        fast[i].latencies = &latencies[i * WORKER_TEST_FAST_REQUESTS];
+        TEST_ASSERT_EQUAL(0, pthread_create(&fast[i].thread, NULL, worker_client_thread, &fast[i]));
+    }
+    for (int i = 0; i < WORKER_TEST_FAST_CLIENTS; i++) {
+        pthread_join(fast[i].thread, NULL);
+    }
+    worker_clients_stop = true;
+    for (int i = 0; i < WORKER_TEST_SLOW_CLIENTS; i++) {
+        pthread_join(slow[i].thread, NULL);
+    }
+    TEST_ASSERT_EQUAL(ESP_OK, httpd_stop(hd));
+
+    const int count = sizeof(latencies) / sizeof(latencies[0]);
+    qsort(latencies, count, sizeof(latencies[0]), compare_latency);
+    printf("%d workers, fast request latency: p50 %lld us, p90 %lld us, p99 %lld us, max %lld us\n",
+           worker_count, (long long) latencies[count / 2], (long long) latencies[count * 90 / 100],
+           (long long) latencies[count * 99 / 100], (long long) latencies[count - 1]);
+    return latencies[count * 99 / 100];
+}
+
+TEST_CASE("Fast handlers are not held up by slow handlers on workers", "[httpd_worker]")
+{
+    run_mixed_load(0);
+    int64_t p99 = run_mixed_load(WORKER_TEST_WORKERS);
+    /* With more workers than slow clients, a fast request never waits for a slow handler */
+    TEST_ASSERT(p99 < WORKER_TEST_SLOW_MS * 1000);
+}
+
+TEST_CASE("Requests of a session are handled in order by workers", "[httpd_worker]")
+{
+    httpd_handle_t hd = worker_test_start(WORKER_TEST_WORKERS);
+    struct worker_conn conn = { .sock = worker_client_connect() };
+
+    /* All requests arrive at once, the session context is kept across them */
+    worker_client_send(conn.sock, "/seq", WORKER_TEST_PIPELINED);
+    for (int i = 1; i <= WORKER_TEST_PIPELINED; i++) {
+        char body[16];
+        char expected[16];
+        TEST_ASSERT(worker_client_recv(&conn, body, sizeof(body)));
+        snprintf(expected, sizeof(expected), "%d", i);
+        TEST_ASSERT_EQUAL_STRING(expected, body);
+    }
+
+    close(conn.sock);
+    TEST_ASSERT_EQUAL(ESP_OK, httpd_stop(hd));
+}
+
+TEST_CASE("Session context set by a handler on a worker is kept", "[httpd_worker]")
+{
+    httpd_handle_t hd = worker_test_start(WORKER_TEST_WORKERS);
+    struct worker_conn conn = { .sock = worker_client_connect() };
+
+    /* The server task doesn't touch the session while a worker runs its handler */
+    worker_client_send(conn.sock, "/sess_ctx", WORKER_TEST_PIPELINED);
+    for (int i = 1; i <= WORKER_TEST_PIPELINED; i++) {
+        char body[16];
+        char expected[16];
+        TEST_ASSERT(worker_client_recv(&conn, body, sizeof(body)));
+        snprintf(expected, sizeof(expected), "%d", i);
+        TEST_ASSERT_EQUAL_STRING(expected, body);
+    }
+
+    close(conn.sock);
+    TEST_ASSERT_EQUAL(ESP_OK, httpd_stop(hd));
+}
+
+TEST_CASE("Session is resumed or closed after a worker runs its handler", "[httpd_worker]")
+{
+    httpd_handle_t hd = worker_test_start(WORKER_TEST_WORKERS);
+    struct worker_conn conn = { .sock = worker_client_connect() };
+    char body[16];
+
+    for (int i = 0; i < 10; i++) {
+        worker_client_send(conn.sock, "/async", 1);
+        TEST_ASSERT(worker_client_recv(&conn, body, sizeof(body)));
+        TEST_ASSERT_EQUAL_STRING("async", body);
+        worker_client_send(conn.sock, "/fast", 1);
+        TEST_ASSERT(worker_client_recv(&conn, body, sizeof(body)));
+        TEST_ASSERT_EQUAL_STRING("fast", body);
+    }
+
+    /* A failing handler closes the session, as without workers */
+    worker_client_send(conn.sock, "/fail", 1);
+    TEST_ASSERT_FALSE(worker_client_recv(&conn, body, sizeof(body)));
+
+    close(conn.sock);
+    TEST_ASSERT_EQUAL(ESP_OK, httpd_stop(hd));
+}
@@ -0,0 +1,14 @@
+# SPDX-FileCopyrightText: 2026 Espressif Systems (Shanghai) CO LTD
+# SPDX-License-Identifier: Unlicense OR CC0-1.0
+import pytest
+from pytest_embedded import Dut
+from pytest_embedded_idf.utils import idf_parametrize
+
+
+@pytest.mark.host_test
+@pytest.mark.parametrize('config', ['select', 'poll', 'epoll'], indirect=True)
+@idf_parametrize('target', ['linux'], indirect=['target'])
+def test_esp_http_server_linux(dut: Dut) -> None:
+    dut.expect_exact('Press ENTER to see the list of tests.')
+    dut.write('*')
+    dut.expect(r'[0-9]+ Tests 0 Failures 0 Ignored', timeout=120)
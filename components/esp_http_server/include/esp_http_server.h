@@ -9,6 +9,7 @@
 
 #include <stdio.h>
 #include <string.h>
+#include <sys/uio.h>
 #include <freertos/FreeRTOS.h>
 #include <freertos/task.h>
 #include <http_parser.h>
@@ -80,7 +81,9 @@ initializer that should be kept in sync
         .keep_alive_count = 0,                          \
         .open_fn = NULL,                                \
         .close_fn = NULL,                               \
-        .uri_match_fn = NULL                            \
+        .uri_match_fn = NULL,                           \
+        .worker_count = 0,                              \
+        .worker_stack_size = 4096                       \
 }
 
 #define ESP_ERR_HTTPD_BASE              (0xb000)                    /*!< Starting number of HTTPD error codes */
@@ -288,6 +291,23 @@ typedef struct httpd_config {
      * of the `httpd_uri_match_func_t` function prototype)
      */
     httpd_uri_match_func_t uri_match_fn;
+
+    /**
+     * Number of worker tasks running the URI handlers.
+     *
+     * With 0, the handlers run on the server task, so a slow handler holds
+     * up every other session. Otherwise, the server task only parses the
+     * requests and hands each one to the next free worker as an asynchronous
+     * request (see `httpd_req_async_handler_begin()`). A session is not read
+     * again before its request is done, so the requests of a session are
+     * still handled one after the other.
+     *
+     * WebSocket frames and error responses are always handled on the server
+     * task. The workers use the priority, core and stack memory capabilities
+     * of the server task.
+     */
+    uint16_t worker_count;
+    size_t worker_stack_size;   /*!< The maximum stack size allowed for each worker task */
 } httpd_config_t;
 
 /**
@@ -753,6 +773,30 @@ esp_err_t httpd_req_handle_err(httpd_req_t *req, httpd_err_code_t error);
  */
 typedef int (*httpd_send_func_t)(httpd_handle_t hd, int sockfd, const char *buf, size_t buf_len, int flags);
 
+/**
+ * @brief  Prototype for HTTPDs low-level vectored send function
+ *
+ * Sends the buffers described by iov one after another, like writev() or
+ * sendmsg() of the BSD socket API. The response APIs use it to send the
+ * status line, the headers and the body of a response with a single call.
+ *
+ * @note   Sending fewer bytes than the buffers hold is allowed, the remaining
+ *         bytes are passed in a following call. Errors must be handled as
+ *         described for httpd_send_func_t.
+ *
+ * @param[in] hd        server instance
+ * @param[in] sockfd    session socket file descriptor
+ * @param[in] iov       array of buffers to send
+ * @param[in] iovcnt    number of buffers in the array
+ * @param[in] flags     flags for the sendmsg() function
+ * @return
+ *  - Bytes : The number of bytes sent successfully
+ *  - HTTPD_SOCK_ERR_INVALID  : Invalid arguments
+ *  - HTTPD_SOCK_ERR_TIMEOUT  : Timeout/interrupted while calling socket send()
+ *  - HTTPD_SOCK_ERR_FAIL     : Unrecoverable error while calling socket send()
+ */
+typedef int (*httpd_sendv_func_t)(httpd_handle_t hd, int sockfd, const struct iovec *iov, int iovcnt, int flags);
+
 /**
  * @brief  Prototype for HTTPDs low-level recv function
  *
@@ -845,6 +889,30 @@ esp_err_t httpd_sess_set_recv_override(httpd_handle_t hd, int sockfd, httpd_recv
  */
 esp_err_t httpd_sess_set_send_override(httpd_handle_t hd, int sockfd, httpd_send_func_t send_func);
 
+/**
+ * @brief   Override web server's vectored send function (by session FD)
+ *
+ * The vectored send function is used to send the responses of httpd_resp_send() and
+ * httpd_resp_send_chunk() with a single call. Without an override the socket is written
+ * with sendmsg(), unless the send function has been overridden by httpd_sess_set_send_override().
+ * In that case the buffers are passed to the overridden send function one by one, so transports
+ * such as TLS should set this override as well to have the whole response handled at once.
+ *
+ * @note    This API is supposed to be called either from the context of
+ *          - an http session APIs where sockfd is a valid parameter
+ *          - a URI handler where sockfd is obtained using httpd_req_to_sockfd()
+ *
+ * @param[in] hd         HTTPD instance handle
+ * @param[in] sockfd     Session socket FD
+ * @param[in] sendv_func The vectored send function to be set for this session,
+ *                       NULL restores the default behavior
+ *
+ * @return
+ *  - ESP_OK : On successfully registering override
+ *  - ESP_ERR_INVALID_ARG : Null arguments
+ */
+esp_err_t httpd_sess_set_sendv_override(httpd_handle_t hd, int sockfd, httpd_sendv_func_t sendv_func);
+
 /**
  * @brief   Override web server's pending function (by session FD)
  *
@@ -1236,10 +1304,13 @@ static inline esp_err_t httpd_resp_sendstr_chunk(httpd_req_t *r, const char *str
 /* Some commonly used status codes */
 #define HTTPD_200      "200 OK"                     /*!< HTTP Response 200 */
 #define HTTPD_204      "204 No Content"             /*!< HTTP Response 204 */
+#define HTTPD_206      "206 Partial Content"        /*!< HTTP Response 206 */
 #define HTTPD_207      "207 Multi-Status"           /*!< HTTP Response 207 */
+#define HTTPD_304      "304 Not Modified"           /*!< HTTP Response 304 */
 #define HTTPD_400      "400 Bad Request"            /*!< HTTP Response 400 */
 #define HTTPD_404      "404 Not Found"              /*!< HTTP Response 404 */
 #define HTTPD_408      "408 Request Timeout"        /*!< HTTP Response 408 */
+#define HTTPD_416      "416 Range Not Satisfiable"  /*!< HTTP Response 416 */
 #define HTTPD_500      "500 Internal Server Error"  /*!< HTTP Response 500 */
 
 /**
@@ -1711,6 +1782,90 @@ esp_err_t httpd_queue_work(httpd_handle_t handle, httpd_work_fn_t work, void *ar
  * @}
  */
 
+/* ************** Group: Static Files ************** */
+/** @name Static Files
+ * APIs for serving files with the built-in static file handler
+ * @{
+ */
+
+/**
+ * @brief   File served by httpd_static_handler() straight from memory
+ */
+typedef struct httpd_static_file {
+    const char *path;       /*!< Path of the file below uri_prefix, starting with '/', e.g. "/index.html" */
+    const void *data;       /*!< Content of the file, e.g. mapped with esp_partition_mmap() or embedded in the application */
+    size_t      size;       /*!< Size of the content in bytes */
+    const char *etag;       /*!< Entity tag of the content including the quotes, or NULL to not send one */
+} httpd_static_file_t;
+
+/**
+ * @brief   Configuration of httpd_static_handler()
+ *
+ * The structure is passed as user_ctx of the URI handler and must stay valid while
+ * the handler is registered.
+ */
+typedef struct httpd_static_config {
+    const char *uri_prefix;             /*!< Leading part of the request URI which is removed to get the file path, e.g. "/static" */
+    const char *base_path;              /*!< VFS directory the files are read from, e.g. "/spiffs/www", or NULL */
+    const httpd_static_file_t *files;   /*!< Files served from memory, looked up before base_path, or NULL */
+    size_t      files_count;            /*!< Number of entries in files */
+    const char *index_file;             /*!< File served for paths ending with '/', or NULL */
+    const char *cache_control;          /*!< Value of the Cache-Control header sent with files, or NULL to not send it */
+    size_t      read_size;              /*!< Size of the buffer files from base_path are read into, rounded up to a multiple of 512 */
+} httpd_static_config_t;
+
+/**
+ * @brief   Default configuration of httpd_static_handler()
+ */
+#define HTTPD_STATIC_DEFAULT_CONFIG() {     \
+        .uri_prefix    = "",                \
+        .base_path     = NULL,              \
+        .files         = NULL,              \
+        .files_count   = 0,                 \
+        .index_file    = "index.html",      \
+        .cache_control = NULL,              \
+        .read_size     = 4096,              \
+}
+
+/**
+ * @brief   URI handler serving static files
+ *
+ * Register this function as the handler of a wildcard URI covering all the files to be
+ * served, with httpd_uri_match_wildcard() as uri_match_fn, for HTTP_GET and optionally
+ * HTTP_HEAD. The user_ctx of the URI handler must point to an httpd_static_config_t.
+ *
+ * The file path is the request URI, without the query and uri_prefix, and with
+ * percent-encoded characters decoded. Paths containing ".." segments are rejected.
+ * The file is first looked up in config->files, where its content is sent straight
+ * from memory without being copied. Otherwise it is opened below config->base_path
+ * and read into a buffer of config->read_size bytes, at offsets aligned to 512 bytes.
+ * The headers go out together with the first block of the content.
+ *
+ * The handler also supports:
+ *  - Single byte ranges requested with the Range header, answered with
+ *    "206 Partial Content" or "416 Range Not Satisfiable". Requests for several
+ *    ranges are answered with the whole file.
+ *  - Conditional requests with If-None-Match, answered with "304 Not Modified".
+ *    The ETag of a file from base_path is made of its size and modification time.
+ *  - Precompressed files. If the client accepts gzip and a file with the same
+ *    path and ".gz" appended exists, it is sent instead with "Content-Encoding: gzip".
+ *
+ * The Content-Type is chosen from the extension of the file.
+ *
+ * @param[in] r     The request being responded to
+ *
+ * @return
+ *  - ESP_OK : If a response was sent, including error responses such as 404
+ *  - ESP_ERR_INVALID_ARG : Null request pointer or user_ctx
+ *  - ESP_ERR_HTTPD_RESP_SEND : Error in raw send, the session is to be closed
+ *  - ESP_FAIL : File could not be read after the headers were sent
+ */
+esp_err_t httpd_static_handler(httpd_req_t *r);
+
+/** End of Group Static Files
+ * @}
+ */
+
 /* ************** Group: WebSocket ************** */
 /** @name WebSocket
  * Functions and structs for WebSocket server
@@ -76,6 +76,7 @@ struct sock_db {
     httpd_free_ctx_fn_t free_ctx;      /*!< Function for freeing the context */
     httpd_free_ctx_fn_t free_transport_ctx; /*!< Function for freeing the 'transport' context */
     httpd_send_func_t send_fn;              /*!< Send function for this socket */
+    httpd_sendv_func_t sendv_fn;            /*!< Vectored send function for this socket, NULL if not overridden */
     httpd_recv_func_t recv_fn;              /*!< Receive function for this socket */
     httpd_pending_func_t pending_fn;        /*!< Pending function for this socket */
     uint64_t lru_counter;                   /*!< LRU Counter indicating when the socket was last used */
@@ -114,6 +115,7 @@ struct httpd_req_aux {
         const char *value;
     } *resp_hdrs;                                   /*!< Additional headers in response packet */
     struct http_parser_url url_parse_res;           /*!< URL parsing result, used for retrieving URL elements */
+    bool            worker_resume;                  /*!< Copy run by a worker task, which resumes the session once the handler returns */
 #ifdef CONFIG_HTTPD_WS_SUPPORT
     bool ws_handshake_detect;                       /*!< WebSocket handshake detection flag */
     httpd_ws_type_t ws_type;                        /*!< WebSocket frame type */
@@ -138,10 +140,16 @@ struct httpd_data {
     struct sock_db *hd_sd;                  /*!< The socket database */
     int hd_sd_active_count;                 /*!< The number of the active sockets */
     httpd_uri_t **hd_calls;                 /*!< Registered URI handlers */
+#if CONFIG_HTTPD_URI_TREE
+    struct httpd_uri_tree *hd_uri_tree;     /*!< Registered URI handlers by URI, NULL if they are scanned in order */
+#endif
     struct httpd_req hd_req;                /*!< The current HTTPD request */
     struct httpd_req_aux hd_req_aux;        /*!< Additional data about the HTTPD request kept unexposed */
     uint64_t lru_counter;                   /*!< LRU counter */
     esp_http_server_event_id_t http_server_state;              /*!< HTTPD server state */
+    struct httpd_poll *hd_poll;             /*!< State of the socket readiness backend */
+    bool hd_sess_pending;                   /*!< A session may have buffered data which no socket event will report */
+    struct httpd_workers *hd_workers;       /*!< Worker tasks running the URI handlers, NULL if they run on the server task */
 
     /* Array of registered error handler functions */
     httpd_err_handler_func_t *err_handler_fns;
@@ -320,6 +328,162 @@ void httpd_sess_close_all(struct httpd_data *hd);
  * @}
  */
 
+/****************** Group : Socket Readiness ********************/
+/** @name Socket Readiness
+ * Backend used by the server task to wait for socket activity. One of
+ * select(), poll() or epoll is compiled in, see CONFIG_HTTPD_POLL_BACKEND.
+ * @{
+ */
+
+/**
+ * @brief Sockets reported as ready by httpd_poll_wait()
+ */
+struct httpd_poll_ready {
+    bool ctrl;                  /*!< Control socket has a message to be received */
+    bool listen;                /*!< Listening socket has a connection to be accepted */
+    int sess_count;             /*!< Number of entries in sessions */
+    struct sock_db **sessions;  /*!< Sessions with data to be received, owned by the backend */
+};
+
+/**
+ * @brief   Creates the backend state and registers the listening and
+ *          control sockets. Called once the server sockets are created.
+ *
+ * @param[in] hd  Server instance data
+ *
+ * @return
+ *  - ESP_OK   : on success
+ *  - ESP_ERR_HTTPD_ALLOC_MEM : if the state could not be allocated
+ *  - ESP_FAIL : if the backend could not be created
+ */
+esp_err_t httpd_poll_init(struct httpd_data *hd);
+
+/**
+ * @brief   Releases the backend state
+ *
+ * @param[in] hd  Server instance data
+ */
+void httpd_poll_deinit(struct httpd_data *hd);
+
+/**
+ * @brief   Starts watching the socket of a new session
+ *
+ * @param[in] hd      Server instance data
+ * @param[in] session Session, with the socket descriptor already set
+ *
+ * @return
+ *  - ESP_OK   : on success
+ *  - ESP_FAIL : if the socket could not be added
+ */
+esp_err_t httpd_poll_add(struct httpd_data *hd, struct sock_db *session);
+
+/**
+ * @brief   Stops watching the socket of a session. Must be called before
+ *          the socket is closed. Does nothing if the socket is not watched.
+ *
+ * @param[in] hd      Server instance data
+ * @param[in] session Session
+ */
+void httpd_poll_remove(struct httpd_data *hd, struct sock_db *session);
+
+/**
+ * @brief   Suspends or resumes watching the socket of a session while it is
+ *          handed over to an asynchronous request handler.
+ *
+ * @note    May be called from a task other than the server task. The server
+ *          task is woken up through the control socket afterwards.
+ *
+ * @param[in] hd      Server instance data
+ * @param[in] session Session
+ * @param[in] active  False to suspend, true to resume
+ */
+void httpd_poll_set_active(struct httpd_data *hd, struct sock_db *session, bool active);
+
+/**
+ * @brief   Enables or disables watching the listening socket, depending on
+ *          whether the server is able to accept more connections.
+ *
+ * @param[in] hd     Server instance data
+ * @param[in] enable True if new connections can be accepted
+ */
+void httpd_poll_set_listen(struct httpd_data *hd, bool enable);
+
+/**
+ * @brief   Waits until any of the watched sockets is ready
+ *
+ * @param[in]  hd         Server instance data
+ * @param[in]  timeout_ms Time to wait in milliseconds, -1 to wait forever
+ * @param[out] ready      Sockets which are ready
+ *
+ * @return
+ *  - Number of ready sockets, 0 on timeout
+ *  - -1 on error, with errno set
+ */
+int httpd_poll_wait(struct httpd_data *hd, int timeout_ms, struct httpd_poll_ready *ready);
+
+/** End of Group : Socket Readiness
+ * @}
+ */
+
+/****************** Group : Workers ********************/
+/** @name Workers
+ * Tasks running the URI handlers in place of the server task, see
+ * httpd_config_t::worker_count
+ * @{
+ */
+
+/**
+ * @brief   Starts the worker tasks, if the configuration asks for any
+ *
+ * @param[in] hd  Server instance data
+ *
+ * @return
+ *  - ESP_OK                  : Workers started, or none configured
+ *  - ESP_ERR_HTTPD_ALLOC_MEM : Failed to allocate memory
+ *  - ESP_ERR_HTTPD_TASK      : Failed to launch a worker task
+ */
+esp_err_t httpd_workers_start(struct httpd_data *hd);
+
+/**
+ * @brief   Waits for the workers to run the requests handed to them and
+ *          stops them
+ *
+ * @param[in] hd  Server instance data
+ */
+void httpd_workers_stop(struct httpd_data *hd);
+
+/**
+ * @brief   Hands the current request over to a worker, which runs the
+ *          handler on an asynchronous copy of it
+ *
+ * The session is not read again until the worker is done with the request.
+ * The job is queued by httpd_workers_send_pending() once the server task has
+ * cleaned up its request, so that the worker has the session to itself.
+ *
+ * @param[in] r        The current request of the server task
+ * @param[in] handler  URI handler to run
+ *
+ * @return
+ *  - ESP_OK : Request handed over
+ *  - ESP_ERR_NO_MEM : Failed to copy the request, the handler has to be
+ *                     run by the caller
+ */
+esp_err_t httpd_workers_dispatch(httpd_req_t *r, esp_err_t (*handler)(httpd_req_t *r));
+
+/**
+ * @brief   Queues the request handed over by httpd_workers_dispatch(), if any
+ *
+ * Called after the server task has stored the session context of its request
+ * and detached the request from the session.
+ *
+ * @param[in] hd  Server instance data
+ */
+void httpd_workers_send_pending(struct httpd_data *hd);
+
+/** End of Group : Workers
+ * @}
+ */
+
 /****************** Group : URI Handling ********************/
 /** @name URI Handling
  * Methods for accessing URI handlers
@@ -405,6 +569,26 @@ esp_err_t httpd_req_new(struct httpd_data *hd, struct sock_db *sd);
  */
 esp_err_t httpd_req_delete(struct httpd_data *hd);
 
+/**
+ * @brief   Receives and discards the part of the request body which the
+ *          handler did not read
+ *
+ * @param[in] r  The request
+ *
+ * @return
+ *  - ESP_OK    : if the whole body has been received
+ *  - ESP_FAIL  : otherwise
+ */
+esp_err_t httpd_req_purge(httpd_req_t *r);
+
+/**
+ * @brief   Frees an asynchronous copy of a request, without resuming its
+ *          session like httpd_req_async_handler_complete() does
+ *
+ * @param[in] r  The request copy
+ */
+void httpd_req_async_free(httpd_req_t *r);
+
 /** End of Group : Parsing
  * @}
  */
@@ -428,6 +612,39 @@ esp_err_t httpd_req_delete(struct httpd_data *hd);
  */
 int httpd_send(httpd_req_t *req, const char *buf, size_t buf_len);
 
+/**
+ * @brief   For sending out all of a buffer in response to an HTTP request.
+ *
+ * @param[in] req     Pointer to the HTTP request for which the response needs to be sent
+ * @param[in] buf     Pointer to the buffer from where the data is taken
+ * @param[in] buf_len Length of the buffer
+ *
+ * @return
+ *  - ESP_OK   : if the whole buffer was sent
+ *  - ESP_FAIL : if failed
+ */
+esp_err_t httpd_send_all(httpd_req_t *req, const char *buf, size_t buf_len);
+
+/**
+ * @brief   For sending out the status line and headers of a response, followed by
+ *          the first part of its content.
+ *
+ * This is httpd_resp_send() with the Content-Length header independent of the length
+ * of the buffer. The rest of the content is then sent with httpd_send_all().
+ *
+ * @param[in] req         Pointer to the HTTP request for which the response needs to be sent
+ * @param[in] content_len Value of the Content-Length header
+ * @param[in] buf         Pointer to the first part of the content, NULL if none
+ * @param[in] buf_len     Length of the buffer
+ *
+ * @return
+ *  - ESP_OK                  : if successful
+ *  - ESP_ERR_HTTPD_RESP_HDR  : if the status line doesn't fit in the header buffer
+ *  - ESP_ERR_HTTPD_ALLOC_MEM : if the send buffer couldn't be allocated
+ *  - ESP_ERR_HTTPD_RESP_SEND : if sending failed
+ */
+esp_err_t httpd_resp_send_hdrs(httpd_req_t *req, size_t content_len, const char *buf, size_t buf_len);
+
 /**
  * @brief   For receiving HTTP request data
  *
@@ -509,6 +726,23 @@ int httpd_default_send(httpd_handle_t hd, int sockfd, const char *buf, size_t bu
  */
 int httpd_default_recv(httpd_handle_t hd, int sockfd, char *buf, size_t buf_len, int flags);
 
+/**
+ * @brief   This is the low level default vectored send function of the HTTPD. This
+ *          should NEVER be called directly. The semantics of this is exactly similar
+ *          to sendmsg() of the BSD socket API, with the buffers given as an iovec array.
+ *
+ * @param[in] hd      Server instance data
+ * @param[in] sockfd  Socket descriptor for sending data
+ * @param[in] iov     Array of buffers to be sent
+ * @param[in] iovcnt  Number of buffers in the array
+ * @param[in] flags   Flags for mode selection
+ *
+ * @return
+ *  - Length of data : if successful
+ *  - -1             : if failed (appropriate errno is set)
+ */
+int httpd_default_sendv(httpd_handle_t hd, int sockfd, const struct iovec *iov, int iovcnt, int flags);
+
 /** End of Group : Send and Receive
  * @}
  */
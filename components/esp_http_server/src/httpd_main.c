@@ -22,20 +22,19 @@
 
 #if defined(CONFIG_LWIP_MAX_SOCKETS)
 #define HTTPD_MAX_SOCKETS CONFIG_LWIP_MAX_SOCKETS
-#else
+#elif CONFIG_HTTPD_POLL_BACKEND_SELECT
 /* LwIP component is not included into the build, use a default value */
 #define HTTPD_MAX_SOCKETS 15
+#else
+/* LwIP component is not included into the build, poll() and epoll are
+ * only limited by the number of descriptors the process may open */
+#define HTTPD_MAX_SOCKETS (UINT16_MAX + 3)
 #endif
 
 static const int DEFAULT_KEEP_ALIVE_IDLE = 5;
 static const int DEFAULT_KEEP_ALIVE_INTERVAL= 5;
 static const int DEFAULT_KEEP_ALIVE_COUNT= 3;
 
-typedef struct {
-    fd_set *fdset;
-    struct httpd_data *hd;
-} process_session_context_t;
-
 static const char *TAG = "httpd";
 
 #ifdef CONFIG_HTTPD_ENABLE_EVENTS
@@ -242,29 +241,21 @@ static void httpd_process_ctrl_msg(struct httpd_data *hd)
 #endif
 }
 
-// Called for each session from httpd_server
-static int httpd_process_session(struct sock_db *session, void *context)
+// Called for each session from httpd_server when some session may have buffered data
+static int httpd_process_pending_session(struct sock_db *session, void *context)
 {
-    if ((!session) || (!context)) {
-        return 0;
-    }
-
-    if (session->fd < 0) {
-        return 1;
-    }
+    struct httpd_data *hd = (struct httpd_data *)context;
 
     // session is busy in an async task, do not process here.
-    if (session->for_async_req) {
+    if (session->fd < 0 || session->for_async_req) {
         return 1;
     }
-
-    process_session_context_t *ctx = (process_session_context_t *)context;
-    int fd = session->fd;
-
-    if (FD_ISSET(fd, ctx->fdset) || httpd_sess_pending(ctx->hd, session)) {
-        ESP_LOGD(TAG, LOG_FMT("processing socket %d"), fd);
-        if (httpd_sess_process(ctx->hd, session) != ESP_OK) {
-            httpd_sess_delete(ctx->hd, session); // Delete session
+    if (httpd_sess_pending(hd, session)) {
+        ESP_LOGD(TAG, LOG_FMT("processing pending data on socket %d"), session->fd);
+        if (httpd_sess_process(hd, session) != ESP_OK) {
+            httpd_sess_delete(hd, session); // Delete session
+        } else if (httpd_sess_pending(hd, session)) {
+            hd->hd_sess_pending = true;
         }
     }
     return 1;
@@ -273,51 +264,63 @@ static int httpd_process_session(struct sock_db *session, void *context)
 /* Manage in-coming connection or data requests */
 static esp_err_t httpd_server(struct httpd_data *hd)
 {
-    fd_set read_set;
-    FD_ZERO(&read_set);
-    if (hd->config.lru_purge_enable || httpd_is_sess_available(hd)) {
-        /* Only listen for new connections if server has capacity to
-         * handle more (or when LRU purge is enabled, in which case
-         * older connections will be closed) */
-        FD_SET(hd->listen_fd, &read_set);
-    }
-    FD_SET(hd->ctrl_fd, &read_set);
-
-    int tmp_max_fd;
-    httpd_sess_set_descriptors(hd, &read_set, &tmp_max_fd);
-    int maxfd = MAX(hd->listen_fd, tmp_max_fd);
-    tmp_max_fd = maxfd;
-    maxfd = MAX(hd->ctrl_fd, tmp_max_fd);
-
-    ESP_LOGD(TAG, LOG_FMT("doing select maxfd+1 = %d"), maxfd + 1);
-    int active_cnt = select(maxfd + 1, &read_set, NULL, NULL, NULL);
+    /* Only listen for new connections if server has capacity to
+     * handle more (or when LRU purge is enabled, in which case
+     * older connections will be closed) */
+    httpd_poll_set_listen(hd, hd->config.lru_purge_enable ||
+                          hd->hd_sd_active_count < hd->config.max_open_sockets);
+
+    /* Data buffered by httpd_unrecv() or by the transport (e.g. TLS) is not
+     * reported by the socket, so don't block while any session has some */
+    struct httpd_poll_ready ready = { 0 };
+    int timeout_ms = hd->hd_sess_pending ? 0 : -1;
+    ESP_LOGD(TAG, LOG_FMT("waiting for sockets, timeout %d"), timeout_ms);
+    int active_cnt = httpd_poll_wait(hd, timeout_ms, &ready);
     if (active_cnt < 0) {
-        ESP_LOGE(TAG, LOG_FMT("error in select (%d)"), errno);
-        httpd_sess_delete_invalid(hd);
+        if (errno != EINTR) {
+            ESP_LOGE(TAG, LOG_FMT("error in poll (%d)"), errno);
+            httpd_sess_delete_invalid(hd);
+        }
         return ESP_OK;
     }
 
     /* Case0: Do we have a control message? */
-    if (FD_ISSET(hd->ctrl_fd, &read_set)) {
+    if (ready.ctrl) {
         ESP_LOGD(TAG, LOG_FMT("processing ctrl message"));
         httpd_process_ctrl_msg(hd);
         if (hd->hd_td.status == THREAD_STOPPING) {
             ESP_LOGD(TAG, LOG_FMT("stopping thread"));
             return ESP_FAIL;
         }
+        /* Work functions and completed async handlers may have received
+         * on a session, leaving data behind in its buffers */
+        hd->hd_sess_pending = true;
     }
 
     /* Case1: Do we have any activity on the current data
      * sessions? */
-    process_session_context_t context = {
-        .fdset = &read_set,
-        .hd = hd
-    };
-    httpd_sess_enum(hd, httpd_process_session, &context);
+    for (int i = 0; i < ready.sess_count; i++) {
+        struct sock_db *session = ready.sessions[i];
+        // session may have been closed by a control message, or
+        // is busy in an async task, do not process here.
+        if (session->fd < 0 || session->for_async_req) {
+            continue;
+        }
+        ESP_LOGD(TAG, LOG_FMT("processing socket %d"), session->fd);
+        if (httpd_sess_process(hd, session) != ESP_OK) {
+            httpd_sess_delete(hd, session); // Delete session
+        } else if (httpd_sess_pending(hd, session)) {
+            hd->hd_sess_pending = true;
+        }
+    }
+    if (hd->hd_sess_pending) {
+        hd->hd_sess_pending = false;
+        httpd_sess_enum(hd, httpd_process_pending_session, hd);
+    }
 
     /* Case2: Do we have any incoming connection requests to
      * process? */
-    if (FD_ISSET(hd->listen_fd, &read_set)) {
+    if (ready.listen) {
         ESP_LOGD(TAG, LOG_FMT("processing listen socket %d"), hd->listen_fd);
         if (httpd_accept_conn(hd, hd->listen_fd) != ESP_OK) {
             ESP_LOGW(TAG, LOG_FMT("error accepting new connection"));
@@ -342,9 +345,11 @@ static void httpd_thread(void *arg)
     }
 
     ESP_LOGD(TAG, LOG_FMT("web server exiting"));
+    httpd_workers_stop(hd);
     close(hd->msg_fd);
     cs_free_ctrl_sock(hd->ctrl_fd);
     httpd_sess_close_all(hd);
+    httpd_poll_deinit(hd);
     close(hd->listen_fd);
     hd->hd_td.status = THREAD_STOPPED;
     httpd_os_thread_delete();
@@ -418,6 +423,23 @@ static esp_err_t httpd_server_init(struct httpd_data *hd)
     hd->listen_fd = fd;
     hd->ctrl_fd = ctrl_fd;
     hd->msg_fd  = msg_fd;
+
+    if (httpd_poll_init(hd) != ESP_OK) {
+        ESP_LOGE(TAG, LOG_FMT("error in creating poll backend"));
+        close(fd);
+        close(ctrl_fd);
+        close(msg_fd);
+        return ESP_FAIL;
+    }
+
+    if (httpd_workers_start(hd) != ESP_OK) {
+        ESP_LOGE(TAG, LOG_FMT("error in starting workers"));
+        httpd_poll_deinit(hd);
+        close(fd);
+        close(ctrl_fd);
+        close(msg_fd);
+        return ESP_FAIL;
+    }
     return ESP_OK;
 }
 
@@ -533,6 +555,7 @@ esp_err_t httpd_start(httpd_handle_t *handle, const httpd_config_t *config)
                                hd->config.core_id,
                                hd->config.task_caps) != ESP_OK) {
         /* Failed to launch task */
+        httpd_workers_stop(hd);
         httpd_delete(hd);
         return ESP_ERR_HTTPD_TASK;
     }
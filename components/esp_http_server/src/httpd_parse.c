@@ -746,6 +746,7 @@ static void httpd_req_cleanup(httpd_req_t *r)
     ra->sd->ignore_sess_ctx_changes = r->ignore_sess_ctx_changes;
 
     /* Clear out the request and request_aux structures */
+    struct httpd_data *hd = (struct httpd_data *) r->handle;
     ra->sd = NULL;
     free(ra->scratch);
     ra->scratch = NULL;
@@ -754,6 +755,10 @@ static void httpd_req_cleanup(httpd_req_t *r)
     r->handle = NULL;
     r->aux = NULL;
     r->user_ctx = NULL;
+
+    /* Only now the session is free to be changed by a worker the request
+     * was handed over to */
+    httpd_workers_send_pending(hd);
 }
 
 /* Function that processes incoming TCP data and
@@ -830,11 +835,10 @@ esp_err_t httpd_req_new(struct httpd_data *hd, struct sock_db *sd)
     return ret;
 }
 
-/* Function that resets the http request data
+/* Function that receives and discards the rest of the request body
  */
-esp_err_t httpd_req_delete(struct httpd_data *hd)
+esp_err_t httpd_req_purge(httpd_req_t *r)
 {
-    httpd_req_t *r = &hd->hd_req;
     struct httpd_req_aux *ra = r->aux;
 
     /* Finish off reading any pending/leftover data */
@@ -845,7 +849,6 @@ esp_err_t httpd_req_delete(struct httpd_data *hd)
         int recv_len = MIN(sizeof(dummy), ra->remaining_len);
         recv_len = httpd_req_recv(r, dummy, recv_len);
         if (recv_len <= 0) {
-            httpd_req_cleanup(r);
             return ESP_FAIL;
         }
 
@@ -860,9 +863,17 @@ esp_err_t httpd_req_delete(struct httpd_data *hd)
         ESP_LOGD(TAG, "===============================================");
 #endif
     }
+    return ESP_OK;
+}
 
+/* Function that resets the http request data
+ */
+esp_err_t httpd_req_delete(struct httpd_data *hd)
+{
+    httpd_req_t *r = &hd->hd_req;
+    esp_err_t ret = httpd_req_purge(r);
     httpd_req_cleanup(r);
-    return ESP_OK;
+    return ret;
 }
 
 /* Validates the request to prevent users from calling APIs, that are to
@@ -878,6 +889,10 @@ bool httpd_validate_req_ptr(httpd_req_t *r)
             if (httpd_os_thread_handle() == hd->hd_td.handle) {
                 return true;
             }
+            /* Asynchronous copies of requests are used by other tasks */
+            if (r != &hd->hd_req) {
+                return true;
+            }
         }
     }
     return false;
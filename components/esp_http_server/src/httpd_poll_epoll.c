@@ -0,0 +1,150 @@
+/*
+ * SPDX-FileCopyrightText: 2026 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdlib.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <esp_log.h>
+
+#include <esp_http_server.h>
+#include "esp_httpd_priv.h"
+
+static const char *TAG = "httpd_poll";
+
+/* Sockets are registered level-triggered, so a session whose request is
+ * only partially read keeps being reported. The listening and control
+ * sockets are told apart from sessions by the address of their descriptor
+ * in the server instance data. */
+struct httpd_poll {
+    int epfd;
+    bool listen;
+    int max_events;
+    struct epoll_event *events;
+    struct sock_db **ready;
+};
+
+static int epoll_update(struct httpd_poll *hp, int op, int fd, void *ptr)
+{
+    struct epoll_event ev = {
+        .events = EPOLLIN,
+        .data.ptr = ptr,
+    };
+    return epoll_ctl(hp->epfd, op, fd, &ev);
+}
+
+esp_err_t httpd_poll_init(struct httpd_data *hd)
+{
+    struct httpd_poll *hp = calloc(1, sizeof(struct httpd_poll));
+    if (!hp) {
+        return ESP_ERR_HTTPD_ALLOC_MEM;
+    }
+    esp_err_t ret = ESP_ERR_HTTPD_ALLOC_MEM;
+    hp->max_events = hd->config.max_open_sockets + 2;
+    hp->events = calloc(hp->max_events, sizeof(struct epoll_event));
+    hp->ready = calloc(hd->config.max_open_sockets, sizeof(struct sock_db *));
+    if (!hp->events || !hp->ready) {
+        goto err;
+    }
+    ret = ESP_FAIL;
+    hp->epfd = epoll_create1(EPOLL_CLOEXEC);
+    if (hp->epfd < 0) {
+        ESP_LOGE(TAG, LOG_FMT("error in epoll_create1 (%d)"), errno);
+        goto err;
+    }
+    if (epoll_update(hp, EPOLL_CTL_ADD, hd->ctrl_fd, &hd->ctrl_fd) < 0 ||
+        epoll_update(hp, EPOLL_CTL_ADD, hd->listen_fd, &hd->listen_fd) < 0) {
+        ESP_LOGE(TAG, LOG_FMT("error in epoll_ctl (%d)"), errno);
+        close(hp->epfd);
+        goto err;
+    }
+    hp->listen = true;
+    hd->hd_poll = hp;
+    return ESP_OK;
+
+err:
+    free(hp->events);
+    free(hp->ready);
+    free(hp);
+    return ret;
+}
+
+void httpd_poll_deinit(struct httpd_data *hd)
+{
+    if (hd->hd_poll) {
+        close(hd->hd_poll->epfd);
+        free(hd->hd_poll->events);
+        free(hd->hd_poll->ready);
+        free(hd->hd_poll);
+        hd->hd_poll = NULL;
+    }
+}
+
+esp_err_t httpd_poll_add(struct httpd_data *hd, struct sock_db *session)
+{
+    if (epoll_update(hd->hd_poll, EPOLL_CTL_ADD, session->fd, session) < 0) {
+        ESP_LOGE(TAG, LOG_FMT("error in epoll_ctl (%d)"), errno);
+        return ESP_FAIL;
+    }
+    return ESP_OK;
+}
+
+void httpd_poll_remove(struct httpd_data *hd, struct sock_db *session)
+{
+    /* Fails with ENOENT if the session is suspended or was never added */
+    epoll_ctl(hd->hd_poll->epfd, EPOLL_CTL_DEL, session->fd, NULL);
+}
+
+void httpd_poll_set_active(struct httpd_data *hd, struct sock_db *session, bool active)
+{
+    if (session->fd < 0) {
+        return;
+    }
+    if (active) {
+        epoll_update(hd->hd_poll, EPOLL_CTL_ADD, session->fd, session);
+    } else {
+        epoll_ctl(hd->hd_poll->epfd, EPOLL_CTL_DEL, session->fd, NULL);
+    }
+}
+
+void httpd_poll_set_listen(struct httpd_data *hd, bool enable)
+{
+    struct httpd_poll *hp = hd->hd_poll;
+    if (hp->listen == enable) {
+        return;
+    }
+    if (enable) {
+        epoll_update(hp, EPOLL_CTL_ADD, hd->listen_fd, &hd->listen_fd);
+    } else {
+        epoll_ctl(hp->epfd, EPOLL_CTL_DEL, hd->listen_fd, NULL);
+    }
+    hp->listen = enable;
+}
+
+int httpd_poll_wait(struct httpd_data *hd, int timeout_ms, struct httpd_poll_ready *ready)
+{
+    struct httpd_poll *hp = hd->hd_poll;
+    int active_cnt = epoll_wait(hp->epfd, hp->events, hp->max_events, timeout_ms);
+    if (active_cnt <= 0) {
+        return active_cnt;
+    }
+
+    ready->ctrl = false;
+    ready->listen = false;
+    ready->sess_count = 0;
+    ready->sessions = hp->ready;
+    for (int i = 0; i < active_cnt; i++) {
+        void *ptr = hp->events[i].data.ptr;
+        if (ptr == &hd->ctrl_fd) {
+            ready->ctrl = true;
+        } else if (ptr == &hd->listen_fd) {
+            ready->listen = true;
+        } else {
+            hp->ready[ready->sess_count++] = ptr;
+        }
+    }
+    return active_cnt;
+}
@@ -0,0 +1,109 @@
+/*
+ * SPDX-FileCopyrightText: 2026 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdlib.h>
+#include <poll.h>
+
+#include <esp_http_server.h>
+#include "esp_httpd_priv.h"
+
+/* Slots of the descriptor array. Session i of the socket database is kept
+ * at HTTPD_POLL_SESS_SLOT + i, unused slots hold a negative descriptor
+ * which poll() ignores. */
+#define HTTPD_POLL_CTRL_SLOT    0
+#define HTTPD_POLL_LISTEN_SLOT  1
+#define HTTPD_POLL_SESS_SLOT    2
+
+struct httpd_poll {
+    nfds_t nfds;
+    struct pollfd *fds;
+    struct sock_db **ready;
+};
+
+static inline struct pollfd *sess_slot(struct httpd_data *hd, struct sock_db *session)
+{
+    return &hd->hd_poll->fds[HTTPD_POLL_SESS_SLOT + (session - hd->hd_sd)];
+}
+
+esp_err_t httpd_poll_init(struct httpd_data *hd)
+{
+    struct httpd_poll *hp = calloc(1, sizeof(struct httpd_poll));
+    if (!hp) {
+        return ESP_ERR_HTTPD_ALLOC_MEM;
+    }
+    hp->nfds = HTTPD_POLL_SESS_SLOT + hd->config.max_open_sockets;
+    hp->fds = calloc(hp->nfds, sizeof(struct pollfd));
+    hp->ready = calloc(hd->config.max_open_sockets, sizeof(struct sock_db *));
+    if (!hp->fds || !hp->ready) {
+        free(hp->fds);
+        free(hp->ready);
+        free(hp);
+        return ESP_ERR_HTTPD_ALLOC_MEM;
+    }
+    for (nfds_t i = 0; i < hp->nfds; i++) {
+        hp->fds[i].fd = -1;
+        hp->fds[i].events = POLLIN;
+    }
+    hp->fds[HTTPD_POLL_CTRL_SLOT].fd = hd->ctrl_fd;
+    hp->fds[HTTPD_POLL_LISTEN_SLOT].fd = hd->listen_fd;
+    hd->hd_poll = hp;
+    return ESP_OK;
+}
+
+void httpd_poll_deinit(struct httpd_data *hd)
+{
+    if (hd->hd_poll) {
+        free(hd->hd_poll->fds);
+        free(hd->hd_poll->ready);
+        free(hd->hd_poll);
+        hd->hd_poll = NULL;
+    }
+}
+
+esp_err_t httpd_poll_add(struct httpd_data *hd, struct sock_db *session)
+{
+    sess_slot(hd, session)->fd = session->fd;
+    return ESP_OK;
+}
+
+void httpd_poll_remove(struct httpd_data *hd, struct sock_db *session)
+{
+    sess_slot(hd, session)->fd = -1;
+}
+
+void httpd_poll_set_active(struct httpd_data *hd, struct sock_db *session, bool active)
+{
+    sess_slot(hd, session)->fd = (active && session->fd >= 0) ? session->fd : -1;
+}
+
+void httpd_poll_set_listen(struct httpd_data *hd, bool enable)
+{
+    hd->hd_poll->fds[HTTPD_POLL_LISTEN_SLOT].fd = enable ? hd->listen_fd : -1;
+}
+
+int httpd_poll_wait(struct httpd_data *hd, int timeout_ms, struct httpd_poll_ready *ready)
+{
+    struct httpd_poll *hp = hd->hd_poll;
+    int active_cnt = poll(hp->fds, hp->nfds, timeout_ms);
+    if (active_cnt <= 0) {
+        return active_cnt;
+    }
+
+    ready->ctrl = hp->fds[HTTPD_POLL_CTRL_SLOT].revents != 0;
+    ready->listen = hp->fds[HTTPD_POLL_LISTEN_SLOT].revents != 0;
+    ready->sess_count = 0;
+    ready->sessions = hp->ready;
+    int remaining = active_cnt - ready->ctrl - ready->listen;
+    for (nfds_t i = HTTPD_POLL_SESS_SLOT; i < hp->nfds && remaining > 0; i++) {
+        if (hp->fds[i].revents) {
+            /* Errors and hang-ups are reported as well, so that the
+             * following recv() closes the session */
+            hp->ready[ready->sess_count++] = &hd->hd_sd[i - HTTPD_POLL_SESS_SLOT];
+            remaining--;
+        }
+    }
+    return active_cnt;
+}
@@ -0,0 +1,98 @@
+/*
+ * SPDX-FileCopyrightText: 2026 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdlib.h>
+#include <sys/select.h>
+#include <sys/param.h>
+
+#include <esp_http_server.h>
+#include "esp_httpd_priv.h"
+
+/* The descriptor set is rebuilt from the session database on every call to
+ * httpd_poll_wait(), so there is nothing to update when sessions change */
+struct httpd_poll {
+    bool listen;
+    struct sock_db **ready;
+};
+
+esp_err_t httpd_poll_init(struct httpd_data *hd)
+{
+    struct httpd_poll *hp = calloc(1, sizeof(struct httpd_poll));
+    if (!hp) {
+        return ESP_ERR_HTTPD_ALLOC_MEM;
+    }
+    hp->ready = calloc(hd->config.max_open_sockets, sizeof(struct sock_db *));
+    if (!hp->ready) {
+        free(hp);
+        return ESP_ERR_HTTPD_ALLOC_MEM;
+    }
+    hp->listen = true;
+    hd->hd_poll = hp;
+    return ESP_OK;
+}
+
+void httpd_poll_deinit(struct httpd_data *hd)
+{
+    if (hd->hd_poll) {
+        free(hd->hd_poll->ready);
+        free(hd->hd_poll);
+        hd->hd_poll = NULL;
+    }
+}
+
+esp_err_t httpd_poll_add(struct httpd_data *hd, struct sock_db *session)
+{
+    return ESP_OK;
+}
+
+void httpd_poll_remove(struct httpd_data *hd, struct sock_db *session)
+{
+}
+
+void httpd_poll_set_active(struct httpd_data *hd, struct sock_db *session, bool active)
+{
+}
+
+void httpd_poll_set_listen(struct httpd_data *hd, bool enable)
+{
+    hd->hd_poll->listen = enable;
+}
+
+int httpd_poll_wait(struct httpd_data *hd, int timeout_ms, struct httpd_poll_ready *ready)
+{
+    struct httpd_poll *hp = hd->hd_poll;
+    fd_set read_set;
+    FD_ZERO(&read_set);
+    if (hp->listen) {
+        FD_SET(hd->listen_fd, &read_set);
+    }
+    FD_SET(hd->ctrl_fd, &read_set);
+
+    int maxfd;
+    httpd_sess_set_descriptors(hd, &read_set, &maxfd);
+    maxfd = MAX(maxfd, MAX(hd->listen_fd, hd->ctrl_fd));
+
+    struct timeval tv = {
+        .tv_sec = timeout_ms / 1000,
+        .tv_usec = (timeout_ms % 1000) * 1000,
+    };
+    int active_cnt = select(maxfd + 1, &read_set, NULL, NULL, timeout_ms < 0 ? NULL : &tv);
+    if (active_cnt <= 0) {
+        return active_cnt;
+    }
+
+    ready->ctrl = FD_ISSET(hd->ctrl_fd, &read_set);
+    ready->listen = hp->listen && FD_ISSET(hd->listen_fd, &read_set);
+    ready->sess_count = 0;
+    ready->sessions = hp->ready;
+    for (int i = 0; i < hd->config.max_open_sockets; i++) {
+        struct sock_db *session = &hd->hd_sd[i];
+        if (session->fd >= 0 && !session->for_async_req && FD_ISSET(session->fd, &read_set)) {
+            hp->ready[ready->sess_count++] = session;
+        }
+    }
+    return active_cnt;
+}
@@ -210,6 +210,12 @@ esp_err_t httpd_sess_new(struct httpd_data *hd, int newfd)
     session->recv_fn = httpd_default_recv;
     session->lru_counter = hd->lru_counter;
 
+    if (httpd_poll_add(hd, session) != ESP_OK) {
+        // the caller closes the socket
+        session->fd = -1;
+        return ESP_FAIL;
+    }
+
     // increment number of sessions
     hd->hd_sd_active_count++;
 
@@ -370,6 +376,9 @@ void httpd_sess_delete(struct httpd_data *hd, struct sock_db *session)
         }
     }
 
+    // Stop watching the socket before it is closed
+    httpd_poll_remove(hd, session);
+
     // Call close function if defined
     if (hd->config.close_fn) {
         hd->config.close_fn(hd, session->fd);
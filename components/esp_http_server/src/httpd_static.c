@@ -0,0 +1,487 @@
+/*
+ * SPDX-FileCopyrightText: 2026 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <ctype.h>
+#include <inttypes.h>
+#include <limits.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <esp_log.h>
+
+#include <esp_http_server.h>
+#include "esp_httpd_priv.h"
+
+static const char *TAG = "httpd_static";
+
+/* File offsets the reads start at are aligned to this, so that filesystems
+ * like FAT can read whole sectors straight into the buffer */
+#define HTTPD_STATIC_READ_ALIGN     512
+
+#define HTTPD_STATIC_GZ_EXT         ".gz"
+
+/* Room for a quoted ETag made of two 32 bit hexadecimal numbers */
+#define HTTPD_STATIC_ETAG_LEN       (2 * 8 + 4)
+
+/* Room for "bytes <first>-<last>/<size>" */
+#define HTTPD_STATIC_RANGE_LEN      (6 + 3 * 20 + 2)
+
+static const struct {
+    const char *ext;
+    const char *type;
+} httpd_static_types[] = {
+    { ".html",  "text/html" },
+    { ".htm",   "text/html" },
+    { ".css",   "text/css" },
+    { ".js",    "application/javascript" },
+    { ".mjs",   "application/javascript" },
+    { ".json",  "application/json" },
+    { ".txt",   "text/plain" },
+    { ".xml",   "text/xml" },
+    { ".csv",   "text/csv" },
+    { ".svg",   "image/svg+xml" },
+    { ".png",   "image/png" },
+    { ".jpg",   "image/jpeg" },
+    { ".jpeg",  "image/jpeg" },
+    { ".gif",   "image/gif" },
+    { ".ico",   "image/x-icon" },
+    { ".webp",  "image/webp" },
+    { ".woff",  "font/woff" },
+    { ".woff2", "font/woff2" },
+    { ".ttf",   "font/ttf" },
+    { ".wasm",  "application/wasm" },
+    { ".pdf",   "application/pdf" },
+    { ".bin",   "application/octet-stream" },
+    { ".gz",    "application/gzip" },
+};
+
+/* The file being served, either from memory or from an open descriptor */
+struct httpd_static_src {
+    const char *data;               /* Content in memory, NULL if read from fd */
+    int fd;
+    size_t size;
+    char etag[HTTPD_STATIC_ETAG_LEN];
+};
+
+static const char *httpd_static_type(const char *path)
+{
+    const char *ext = strrchr(path, '.');
+    if (ext && !strchr(ext, '/')) {
+        for (size_t i = 0; i < sizeof(httpd_static_types) / sizeof(httpd_static_types[0]); i++) {
+            if (strcasecmp(ext, httpd_static_types[i].ext) == 0) {
+                return httpd_static_types[i].type;
+            }
+        }
+    }
+    return HTTPD_TYPE_OCTET;
+}
+
+static int httpd_static_hex(char c)
+{
+    if (c >= '0' && c <= '9') {
+        return c - '0';
+    }
+    c = tolower((unsigned char) c);
+    if (c >= 'a' && c <= 'f') {
+        return c - 'a' + 10;
+    }
+    return -1;
+}
+
+/* Writes the path part of the URI into path, percent-decoded. Fails if a
+ * segment of the decoded path is "..", or if it contains a NUL character. */
+static esp_err_t httpd_static_decode_path(const char *uri, size_t uri_len, char *path)
+{
+    size_t len = 0;
+    for (size_t i = 0; i < uri_len && uri[i] != '?' && uri[i] != '#'; i++) {
+        char c = uri[i];
+        if (c == '%' && i + 2 < uri_len && httpd_static_hex(uri[i + 1]) >= 0 && httpd_static_hex(uri[i + 2]) >= 0) {
+            c = (char) (httpd_static_hex(uri[i + 1]) << 4 | httpd_static_hex(uri[i + 2]));
+            i += 2;
+            if (c == '\0') {
+                return ESP_FAIL;
+            }
+        }
+        path[len++] = c;
+    }
+    path[len] = '\0';
+
+    for (const char *seg = path; seg; seg = strchr(seg, '/')) {
+        seg += (*seg == '/');
+        if (seg[0] == '.' && seg[1] == '.' && (seg[2] == '/' || seg[2] == '\0')) {
+            return ESP_FAIL;
+        }
+    }
+    return ESP_OK;
+}
+
+/* Returns a copy of the request header field, NULL if absent */
+static char *httpd_static_get_hdr(httpd_req_t *r, const char *field)
+{
+    size_t len = httpd_req_get_hdr_value_len(r, field);
+    if (len == 0) {
+        return NULL;
+    }
+    char *val = malloc(len + 1);
+    if (val && httpd_req_get_hdr_value_str(r, field, val, len + 1) != ESP_OK) {
+        free(val);
+        val = NULL;
+    }
+    return val;
+}
+
+/* Checks whether gzip is in the list of Accept-Encoding, with a non-zero quality */
+static bool httpd_static_accepts_gzip(const char *accept)
+{
+    while (accept && *accept) {
+        accept += strspn(accept, " \t,");
+        size_t len = strcspn(accept, " \t;,");
+        bool gzip = (len == 4 && strncasecmp(accept, "gzip", 4) == 0);
+        accept += len;
+
+        /* Parameters of this coding */
+        const char *end = accept + strcspn(accept, ",");
+        const char *q = accept;
+        while (gzip && (q = strchr(q, ';')) && q < end) {
+            q += 1 + strspn(q + 1, " \t");
+            if ((q[0] == 'q' || q[0] == 'Q') && q[1] == '=') {
+                gzip = strtod(q + 2, NULL) > 0;
+            }
+        }
+        if (gzip) {
+            return true;
+        }
+        accept = end;
+    }
+    return false;
+}
+
+/* Checks whether the entity tag is in the list of If-None-Match, using the
+ * weak comparison */
+static bool httpd_static_etag_matches(const char *list, const char *etag)
+{
+    if (etag[0] == '\0') {
+        return false;
+    }
+    while (*list) {
+        list += strspn(list, " \t,");
+        if (list[0] == '*') {
+            return true;
+        }
+        if (strncmp(list, "W/", 2) == 0) {
+            list += 2;
+        }
+        size_t len = strcspn(list, " \t,");
+        if (len == strlen(etag) && strncmp(list, etag, len) == 0) {
+            return true;
+        }
+        list += len;
+    }
+    return false;
+}
+
+/* Parses a Range header asking for a single range of a file of the given size.
+ * Returns ESP_OK with the first and last byte of the range, ESP_ERR_NOT_FOUND if
+ * the whole file is to be sent, or ESP_ERR_INVALID_SIZE if the range can't be
+ * satisfied. */
+static esp_err_t httpd_static_parse_range(const char *range, size_t size, size_t *first, size_t *last)
+{
+    if (strncasecmp(range, "bytes=", 6) != 0 || strchr(range, ',')) {
+        return ESP_ERR_NOT_FOUND;
+    }
+    range += 6 + strspn(range + 6, " \t");
+
+    char *end;
+    if (range[0] == '-') {
+        /* Suffix of the given length */
+        if (!isdigit((unsigned char) range[1])) {
+            return ESP_ERR_NOT_FOUND;
+        }
+        unsigned long long suffix = strtoull(range + 1, &end, 10);
+        if (*end != '\0' && !isspace((unsigned char) *end)) {
+            return ESP_ERR_NOT_FOUND;
+        }
+        if (suffix == 0 || size == 0) {
+            return ESP_ERR_INVALID_SIZE;
+        }
+        *first = (suffix < size) ? size - suffix : 0;
+        *last = size - 1;
+        return ESP_OK;
+    }
+
+    if (!isdigit((unsigned char) range[0])) {
+        return ESP_ERR_NOT_FOUND;
+    }
+    unsigned long long from = strtoull(range, &end, 10);
+    if (*end != '-') {
+        return ESP_ERR_NOT_FOUND;
+    }
+    unsigned long long to = ULLONG_MAX;
+    if (isdigit((unsigned char) end[1])) {
+        to = strtoull(end + 1, &end, 10);
+        if (to < from) {
+            return ESP_ERR_NOT_FOUND;
+        }
+    } else {
+        end++;
+    }
+    if (*end != '\0' && !isspace((unsigned char) *end)) {
+        return ESP_ERR_NOT_FOUND;
+    }
+    if (from >= size) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    *first = from;
+    *last = (to < size) ? to : size - 1;
+    return ESP_OK;
+}
+
+static const httpd_static_file_t *httpd_static_find_file(const httpd_static_config_t *config, const char *path)
+{
+    for (size_t i = 0; i < config->files_count; i++) {
+        if (strcmp(config->files[i].path, path) == 0) {
+            return &config->files[i];
+        }
+    }
+    return NULL;
+}
+
+/* Opens the file at path, below base_path for a file which isn't in memory.
+ * The buffer holding path has room for the ".gz" extension. */
+static esp_err_t httpd_static_open(const httpd_static_config_t *config, char *path, size_t base_len,
+                                   struct httpd_static_src *src)
+{
+    const httpd_static_file_t *file = httpd_static_find_file(config, path + base_len);
+    if (file) {
+        src->data = file->data;
+        src->size = file->size;
+        strlcpy(src->etag, file->etag ? file->etag : "", sizeof(src->etag));
+        return ESP_OK;
+    }
+    if (!config->base_path) {
+        return ESP_ERR_NOT_FOUND;
+    }
+
+    struct stat st;
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return ESP_ERR_NOT_FOUND;
+    }
+    if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode)) {
+        close(fd);
+        return ESP_ERR_NOT_FOUND;
+    }
+    src->data = NULL;
+    src->fd = fd;
+    src->size = st.st_size;
+    snprintf(src->etag, sizeof(src->etag), "\"%" PRIx32 "-%" PRIx32 "\"",
+             (uint32_t) st.st_mtime, (uint32_t) st.st_size);
+    return ESP_OK;
+}
+
+/* Sends the headers followed by len bytes of the file starting at offset */
+static esp_err_t httpd_static_send(httpd_req_t *r, const httpd_static_config_t *config,
+                                   struct httpd_static_src *src, size_t offset, size_t len,
+                                   size_t content_len)
+{
+    if (src->data || len == 0) {
+        return httpd_resp_send_hdrs(r, content_len, src->data ? src->data + offset : NULL, len);
+    }
+
+    size_t buf_size = (config->read_size + HTTPD_STATIC_READ_ALIGN - 1) & ~(HTTPD_STATIC_READ_ALIGN - 1);
+    if (buf_size == 0) {
+        buf_size = HTTPD_STATIC_READ_ALIGN;
+    }
+    char *buf = malloc(buf_size);
+    if (!buf) {
+        ESP_LOGE(TAG, LOG_FMT("failed to allocate read buffer"));
+        return httpd_resp_send_err(r, HTTPD_500_INTERNAL_SERVER_ERROR, NULL);
+    }
+
+    size_t pos = offset & ~(size_t) (HTTPD_STATIC_READ_ALIGN - 1);
+    size_t skip = offset - pos;
+    bool hdrs_sent = false;
+    esp_err_t ret = ESP_OK;
+
+    if (lseek(src->fd, pos, SEEK_SET) != (off_t) pos) {
+        ret = ESP_FAIL;
+    }
+    while (ret == ESP_OK && len > 0) {
+        size_t want = MIN(buf_size, skip + len);
+        size_t got = 0;
+        while (got < want) {
+            ssize_t n = read(src->fd, buf + got, want - got);
+            if (n <= 0) {
+                break;
+            }
+            got += n;
+        }
+        if (got <= skip) {
+            ESP_LOGW(TAG, LOG_FMT("failed to read file at offset %"NEWLIB_NANO_COMPAT_FORMAT),
+                     NEWLIB_NANO_COMPAT_CAST(pos));
+            ret = ESP_FAIL;
+            break;
+        }
+
+        size_t n = MIN(got - skip, len);
+        if (!hdrs_sent) {
+            ret = httpd_resp_send_hdrs(r, content_len, buf + skip, n);
+            hdrs_sent = true;
+        } else if (httpd_send_all(r, buf + skip, n) != ESP_OK) {
+            ret = ESP_ERR_HTTPD_RESP_SEND;
+        }
+        pos += got;
+        len -= n;
+        skip = 0;
+    }
+    free(buf);
+
+    if (ret == ESP_FAIL && !hdrs_sent) {
+        /* Nothing was sent yet, so the client can still be told */
+        return httpd_resp_send_err(r, HTTPD_500_INTERNAL_SERVER_ERROR, NULL);
+    }
+    return ret;
+}
+
+esp_err_t httpd_static_handler(httpd_req_t *r)
+{
+    if (r == NULL || r->user_ctx == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    const httpd_static_config_t *config = r->user_ctx;
+
+    if (r->method != HTTP_GET && r->method != HTTP_HEAD) {
+        return httpd_resp_send_err(r, HTTPD_405_METHOD_NOT_ALLOWED, NULL);
+    }
+
+    size_t prefix_len = config->uri_prefix ? strlen(config->uri_prefix) : 0;
+    if (strncmp(r->uri, config->uri_prefix ? config->uri_prefix : "", prefix_len) != 0) {
+        return httpd_resp_send_404(r);
+    }
+    const char *uri = r->uri + prefix_len;
+    size_t uri_len = strlen(uri);
+
+    /* Base path, '/', the decoded URI, the index file and the ".gz" extension */
+    size_t base_len = config->base_path ? strlen(config->base_path) : 0;
+    size_t index_len = config->index_file ? strlen(config->index_file) : 0;
+    char *path = malloc(base_len + 1 + uri_len + index_len + sizeof(HTTPD_STATIC_GZ_EXT));
+    if (!path) {
+        return httpd_resp_send_err(r, HTTPD_500_INTERNAL_SERVER_ERROR, NULL);
+    }
+    if (base_len) {
+        memcpy(path, config->base_path, base_len);
+    }
+    /* The URI prefix must be followed by a '/' or nothing */
+    char *rel = path + base_len;
+    rel[0] = '/';
+    if ((uri[0] != '/' && uri[0] != '\0' && uri[0] != '?' && uri[0] != '#') ||
+            httpd_static_decode_path(uri, uri_len, rel + (uri[0] != '/')) != ESP_OK) {
+        free(path);
+        return httpd_resp_send_404(r);
+    }
+    if (rel[strlen(rel) - 1] == '/' && config->index_file) {
+        strcat(rel, config->index_file);
+    }
+    const char *type = httpd_static_type(path + base_len);
+
+    /* The request headers are no longer available once the response is sent */
+    char *accept = httpd_static_get_hdr(r, "Accept-Encoding");
+    char *if_none_match = httpd_static_get_hdr(r, "If-None-Match");
+    char *range = httpd_static_get_hdr(r, "Range");
+
+    struct httpd_static_src src;
+    esp_err_t ret = ESP_ERR_NOT_FOUND;
+    bool gzip = false;
+    bool has_gzip = false;
+
+    /* The precompressed file is preferred if the client accepts it */
+    size_t path_len = strlen(path);
+    strcpy(path + path_len, HTTPD_STATIC_GZ_EXT);
+    if (httpd_static_open(config, path, base_len, &src) == ESP_OK) {
+        has_gzip = true;
+        if (httpd_static_accepts_gzip(accept)) {
+            gzip = true;
+            ret = ESP_OK;
+        } else if (!src.data) {
+            close(src.fd);
+        }
+    }
+    path[path_len] = '\0';
+    if (!gzip) {
+        ret = httpd_static_open(config, path, base_len, &src);
+    }
+    free(accept);
+
+    if (ret != ESP_OK) {
+        ESP_LOGD(TAG, LOG_FMT("not found: %s"), path);
+        free(path);
+        free(if_none_match);
+        free(range);
+        return httpd_resp_send_404(r);
+    }
+    ESP_LOGD(TAG, LOG_FMT("%s%s, %"NEWLIB_NANO_COMPAT_FORMAT" bytes"), path, gzip ? HTTPD_STATIC_GZ_EXT : "",
+             NEWLIB_NANO_COMPAT_CAST(src.size));
+    free(path);
+
+    httpd_resp_set_type(r, type);
+    if (src.etag[0]) {
+        httpd_resp_set_hdr(r, "ETag", src.etag);
+    }
+    if (config->cache_control) {
+        httpd_resp_set_hdr(r, "Cache-Control", config->cache_control);
+    }
+    if (has_gzip) {
+        httpd_resp_set_hdr(r, "Vary", "Accept-Encoding");
+    }
+    if (gzip) {
+        httpd_resp_set_hdr(r, "Content-Encoding", "gzip");
+    }
+
+    size_t first = 0;
+    size_t len = src.size;
+    char content_range[HTTPD_STATIC_RANGE_LEN];
+
+    if (if_none_match && httpd_static_etag_matches(if_none_match, src.etag)) {
+        /* The Content-Length is that of the content which would have been sent */
+        httpd_resp_set_status(r, HTTPD_304);
+        ret = httpd_resp_send_hdrs(r, src.size, NULL, 0);
+        goto out;
+    }
+
+    httpd_resp_set_hdr(r, "Accept-Ranges", "bytes");
+    if (range) {
+        size_t last;
+        esp_err_t err = httpd_static_parse_range(range, src.size, &first, &last);
+        if (err == ESP_ERR_INVALID_SIZE) {
+            snprintf(content_range, sizeof(content_range), "bytes */%"NEWLIB_NANO_COMPAT_FORMAT,
+                     NEWLIB_NANO_COMPAT_CAST(src.size));
+            httpd_resp_set_status(r, HTTPD_416);
+            httpd_resp_set_hdr(r, "Content-Range", content_range);
+            ret = httpd_resp_send_hdrs(r, 0, NULL, 0);
+            goto out;
+        }
+        if (err == ESP_OK) {
+            len = last - first + 1;
+            snprintf(content_range, sizeof(content_range), "bytes %"NEWLIB_NANO_COMPAT_FORMAT"-%"NEWLIB_NANO_COMPAT_FORMAT"/%"NEWLIB_NANO_COMPAT_FORMAT,
+                     NEWLIB_NANO_COMPAT_CAST(first), NEWLIB_NANO_COMPAT_CAST(last), NEWLIB_NANO_COMPAT_CAST(src.size));
+            httpd_resp_set_status(r, HTTPD_206);
+            httpd_resp_set_hdr(r, "Content-Range", content_range);
+        }
+    }
+
+    ret = httpd_static_send(r, config, &src, first, (r->method == HTTP_HEAD) ? 0 : len, len);
+
+out:
+    if (!src.data) {
+        close(src.fd);
+    }
+    free(if_none_match);
+    free(range);
+    return ret;
+}
@@ -1,5 +1,5 @@
 /*
- * SPDX-FileCopyrightText: 2018-2025 Espressif Systems (Shanghai) CO LTD
+ * SPDX-FileCopyrightText: 2018-2026 Espressif Systems (Shanghai) CO LTD
  *
  * SPDX-License-Identifier: Apache-2.0
  */
@@ -26,6 +26,16 @@ esp_err_t httpd_sess_set_send_override(httpd_handle_t hd, int sockfd, httpd_send
     return ESP_OK;
 }
 
+esp_err_t httpd_sess_set_sendv_override(httpd_handle_t hd, int sockfd, httpd_sendv_func_t sendv_func)
+{
+    struct sock_db *sess = httpd_sess_get(hd, sockfd);
+    if (!sess) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    sess->sendv_fn = sendv_func;
+    return ESP_OK;
+}
+
 esp_err_t httpd_sess_set_recv_override(httpd_handle_t hd, int sockfd, httpd_recv_func_t recv_func)
 {
     struct sock_db *sess = httpd_sess_get(hd, sockfd);
@@ -65,7 +75,7 @@ int httpd_send(httpd_req_t *r, const char *buf, size_t buf_len)
     return ret;
 }
 
-static esp_err_t httpd_send_all(httpd_req_t *r, const char *buf, size_t buf_len)
+esp_err_t httpd_send_all(httpd_req_t *r, const char *buf, size_t buf_len)
 {
     struct httpd_req_aux *ra = r->aux;
     int ret;
@@ -83,6 +93,48 @@ static esp_err_t httpd_send_all(httpd_req_t *r, const char *buf, size_t buf_len)
     return ESP_OK;
 }
 
+/* Sends all the buffers described by iov, the array is modified while sending */
+static esp_err_t httpd_send_all_iov(httpd_req_t *r, struct iovec *iov, int iovcnt)
+{
+    struct httpd_req_aux *ra = r->aux;
+    httpd_sendv_func_t sendv_fn = ra->sd->sendv_fn;
+
+    /* The socket is written directly only if the send function hasn't been overridden,
+     * otherwise the buffers are passed to the overridden function one by one */
+    if (!sendv_fn && ra->sd->send_fn == httpd_default_send) {
+        sendv_fn = httpd_default_sendv;
+    }
+    if (!sendv_fn) {
+        for (int i = 0; i < iovcnt; i++) {
+            if (httpd_send_all(r, iov[i].iov_base, iov[i].iov_len) != ESP_OK) {
+                return ESP_FAIL;
+            }
+        }
+        return ESP_OK;
+    }
+
+    while (iovcnt > 0) {
+        int ret = sendv_fn(ra->sd->handle, ra->sd->fd, iov, iovcnt, 0);
+        if (ret < 0) {
+            ESP_LOGD(TAG, LOG_FMT("error in sendv_fn"));
+            return ESP_FAIL;
+        }
+        ESP_LOGD(TAG, LOG_FMT("sent = %d"), ret);
+        /* Skip the buffers which have been sent completely */
+        size_t sent = ret;
+        while (iovcnt > 0 && sent >= iov->iov_len) {
+            sent -= iov->iov_len;
+            iov++;
+            iovcnt--;
+        }
+        if (iovcnt > 0) {
+            iov->iov_base = (char *) iov->iov_base + sent;
+            iov->iov_len -= sent;
+        }
+    }
+    return ESP_OK;
+}
+
 static size_t httpd_recv_pending(httpd_req_t *r, char *buf, size_t buf_len)
 {
     struct httpd_req_aux *ra = r->aux;
@@ -233,85 +285,94 @@ esp_err_t httpd_resp_set_type(httpd_req_t *r, const char *type)
     return ESP_OK;
 }
 
-esp_err_t httpd_resp_send(httpd_req_t *r, const char *buf, ssize_t buf_len)
+/* Number of buffers for each additional header: field, ": ", value and CRLF */
+#define HTTPD_RESP_HDR_IOVCNT   4
+
+/* Number of buffers besides the additional headers: status line, end of header section,
+ * chunk size, content and end of chunk */
+#define HTTPD_RESP_MAX_IOVCNT(hdrs_count)   (HTTPD_RESP_HDR_IOVCNT * (hdrs_count) + 5)
+
+static inline int httpd_iov_add(struct iovec *iov, int iovcnt, const char *buf, size_t buf_len)
 {
-    if (r == NULL) {
-        return ESP_ERR_INVALID_ARG;
+    if (buf_len > 0) {
+        iov[iovcnt].iov_base = (void *) buf;
+        iov[iovcnt].iov_len = buf_len;
+        iovcnt++;
     }
+    return iovcnt;
+}
 
-    if (!httpd_valid_req(r)) {
-        return ESP_ERR_HTTPD_INVALID_REQ;
+/* Adds the status line, the additional headers set with httpd_resp_set_hdr() and the
+ * end of the header section to iov, returns the new number of buffers */
+static int httpd_resp_hdrs_to_iov(struct httpd_req_aux *ra, const char *status_line, struct iovec *iov, int iovcnt)
+{
+    iovcnt = httpd_iov_add(iov, iovcnt, status_line, strlen(status_line));
+    for (unsigned i = 0; i < ra->resp_hdrs_count; i++) {
+        iovcnt = httpd_iov_add(iov, iovcnt, ra->resp_hdrs[i].field, strlen(ra->resp_hdrs[i].field));
+        iovcnt = httpd_iov_add(iov, iovcnt, ": ", 2);
+        iovcnt = httpd_iov_add(iov, iovcnt, ra->resp_hdrs[i].value, strlen(ra->resp_hdrs[i].value));
+        iovcnt = httpd_iov_add(iov, iovcnt, "\r\n", 2);
     }
+    return httpd_iov_add(iov, iovcnt, "\r\n", 2);
+}
 
-    struct httpd_req_aux *ra = r->aux;
-    const char *httpd_hdr_str = "HTTP/1.1 %s\r\nContent-Type: %s\r\nContent-Length: %d\r\n";
-    const char *colon_separator = ": ";
-    const char *cr_lf_seperator = "\r\n";
+/* Allocates a buffer for the formatted status line together with the array of buffers for the
+ * whole response, the status line starts right after the array */
+static struct iovec *httpd_resp_alloc_iov(struct httpd_req_aux *ra, size_t status_line_size)
+{
+    return malloc(HTTPD_RESP_MAX_IOVCNT(ra->resp_hdrs_count) * sizeof(struct iovec) + status_line_size);
+}
 
-    if (buf_len == HTTPD_RESP_USE_STRLEN) {
-        buf_len = strlen(buf);
-    }
+static inline char *httpd_resp_status_line(struct httpd_req_aux *ra, struct iovec *iov)
+{
+    return (char *) (iov + HTTPD_RESP_MAX_IOVCNT(ra->resp_hdrs_count));
+}
+
+esp_err_t httpd_resp_send_hdrs(httpd_req_t *r, size_t content_len, const char *buf, size_t buf_len)
+{
+    struct httpd_req_aux *ra = r->aux;
+    const char *httpd_hdr_str = "HTTP/1.1 %s\r\nContent-Type: %s\r\nContent-Length: %"NEWLIB_NANO_COMPAT_FORMAT"\r\n";
 
     /* Request headers are no longer available */
     ra->req_hdrs_count = 0;
 
     /* Calculate the size of the headers. +1 for the null terminator */
-    size_t required_size = snprintf(NULL, 0, httpd_hdr_str, ra->status, ra->content_type, buf_len) + 1;
+    size_t required_size = snprintf(NULL, 0, httpd_hdr_str, ra->status, ra->content_type,
+                                    NEWLIB_NANO_COMPAT_CAST(content_len)) + 1;
     if (required_size > ra->max_req_hdr_len) {
         return ESP_ERR_HTTPD_RESP_HDR;
     }
-    char *res_buf = malloc(required_size); /* Temporary buffer to store the headers */
-    if (res_buf == NULL) {
+    /* Temporary buffer to store the status line and the list of buffers making up the response */
+    struct iovec *iov = httpd_resp_alloc_iov(ra, required_size);
+    if (iov == NULL) {
         ESP_LOGE(TAG, "Unable to allocate httpd send buffer");
         return ESP_ERR_HTTPD_ALLOC_MEM;
     }
+    char *res_buf = httpd_resp_status_line(ra, iov);
 
-    esp_err_t ret = snprintf(res_buf, required_size, httpd_hdr_str, ra->status, ra->content_type, buf_len);
+    esp_err_t ret = snprintf(res_buf, required_size, httpd_hdr_str, ra->status, ra->content_type,
+                             NEWLIB_NANO_COMPAT_CAST(content_len));
     if (ret < 0 || ret >= required_size) {
-        free(res_buf);
+        free(iov);
         return ESP_ERR_HTTPD_RESP_HDR;
     }
     ESP_LOGD(TAG, "httpd send buffer size = %d", strlen(res_buf));
-    ret = httpd_send_all(r, res_buf, strlen(res_buf));
-    free(res_buf);
-    if (ret != ESP_OK) {
-        return ESP_ERR_HTTPD_RESP_SEND;
-    }
 
-    /* Sending additional headers based on set_header */
-    for (unsigned i = 0; i < ra->resp_hdrs_count; i++) {
-        /* Send header field */
-        if (httpd_send_all(r, ra->resp_hdrs[i].field, strlen(ra->resp_hdrs[i].field)) != ESP_OK) {
-            return ESP_ERR_HTTPD_RESP_SEND;
-        }
-        /* Send ': ' */
-        if (httpd_send_all(r, colon_separator, strlen(colon_separator)) != ESP_OK) {
-            return ESP_ERR_HTTPD_RESP_SEND;
-        }
-        /* Send header value */
-        if (httpd_send_all(r, ra->resp_hdrs[i].value, strlen(ra->resp_hdrs[i].value)) != ESP_OK) {
-            return ESP_ERR_HTTPD_RESP_SEND;
-        }
-        /* Send CR + LF */
-        if (httpd_send_all(r, cr_lf_seperator, strlen(cr_lf_seperator)) != ESP_OK) {
-            return ESP_ERR_HTTPD_RESP_SEND;
-        }
+    /* Status line, additional headers based on set_header and the content are sent at once */
+    int iovcnt = httpd_resp_hdrs_to_iov(ra, res_buf, iov, 0);
+    if (buf) {
+        iovcnt = httpd_iov_add(iov, iovcnt, buf, buf_len);
     }
-
-    /* End header section */
-    if (httpd_send_all(r, cr_lf_seperator, strlen(cr_lf_seperator)) != ESP_OK) {
+    ret = httpd_send_all_iov(r, iov, iovcnt);
+    free(iov);
+    if (ret != ESP_OK) {
         return ESP_ERR_HTTPD_RESP_SEND;
     }
+
     struct httpd_data *hd = (struct httpd_data *) r->handle;
     hd->http_server_state = HTTP_SERVER_EVENT_HEADERS_SENT;
     esp_http_server_dispatch_event(HTTP_SERVER_EVENT_HEADERS_SENT, &(ra->sd->fd), sizeof(int));
 
-    /* Sending content */
-    if (buf && buf_len) {
-        if (httpd_send_all(r, buf, buf_len) != ESP_OK) {
-            return ESP_ERR_HTTPD_RESP_SEND;
-        }
-    }
     esp_http_server_event_data evt_data = {
         .fd = ra->sd->fd,
         .data_len = buf_len,
@@ -321,6 +382,22 @@ esp_err_t httpd_resp_send(httpd_req_t *r, const char *buf, ssize_t buf_len)
     return ESP_OK;
 }
 
+esp_err_t httpd_resp_send(httpd_req_t *r, const char *buf, ssize_t buf_len)
+{
+    if (r == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    if (!httpd_valid_req(r)) {
+        return ESP_ERR_HTTPD_INVALID_REQ;
+    }
+
+    if (buf_len == HTTPD_RESP_USE_STRLEN) {
+        buf_len = strlen(buf);
+    }
+    return httpd_resp_send_hdrs(r, buf_len, buf, buf_len);
+}
+
 esp_err_t httpd_resp_send_chunk(httpd_req_t *r, const char *buf, ssize_t buf_len)
 {
     if (r == NULL) {
@@ -338,80 +415,57 @@ esp_err_t httpd_resp_send_chunk(httpd_req_t *r, const char *buf, ssize_t buf_len
     struct httpd_req_aux *ra = r->aux;
     struct httpd_data *hd = (struct httpd_data *) r->handle;
     const char *httpd_chunked_hdr_str = "HTTP/1.1 %s\r\nContent-Type: %s\r\nTransfer-Encoding: chunked\r\n";
-    const char *colon_separator = ": ";
-    const char *cr_lf_seperator = "\r\n";
 
     /* Request headers are no longer available */
     ra->req_hdrs_count = 0;
 
+    /* Buffers for a chunk following the first one: chunk size, content and end of chunk */
+    struct iovec chunk_iov[3];
+    struct iovec *iov = chunk_iov;
+    int iovcnt = 0;
+
     if (!ra->first_chunk_sent) {
         /* Calculate the size of the headers. +1 for the null terminator */
         size_t required_size = snprintf(NULL, 0, httpd_chunked_hdr_str, ra->status, ra->content_type) + 1;
         if (required_size > ra->max_req_hdr_len) {
             return ESP_ERR_HTTPD_RESP_HDR;
         }
-        char *res_buf = malloc(required_size); /* Temporary buffer to store the headers */
-        if (res_buf == NULL) {
+        /* Temporary buffer to store the status line and the list of buffers making up the response */
+        iov = httpd_resp_alloc_iov(ra, required_size);
+        if (iov == NULL) {
             ESP_LOGE(TAG, "Unable to allocate httpd send chunk buffer");
             return ESP_ERR_HTTPD_ALLOC_MEM;
         }
+        char *res_buf = httpd_resp_status_line(ra, iov);
         esp_err_t ret = snprintf(res_buf, required_size, httpd_chunked_hdr_str, ra->status, ra->content_type);
         if (ret < 0 || ret >= required_size) {
-            free(res_buf);
+            free(iov);
             return ESP_ERR_HTTPD_RESP_HDR;
         }
         ESP_LOGD(TAG, "httpd send chunk buffer size = %d", strlen(res_buf));
-        /* Size of essential headers is limited by scratch buffer size */
-        ret = httpd_send_all(r, res_buf, strlen(res_buf));
-        free(res_buf);
-        if (ret != ESP_OK) {
-            return ESP_ERR_HTTPD_RESP_SEND;
-        }
-
-        /* Sending additional headers based on set_header */
-        for (unsigned i = 0; i < ra->resp_hdrs_count; i++) {
-            /* Send header field */
-            if (httpd_send_all(r, ra->resp_hdrs[i].field, strlen(ra->resp_hdrs[i].field)) != ESP_OK) {
-                return ESP_ERR_HTTPD_RESP_SEND;
-            }
-            /* Send ': ' */
-            if (httpd_send_all(r, colon_separator, strlen(colon_separator)) != ESP_OK) {
-                return ESP_ERR_HTTPD_RESP_SEND;
-            }
-            /* Send header value */
-            if (httpd_send_all(r, ra->resp_hdrs[i].value, strlen(ra->resp_hdrs[i].value)) != ESP_OK) {
-                return ESP_ERR_HTTPD_RESP_SEND;
-            }
-            /* Send CR + LF */
-            if (httpd_send_all(r, cr_lf_seperator, strlen(cr_lf_seperator)) != ESP_OK) {
-                return ESP_ERR_HTTPD_RESP_SEND;
-            }
-        }
-
-        /* End header section */
-        if (httpd_send_all(r, cr_lf_seperator, strlen(cr_lf_seperator)) != ESP_OK) {
-            return ESP_ERR_HTTPD_RESP_SEND;
-        }
-        ra->first_chunk_sent = true;
+        /* Status line and additional headers based on set_header go out together with the first chunk */
+        iovcnt = httpd_resp_hdrs_to_iov(ra, res_buf, iov, iovcnt);
     }
 
-    /* Sending chunked content */
+    /* Chunked content */
     char len_str[10];
     snprintf(len_str, sizeof(len_str), "%lx\r\n", (long)buf_len);
-    if (httpd_send_all(r, len_str, strlen(len_str)) != ESP_OK) {
-        return ESP_ERR_HTTPD_RESP_SEND;
-    }
-
+    iovcnt = httpd_iov_add(iov, iovcnt, len_str, strlen(len_str));
     if (buf) {
-        if (httpd_send_all(r, buf, (size_t) buf_len) != ESP_OK) {
-            return ESP_ERR_HTTPD_RESP_SEND;
-        }
+        iovcnt = httpd_iov_add(iov, iovcnt, buf, (size_t) buf_len);
     }
-
     /* Indicate end of chunk */
-    if (httpd_send_all(r, "\r\n", strlen("\r\n")) != ESP_OK) {
+    iovcnt = httpd_iov_add(iov, iovcnt, "\r\n", 2);
+
+    esp_err_t ret = httpd_send_all_iov(r, iov, iovcnt);
+    if (iov != chunk_iov) {
+        free(iov);
+    }
+    if (ret != ESP_OK) {
         return ESP_ERR_HTTPD_RESP_SEND;
     }
+    ra->first_chunk_sent = true;
+
     esp_http_server_event_data evt_data = {
         .fd = ra->sd->fd,
         .data_len = buf_len,
@@ -682,18 +736,38 @@ esp_err_t httpd_req_async_handler_begin(httpd_req_t *r, httpd_req_t **out)
         return ESP_ERR_NO_MEM;
     }
     memcpy(async_aux->resp_hdrs, r_aux->resp_hdrs, hd->config.max_resp_headers * sizeof(struct resp_hdr));
+    async_aux->worker_resume = false;
 
     // Prevent the main thread from reading the rest of the request after the handler returns.
     r_aux->remaining_len = 0;
 
-    // mark socket as "in use"
-    r_aux->sd->for_async_req = true;
+    if (r_aux->worker_resume) {
+        // Called by a handler running on a worker, the session is already suspended.
+        // The new copy takes over resuming it, once completed.
+        r_aux->worker_resume = false;
+    } else {
+        // mark socket as "in use"
+        r_aux->sd->for_async_req = true;
+        httpd_poll_set_active(hd, r_aux->sd, false);
+    }
 
     *out = async;
 
     return ESP_OK;
 }
 
+void httpd_req_async_free(httpd_req_t *r)
+{
+    struct httpd_req_aux *ra = r->aux;
+    free(ra->scratch);
+    ra->scratch = NULL;
+    ra->scratch_cur_size = 0;
+    ra->scratch_size_limit = 0;
+    free(ra->resp_hdrs);
+    free(r->aux);
+    free(r);
+}
+
 esp_err_t httpd_req_async_handler_complete(httpd_req_t *r)
 {
     if (r == NULL) {
@@ -707,17 +781,12 @@ esp_err_t httpd_req_async_handler_complete(httpd_req_t *r)
 
     struct httpd_req_aux *ra = r->aux;
     ra->sd->for_async_req = false;
-    free(ra->scratch);
-    ra->scratch = NULL;
-    ra->scratch_cur_size = 0;
-    ra->scratch_size_limit = 0;
-    free(ra->resp_hdrs);
-    free(r->aux);
-    free(r);
+    httpd_poll_set_active(hd, ra->sd, true);
+    httpd_req_async_free(r);
 
-    // Send a dummy control message(httpd_ctrl_data) to unblock the main HTTP server task from the select() call.
+    // Send a dummy control message(httpd_ctrl_data) to unblock the main HTTP server task from waiting on sockets.
     // Since the current connection FD was marked as inactive for async requests, the main task
-    // will now re-add this FD to its select() descriptor list. This ensures that subsequent requests
+    // will now watch this FD again. This ensures that subsequent requests
     // on the same FD are processed correctly
     struct httpd_ctrl_data msg = {.hc_msg = HTTPD_CTRL_MAX};
     int ret = cs_send_to_ctrl_sock(msg_fd, port, &msg, sizeof(msg));
@@ -781,6 +850,24 @@ int httpd_default_send(httpd_handle_t hd, int sockfd, const char *buf, size_t bu
     return ret;
 }
 
+int httpd_default_sendv(httpd_handle_t hd, int sockfd, const struct iovec *iov, int iovcnt, int flags)
+{
+    (void)hd;
+    if (iov == NULL) {
+        return HTTPD_SOCK_ERR_INVALID;
+    }
+
+    struct msghdr msg = {
+        .msg_iov = (struct iovec *) iov,
+        .msg_iovlen = iovcnt,
+    };
+    int ret = sendmsg(sockfd, &msg, flags);
+    if (ret < 0) {
+        return httpd_sock_err("sendmsg", sockfd);
+    }
+    return ret;
+}
+
 int httpd_default_recv(httpd_handle_t hd, int sockfd, char *buf, size_t buf_len, int flags)
 {
     (void)hd;
@@ -12,6 +12,9 @@
 
 #include <esp_http_server.h>
 #include "esp_httpd_priv.h"
+#if CONFIG_HTTPD_URI_TREE
+#include "uri_tree.h"
+#endif
 
 static const char *TAG = "httpd_uri";
 
@@ -80,6 +83,44 @@ bool httpd_uri_match_wildcard(const char *template, const char *uri, size_t len)
     }
 }
 
+#if CONFIG_HTTPD_URI_TREE
+/* Build the tree of URI handlers from scratch. The tree is only used with
+ * the matching functions it knows about, else and if memory runs out the
+ * handlers are scanned one by one in httpd_find_uri_handler() */
+static void httpd_uri_tree_rebuild(struct httpd_data *hd)
+{
+    httpd_uri_tree_delete(hd->hd_uri_tree);
+    hd->hd_uri_tree = NULL;
+
+    bool wildcard = (hd->config.uri_match_fn == httpd_uri_match_wildcard);
+    if (hd->config.uri_match_fn && !wildcard) {
+        return;
+    }
+
+    httpd_uri_tree_t *tree = httpd_uri_tree_create(wildcard);
+    if (!tree) {
+        ESP_LOGW(TAG, LOG_FMT("no memory for URI tree, using linear lookup"));
+        return;
+    }
+    for (int i = 0; i < hd->config.max_uri_handlers && hd->hd_calls[i]; i++) {
+        if (httpd_uri_tree_insert(tree, hd->hd_calls[i], i) != ESP_OK) {
+            ESP_LOGW(TAG, LOG_FMT("no memory for URI tree, using linear lookup"));
+            httpd_uri_tree_delete(tree);
+            return;
+        }
+    }
+    hd->hd_uri_tree = tree;
+}
+
+/* Add a newly registered handler to the tree */
+static void httpd_uri_tree_add(struct httpd_data *hd, int index)
+{
+    if (!hd->hd_uri_tree || httpd_uri_tree_insert(hd->hd_uri_tree, hd->hd_calls[index], index) != ESP_OK) {
+        httpd_uri_tree_rebuild(hd);
+    }
+}
+#endif /* CONFIG_HTTPD_URI_TREE */
+
 /* Find handler with matching URI and method, and set
  * appropriate error code if URI or method not found */
 static httpd_uri_t* httpd_find_uri_handler(struct httpd_data *hd,
@@ -87,6 +128,12 @@ static httpd_uri_t* httpd_find_uri_handler(struct httpd_data *hd,
                                            httpd_method_t method,
                                            httpd_err_code_t *err)
 {
+#if CONFIG_HTTPD_URI_TREE
+    if (hd->hd_uri_tree) {
+        return httpd_uri_tree_find(hd->hd_uri_tree, uri, uri_len, method, err);
+    }
+#endif
+
     if (err) {
         *err = HTTPD_404_NOT_FOUND;
     }
@@ -186,6 +233,9 @@ esp_err_t httpd_register_uri_handler(httpd_handle_t handle,
             } else {
                 hd->hd_calls[i]->supported_subprotocol = NULL;
             }
+#endif
+#if CONFIG_HTTPD_URI_TREE
+            httpd_uri_tree_add(hd, i);
 #endif
             ESP_LOGD(TAG, LOG_FMT("[%d] installed %s"), i, uri_handler->uri);
             return ESP_OK;
@@ -226,6 +276,9 @@ esp_err_t httpd_unregister_uri_handler(httpd_handle_t handle,
             }
             /* Nullify the following non null entry */
             hd->hd_calls[i-1] = NULL;
+#if CONFIG_HTTPD_URI_TREE
+            httpd_uri_tree_rebuild(hd);
+#endif
             return ESP_OK;
         }
     }
@@ -269,12 +322,20 @@ esp_err_t httpd_unregister_uri(httpd_handle_t handle, const char *uri)
 
     if (!found) {
         ESP_LOGW(TAG, LOG_FMT("no handler found for URI %s"), uri);
+        return ESP_ERR_NOT_FOUND;
     }
-    return (found ? ESP_OK : ESP_ERR_NOT_FOUND);
+#if CONFIG_HTTPD_URI_TREE
+    httpd_uri_tree_rebuild(hd);
+#endif
+    return ESP_OK;
 }
 
 void httpd_unregister_all_uri_handlers(struct httpd_data *hd)
 {
+#if CONFIG_HTTPD_URI_TREE
+    httpd_uri_tree_delete(hd->hd_uri_tree);
+    hd->hd_uri_tree = NULL;
+#endif
     for (unsigned i = 0; i < hd->config.max_uri_handlers; i++) {
         if (!hd->hd_calls[i]) {
             break;
@@ -354,6 +415,11 @@ esp_err_t httpd_uri(struct httpd_data *hd)
         return ESP_OK;
     }
 #endif /* CONFIG_HTTPD_WS_SUPPORT */
+    /* Hand the request over to a worker, if there are any */
+    if (hd->hd_workers && httpd_workers_dispatch(req, uri->handler) == ESP_OK) {
+        return ESP_OK;
+    }
+
     /* Invoke handler */
     if (uri->handler(req) != ESP_OK) {
         /* Handler returns error, this socket should be closed */
@@ -0,0 +1,193 @@
+/*
+ * SPDX-FileCopyrightText: 2026 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdlib.h>
+#include <esp_log.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
+#include <freertos/semphr.h>
+
+#include <esp_http_server.h>
+#include "esp_httpd_priv.h"
+
+static const char *TAG = "httpd_worker";
+
+/* A request handed over to the workers. A job without request tells the
+ * worker taking it to exit. */
+struct httpd_worker_job {
+    httpd_req_t *req;
+    esp_err_t (*handler)(httpd_req_t *r);
+    void *sess_ctx;                 /* Session context when the request was handed over */
+};
+
+struct httpd_workers {
+    QueueHandle_t jobs;
+    SemaphoreHandle_t exited;       /* Given by each worker when it exits */
+    uint16_t count;                 /* Number of workers running */
+    struct httpd_worker_job pending;    /* Handed over by the current request, not queued yet */
+};
+
+/* Stores the session context of the request like httpd_req_delete() does.
+ * The server task is done with the session before the job is queued, and
+ * leaves it alone while it is suspended. */
+static void httpd_worker_store_sess_ctx(const struct httpd_worker_job *job, struct sock_db *sd)
+{
+    httpd_req_t *r = job->req;
+
+    /* The handler may also have set the context with httpd_sess_set_ctx(),
+     * which changes the session directly */
+    if (r->sess_ctx != job->sess_ctx) {
+        if ((r->ignore_sess_ctx_changes == false) && (sd->ctx != r->sess_ctx)) {
+            httpd_sess_free_ctx(&sd->ctx, sd->free_ctx);
+        }
+        sd->ctx = r->sess_ctx;
+        sd->free_ctx = r->free_ctx;
+    }
+    sd->ignore_sess_ctx_changes = r->ignore_sess_ctx_changes;
+}
+
+static void httpd_worker_run(struct httpd_data *hd, const struct httpd_worker_job *job)
+{
+    httpd_req_t *r = job->req;
+    struct httpd_req_aux *ra = r->aux;
+    struct sock_db *sd = ra->sd;
+
+    esp_err_t ret = job->handler(r);
+    if (ret != ESP_OK) {
+        ESP_LOGW(TAG, LOG_FMT("uri handler execution failed"));
+    }
+
+    if (!ra->worker_resume) {
+        /* The handler made its own asynchronous copy of the request, which
+         * resumes the session when completed */
+        httpd_req_async_free(r);
+        return;
+    }
+
+    if (ret == ESP_OK) {
+        ret = httpd_req_purge(r);
+    }
+    httpd_worker_store_sess_ctx(job, sd);
+
+    /* As on the server task, the session is closed if the handler failed.
+     * It stays suspended until the server task closes it. */
+    if (ret != ESP_OK && httpd_sess_trigger_close_(hd, sd) == ESP_OK) {
+        httpd_req_async_free(r);
+        return;
+    }
+    httpd_req_async_handler_complete(r);
+}
+
+static void httpd_worker_thread(void *arg)
+{
+    struct httpd_data *hd = (struct httpd_data *) arg;
+    struct httpd_workers *hw = hd->hd_workers;
+    struct httpd_worker_job job;
+
+    while (xQueueReceive(hw->jobs, &job, portMAX_DELAY) == pdTRUE && job.req) {
+        httpd_worker_run(hd, &job);
+    }
+
+    xSemaphoreGive(hw->exited);
+    httpd_os_thread_delete();
+}
+
+esp_err_t httpd_workers_start(struct httpd_data *hd)
+{
+    if (hd->config.worker_count == 0) {
+        return ESP_OK;
+    }
+
+    struct httpd_workers *hw = calloc(1, sizeof(struct httpd_workers));
+    if (!hw) {
+        return ESP_ERR_HTTPD_ALLOC_MEM;
+    }
+    /* Each session has at most one request handed over, so sending a job never blocks */
+    hw->jobs = xQueueCreate(hd->config.max_open_sockets + hd->config.worker_count, sizeof(struct httpd_worker_job));
+    hw->exited = xSemaphoreCreateCounting(hd->config.worker_count, 0);
+    if (!hw->jobs || !hw->exited) {
+        if (hw->jobs) {
+            vQueueDelete(hw->jobs);
+        }
+        if (hw->exited) {
+            vSemaphoreDelete(hw->exited);
+        }
+        free(hw);
+        return ESP_ERR_HTTPD_ALLOC_MEM;
+    }
+    hd->hd_workers = hw;
+
+    for (int i = 0; i < hd->config.worker_count; i++) {
+        othread_t handle;
+        if (httpd_os_thread_create(&handle, "httpd_worker",
+                                   hd->config.worker_stack_size,
+                                   hd->config.task_priority,
+                                   httpd_worker_thread, hd,
+                                   hd->config.core_id,
+                                   hd->config.task_caps) != ESP_OK) {
+            ESP_LOGE(TAG, LOG_FMT("failed to launch worker %d"), i);
+            httpd_workers_stop(hd);
+            return ESP_ERR_HTTPD_TASK;
+        }
+        hw->count++;
+    }
+    ESP_LOGD(TAG, LOG_FMT("%d workers started"), hw->count);
+    return ESP_OK;
+}
+
+void httpd_workers_stop(struct httpd_data *hd)
+{
+    struct httpd_workers *hw = hd->hd_workers;
+    if (!hw) {
+        return;
+    }
+
+    /* The exit jobs are queued behind the requests still waiting for a worker */
+    struct httpd_worker_job job = { .req = NULL };
+    for (int i = 0; i < hw->count; i++) {
+        xQueueSend(hw->jobs, &job, portMAX_DELAY);
+    }
+    for (int i = 0; i < hw->count; i++) {
+        xSemaphoreTake(hw->exited, portMAX_DELAY);
+    }
+
+    vQueueDelete(hw->jobs);
+    vSemaphoreDelete(hw->exited);
+    free(hw);
+    hd->hd_workers = NULL;
+}
+
+esp_err_t httpd_workers_dispatch(httpd_req_t *r, esp_err_t (*handler)(httpd_req_t *r))
+{
+    struct httpd_data *hd = (struct httpd_data *) r->handle;
+    struct httpd_worker_job job = {
+        .handler = handler,
+        .sess_ctx = r->sess_ctx,
+    };
+
+    /* Suspends the session until the worker is done with the copy */
+    esp_err_t ret = httpd_req_async_handler_begin(r, &job.req);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    struct httpd_req_aux *ra = job.req->aux;
+    ra->worker_resume = true;
+
+    /* The server task still stores the session context of its own request,
+     * the job is queued once that is done */
+    hd->hd_workers->pending = job;
+    return ESP_OK;
+}
+
+void httpd_workers_send_pending(struct httpd_data *hd)
+{
+    struct httpd_workers *hw = hd->hd_workers;
+    if (!hw || !hw->pending.req) {
+        return;
+    }
+    xQueueSend(hw->jobs, &hw->pending, portMAX_DELAY);
+    hw->pending.req = NULL;
+}
@@ -0,0 +1,285 @@
+/*
+ * SPDX-FileCopyrightText: 2026 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+
+#include "uri_tree.h"
+
+/* A template is reduced to one or two routes, each of which either matches
+ * one URI exactly or all URIs starting with a prefix. Every route ends at a
+ * node of the tree, the routes of a node are kept in registration order. */
+typedef struct {
+    httpd_uri_t *handler;
+    int order;
+    bool prefix;
+} uri_route_t;
+
+typedef struct uri_node {
+    struct uri_node **children;     /* Sorted by the first character of their label */
+    uri_route_t *routes;
+    unsigned short child_count;
+    unsigned short route_count;
+    unsigned short label_len;
+    char label[];                   /* Characters on the edge from the parent */
+} uri_node_t;
+
+struct httpd_uri_tree {
+    uri_node_t *root;
+    bool wildcard;
+};
+
+static uri_node_t *node_new(const char *label, size_t label_len)
+{
+    if (label_len > USHRT_MAX) {
+        return NULL;
+    }
+    uri_node_t *node = calloc(1, sizeof(uri_node_t) + label_len);
+    if (node && label_len) {
+        memcpy(node->label, label, label_len);
+        node->label_len = label_len;
+    }
+    return node;
+}
+
+static void node_free(uri_node_t *node)
+{
+    for (int i = 0; i < node->child_count; i++) {
+        node_free(node->children[i]);
+    }
+    free(node->children);
+    free(node->routes);
+    free(node);
+}
+
+/* Returns the index of the child whose label starts with c, or the
+ * negative (index + 1) at which such a child would be inserted */
+static int node_child_index(const uri_node_t *node, char c)
+{
+    int lo = 0;
+    int hi = node->child_count;
+    while (lo < hi) {
+        int mid = (lo + hi) / 2;
+        char m = node->children[mid]->label[0];
+        if (m == c) {
+            return mid;
+        }
+        if ((unsigned char) m < (unsigned char) c) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return -(lo + 1);
+}
+
+static esp_err_t node_add_child(uri_node_t *node, int index, uri_node_t *child)
+{
+    if (node->child_count == USHRT_MAX) {
+        return ESP_ERR_NO_MEM;
+    }
+    uri_node_t **children = realloc(node->children, (node->child_count + 1) * sizeof(uri_node_t *));
+    if (!children) {
+        return ESP_ERR_NO_MEM;
+    }
+    memmove(&children[index + 1], &children[index], (node->child_count - index) * sizeof(uri_node_t *));
+    children[index] = child;
+    node->children = children;
+    node->child_count++;
+    return ESP_OK;
+}
+
+static esp_err_t node_add_route(uri_node_t *node, const uri_route_t *route)
+{
+    if (node->route_count == USHRT_MAX) {
+        return ESP_ERR_NO_MEM;
+    }
+    uri_route_t *routes = realloc(node->routes, (node->route_count + 1) * sizeof(uri_route_t));
+    if (!routes) {
+        return ESP_ERR_NO_MEM;
+    }
+    /* Handlers are usually added in registration order, so this is an append */
+    int i = node->route_count;
+    while (i > 0 && routes[i - 1].order > route->order) {
+        routes[i] = routes[i - 1];
+        i--;
+    }
+    routes[i] = *route;
+    node->routes = routes;
+    node->route_count++;
+    return ESP_OK;
+}
+
+static esp_err_t tree_add_route(httpd_uri_tree_t *tree, const char *key, size_t key_len, const uri_route_t *route)
+{
+    uri_node_t *node = tree->root;
+    size_t pos = 0;
+
+    while (pos < key_len) {
+        int index = node_child_index(node, key[pos]);
+        if (index < 0) {
+            /* No common prefix with any child, add the rest of the key as a leaf */
+            uri_node_t *leaf = node_new(key + pos, key_len - pos);
+            if (!leaf) {
+                return ESP_ERR_NO_MEM;
+            }
+            if (node_add_route(leaf, route) != ESP_OK || node_add_child(node, -index - 1, leaf) != ESP_OK) {
+                node_free(leaf);
+                return ESP_ERR_NO_MEM;
+            }
+            return ESP_OK;
+        }
+
+        uri_node_t *child = node->children[index];
+        size_t common = 1;
+        while (common < child->label_len && pos + common < key_len &&
+               child->label[common] == key[pos + common]) {
+            common++;
+        }
+        if (common < child->label_len) {
+            /* The key ends or diverges inside the label, split the edge */
+            uri_node_t *mid = node_new(child->label, common);
+            if (!mid) {
+                return ESP_ERR_NO_MEM;
+            }
+            mid->children = malloc(sizeof(uri_node_t *));
+            if (!mid->children) {
+                free(mid);
+                return ESP_ERR_NO_MEM;
+            }
+            child->label_len -= common;
+            memmove(child->label, child->label + common, child->label_len);
+            mid->children[0] = child;
+            mid->child_count = 1;
+            node->children[index] = mid;
+            child = mid;
+        }
+        node = child;
+        pos += common;
+    }
+    return node_add_route(node, route);
+}
+
+httpd_uri_tree_t *httpd_uri_tree_create(bool wildcard)
+{
+    httpd_uri_tree_t *tree = calloc(1, sizeof(httpd_uri_tree_t));
+    if (!tree) {
+        return NULL;
+    }
+    tree->root = node_new(NULL, 0);
+    if (!tree->root) {
+        free(tree);
+        return NULL;
+    }
+    tree->wildcard = wildcard;
+    return tree;
+}
+
+void httpd_uri_tree_delete(httpd_uri_tree_t *tree)
+{
+    if (tree) {
+        node_free(tree->root);
+        free(tree);
+    }
+}
+
+esp_err_t httpd_uri_tree_insert(httpd_uri_tree_t *tree, httpd_uri_t *handler, int order)
+{
+    const char *template = handler->uri;
+    size_t len = strlen(template);
+    uri_route_t route = {
+        .handler = handler,
+        .order = order,
+        .prefix = false,
+    };
+
+    if (!tree->wildcard) {
+        return tree_add_route(tree, template, len, &route);
+    }
+
+    /* Trailing '*' and '?' as interpreted by httpd_uri_match_wildcard() */
+    const char last = len > 0 ? template[len - 1] : 0;
+    const char prevlast = len > 1 ? template[len - 2] : 0;
+    const bool asterisk = last == '*' || (prevlast == '*' && last == '?');
+    const bool quest = last == '?' || (prevlast == '?' && last == '*');
+    const size_t specials = asterisk + quest * 2;
+
+    if (len < specials) {
+        /* Invalid template such as "?", never matches */
+        return ESP_OK;
+    }
+    len -= specials;
+
+    if (!quest) {
+        /* "/path" matches "/path", "/path*" any URI starting with "/path" */
+        route.prefix = asterisk;
+        return tree_add_route(tree, template, len, &route);
+    }
+
+    /* "/path/?" matches "/path" and "/path/", "/path/?*" matches "/path"
+     * and any URI starting with "/path/" */
+    esp_err_t ret = tree_add_route(tree, template, len, &route);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    route.prefix = asterisk;
+    return tree_add_route(tree, template, len + 1, &route);
+}
+
+/* Considers the routes ending at a node on the path of the URI */
+static void node_match(const uri_node_t *node, bool uri_end, httpd_method_t method,
+                       httpd_uri_t **best, int *best_order, bool *uri_found)
+{
+    for (int i = 0; i < node->route_count; i++) {
+        const uri_route_t *route = &node->routes[i];
+        if (!route->prefix && !uri_end) {
+            continue;
+        }
+        *uri_found = true;
+        if (route->order >= *best_order) {
+            /* Routes are in order, none of the rest can be better */
+            return;
+        }
+        if (route->handler->method == method || route->handler->method == HTTP_ANY) {
+            *best = route->handler;
+            *best_order = route->order;
+            return;
+        }
+    }
+}
+
+httpd_uri_t *httpd_uri_tree_find(const httpd_uri_tree_t *tree, const char *uri, size_t len,
+                                 httpd_method_t method, httpd_err_code_t *err)
+{
+    httpd_uri_t *best = NULL;
+    int best_order = INT_MAX;
+    bool uri_found = false;
+
+    const uri_node_t *node = tree->root;
+    size_t pos = 0;
+    for (;;) {
+        node_match(node, pos == len, method, &best, &best_order, &uri_found);
+        if (pos == len) {
+            break;
+        }
+        int index = node_child_index(node, uri[pos]);
+        if (index < 0) {
+            break;
+        }
+        const uri_node_t *child = node->children[index];
+        if (child->label_len > len - pos || memcmp(child->label, uri + pos, child->label_len) != 0) {
+            break;
+        }
+        pos += child->label_len;
+        node = child;
+    }
+
+    if (err) {
+        *err = best ? 0 : (uri_found ? HTTPD_405_METHOD_NOT_ALLOWED : HTTPD_404_NOT_FOUND);
+    }
+    return best;
+}
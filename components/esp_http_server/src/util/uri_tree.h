@@ -0,0 +1,86 @@
+/*
+ * SPDX-FileCopyrightText: 2026 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * \file uri_tree.h
+ * \brief Radix tree of URI handlers
+ *
+ * Keeps URI handlers in a radix tree keyed by their URI template, so that
+ * the handler for a request is found by walking the characters of the
+ * request URI once, independently of the number of registered handlers.
+ *
+ * The tree gives the same result as scanning the handlers in registration
+ * order with either exact matching or httpd_uri_match_wildcard(): the
+ * handler registered first among those whose template and method match
+ * the request wins.
+ */
+#ifndef _URI_TREE_H_
+#define _URI_TREE_H_
+
+#include <stdbool.h>
+#include <esp_err.h>
+#include <esp_http_server.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct httpd_uri_tree httpd_uri_tree_t;
+
+/**
+ * @brief Create an empty tree
+ *
+ * @param[in] wildcard  True to interpret the templates like
+ *                      httpd_uri_match_wildcard(), false to match them exactly
+ *
+ * @return - the tree
+ *         - NULL if out of memory
+ */
+httpd_uri_tree_t *httpd_uri_tree_create(bool wildcard);
+
+/**
+ * @brief Delete a tree. The handlers it refers to are not freed.
+ *
+ * @param[in] tree  Tree to delete, may be NULL
+ */
+void httpd_uri_tree_delete(httpd_uri_tree_t *tree);
+
+/**
+ * @brief Add a handler to the tree
+ *
+ * @param[in] tree    Tree
+ * @param[in] handler Handler, must stay valid while it is in the tree
+ * @param[in] order   Registration order of the handler. When several handlers
+ *                    match a request, the one with the lowest order is found.
+ *
+ * @return - ESP_OK on success
+ *         - ESP_ERR_NO_MEM if out of memory. The handler may then be found
+ *           for part of the URIs it matches, so the tree should be deleted.
+ */
+esp_err_t httpd_uri_tree_insert(httpd_uri_tree_t *tree, httpd_uri_t *handler, int order);
+
+/**
+ * @brief Find the handler for a request
+ *
+ * @param[in]  tree    Tree
+ * @param[in]  uri     Request URI path, need not be null terminated
+ * @param[in]  len     Length of the URI path
+ * @param[in]  method  Request method
+ * @param[out] err     Set to HTTPD_404_NOT_FOUND if no template matches,
+ *                     HTTPD_405_METHOD_NOT_ALLOWED if no template matching
+ *                     the URI accepts the method and to 0 otherwise. May be NULL.
+ *
+ * @return - the handler with the lowest order matching URI and method
+ *         - NULL if there is none
+ */
+httpd_uri_t *httpd_uri_tree_find(const httpd_uri_tree_t *tree, const char *uri, size_t len,
+                                 httpd_method_t method, httpd_err_code_t *err);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ! _URI_TREE_H_ */
@@ -6,7 +6,13 @@
 
 #include <stdlib.h>
 #include <stdbool.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
 #include <esp_system.h>
+#include <esp_timer.h>
 #include <esp_http_server.h>
 
 #include "unity.h"
@@ -244,6 +250,258 @@ TEST_CASE("Max Allowed Sockets Test", "[HTTP SERVER]")
     TEST_ASSERT(httpd_start(&hd, &config) != ESP_OK);
 }
 
+/********************* Vectored Send Test Begin *******************/
+
+#define SENDV_TEST_BODY     "Hello World! Hello World! Hello World!"
+#define SENDV_TEST_ROUNDS   100
+
+enum sendv_test_mode {
+    SENDV_TEST_DEFAULT,         /* no override, the socket is written with sendmsg() */
+    SENDV_TEST_SEND_OVERRIDE,   /* only send_fn is overridden, buffers are sent one by one */
+    SENDV_TEST_SENDV_OVERRIDE,  /* send_fn and sendv_fn are overridden */
+};
+
+static enum sendv_test_mode sendv_test_mode;
+static volatile unsigned sendv_test_send_calls, sendv_test_sendv_calls;
+
+static int sendv_test_send(httpd_handle_t hd, int sockfd, const char *buf, size_t buf_len, int flags)
+{
+    sendv_test_send_calls++;
+    return send(sockfd, buf, buf_len, flags);
+}
+
+static int sendv_test_sendv(httpd_handle_t hd, int sockfd, const struct iovec *iov, int iovcnt, int flags)
+{
+    struct msghdr msg = {
+        .msg_iov    = (struct iovec *) iov,
+        .msg_iovlen = iovcnt,
+    };
+    sendv_test_sendv_calls++;
+    return sendmsg(sockfd, &msg, flags);
+}
+
+static esp_err_t sendv_test_open(httpd_handle_t hd, int sockfd)
+{
+    if (sendv_test_mode != SENDV_TEST_DEFAULT) {
+        httpd_sess_set_send_override(hd, sockfd, sendv_test_send);
+    }
+    if (sendv_test_mode == SENDV_TEST_SENDV_OVERRIDE) {
+        httpd_sess_set_sendv_override(hd, sockfd, sendv_test_sendv);
+    }
+    return ESP_OK;
+}
+
+static esp_err_t sendv_test_handler(httpd_req_t *req)
+{
+    httpd_resp_set_hdr(req, "Cache-Control", "no-cache");
+    httpd_resp_set_hdr(req, "Server", "esp-httpd");
+    if (strcmp(req->uri, "/chunk") == 0) {
+        httpd_resp_send_chunk(req, SENDV_TEST_BODY, HTTPD_RESP_USE_STRLEN);
+        httpd_resp_send_chunk(req, SENDV_TEST_BODY, HTTPD_RESP_USE_STRLEN);
+        return httpd_resp_send_chunk(req, NULL, 0);
+    }
+    return httpd_resp_send(req, SENDV_TEST_BODY, HTTPD_RESP_USE_STRLEN);
+}
+
+/* Sends a request over the client socket and checks that the response
+ * received is exactly the expected one */
+static void sendv_test_request(int sock, const char *uri, const char *expected)
+{
+    char buf[512];
+    size_t expected_len = strlen(expected);
+    size_t len = 0;
+
+    snprintf(buf, sizeof(buf), "GET %s HTTP/1.1\r\nHost: localhost\r\n\r\n", uri);
+    TEST_ASSERT(send(sock, buf, strlen(buf), 0) == strlen(buf));
+    while (len < expected_len) {
+        int ret = recv(sock, buf + len, sizeof(buf) - 1 - len, 0);
+        TEST_ASSERT(ret > 0);
+        len += ret;
+    }
+    buf[len] = '\0';
+    TEST_ASSERT_EQUAL_STRING(expected, buf);
+}
+
+TEST_CASE("Vectored Response Send Test", "[HTTP SERVER]")
+{
+    static const char *expected_plain =
+        "HTTP/1.1 200 OK\r\n"
+        "Content-Type: text/html\r\n"
+        "Content-Length: 38\r\n"
+        "Cache-Control: no-cache\r\n"
+        "Server: esp-httpd\r\n"
+        "\r\n"
+        SENDV_TEST_BODY;
+    static const char *expected_chunk =
+        "HTTP/1.1 200 OK\r\n"
+        "Content-Type: text/html\r\n"
+        "Transfer-Encoding: chunked\r\n"
+        "Cache-Control: no-cache\r\n"
+        "Server: esp-httpd\r\n"
+        "\r\n"
+        "26\r\n" SENDV_TEST_BODY "\r\n"
+        "26\r\n" SENDV_TEST_BODY "\r\n"
+        "0\r\n\r\n";
+    static const char *mode_names[] = { "default", "send override", "sendv override" };
+
+    test_case_uses_tcpip();
+
+    for (int mode = SENDV_TEST_DEFAULT; mode <= SENDV_TEST_SENDV_OVERRIDE; mode++) {
+        httpd_handle_t hd;
+        httpd_config_t config = HTTPD_DEFAULT_CONFIG();
+        config.open_fn = sendv_test_open;
+        sendv_test_mode = mode;
+        TEST_ASSERT(httpd_start(&hd, &config) == ESP_OK);
+
+        httpd_uri_t uri = {
+            .uri      = "/plain",
+            .method   = HTTP_GET,
+            .handler  = sendv_test_handler,
+        };
+        TEST_ASSERT(httpd_register_uri_handler(hd, &uri) == ESP_OK);
+        uri.uri = "/chunk";
+        TEST_ASSERT(httpd_register_uri_handler(hd, &uri) == ESP_OK);
+
+        int sock = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+        TEST_ASSERT(sock >= 0);
+        struct timeval timeout = { .tv_sec = 5 };
+        setsockopt(sock, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+        struct sockaddr_in addr = {
+            .sin_family = AF_INET,
+            .sin_port   = htons(config.server_port),
+            .sin_addr.s_addr = htonl(INADDR_LOOPBACK),
+        };
+        TEST_ASSERT(connect(sock, (struct sockaddr *) &addr, sizeof(addr)) == 0);
+
+        /* The whole response is written with one call per httpd_resp_send()
+         * and one per httpd_resp_send_chunk() when sendv_fn is available */
+        sendv_test_send_calls = sendv_test_sendv_calls = 0;
+        sendv_test_request(sock, "/plain", expected_plain);
+        if (mode == SENDV_TEST_SENDV_OVERRIDE) {
+            TEST_ASSERT_EQUAL(1, sendv_test_sendv_calls);
+            TEST_ASSERT_EQUAL(0, sendv_test_send_calls);
+        } else if (mode == SENDV_TEST_SEND_OVERRIDE) {
+            TEST_ASSERT(sendv_test_send_calls > 1);
+        }
+
+        sendv_test_send_calls = sendv_test_sendv_calls = 0;
+        sendv_test_request(sock, "/chunk", expected_chunk);
+        if (mode == SENDV_TEST_SENDV_OVERRIDE) {
+            TEST_ASSERT_EQUAL(3, sendv_test_sendv_calls);
+            TEST_ASSERT_EQUAL(0, sendv_test_send_calls);
+        }
+
+        sendv_test_send_calls = sendv_test_sendv_calls = 0;
+        int64_t start = esp_timer_get_time();
+        for (int i = 0; i < SENDV_TEST_ROUNDS; i++) {
+            sendv_test_request(sock, "/plain", expected_plain);
+        }
+        int64_t elapsed = esp_timer_get_time() - start;
+        printf("%s: %lld req/s, %u send and %u sendv calls per response\n", mode_names[mode],
+               SENDV_TEST_ROUNDS * 1000000LL / (elapsed ? elapsed : 1),
+               sendv_test_send_calls / SENDV_TEST_ROUNDS, sendv_test_sendv_calls / SENDV_TEST_ROUNDS);
+
+        close(sock);
+        TEST_ASSERT(httpd_stop(hd) == ESP_OK);
+    }
+}
+
+/********************* Vectored Send Test End *******************/
+
+/********************* URI Tree Test Begin *******************/
+
+#if CONFIG_HTTPD_URI_TREE
+#include "uri_tree.h"
+
+#define URI_TREE_TEST_RESOURCES     20
+#define URI_TREE_TEST_ROUNDS        1000
+
+static esp_err_t uri_tree_test_handler(httpd_req_t *req)
+{
+    return ESP_OK;
+}
+
+/* Reference lookup, as done without the tree */
+static httpd_uri_t *uri_tree_test_scan(httpd_uri_t *handlers, int count, const char *uri,
+                                       httpd_method_t method, httpd_err_code_t *err)
+{
+    *err = HTTPD_404_NOT_FOUND;
+    for (int i = 0; i < count; i++) {
+        if (httpd_uri_match_wildcard(handlers[i].uri, uri, strlen(uri))) {
+            if (handlers[i].method == method || handlers[i].method == HTTP_ANY) {
+                *err = 0;
+                return &handlers[i];
+            }
+            *err = HTTPD_405_METHOD_NOT_ALLOWED;
+        }
+    }
+    return NULL;
+}
+
+TEST_CASE("URI Tree Lookup Test", "[HTTP SERVER]")
+{
+    /* A REST-like API, each resource has an exact handler, a handler for its
+     * sub-resources and a handler for the other methods */
+    static httpd_uri_t handlers[URI_TREE_TEST_RESOURCES * 4 + 2];
+    static char templates[URI_TREE_TEST_RESOURCES * 3][32];
+    int count = 0;
+    for (int i = 0; i < URI_TREE_TEST_RESOURCES; i++) {
+        snprintf(templates[i * 3], sizeof(templates[0]), "/api/v1/res%d", i);
+        snprintf(templates[i * 3 + 1], sizeof(templates[0]), "/api/v1/res%d/*", i);
+        snprintf(templates[i * 3 + 2], sizeof(templates[0]), "/api/v1/res%d/?", i);
+        handlers[count++] = (httpd_uri_t) { templates[i * 3], HTTP_GET, uri_tree_test_handler };
+        handlers[count++] = (httpd_uri_t) { templates[i * 3], HTTP_PUT, uri_tree_test_handler };
+        handlers[count++] = (httpd_uri_t) { templates[i * 3 + 1], HTTP_GET, uri_tree_test_handler };
+        handlers[count++] = (httpd_uri_t) { templates[i * 3 + 2], HTTP_ANY, uri_tree_test_handler };
+    }
+    handlers[count++] = (httpd_uri_t) { "/static/?*", HTTP_GET, uri_tree_test_handler };
+    handlers[count++] = (httpd_uri_t) { "*", HTTP_DELETE, uri_tree_test_handler };
+
+    httpd_uri_tree_t *tree = httpd_uri_tree_create(true);
+    TEST_ASSERT_NOT_NULL(tree);
+    for (int i = 0; i < count; i++) {
+        TEST_ASSERT_EQUAL(ESP_OK, httpd_uri_tree_insert(tree, &handlers[i], i));
+    }
+
+    const char *uris[] = {
+        "/", "", "/api", "/api/v1/res0", "/api/v1/res0/", "/api/v1/res0/x",
+        "/api/v1/res1", "/api/v1/res10", "/api/v1/res19/a/b", "/api/v1/res2x",
+        "/api/v1/res20", "/static", "/static/", "/static/css/main.css", "/staticx",
+    };
+    const httpd_method_t methods[] = { HTTP_GET, HTTP_PUT, HTTP_POST, HTTP_DELETE };
+    for (int i = 0; i < sizeof(uris) / sizeof(uris[0]); i++) {
+        for (int j = 0; j < sizeof(methods) / sizeof(methods[0]); j++) {
+            httpd_err_code_t scan_err, tree_err;
+            httpd_uri_t *expected = uri_tree_test_scan(handlers, count, uris[i], methods[j], &scan_err);
+            httpd_uri_t *found = httpd_uri_tree_find(tree, uris[i], strlen(uris[i]), methods[j], &tree_err);
+            TEST_ASSERT(found == expected);
+            TEST_ASSERT_EQUAL(scan_err, tree_err);
+        }
+    }
+
+    /* The last resource is the worst case for the scan */
+    const char *uri = "/api/v1/res19/item";
+    httpd_err_code_t err;
+    int64_t start = esp_timer_get_time();
+    for (int i = 0; i < URI_TREE_TEST_ROUNDS; i++) {
+        uri_tree_test_scan(handlers, count, uri, HTTP_GET, &err);
+    }
+    int64_t scan_time = esp_timer_get_time() - start;
+    start = esp_timer_get_time();
+    for (int i = 0; i < URI_TREE_TEST_ROUNDS; i++) {
+        httpd_uri_tree_find(tree, uri, strlen(uri), HTTP_GET, &err);
+    }
+    int64_t tree_time = esp_timer_get_time() - start;
+    printf("%d handlers: scan %lld ns, tree %lld ns per lookup\n", count,
+           (long long) scan_time * 1000 / URI_TREE_TEST_ROUNDS,
+           (long long) tree_time * 1000 / URI_TREE_TEST_ROUNDS);
+
+    httpd_uri_tree_delete(tree);
+}
+#endif /* CONFIG_HTTPD_URI_TREE */
+
+/********************* URI Tree Test End *******************/
+
 void app_main(void)
 {
     unity_run_menu();
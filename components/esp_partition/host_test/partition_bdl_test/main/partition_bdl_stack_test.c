@@ -0,0 +1,277 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Linux host test of the Block Device Layer stacking devices over emulated esp_partition instances
+ */
+
+#include <string.h>
+#include "esp_partition.h"
+#include "esp_blockdev_stack.h"
+#include "unity.h"
+#include "unity_fixture.h"
+
+#define SECTOR_SIZE 4096
+
+TEST_GROUP(partition_bdl_stack);
+
+TEST_SETUP(partition_bdl_stack)
+{
+}
+
+TEST_TEAR_DOWN(partition_bdl_stack)
+{
+}
+
+static void fill_pattern(uint8_t *buf, size_t len, uint32_t seed)
+{
+    for (size_t i = 0; i < len; i++) {
+        buf[i] = (uint8_t)((i + seed) * 7);
+    }
+}
+
+static void get_stats(esp_blockdev_handle_t dev, esp_blockdev_cmd_arg_stats_t *stats)
+{
+    memset(stats, 0, sizeof(*stats));
+    TEST_ESP_OK(dev->ops->ioctl(dev, ESP_BLOCKDEV_CMD_GET_STATS, stats));
+}
+
+/* Repeated small reads are served from the cache, writes through the cache are visible on the lower device */
+TEST(partition_bdl_stack, test_cache)
+{
+    esp_blockdev_handle_t part = NULL;
+    TEST_ESP_OK(esp_partition_get_blockdev(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY, "storage1", &part));
+
+    esp_blockdev_cache_config_t config = ESP_BLOCKDEV_CACHE_CONFIG_DEFAULT();
+    config.block_count = 4;
+    esp_blockdev_handle_t cache = NULL;
+    TEST_ESP_OK(esp_blockdev_cache_get_blockdev(part, &config, &cache));
+    TEST_ASSERT_EQUAL(part->geometry.disk_size, cache->geometry.disk_size);
+    TEST_ASSERT_EQUAL(part->device_flags.val, cache->device_flags.val);
+
+    static uint8_t data[2 * SECTOR_SIZE];
+    static uint8_t buf[2 * SECTOR_SIZE];
+    fill_pattern(data, sizeof(data), 1);
+    TEST_ESP_OK(cache->ops->erase(cache, 0, sizeof(data)));
+    TEST_ESP_OK(cache->ops->write(cache, data, 0, sizeof(data)));
+
+    // read everything twice in small chunks
+    const size_t chunk = 256;
+    for (int pass = 0; pass < 2; pass++) {
+        for (size_t offset = 0; offset < sizeof(buf); offset += chunk) {
+            TEST_ESP_OK(cache->ops->read(cache, buf + offset, chunk, offset, chunk));
+        }
+        TEST_ASSERT_EQUAL_HEX8_ARRAY(data, buf, sizeof(data));
+    }
+
+    esp_blockdev_cmd_arg_stats_t stats;
+    get_stats(cache, &stats);
+    TEST_ASSERT_EQUAL(2 * sizeof(buf) / chunk, stats.read_ops);
+    TEST_ASSERT_EQUAL(2, stats.lower_read_ops);
+    TEST_ASSERT_EQUAL(stats.read_ops - stats.lower_read_ops, stats.hits);
+
+    // overwrite of cached data (clearing bits only, as allowed on NOR flash), the cache must follow the device
+    memset(data, 0x00, chunk);
+    TEST_ESP_OK(cache->ops->write(cache, data, 0, chunk));
+    TEST_ESP_OK(cache->ops->read(cache, buf, chunk, 0, chunk));
+    uint8_t direct[256];
+    TEST_ESP_OK(part->ops->read(part, direct, sizeof(direct), 0, sizeof(direct)));
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(direct, buf, chunk);
+
+    // erase drops the cached blocks
+    TEST_ESP_OK(cache->ops->erase(cache, 0, SECTOR_SIZE));
+    TEST_ESP_OK(cache->ops->read(cache, buf, chunk, 0, chunk));
+    memset(data, 0xFF, chunk);
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(data, buf, chunk);
+
+    TEST_ESP_OK(cache->ops->release(cache));
+    TEST_ESP_OK(part->ops->release(part));
+}
+
+/* Sequential small reads are served from the read-ahead window */
+TEST(partition_bdl_stack, test_readahead)
+{
+    esp_blockdev_handle_t part = NULL;
+    TEST_ESP_OK(esp_partition_get_blockdev(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY, "storage1", &part));
+
+    esp_blockdev_readahead_config_t config = ESP_BLOCKDEV_READAHEAD_CONFIG_DEFAULT();
+    config.window_size = 2 * SECTOR_SIZE;
+    esp_blockdev_handle_t ra = NULL;
+    TEST_ESP_OK(esp_blockdev_readahead_get_blockdev(part, &config, &ra));
+
+    static uint8_t data[8 * SECTOR_SIZE];
+    static uint8_t buf[8 * SECTOR_SIZE];
+    fill_pattern(data, sizeof(data), 2);
+    TEST_ESP_OK(part->ops->erase(part, 0, sizeof(data)));
+    TEST_ESP_OK(part->ops->write(part, data, 0, sizeof(data)));
+
+    const size_t chunk = 512;
+    for (size_t offset = 0; offset < sizeof(buf); offset += chunk) {
+        TEST_ESP_OK(ra->ops->read(ra, buf + offset, chunk, offset, chunk));
+    }
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(data, buf, sizeof(data));
+
+    esp_blockdev_cmd_arg_stats_t stats;
+    get_stats(ra, &stats);
+    TEST_ASSERT_EQUAL(sizeof(buf) / chunk, stats.read_ops);
+    TEST_ASSERT_EQUAL(sizeof(buf) / config.window_size, stats.lower_read_ops);
+
+    // a write through the device updates the window
+    memset(data, 0, chunk);
+    TEST_ESP_OK(ra->ops->write(ra, data, sizeof(buf) - chunk, chunk));
+    TEST_ESP_OK(ra->ops->read(ra, buf, chunk, sizeof(buf) - chunk, chunk));
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(data, buf, chunk);
+
+    TEST_ESP_OK(ra->ops->release(ra));
+    TEST_ESP_OK(part->ops->release(part));
+}
+
+/* Consecutive small writes reach the lower device as buffer-sized writes */
+TEST(partition_bdl_stack, test_write_combine)
+{
+    esp_blockdev_handle_t part = NULL;
+    TEST_ESP_OK(esp_partition_get_blockdev(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY, "storage1", &part));
+
+    esp_blockdev_write_combine_config_t config = ESP_BLOCKDEV_WRITE_COMBINE_CONFIG_DEFAULT();
+    config.buffer_size = SECTOR_SIZE;
+    esp_blockdev_handle_t wc = NULL;
+    TEST_ESP_OK(esp_blockdev_write_combine_get_blockdev(part, &config, &wc));
+
+    static uint8_t data[4 * SECTOR_SIZE];
+    static uint8_t buf[4 * SECTOR_SIZE];
+    fill_pattern(data, sizeof(data), 3);
+    TEST_ESP_OK(wc->ops->erase(wc, 0, sizeof(data)));
+
+    const size_t chunk = 128;
+    for (size_t offset = 0; offset < sizeof(data); offset += chunk) {
+        TEST_ESP_OK(wc->ops->write(wc, data + offset, offset, chunk));
+    }
+    // reading the pending range through the device writes it first
+    TEST_ESP_OK(wc->ops->read(wc, buf, sizeof(buf), 0, sizeof(buf)));
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(data, buf, sizeof(data));
+    TEST_ESP_OK(wc->ops->sync(wc));
+
+    esp_blockdev_cmd_arg_stats_t stats;
+    get_stats(wc, &stats);
+    TEST_ASSERT_EQUAL(sizeof(data) / chunk, stats.write_ops);
+    TEST_ASSERT_EQUAL(sizeof(data) / config.buffer_size, stats.lower_write_ops);
+
+    TEST_ESP_OK(part->ops->read(part, buf, sizeof(buf), 0, sizeof(buf)));
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(data, buf, sizeof(data));
+
+    // release writes the pending data
+    memset(data, 0x55, chunk);
+    TEST_ESP_OK(wc->ops->erase(wc, 0, SECTOR_SIZE));
+    TEST_ESP_OK(wc->ops->write(wc, data, 0, chunk));
+    TEST_ESP_OK(wc->ops->release(wc));
+    TEST_ESP_OK(part->ops->read(part, buf, chunk, 0, chunk));
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(data, buf, chunk);
+
+    TEST_ESP_OK(part->ops->release(part));
+}
+
+/* Striped device spreads consecutive stripes over both partitions */
+TEST(partition_bdl_stack, test_concat_striped)
+{
+    esp_blockdev_handle_t part1 = NULL;
+    esp_blockdev_handle_t part2 = NULL;
+    TEST_ESP_OK(esp_partition_get_blockdev(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY, "storage1", &part1));
+    TEST_ESP_OK(esp_partition_get_blockdev(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY, "storage2", &part2));
+
+    esp_blockdev_concat_config_t config = ESP_BLOCKDEV_CONCAT_CONFIG_DEFAULT();
+    config.mode = ESP_BLOCKDEV_CONCAT_STRIPED;
+    config.stripe_size = SECTOR_SIZE;
+    esp_blockdev_handle_t concat = NULL;
+    TEST_ESP_OK(esp_blockdev_concat_get_blockdev(part1, part2, &config, &concat));
+    TEST_ASSERT_EQUAL(2 * part2->geometry.disk_size, concat->geometry.disk_size);
+
+    // stripe size not aligned to the erase size is rejected
+    esp_blockdev_handle_t invalid = NULL;
+    config.stripe_size = SECTOR_SIZE / 2;
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, esp_blockdev_concat_get_blockdev(part1, part2, &config, &invalid));
+
+    static uint8_t data[4 * SECTOR_SIZE];
+    static uint8_t buf[4 * SECTOR_SIZE];
+    fill_pattern(data, sizeof(data), 4);
+    TEST_ESP_OK(concat->ops->erase(concat, 0, sizeof(data)));
+    TEST_ESP_OK(concat->ops->write(concat, data, 0, sizeof(data)));
+    TEST_ESP_OK(concat->ops->read(concat, buf, sizeof(buf), 0, sizeof(buf)));
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(data, buf, sizeof(data));
+
+    // stripes 0 and 2 are on the first partition, 1 and 3 on the second one
+    TEST_ESP_OK(part1->ops->read(part1, buf, SECTOR_SIZE, SECTOR_SIZE, SECTOR_SIZE));
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(data + 2 * SECTOR_SIZE, buf, SECTOR_SIZE);
+    TEST_ESP_OK(part2->ops->read(part2, buf, SECTOR_SIZE, 0, SECTOR_SIZE));
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(data + SECTOR_SIZE, buf, SECTOR_SIZE);
+
+    esp_blockdev_cmd_arg_stats_t stats;
+    get_stats(concat, &stats);
+    TEST_ASSERT_EQUAL(1, stats.write_ops);
+    TEST_ASSERT_EQUAL(4, stats.lower_write_ops);
+
+    TEST_ESP_OK(concat->ops->release(concat));
+    TEST_ESP_OK(part1->ops->release(part1));
+    TEST_ESP_OK(part2->ops->release(part2));
+}
+
+/* All the devices combined in one stack over a linear concatenation of two partitions */
+TEST(partition_bdl_stack, test_full_stack)
+{
+    esp_blockdev_handle_t part1 = NULL;
+    esp_blockdev_handle_t part2 = NULL;
+    TEST_ESP_OK(esp_partition_get_blockdev(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY, "storage1", &part1));
+    TEST_ESP_OK(esp_partition_get_blockdev(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY, "storage2", &part2));
+
+    esp_blockdev_concat_config_t concat_config = ESP_BLOCKDEV_CONCAT_CONFIG_DEFAULT();
+    esp_blockdev_handle_t concat = NULL;
+    TEST_ESP_OK(esp_blockdev_concat_get_blockdev(part1, part2, &concat_config, &concat));
+    TEST_ASSERT_EQUAL(part1->geometry.disk_size + part2->geometry.disk_size, concat->geometry.disk_size);
+
+    esp_blockdev_cache_config_t cache_config = ESP_BLOCKDEV_CACHE_CONFIG_DEFAULT();
+    esp_blockdev_handle_t cache = NULL;
+    TEST_ESP_OK(esp_blockdev_cache_get_blockdev(concat, &cache_config, &cache));
+
+    esp_blockdev_write_combine_config_t wc_config = ESP_BLOCKDEV_WRITE_COMBINE_CONFIG_DEFAULT();
+    esp_blockdev_handle_t wc = NULL;
+    TEST_ESP_OK(esp_blockdev_write_combine_get_blockdev(cache, &wc_config, &wc));
+
+    // write across the boundary between the partitions
+    static uint8_t data[2 * SECTOR_SIZE];
+    static uint8_t buf[2 * SECTOR_SIZE];
+    const uint64_t addr = part1->geometry.disk_size - SECTOR_SIZE;
+    fill_pattern(data, sizeof(data), 5);
+    TEST_ESP_OK(wc->ops->erase(wc, addr, sizeof(data)));
+    for (size_t offset = 0; offset < sizeof(data); offset += 512) {
+        TEST_ESP_OK(wc->ops->write(wc, data + offset, addr + offset, 512));
+    }
+    TEST_ESP_OK(wc->ops->sync(wc));
+
+    TEST_ESP_OK(wc->ops->read(wc, buf, sizeof(buf), addr, sizeof(buf)));
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(data, buf, sizeof(data));
+    TEST_ESP_OK(part2->ops->read(part2, buf, SECTOR_SIZE, 0, SECTOR_SIZE));
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(data + SECTOR_SIZE, buf, SECTOR_SIZE);
+
+    esp_blockdev_cmd_arg_stats_t wc_stats;
+    esp_blockdev_cmd_arg_stats_t concat_stats;
+    get_stats(wc, &wc_stats);
+    get_stats(concat, &concat_stats);
+    TEST_ASSERT_EQUAL(sizeof(data) / 512, wc_stats.write_ops);
+    TEST_ASSERT_EQUAL(sizeof(data) / wc_config.buffer_size, wc_stats.lower_write_ops);
+    TEST_ASSERT_EQUAL(wc_stats.lower_write_ops, concat_stats.write_ops);
+
+    TEST_ESP_OK(wc->ops->release(wc));
+    TEST_ESP_OK(cache->ops->release(cache));
+    TEST_ESP_OK(concat->ops->release(concat));
+    TEST_ESP_OK(part1->ops->release(part1));
+    TEST_ESP_OK(part2->ops->release(part2));
+}
+
+TEST_GROUP_RUNNER(partition_bdl_stack)
+{
+    RUN_TEST_CASE(partition_bdl_stack, test_cache);
+    RUN_TEST_CASE(partition_bdl_stack, test_readahead);
+    RUN_TEST_CASE(partition_bdl_stack, test_write_combine);
+    RUN_TEST_CASE(partition_bdl_stack, test_concat_striped);
+    RUN_TEST_CASE(partition_bdl_stack, test_full_stack);
+}
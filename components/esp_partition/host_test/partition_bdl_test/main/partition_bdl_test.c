@@ -198,6 +198,7 @@ TEST_GROUP_RUNNER(partition_bdl)
 static void run_all_tests(void)
 {
     RUN_TEST_GROUP(partition_bdl);
+    RUN_TEST_GROUP(partition_bdl_stack);
 }
 
 int main(int argc, char **argv)
@@ -41,6 +41,15 @@ typedef enum {
      * time.
      */
     RINGBUF_TYPE_BYTEBUF,
+    /**
+     * Single-producer/single-consumer byte buffers behave like byte buffers,
+     * but may only be sent to by one task or ISR and received from by one
+     * other task or ISR. Sending, receiving and returning data does not enter
+     * a critical section unless a task has to be blocked or unblocked. One
+     * byte of the storage area is kept free, so the maximum item size is
+     * xBufferSize - 1. These buffers cannot be added to a queue set.
+     */
+    RINGBUF_TYPE_BYTEBUF_SPSC,
     RINGBUF_TYPE_MAX,
 } RingbufferType_t;
 
@@ -214,6 +223,52 @@ BaseType_t xRingbufferSendAcquire(RingbufHandle_t xRingbuffer, void **ppvItem, s
  */
 BaseType_t xRingbufferSendComplete(RingbufHandle_t xRingbuffer, void *pvItem);
 
+/**
+ * @brief   Acquire memory for several items of the same size from the ring
+ *          buffer, to be written to by an external source and sent later.
+ *
+ * Same as ``xRingbufferSendAcquire``, but acquires up to uxItemCount items
+ * within a single critical section. This function will block until at least
+ * one item fits or until it times out, and then acquires as many items as
+ * currently fit.
+ *
+ * @param[in]   xRingbuffer     Ring buffer to allocate the memory
+ * @param[out]  ppvItems        Array of uxItemCount pointers, the first entries of which are set to the memory acquired
+ * @param[in]   xItemSize       Size of each item to acquire.
+ * @param[in]   uxItemCount     Maximum number of items to acquire
+ * @param[in]   xTicksToWait    Ticks to wait for room in the ring buffer.
+ *
+ * @note Only applicable for no-split ring buffers.
+ *
+ * @return  Number of items acquired, 0 on time-out or when the item is larger
+ *          than the maximum permissible size of the buffer
+ */
+UBaseType_t xRingbufferSendAcquireMultiple(RingbufHandle_t xRingbuffer,
+                                           void **ppvItems,
+                                           size_t xItemSize,
+                                           UBaseType_t uxItemCount,
+                                           TickType_t xTicksToWait);
+
+/**
+ * @brief   Actually send several items into the ring buffer allocated before by
+ *          ``xRingbufferSendAcquire`` or ``xRingbufferSendAcquireMultiple``.
+ *
+ * Same as calling ``xRingbufferSendComplete`` for each item, but the items are
+ * sent within a single critical section, and a task waiting to receive is
+ * woken up once.
+ *
+ * @param[in]   xRingbuffer     Ring buffer to insert the items into
+ * @param[in]   ppvItems        Array of pointers to the items in allocated memory to insert
+ * @param[in]   uxItemCount     Number of items in ppvItems
+ *
+ * @note Only applicable for no-split ring buffers.
+ *
+ * @return
+ *      - pdTRUE if succeeded
+ *      - pdFALSE if fail for some reason.
+ */
+BaseType_t xRingbufferSendCompleteMultiple(RingbufHandle_t xRingbuffer, void **ppvItems, UBaseType_t uxItemCount);
+
 /**
  * @brief   Retrieve an item from the ring buffer
  *
@@ -256,6 +311,31 @@ void *xRingbufferReceive(RingbufHandle_t xRingbuffer, size_t *pxItemSize, TickTy
  */
 void *xRingbufferReceiveFromISR(RingbufHandle_t xRingbuffer, size_t *pxItemSize);
 
+/**
+ * @brief   Retrieve several items from a no-split ring buffer
+ *
+ * Attempt to retrieve up to uxMaxItems items from the ring buffer within a
+ * single critical section. This function will block until at least one item is
+ * available or until it times out, and then retrieves the items that are
+ * currently available.
+ *
+ * @param[in]   xRingbuffer     Ring buffer to retrieve the items from
+ * @param[out]  ppvItems        Array of uxMaxItems pointers, the first entries of which are set to the items retrieved
+ * @param[out]  pxItemSizes     Array of uxMaxItems sizes, the first entries of which are set to the sizes of the items retrieved
+ * @param[in]   uxMaxItems      Maximum number of items to retrieve
+ * @param[in]   xTicksToWait    Ticks to wait for items in the ring buffer.
+ *
+ * @note    The items retrieved must be returned with vRingbufferReturnItem() or vRingbufferReturnItemMultiple().
+ * @note    This function should only be called on no-split buffers
+ *
+ * @return  Number of items retrieved, 0 on timeout
+ */
+UBaseType_t xRingbufferReceiveMultiple(RingbufHandle_t xRingbuffer,
+                                       void **ppvItems,
+                                       size_t *pxItemSizes,
+                                       UBaseType_t uxMaxItems,
+                                       TickType_t xTicksToWait);
+
 /**
  * @brief   Retrieve a split item from an allow-split ring buffer
  *
@@ -364,6 +444,38 @@ void *xRingbufferReceiveUpTo(RingbufHandle_t xRingbuffer,
  */
 void *xRingbufferReceiveUpToFromISR(RingbufHandle_t xRingbuffer, size_t *pxItemSize, size_t xMaxSize);
 
+/**
+ * @brief   Retrieve bytes from a byte buffer, including the bytes that wrap around
+ *          the end of the ring buffer, specifying the maximum amount of bytes to retrieve
+ *
+ * Same as xRingbufferReceiveUpTo(), but if the data wraps around the end of the
+ * ring buffer, the data at the start of the ring buffer is retrieved as a second
+ * part, up to a total of xMaxSize bytes. This function will block until there
+ * is data available for retrieval or until it times out.
+ *
+ * @param[in]   xRingbuffer     Ring buffer to retrieve the data from
+ * @param[out]  ppvHeadItem     Double pointer to first part (set to NULL if no data was retrieved)
+ * @param[out]  ppvTailItem     Double pointer to second part (set to NULL if the data does not wrap around)
+ * @param[out]  pxHeadItemSize  Pointer to size of first part (unmodified if no data was retrieved)
+ * @param[out]  pxTailItemSize  Pointer to size of second part (set to 0 if the data does not wrap around)
+ * @param[in]   xTicksToWait    Ticks to wait for data in the ring buffer.
+ * @param[in]   xMaxSize        Maximum total number of bytes to return.
+ *
+ * @note    A single call to vRingbufferReturnItem() with the first part frees up both parts.
+ * @note    This function should only be called on byte buffers
+ *
+ * @return
+ *      - pdTRUE if data was retrieved
+ *      - pdFALSE on timeout
+ */
+BaseType_t xRingbufferReceiveUpToSplit(RingbufHandle_t xRingbuffer,
+                                       void **ppvHeadItem,
+                                       void **ppvTailItem,
+                                       size_t *pxHeadItemSize,
+                                       size_t *pxTailItemSize,
+                                       TickType_t xTicksToWait,
+                                       size_t xMaxSize);
+
 /**
  * @brief   Return a previously-retrieved item to the ring buffer
  *
@@ -386,6 +498,19 @@ void vRingbufferReturnItem(RingbufHandle_t xRingbuffer, void *pvItem);
  */
 void vRingbufferReturnItemFromISR(RingbufHandle_t xRingbuffer, void *pvItem, BaseType_t *pxHigherPriorityTaskWoken);
 
+/**
+ * @brief   Return several previously-retrieved items to the ring buffer
+ *
+ * Same as calling vRingbufferReturnItem() for each item, but the items are
+ * returned within a single critical section, and a task waiting to send is
+ * woken up once.
+ *
+ * @param[in]   xRingbuffer Ring buffer the items were retrieved from
+ * @param[in]   ppvItems    Array of items that were received earlier
+ * @param[in]   uxItemCount Number of items in ppvItems
+ */
+void vRingbufferReturnItemMultiple(RingbufHandle_t xRingbuffer, void **ppvItems, UBaseType_t uxItemCount);
+
 /**
  * @brief   Reset a ring buffer back to its original empty state
  *
@@ -452,6 +577,8 @@ size_t xRingbufferGetCurFreeSize(RingbufHandle_t xRingbuffer);
  * @param[in]   xRingbuffer     Ring buffer to add to the queue set
  * @param[in]   xQueueSet       Queue set to add the ring buffer to
  *
+ * @note    Single-producer/single-consumer byte buffers cannot be added to a queue set.
+ *
  * @return
  *      - pdTRUE on success, pdFALSE otherwise
  */
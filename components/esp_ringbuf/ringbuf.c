@@ -27,6 +27,11 @@
 #define rbBUFFER_FULL_FLAG          ( ( UBaseType_t ) 4 )   //The ring buffer is currently full (write pointer == free pointer)
 #define rbBUFFER_STATIC_FLAG        ( ( UBaseType_t ) 8 )   //The ring buffer is statically allocated
 #define rbUSING_QUEUE_SET           ( ( UBaseType_t ) 16 )  //The ring buffer has been added to a queue set
+#define rbSPSC_FLAG                 ( ( UBaseType_t ) 32 )  //The ring buffer is a single-producer/single-consumer byte buffer
+
+//Waiting flags of single-producer/single-consumer byte buffers
+#define rbRX_WAITING_FLAG           ( ( UBaseType_t ) 1 )   //A task is blocked (or about to block) on an empty buffer
+#define rbTX_WAITING_FLAG           ( ( UBaseType_t ) 2 )   //A task is blocked (or about to block) on a full buffer
 
 //Item flags
 #define rbITEM_FREE_FLAG            ( ( UBaseType_t ) 1 )   //Item has been retrieved and returned by application, free to overwrite
@@ -67,7 +72,10 @@ typedef struct RingbufferDefinition {
     uint8_t *pucHead;                           //Pointer to the start of the ring buffer storage area
     uint8_t *pucTail;                           //Pointer to the end of the ring buffer storage area
 
-    BaseType_t xItemsWaiting;                   //Number of items/bytes(for byte buffers) currently in ring buffer that have not yet been read
+    union {
+        BaseType_t xItemsWaiting;               //Number of items/bytes(for byte buffers) currently in ring buffer that have not yet been read
+        UBaseType_t uxWaitingFlags;             //For SPSC buffers, which sides of the ring buffer have a task waiting
+    };
     List_t xTasksWaitingToSend;                 //List of tasks that are blocked waiting to send/acquire onto this ring buffer. Stored in priority order.
     List_t xTasksWaitingToReceive;              //List of tasks that are blocked waiting to receive from this ring buffer. Stored in priority order.
     QueueSetHandle_t xQueueSet;                 //Ring buffer's read queue set handle.
@@ -157,6 +165,16 @@ Exit:
 */
 static void prvReturnItemDefault(Ringbuffer_t *pxRingbuffer, uint8_t *pucItem);
 
+/*
+Retrieve the data that wrapped around to the head of a byte buffer, after
+prvGetItemByteBuf() has retrieved the data up to the tail.
+Entry:
+    - If pucRead is not at pucHead, the data did not wrap around and nothing is retrieved
+Exit:
+    - Returns NULL and sets *pxItemSize to 0 if no data is retrieved
+*/
+static void *prvGetWrappedItemByteBuf(Ringbuffer_t *pxRingbuffer, size_t xMaxSize, size_t *pxItemSize);
+
 //Return data to a byte buffer
 static void prvReturnItemByteBuf(Ringbuffer_t *pxRingbuffer, uint8_t *pucItem);
 
@@ -169,22 +187,103 @@ static size_t prvGetCurMaxSizeAllowSplit(Ringbuffer_t *pxRingbuffer);
 //Get the maximum size an item that can currently have if sent to a byte buffer
 static size_t prvGetCurMaxSizeByteBuf(Ringbuffer_t *pxRingbuffer);
 
+/*
+The following functions implement single-producer/single-consumer byte buffers
+and, unlike the functions above, are called outside of critical sections.
+pucWrite (mirrored by pucAcquire) is only written by the producer, pucRead and
+pucFree are only written by the consumer, and uxWaitingFlags is only written
+within the critical section. One byte is always kept free so that
+pucWrite == pucFree means the buffer is empty. The mux is only taken to block
+or unblock a task, which is announced in uxWaitingFlags.
+*/
+
+//Get the amount of free space in a SPSC buffer. Called by the producer
+static size_t prvGetCurMaxSizeSPSC(Ringbuffer_t *pxRingbuffer);
+
+//Checks if an item will currently fit in a SPSC buffer. Called by the producer
+static BaseType_t prvCheckItemFitsSPSC(Ringbuffer_t *pxRingbuffer, size_t xItemSize);
+
+//Checks if data is currently available for retrieval from a SPSC buffer. Called by the consumer
+static BaseType_t prvCheckItemAvailSPSC(Ringbuffer_t *pxRingbuffer, size_t xUnusedParam);
+
+//Copies an item to a SPSC buffer and publishes it. Only call this function after calling prvCheckItemFitsSPSC()
+static void prvCopyItemSPSC(Ringbuffer_t *pxRingbuffer, const uint8_t *pucItem, size_t xItemSize);
+
+//Retrieve data from a SPSC buffer. Only call this function after calling prvCheckItemAvailSPSC()
+static void *prvGetItemSPSC(Ringbuffer_t *pxRingbuffer,
+                            BaseType_t *pxUnusedParam,
+                            size_t xMaxSize,
+                            size_t *pxItemSize);
+
+//SPSC version of prvGetWrappedItemByteBuf()
+static void *prvGetWrappedItemSPSC(Ringbuffer_t *pxRingbuffer, size_t xMaxSize, size_t *pxItemSize);
+
+//Return data to a SPSC buffer, making its space available to the producer
+static void prvReturnItemSPSC(Ringbuffer_t *pxRingbuffer, uint8_t *pucItem);
+
+//Get the number of bytes in a SPSC buffer that have not been retrieved yet
+static size_t prvGetBytesWaitingSPSC(Ringbuffer_t *pxRingbuffer);
+
+/*
+Block the calling task until xCheckReady() succeeds or the timeout expires.
+- uxWaitingFlag and pxTasksWaiting select the side of the buffer to wait on
+- Returns pdFALSE if timed out. Otherwise, the caller must check the condition again.
+*/
+static BaseType_t prvBlockSPSC(Ringbuffer_t *pxRingbuffer,
+                               UBaseType_t uxWaitingFlag,
+                               List_t *pxTasksWaiting,
+                               CheckItemFitsFunction_t xCheckReady,
+                               size_t xItemSize,
+                               TimeOut_t *pxTimeOut,
+                               TickType_t *pxTicksToWait);
+
+//Unblock a task waiting on the other side of a SPSC buffer, if any, after pucWrite or pucFree has been updated
+static void prvWakeSPSC(Ringbuffer_t *pxRingbuffer, UBaseType_t uxWaitingFlag, List_t *pxTasksWaiting);
+
+//From ISR version of prvWakeSPSC()
+static void prvWakeSPSCFromISR(Ringbuffer_t *pxRingbuffer,
+                               UBaseType_t uxWaitingFlag,
+                               List_t *pxTasksWaiting,
+                               BaseType_t *pxHigherPriorityTaskWoken);
+
+//Send an item to a SPSC buffer, blocking while it is full
+static BaseType_t prvSendSPSC(Ringbuffer_t *pxRingbuffer, const void *pvItem, size_t xItemSize, TickType_t xTicksToWait);
+
+/*
+Retrieve up to xMaxSize bytes from a SPSC buffer, blocking while it is empty.
+If pvItem2 and xItemSize2 are not NULL, the data wrapped around to the head of
+the buffer is retrieved as well.
+*/
+static BaseType_t prvReceiveSPSC(Ringbuffer_t *pxRingbuffer,
+                                 void **pvItem1,
+                                 void **pvItem2,
+                                 size_t *xItemSize1,
+                                 size_t *xItemSize2,
+                                 size_t xMaxSize,
+                                 TickType_t xTicksToWait);
+
 /*
 Generic function used to send or acquire an item/buffer.
 - If sending, set ppvItem to NULL. pvItem remains unchanged on failure.
-- If acquiring, set pvItem to NULL. ppvItem remains unchanged on failure.
+- If acquiring, set pvItem to NULL. ppvItem remains unchanged on failure. Up to
+  uxItemCount items are acquired into ppvItem[], as many as currently fit.
+- Returns the number of items sent or acquired, 0 on failure
 */
 static BaseType_t prvSendAcquireGeneric(Ringbuffer_t *pxRingbuffer,
                                         const void *pvItem,
                                         void **ppvItem,
                                         size_t xItemSize,
+                                        UBaseType_t uxItemCount,
                                         TickType_t xTicksToWait);
 
 /*
 Generic function used to retrieve an item/data from ring buffers. If called on
 an allow-split buffer, and pvItem2 and xItemSize2 are not NULL, both parts of
-a split item will be retrieved. xMaxSize will only take effect if called on
-byte buffers. xItemSize must remain unchanged if no item is retrieved.
+a split item will be retrieved. If called on a byte buffer, and pvItem2 and
+xItemSize2 are not NULL, the data wrapped around to the head of the buffer is
+retrieved as a second part, up to a total of xMaxSize bytes. xMaxSize will only
+take effect if called on byte buffers. xItemSize must remain unchanged if no
+item is retrieved.
 */
 static BaseType_t prvReceiveGeneric(Ringbuffer_t *pxRingbuffer,
                                     void **pvItem1,
@@ -202,6 +301,17 @@ static BaseType_t prvReceiveGenericFromISR(Ringbuffer_t *pxRingbuffer,
                                            size_t *xItemSize2,
                                            size_t xMaxSize);
 
+/*
+Retrieve up to uxMaxItems items from a no-split ring buffer within a single
+critical section. Blocks until at least one item is available. Returns the
+number of items retrieved, 0 on timeout.
+*/
+static UBaseType_t prvReceiveMultipleNoSplit(Ringbuffer_t *pxRingbuffer,
+                                             void **ppvItems,
+                                             size_t *pxItemSizes,
+                                             UBaseType_t uxMaxItems,
+                                             TickType_t xTicksToWait);
+
 // ------------------------------------------------ Static Functions ---------------------------------------------------
 
 static void prvInitializeNewRingbuffer(size_t xBufferSize,
@@ -241,6 +351,16 @@ static void prvInitializeNewRingbuffer(size_t xBufferSize,
         //Worst case an item is split into two, incurring two headers of overhead
         pxNewRingbuffer->xMaxItemSize = pxNewRingbuffer->xSize - (sizeof(ItemHeader_t) * 2);
         pxNewRingbuffer->xGetCurMaxSize = prvGetCurMaxSizeAllowSplit;
+    } else if (xBufferType == RINGBUF_TYPE_BYTEBUF_SPSC) {
+        //SPSC buffers are byte buffers, so that the byte buffer argument checks apply to them as well
+        pxNewRingbuffer->uxRingbufferFlags |= rbBYTE_BUFFER_FLAG | rbSPSC_FLAG;
+        pxNewRingbuffer->xCheckItemFits = prvCheckItemFitsSPSC;
+        pxNewRingbuffer->vCopyItem = prvCopyItemSPSC;
+        pxNewRingbuffer->pvGetItem = prvGetItemSPSC;
+        pxNewRingbuffer->vReturnItem = prvReturnItemSPSC;
+        //One byte is kept free to distinguish a full buffer from an empty one
+        pxNewRingbuffer->xMaxItemSize = pxNewRingbuffer->xSize - 1;
+        pxNewRingbuffer->xGetCurMaxSize = prvGetCurMaxSizeSPSC;
     } else { //Byte Buffer
         pxNewRingbuffer->uxRingbufferFlags |= rbBYTE_BUFFER_FLAG;
         pxNewRingbuffer->xCheckItemFits = prvCheckItemFitsByteBuffer;
@@ -262,7 +382,9 @@ static void prvInitializeNewRingbuffer(size_t xBufferSize,
 static size_t prvGetFreeSize(Ringbuffer_t *pxRingbuffer)
 {
     size_t xReturn;
-    if (pxRingbuffer->uxRingbufferFlags & rbBUFFER_FULL_FLAG) {
+    if (pxRingbuffer->uxRingbufferFlags & rbSPSC_FLAG) {
+        xReturn = prvGetCurMaxSizeSPSC(pxRingbuffer);
+    } else if (pxRingbuffer->uxRingbufferFlags & rbBUFFER_FULL_FLAG) {
         xReturn =  0;
     } else {
         BaseType_t xFreeSize = pxRingbuffer->pucFree - pxRingbuffer->pucAcquire;
@@ -607,6 +729,25 @@ static void *prvGetItemByteBuf(Ringbuffer_t *pxRingbuffer,
     return (void *)ret;
 }
 
+static void *prvGetWrappedItemByteBuf(Ringbuffer_t *pxRingbuffer, size_t xMaxSize, size_t *pxItemSize)
+{
+    *pxItemSize = 0;
+    if (pxRingbuffer->pucRead != pxRingbuffer->pucHead || pxRingbuffer->xItemsWaiting == 0 || xMaxSize == 0) {
+        return NULL;    //Data did not wrap around, nothing left to read, or no more data requested
+    }
+    //The remaining data is contiguous from the head of the buffer to the write pointer
+    configASSERT(pxRingbuffer->pucWrite > pxRingbuffer->pucRead);
+    uint8_t *ret = pxRingbuffer->pucRead;
+    size_t xItemSize = pxRingbuffer->pucWrite - pxRingbuffer->pucRead;
+    if (xItemSize > xMaxSize) {
+        xItemSize = xMaxSize;
+    }
+    pxRingbuffer->xItemsWaiting -= xItemSize;
+    pxRingbuffer->pucRead += xItemSize;
+    *pxItemSize = xItemSize;
+    return (void *)ret;
+}
+
 static void prvReturnItemDefault(Ringbuffer_t *pxRingbuffer, uint8_t *pucItem)
 {
     //Check arguments and buffer state
@@ -763,13 +904,254 @@ static size_t prvGetCurMaxSizeByteBuf(Ringbuffer_t *pxRingbuffer)
     return xFreeSize;
 }
 
+static size_t prvGetCurMaxSizeSPSC(Ringbuffer_t *pxRingbuffer)
+{
+    //Acquire pairs with the release in prvReturnItemSPSC(), so the consumer is done with the space before it is reused
+    uint8_t *pucFree = __atomic_load_n(&pxRingbuffer->pucFree, __ATOMIC_ACQUIRE);
+    uint8_t *pucWrite = __atomic_load_n(&pxRingbuffer->pucWrite, __ATOMIC_RELAXED);
+    BaseType_t xFreeSize = pucFree - pucWrite - 1;
+    if (xFreeSize < 0) {
+        xFreeSize += pxRingbuffer->xSize;
+    }
+    return xFreeSize;
+}
+
+static BaseType_t prvCheckItemFitsSPSC(Ringbuffer_t *pxRingbuffer, size_t xItemSize)
+{
+    return (xItemSize <= prvGetCurMaxSizeSPSC(pxRingbuffer)) ? pdTRUE : pdFALSE;
+}
+
+static BaseType_t prvCheckItemAvailSPSC(Ringbuffer_t *pxRingbuffer, size_t xUnusedParam)
+{
+    if (pxRingbuffer->pucRead != pxRingbuffer->pucFree) {
+        return pdFALSE;     //Byte buffers do not allow multiple retrievals before return
+    }
+    return (__atomic_load_n(&pxRingbuffer->pucWrite, __ATOMIC_RELAXED) != pxRingbuffer->pucRead) ? pdTRUE : pdFALSE;
+}
+
+static void prvCopyItemSPSC(Ringbuffer_t *pxRingbuffer, const uint8_t *pucItem, size_t xItemSize)
+{
+    uint8_t *pucWrite = pxRingbuffer->pucWrite;
+    configASSERT(pucWrite >= pxRingbuffer->pucHead && pucWrite < pxRingbuffer->pucTail);     //Check write pointer is within bounds
+
+    size_t xRemLen = pxRingbuffer->pucTail - pucWrite;     //Length from pucWrite until end of buffer
+    if (xRemLen <= xItemSize) {
+        //Fill up to the end of the buffer and wrap around
+        memcpy(pucWrite, pucItem, xRemLen);
+        pucItem += xRemLen;
+        xItemSize -= xRemLen;
+        pucWrite = pxRingbuffer->pucHead;
+    }
+    memcpy(pucWrite, pucItem, xItemSize);
+    pucWrite += xItemSize;
+
+    //Release pairs with the acquire in prvGetItemSPSC(), so the data is visible before the new write pointer
+    __atomic_store_n(&pxRingbuffer->pucAcquire, pucWrite, __ATOMIC_RELAXED);
+    __atomic_store_n(&pxRingbuffer->pucWrite, pucWrite, __ATOMIC_RELEASE);
+}
+
+static void *prvGetItemSPSC(Ringbuffer_t *pxRingbuffer,
+                            BaseType_t *pxUnusedParam,
+                            size_t xMaxSize,
+                            size_t *pxItemSize)
+{
+    uint8_t *pucWrite = __atomic_load_n(&pxRingbuffer->pucWrite, __ATOMIC_ACQUIRE);
+    uint8_t *ret = pxRingbuffer->pucRead;
+    configASSERT(ret != pucWrite);      //Check there is data to be read
+    configASSERT(ret >= pxRingbuffer->pucHead && ret < pxRingbuffer->pucTail);    //Check read pointer is within bounds
+
+    //Return contiguous piece from read pointer until write pointer or buffer tail, or xMaxSize
+    size_t xItemSize = (pucWrite > ret) ? (size_t)(pucWrite - ret) : (size_t)(pxRingbuffer->pucTail - ret);
+    if (xMaxSize != 0 && xItemSize > xMaxSize) {
+        xItemSize = xMaxSize;
+    }
+    pxRingbuffer->pucRead = ret + xItemSize;
+    if (pxRingbuffer->pucRead == pxRingbuffer->pucTail) {
+        pxRingbuffer->pucRead = pxRingbuffer->pucHead;  //Wrap around read pointer
+    }
+    *pxItemSize = xItemSize;
+    return (void *)ret;
+}
+
+static void *prvGetWrappedItemSPSC(Ringbuffer_t *pxRingbuffer, size_t xMaxSize, size_t *pxItemSize)
+{
+    uint8_t *pucWrite = __atomic_load_n(&pxRingbuffer->pucWrite, __ATOMIC_ACQUIRE);
+    uint8_t *ret = pxRingbuffer->pucRead;
+
+    *pxItemSize = 0;
+    if (ret != pxRingbuffer->pucHead || pucWrite == ret || xMaxSize == 0) {
+        return NULL;    //Data did not wrap around, nothing left to read, or no more data requested
+    }
+    //The remaining data is contiguous from the head of the buffer to the write pointer
+    size_t xItemSize = pucWrite - ret;
+    if (xItemSize > xMaxSize) {
+        xItemSize = xMaxSize;
+    }
+    pxRingbuffer->pucRead = ret + xItemSize;
+    *pxItemSize = xItemSize;
+    return (void *)ret;
+}
+
+static void prvReturnItemSPSC(Ringbuffer_t *pxRingbuffer, uint8_t *pucItem)
+{
+    //Check pointer points to address inside buffer
+    configASSERT(pucItem >= pxRingbuffer->pucHead);
+    configASSERT(pucItem < pxRingbuffer->pucTail);
+    //Free the read memory. The producer may overwrite it as soon as the free pointer is stored
+    __atomic_store_n(&pxRingbuffer->pucFree, pxRingbuffer->pucRead, __ATOMIC_RELEASE);
+}
+
+static size_t prvGetBytesWaitingSPSC(Ringbuffer_t *pxRingbuffer)
+{
+    BaseType_t xBytesWaiting = __atomic_load_n(&pxRingbuffer->pucWrite, __ATOMIC_RELAXED) - pxRingbuffer->pucRead;
+    if (xBytesWaiting < 0) {
+        xBytesWaiting += pxRingbuffer->xSize;
+    }
+    return xBytesWaiting;
+}
+
+static BaseType_t prvBlockSPSC(Ringbuffer_t *pxRingbuffer,
+                               UBaseType_t uxWaitingFlag,
+                               List_t *pxTasksWaiting,
+                               CheckItemFitsFunction_t xCheckReady,
+                               size_t xItemSize,
+                               TimeOut_t *pxTimeOut,
+                               TickType_t *pxTicksToWait)
+{
+    BaseType_t xReturn = pdTRUE;
+
+    portENTER_CRITICAL(&pxRingbuffer->mux);
+    /*
+     * Set the waiting flag before checking again. Paired with the fence in
+     * prvWakeSPSC(), either the other side sees the flag after its update, or
+     * the update is seen here.
+     */
+    __atomic_store_n(&pxRingbuffer->uxWaitingFlags, pxRingbuffer->uxWaitingFlags | uxWaitingFlag, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    if (xCheckReady(pxRingbuffer, xItemSize) == pdTRUE) {
+        __atomic_store_n(&pxRingbuffer->uxWaitingFlags, pxRingbuffer->uxWaitingFlags & ~uxWaitingFlag, __ATOMIC_RELAXED);
+    } else if (xTaskCheckForTimeOut(pxTimeOut, pxTicksToWait) == pdFALSE) {
+        //Not timed out yet. Block the current task, the flag is cleared by the task unblocking it
+        vTaskPlaceOnEventList(pxTasksWaiting, *pxTicksToWait);
+        portYIELD_WITHIN_API();
+    } else {
+        //We have timed out
+        __atomic_store_n(&pxRingbuffer->uxWaitingFlags, pxRingbuffer->uxWaitingFlags & ~uxWaitingFlag, __ATOMIC_RELAXED);
+        xReturn = pdFALSE;
+    }
+    portEXIT_CRITICAL(&pxRingbuffer->mux);
+
+    return xReturn;
+}
+
+static void prvWakeSPSC(Ringbuffer_t *pxRingbuffer, UBaseType_t uxWaitingFlag, List_t *pxTasksWaiting)
+{
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    if ((__atomic_load_n(&pxRingbuffer->uxWaitingFlags, __ATOMIC_RELAXED) & uxWaitingFlag) == 0) {
+        return;     //Nobody is waiting, which is the common case
+    }
+
+    portENTER_CRITICAL(&pxRingbuffer->mux);
+    __atomic_store_n(&pxRingbuffer->uxWaitingFlags, pxRingbuffer->uxWaitingFlags & ~uxWaitingFlag, __ATOMIC_RELAXED);
+    if (listLIST_IS_EMPTY(pxTasksWaiting) == pdFALSE) {
+        if (xTaskRemoveFromEventList(pxTasksWaiting) == pdTRUE) {
+            //The unblocked task will preempt us. Trigger a yield here.
+            portYIELD_WITHIN_API();
+        }
+    }
+    portEXIT_CRITICAL(&pxRingbuffer->mux);
+}
+
+static void prvWakeSPSCFromISR(Ringbuffer_t *pxRingbuffer,
+                               UBaseType_t uxWaitingFlag,
+                               List_t *pxTasksWaiting,
+                               BaseType_t *pxHigherPriorityTaskWoken)
+{
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    if ((__atomic_load_n(&pxRingbuffer->uxWaitingFlags, __ATOMIC_RELAXED) & uxWaitingFlag) == 0) {
+        return;     //Nobody is waiting, which is the common case
+    }
+
+    portENTER_CRITICAL_ISR(&pxRingbuffer->mux);
+    __atomic_store_n(&pxRingbuffer->uxWaitingFlags, pxRingbuffer->uxWaitingFlags & ~uxWaitingFlag, __ATOMIC_RELAXED);
+    if (listLIST_IS_EMPTY(pxTasksWaiting) == pdFALSE) {
+        if (xTaskRemoveFromEventList(pxTasksWaiting) == pdTRUE) {
+            //The unblocked task will preempt us. Record that a context switch is required.
+            if (pxHigherPriorityTaskWoken != NULL) {
+                *pxHigherPriorityTaskWoken = pdTRUE;
+            }
+        }
+    }
+    portEXIT_CRITICAL_ISR(&pxRingbuffer->mux);
+}
+
+static BaseType_t prvSendSPSC(Ringbuffer_t *pxRingbuffer, const void *pvItem, size_t xItemSize, TickType_t xTicksToWait)
+{
+    BaseType_t xEntryTimeSet = pdFALSE;
+    TimeOut_t xTimeOut;
+
+    while (prvCheckItemFitsSPSC(pxRingbuffer, xItemSize) == pdFALSE) {
+        if (xTicksToWait == (TickType_t) 0) {
+            //No block time. Return immediately.
+            return pdFALSE;
+        }
+        if (xEntryTimeSet == pdFALSE) {
+            //This is our first block. Set entry time
+            vTaskSetTimeOutState(&xTimeOut);
+            xEntryTimeSet = pdTRUE;
+        }
+        if (prvBlockSPSC(pxRingbuffer, rbTX_WAITING_FLAG, &pxRingbuffer->xTasksWaitingToSend,
+                         prvCheckItemFitsSPSC, xItemSize, &xTimeOut, &xTicksToWait) == pdFALSE) {
+            return pdFALSE;
+        }
+    }
+    prvCopyItemSPSC(pxRingbuffer, pvItem, xItemSize);
+    //If a task was waiting for data to arrive on the ring buffer, unblock it
+    prvWakeSPSC(pxRingbuffer, rbRX_WAITING_FLAG, &pxRingbuffer->xTasksWaitingToReceive);
+    return pdTRUE;
+}
+
+static BaseType_t prvReceiveSPSC(Ringbuffer_t *pxRingbuffer,
+                                 void **pvItem1,
+                                 void **pvItem2,
+                                 size_t *xItemSize1,
+                                 size_t *xItemSize2,
+                                 size_t xMaxSize,
+                                 TickType_t xTicksToWait)
+{
+    BaseType_t xEntryTimeSet = pdFALSE;
+    TimeOut_t xTimeOut;
+
+    while (prvCheckItemAvailSPSC(pxRingbuffer, 0) == pdFALSE) {
+        if (xTicksToWait == (TickType_t) 0) {
+            //No block time. Return immediately.
+            return pdFALSE;
+        }
+        if (xEntryTimeSet == pdFALSE) {
+            //This is our first block. Set entry time
+            vTaskSetTimeOutState(&xTimeOut);
+            xEntryTimeSet = pdTRUE;
+        }
+        if (prvBlockSPSC(pxRingbuffer, rbRX_WAITING_FLAG, &pxRingbuffer->xTasksWaitingToReceive,
+                         prvCheckItemAvailSPSC, 0, &xTimeOut, &xTicksToWait) == pdFALSE) {
+            return pdFALSE;
+        }
+    }
+    *pvItem1 = prvGetItemSPSC(pxRingbuffer, NULL, xMaxSize, xItemSize1);
+    if (pvItem2 != NULL && xItemSize2 != NULL) {
+        *pvItem2 = prvGetWrappedItemSPSC(pxRingbuffer, xMaxSize - *xItemSize1, xItemSize2);
+    }
+    return pdTRUE;
+}
+
 static BaseType_t prvSendAcquireGeneric(Ringbuffer_t *pxRingbuffer,
                                         const void *pvItem,
                                         void **ppvItem,
                                         size_t xItemSize,
+                                        UBaseType_t uxItemCount,
                                         TickType_t xTicksToWait)
 {
-    BaseType_t xReturn = pdFALSE;
+    BaseType_t xReturn = 0;
     BaseType_t xExitLoop = pdFALSE;
     BaseType_t xEntryTimeSet = pdFALSE;
     BaseType_t xNotifyQueueSet = pdFALSE;
@@ -780,8 +1162,11 @@ static BaseType_t prvSendAcquireGeneric(Ringbuffer_t *pxRingbuffer,
         if (pxRingbuffer->xCheckItemFits(pxRingbuffer, xItemSize) == pdTRUE) {
             //xItemSize will fit. Copy or acquire the buffer immediately
             if (ppvItem) {
-                //Acquire the buffer
-                *ppvItem = prvAcquireItemNoSplit(pxRingbuffer, xItemSize);
+                //Acquire the buffer, then as many of the following ones as currently fit
+                ppvItem[xReturn++] = prvAcquireItemNoSplit(pxRingbuffer, xItemSize);
+                while (xReturn < uxItemCount && pxRingbuffer->xCheckItemFits(pxRingbuffer, xItemSize) == pdTRUE) {
+                    ppvItem[xReturn++] = prvAcquireItemNoSplit(pxRingbuffer, xItemSize);
+                }
             } else {
                 //Copy item into buffer
                 pxRingbuffer->vCopyItem(pxRingbuffer, pvItem, xItemSize);
@@ -797,8 +1182,8 @@ static BaseType_t prvSendAcquireGeneric(Ringbuffer_t *pxRingbuffer,
                         }
                     }
                 }
+                xReturn = 1;
             }
-            xReturn = pdTRUE;
             xExitLoop = pdTRUE;
             goto loop_end;
         } else if (xTicksToWait == (TickType_t) 0) {
@@ -845,6 +1230,10 @@ static BaseType_t prvReceiveGeneric(Ringbuffer_t *pxRingbuffer,
 
     ESP_STATIC_ANALYZER_CHECK(!pvItem1 || !xItemSize1, pdFALSE);
 
+    if (pxRingbuffer->uxRingbufferFlags & rbSPSC_FLAG) {
+        return prvReceiveSPSC(pxRingbuffer, pvItem1, pvItem2, xItemSize1, xItemSize2, xMaxSize, xTicksToWait);
+    }
+
     while (xExitLoop == pdFALSE) {
         portENTER_CRITICAL(&pxRingbuffer->mux);
         if (prvCheckItemAvail(pxRingbuffer) == pdTRUE) {
@@ -853,6 +1242,10 @@ static BaseType_t prvReceiveGeneric(Ringbuffer_t *pxRingbuffer,
             if (pxRingbuffer->uxRingbufferFlags & rbBYTE_BUFFER_FLAG) {
                 //Read up to xMaxSize bytes from byte buffer
                 *pvItem1 = pxRingbuffer->pvGetItem(pxRingbuffer, NULL, xMaxSize, xItemSize1);
+                if (pvItem2 != NULL && xItemSize2 != NULL) {
+                    //Also read the data wrapped around to the head of the buffer
+                    *pvItem2 = prvGetWrappedItemByteBuf(pxRingbuffer, xMaxSize - *xItemSize1, xItemSize2);
+                }
             } else {
                 //Get (first) item from no-split/allow-split buffers
                 *pvItem1 = pxRingbuffer->pvGetItem(pxRingbuffer, &xIsSplit, 0, xItemSize1);
@@ -907,12 +1300,27 @@ static BaseType_t prvReceiveGenericFromISR(Ringbuffer_t *pxRingbuffer,
 
     ESP_STATIC_ANALYZER_CHECK(!pvItem1 || !xItemSize1, pdFALSE);
 
+    if (pxRingbuffer->uxRingbufferFlags & rbSPSC_FLAG) {
+        if (prvCheckItemAvailSPSC(pxRingbuffer, 0) == pdFALSE) {
+            return pdFALSE;
+        }
+        *pvItem1 = prvGetItemSPSC(pxRingbuffer, NULL, xMaxSize, xItemSize1);
+        if (pvItem2 != NULL && xItemSize2 != NULL) {
+            *pvItem2 = prvGetWrappedItemSPSC(pxRingbuffer, xMaxSize - *xItemSize1, xItemSize2);
+        }
+        return pdTRUE;
+    }
+
     portENTER_CRITICAL_ISR(&pxRingbuffer->mux);
     if (prvCheckItemAvail(pxRingbuffer) == pdTRUE) {
         BaseType_t xIsSplit = pdFALSE;
         if (pxRingbuffer->uxRingbufferFlags & rbBYTE_BUFFER_FLAG) {
             //Read up to xMaxSize bytes from byte buffer
             *pvItem1 = pxRingbuffer->pvGetItem(pxRingbuffer, NULL, xMaxSize, xItemSize1);
+            if (pvItem2 != NULL && xItemSize2 != NULL) {
+                //Also read the data wrapped around to the head of the buffer
+                *pvItem2 = prvGetWrappedItemByteBuf(pxRingbuffer, xMaxSize - *xItemSize1, xItemSize2);
+            }
         } else {
             //Get (first) item from no-split/allow-split buffers
             *pvItem1 = pxRingbuffer->pvGetItem(pxRingbuffer, &xIsSplit, 0, xItemSize1);
@@ -937,6 +1345,53 @@ static BaseType_t prvReceiveGenericFromISR(Ringbuffer_t *pxRingbuffer,
     return xReturn;
 }
 
+static UBaseType_t prvReceiveMultipleNoSplit(Ringbuffer_t *pxRingbuffer,
+                                             void **ppvItems,
+                                             size_t *pxItemSizes,
+                                             UBaseType_t uxMaxItems,
+                                             TickType_t xTicksToWait)
+{
+    UBaseType_t uxReturn = 0;
+    BaseType_t xExitLoop = pdFALSE;
+    BaseType_t xEntryTimeSet = pdFALSE;
+    TimeOut_t xTimeOut;
+
+    while (xExitLoop == pdFALSE) {
+        portENTER_CRITICAL(&pxRingbuffer->mux);
+        if (prvCheckItemAvail(pxRingbuffer) == pdTRUE) {
+            //Retrieve items until uxMaxItems or until an item is not available (not yet written)
+            do {
+                BaseType_t xIsSplit;
+                ppvItems[uxReturn] = pxRingbuffer->pvGetItem(pxRingbuffer, &xIsSplit, 0, &pxItemSizes[uxReturn]);
+                uxReturn++;
+            } while (uxReturn < uxMaxItems && prvCheckItemAvail(pxRingbuffer) == pdTRUE);
+            xExitLoop = pdTRUE;
+            goto loop_end;
+        } else if (xTicksToWait == (TickType_t) 0) {
+            //No block time. Return immediately.
+            xExitLoop = pdTRUE;
+            goto loop_end;
+        } else if (xEntryTimeSet == pdFALSE) {
+            //This is our first block. Set entry time
+            vTaskInternalSetTimeOutState(&xTimeOut);
+            xEntryTimeSet = pdTRUE;
+        }
+
+        if (xTaskCheckForTimeOut(&xTimeOut, &xTicksToWait) == pdFALSE) {
+            //Not timed out yet. Block the current task
+            vTaskPlaceOnEventList(&pxRingbuffer->xTasksWaitingToReceive, xTicksToWait);
+            portYIELD_WITHIN_API();
+        } else {
+            //We have timed out.
+            xExitLoop = pdTRUE;
+        }
+loop_end:
+        portEXIT_CRITICAL(&pxRingbuffer->mux);
+    }
+
+    return uxReturn;
+}
+
 // ------------------------------------------------ Public Functions ---------------------------------------------------
 
 RingbufHandle_t xRingbufferCreate(size_t xBufferSize, RingbufferType_t xBufferType)
@@ -945,7 +1400,7 @@ RingbufHandle_t xRingbufferCreate(size_t xBufferSize, RingbufferType_t xBufferTy
     configASSERT(xBufferType < RINGBUF_TYPE_MAX);
 
     //Allocate memory
-    if (xBufferType != RINGBUF_TYPE_BYTEBUF) {
+    if (xBufferType == RINGBUF_TYPE_NOSPLIT || xBufferType == RINGBUF_TYPE_ALLOWSPLIT) {
         xBufferSize = rbALIGN_SIZE(xBufferSize);    //xBufferSize is rounded up for no-split/allow-split buffers
     }
     Ringbuffer_t *pxNewRingbuffer = calloc(1, sizeof(Ringbuffer_t));
@@ -978,7 +1433,7 @@ RingbufHandle_t xRingbufferCreateStatic(size_t xBufferSize,
     configASSERT(xBufferSize > 0);
     configASSERT(xBufferType < RINGBUF_TYPE_MAX);
     configASSERT(pucRingbufferStorage != NULL && pxStaticRingbuffer != NULL);
-    if (xBufferType != RINGBUF_TYPE_BYTEBUF) {
+    if (xBufferType == RINGBUF_TYPE_NOSPLIT || xBufferType == RINGBUF_TYPE_ALLOWSPLIT) {
         //No-split/allow-split buffer sizes must be 32-bit aligned
         configASSERT(rbCHECK_ALIGNED(xBufferSize));
     }
@@ -1003,7 +1458,7 @@ BaseType_t xRingbufferSendAcquire(RingbufHandle_t xRingbuffer, void **ppvItem, s
         return pdFALSE;     //Data will never ever fit in the queue.
     }
 
-    return prvSendAcquireGeneric(pxRingbuffer, NULL, ppvItem, xItemSize, xTicksToWait);
+    return prvSendAcquireGeneric(pxRingbuffer, NULL, ppvItem, xItemSize, 1, xTicksToWait);
 }
 
 BaseType_t xRingbufferSendComplete(RingbufHandle_t xRingbuffer, void *pvItem)
@@ -1038,6 +1493,63 @@ BaseType_t xRingbufferSendComplete(RingbufHandle_t xRingbuffer, void *pvItem)
     return pdTRUE;
 }
 
+UBaseType_t xRingbufferSendAcquireMultiple(RingbufHandle_t xRingbuffer,
+                                          void **ppvItems,
+                                          size_t xItemSize,
+                                          UBaseType_t uxItemCount,
+                                          TickType_t xTicksToWait)
+{
+    Ringbuffer_t *pxRingbuffer = (Ringbuffer_t *)xRingbuffer;
+
+    //Check arguments
+    configASSERT(pxRingbuffer);
+    configASSERT(ppvItems != NULL && uxItemCount > 0);
+    configASSERT((pxRingbuffer->uxRingbufferFlags & (rbBYTE_BUFFER_FLAG | rbALLOW_SPLIT_FLAG)) == 0); //Send acquire currently only supported in NoSplit buffers
+
+    if (xItemSize > pxRingbuffer->xMaxItemSize) {
+        return 0;       //Data will never ever fit in the queue.
+    }
+
+    return (UBaseType_t)prvSendAcquireGeneric(pxRingbuffer, NULL, ppvItems, xItemSize, uxItemCount, xTicksToWait);
+}
+
+BaseType_t xRingbufferSendCompleteMultiple(RingbufHandle_t xRingbuffer, void **ppvItems, UBaseType_t uxItemCount)
+{
+    Ringbuffer_t *pxRingbuffer = (Ringbuffer_t *)xRingbuffer;
+
+    //Check arguments
+    configASSERT(pxRingbuffer);
+    configASSERT(ppvItems != NULL);
+    configASSERT((pxRingbuffer->uxRingbufferFlags & (rbBYTE_BUFFER_FLAG | rbALLOW_SPLIT_FLAG)) == 0);
+
+    if (uxItemCount == 0) {
+        return pdTRUE;
+    }
+    portENTER_CRITICAL(&pxRingbuffer->mux);
+    for (UBaseType_t i = 0; i < uxItemCount; i++) {
+        configASSERT(ppvItems[i] != NULL);
+        prvSendItemDoneNoSplit(pxRingbuffer, ppvItems[i]);
+    }
+    if (pxRingbuffer->xQueueSet == NULL) {
+        //If a task was waiting for data to arrive on the ring buffer, unblock it immediately.
+        if (listLIST_IS_EMPTY(&pxRingbuffer->xTasksWaitingToReceive) == pdFALSE) {
+            if (xTaskRemoveFromEventList(&pxRingbuffer->xTasksWaitingToReceive) == pdTRUE) {
+                //The unblocked task will preempt us. Trigger a yield here.
+                portYIELD_WITHIN_API();
+            }
+        }
+    }
+    portEXIT_CRITICAL(&pxRingbuffer->mux);
+
+    if (pxRingbuffer->xQueueSet) {
+        //A queue set holds one event per item, so notify it once for every item completed
+        for (UBaseType_t i = 0; i < uxItemCount; i++) {
+            xQueueSend((QueueHandle_t)pxRingbuffer->xQueueSet, (QueueSetMemberHandle_t *)&pxRingbuffer, 0);
+        }
+    }
+    return pdTRUE;
+}
+
 BaseType_t xRingbufferSend(RingbufHandle_t xRingbuffer,
                            const void *pvItem,
                            size_t xItemSize,
@@ -1054,8 +1566,11 @@ BaseType_t xRingbufferSend(RingbufHandle_t xRingbuffer,
     if ((pxRingbuffer->uxRingbufferFlags & rbBYTE_BUFFER_FLAG) && xItemSize == 0) {
         return pdTRUE;      //Sending 0 bytes to byte buffer has no effect
     }
+    if (pxRingbuffer->uxRingbufferFlags & rbSPSC_FLAG) {
+        return prvSendSPSC(pxRingbuffer, pvItem, xItemSize, xTicksToWait);
+    }
 
-    return prvSendAcquireGeneric(pxRingbuffer, pvItem, NULL, xItemSize, xTicksToWait);
+    return prvSendAcquireGeneric(pxRingbuffer, pvItem, NULL, xItemSize, 1, xTicksToWait);
 }
 
 BaseType_t xRingbufferSendFromISR(RingbufHandle_t xRingbuffer,
@@ -1076,6 +1591,14 @@ BaseType_t xRingbufferSendFromISR(RingbufHandle_t xRingbuffer,
     if ((pxRingbuffer->uxRingbufferFlags & rbBYTE_BUFFER_FLAG) && xItemSize == 0) {
         return pdTRUE;      //Sending 0 bytes to byte buffer has no effect
     }
+    if (pxRingbuffer->uxRingbufferFlags & rbSPSC_FLAG) {
+        if (prvCheckItemFitsSPSC(pxRingbuffer, xItemSize) == pdFALSE) {
+            return pdFALSE;
+        }
+        prvCopyItemSPSC(pxRingbuffer, pvItem, xItemSize);
+        prvWakeSPSCFromISR(pxRingbuffer, rbRX_WAITING_FLAG, &pxRingbuffer->xTasksWaitingToReceive, pxHigherPriorityTaskWoken);
+        return pdTRUE;
+    }
 
     portENTER_CRITICAL_ISR(&pxRingbuffer->mux);
     if (pxRingbuffer->xCheckItemFits(xRingbuffer, xItemSize) == pdTRUE) {
@@ -1171,6 +1694,24 @@ BaseType_t xRingbufferReceiveSplitFromISR(RingbufHandle_t xRingbuffer,
     return prvReceiveGenericFromISR(pxRingbuffer, ppvHeadItem, ppvTailItem, pxHeadItemSize, pxTailItemSize, 0);
 }
 
+UBaseType_t xRingbufferReceiveMultiple(RingbufHandle_t xRingbuffer,
+                                      void **ppvItems,
+                                      size_t *pxItemSizes,
+                                      UBaseType_t uxMaxItems,
+                                      TickType_t xTicksToWait)
+{
+    Ringbuffer_t *pxRingbuffer = (Ringbuffer_t *)xRingbuffer;
+
+    //Check arguments
+    configASSERT(pxRingbuffer && ppvItems && pxItemSizes);
+    configASSERT((pxRingbuffer->uxRingbufferFlags & (rbBYTE_BUFFER_FLAG | rbALLOW_SPLIT_FLAG)) == 0);    //This function should only be called for no-split buffers
+
+    if (uxMaxItems == 0) {
+        return 0;
+    }
+    return prvReceiveMultipleNoSplit(pxRingbuffer, ppvItems, pxItemSizes, uxMaxItems, xTicksToWait);
+}
+
 void *xRingbufferReceiveUpTo(RingbufHandle_t xRingbuffer,
                              size_t *pxItemSize,
                              TickType_t xTicksToWait,
@@ -1214,12 +1755,43 @@ void *xRingbufferReceiveUpToFromISR(RingbufHandle_t xRingbuffer, size_t *pxItemS
     }
 }
 
+BaseType_t xRingbufferReceiveUpToSplit(RingbufHandle_t xRingbuffer,
+                                       void **ppvHeadItem,
+                                       void **ppvTailItem,
+                                       size_t *pxHeadItemSize,
+                                       size_t *pxTailItemSize,
+                                       TickType_t xTicksToWait,
+                                       size_t xMaxSize)
+{
+    Ringbuffer_t *pxRingbuffer = (Ringbuffer_t *)xRingbuffer;
+
+    //Check arguments
+    configASSERT(pxRingbuffer && ppvHeadItem && ppvTailItem && pxHeadItemSize && pxTailItemSize);
+    configASSERT(pxRingbuffer->uxRingbufferFlags & rbBYTE_BUFFER_FLAG);    //This function should only be called for byte buffers
+
+    *ppvHeadItem = NULL;
+    *ppvTailItem = NULL;
+    *pxTailItemSize = 0;
+    if (xMaxSize == 0) {
+        return pdFALSE;
+    }
+    //Attempt to retrieve up to xMaxSize bytes, in up to two contiguous parts
+    return prvReceiveGeneric(pxRingbuffer, ppvHeadItem, ppvTailItem, pxHeadItemSize, pxTailItemSize, xMaxSize, xTicksToWait);
+}
+
 void vRingbufferReturnItem(RingbufHandle_t xRingbuffer, void *pvItem)
 {
     Ringbuffer_t *pxRingbuffer = (Ringbuffer_t *)xRingbuffer;
     configASSERT(pxRingbuffer);
     configASSERT(pvItem != NULL);
 
+    if (pxRingbuffer->uxRingbufferFlags & rbSPSC_FLAG) {
+        prvReturnItemSPSC(pxRingbuffer, (uint8_t *)pvItem);
+        //If a task was waiting for space to send, unblock it
+        prvWakeSPSC(pxRingbuffer, rbTX_WAITING_FLAG, &pxRingbuffer->xTasksWaitingToSend);
+        return;
+    }
+
     portENTER_CRITICAL(&pxRingbuffer->mux);
     pxRingbuffer->vReturnItem(pxRingbuffer, (uint8_t *)pvItem);
     //If a task was waiting for space to send, unblock it immediately.
@@ -1238,6 +1810,13 @@ void vRingbufferReturnItemFromISR(RingbufHandle_t xRingbuffer, void *pvItem, Bas
     configASSERT(pxRingbuffer);
     configASSERT(pvItem != NULL);
 
+    if (pxRingbuffer->uxRingbufferFlags & rbSPSC_FLAG) {
+        prvReturnItemSPSC(pxRingbuffer, (uint8_t *)pvItem);
+        //If a task was waiting for space to send, unblock it
+        prvWakeSPSCFromISR(pxRingbuffer, rbTX_WAITING_FLAG, &pxRingbuffer->xTasksWaitingToSend, pxHigherPriorityTaskWoken);
+        return;
+    }
+
     portENTER_CRITICAL_ISR(&pxRingbuffer->mux);
     pxRingbuffer->vReturnItem(pxRingbuffer, (uint8_t *)pvItem);
     //If a task was waiting for space to send, unblock it immediately.
@@ -1252,6 +1831,39 @@ void vRingbufferReturnItemFromISR(RingbufHandle_t xRingbuffer, void *pvItem, Bas
     portEXIT_CRITICAL_ISR(&pxRingbuffer->mux);
 }
 
+void vRingbufferReturnItemMultiple(RingbufHandle_t xRingbuffer, void **ppvItems, UBaseType_t uxItemCount)
+{
+    Ringbuffer_t *pxRingbuffer = (Ringbuffer_t *)xRingbuffer;
+    configASSERT(pxRingbuffer);
+    configASSERT(ppvItems != NULL);
+
+    if (uxItemCount == 0) {
+        return;
+    }
+    if (pxRingbuffer->uxRingbufferFlags & rbSPSC_FLAG) {
+        for (UBaseType_t i = 0; i < uxItemCount; i++) {
+            prvReturnItemSPSC(pxRingbuffer, (uint8_t *)ppvItems[i]);
+        }
+        //If a task was waiting for space to send, unblock it
+        prvWakeSPSC(pxRingbuffer, rbTX_WAITING_FLAG, &pxRingbuffer->xTasksWaitingToSend);
+        return;
+    }
+
+    portENTER_CRITICAL(&pxRingbuffer->mux);
+    for (UBaseType_t i = 0; i < uxItemCount; i++) {
+        configASSERT(ppvItems[i] != NULL);
+        pxRingbuffer->vReturnItem(pxRingbuffer, (uint8_t *)ppvItems[i]);
+    }
+    //If a task was waiting for space to send, unblock it immediately.
+    if (listLIST_IS_EMPTY(&pxRingbuffer->xTasksWaitingToSend) == pdFALSE) {
+        if (xTaskRemoveFromEventList(&pxRingbuffer->xTasksWaitingToSend) == pdTRUE) {
+            //The unblocked task will preempt us. Trigger a yield here.
+            portYIELD_WITHIN_API();
+        }
+    }
+    portEXIT_CRITICAL(&pxRingbuffer->mux);
+}
+
 esp_err_t vRingbufferReset(RingbufHandle_t xRingbuffer)
 {
     Ringbuffer_t *pxRingbuffer = (Ringbuffer_t *)xRingbuffer;
@@ -1270,7 +1882,9 @@ esp_err_t vRingbufferReset(RingbufHandle_t xRingbuffer)
     pxRingbuffer->pucWrite = pxRingbuffer->pucHead;
     pxRingbuffer->pucRead = pxRingbuffer->pucHead;
     pxRingbuffer->pucFree = pxRingbuffer->pucHead;
-    pxRingbuffer->xItemsWaiting = 0;
+    if ((pxRingbuffer->uxRingbufferFlags & rbSPSC_FLAG) == 0) {
+        pxRingbuffer->xItemsWaiting = 0;    //SPSC buffers keep the waiting flags of a blocked receiver
+    }
     pxRingbuffer->uxRingbufferFlags &= ~rbBUFFER_FULL_FLAG;
 
     // If there's a task waiting to transmit, unblock it
@@ -1323,9 +1937,12 @@ BaseType_t xRingbufferAddToQueueSetRead(RingbufHandle_t xRingbuffer, QueueSetHan
     configASSERT(pxRingbuffer && xQueueSet);
 
     portENTER_CRITICAL(&pxRingbuffer->mux);
-    if (pxRingbuffer->xQueueSet != NULL || prvCheckItemAvail(pxRingbuffer) == pdTRUE) {
+    if (pxRingbuffer->xQueueSet != NULL ||
+            (pxRingbuffer->uxRingbufferFlags & rbSPSC_FLAG) ||
+            prvCheckItemAvail(pxRingbuffer) == pdTRUE) {
         /*
         - Cannot add ring buffer to more than one queue set
+        - SPSC buffers do not notify queue sets
         - It is dangerous to add a ring buffer to a queue set if the ring buffer currently has data to be read.
         */
         xReturn = pdFALSE;
@@ -1387,7 +2004,11 @@ void vRingbufferGetInfo(RingbufHandle_t xRingbuffer,
         *uxAcquire = (UBaseType_t)(pxRingbuffer->pucAcquire - pxRingbuffer->pucHead);
     }
     if (uxItemsWaiting != NULL) {
-        *uxItemsWaiting = (UBaseType_t)(pxRingbuffer->xItemsWaiting);
+        if (pxRingbuffer->uxRingbufferFlags & rbSPSC_FLAG) {
+            *uxItemsWaiting = (UBaseType_t)prvGetBytesWaitingSPSC(pxRingbuffer);
+        } else {
+            *uxItemsWaiting = (UBaseType_t)(pxRingbuffer->xItemsWaiting);
+        }
     }
     portEXIT_CRITICAL(&pxRingbuffer->mux);
 }
@@ -1406,7 +2027,7 @@ void xRingbufferPrintInfo(RingbufHandle_t xRingbuffer)
            (int32_t)(pxRingbuffer->pucFree - pxRingbuffer->pucHead),
            (int32_t)(pxRingbuffer->pucWrite - pxRingbuffer->pucHead),
            (int32_t)(pxRingbuffer->pucAcquire - pxRingbuffer->pucHead),
-           (int32_t)pxRingbuffer->xItemsWaiting,
+           (int32_t)((RingbufferFlags & rbSPSC_FLAG) ? prvGetBytesWaitingSPSC(pxRingbuffer) : pxRingbuffer->xItemsWaiting),
            RingbufferFlags);
 
     if (RingbufferFlags) {
@@ -1425,6 +2046,9 @@ void xRingbufferPrintInfo(RingbufHandle_t xRingbuffer)
         if (RingbufferFlags & rbUSING_QUEUE_SET) {
             printf(" [USING_QUEUE_SET]");
         }
+        if (RingbufferFlags & rbSPSC_FLAG) {
+            printf(" [SPSC]");
+        }
     }
     printf(" ]\n  Items:\n");
 
@@ -1497,7 +2121,7 @@ RingbufHandle_t xRingbufferCreateWithCaps(size_t xBufferSize, RingbufferType_t x
     uint8_t *pucRingbufferStorage;
 
     //Allocate memory
-    if (xBufferType != RINGBUF_TYPE_BYTEBUF) {
+    if (xBufferType == RINGBUF_TYPE_NOSPLIT || xBufferType == RINGBUF_TYPE_ALLOWSPLIT) {
         xBufferSize = rbALIGN_SIZE(xBufferSize);    //xBufferSize is rounded up for no-split/allow-split buffers
     }
 
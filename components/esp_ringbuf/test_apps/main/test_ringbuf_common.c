@@ -13,6 +13,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <inttypes.h>
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include "freertos/queue.h"
@@ -769,7 +770,7 @@ void read_from_buffer(RingbufHandle_t buffer, RingbufferType_t buf_type, size_t
 
             //Check received item and return it
             TEST_ASSERT_MESSAGE(item_data != NULL, "Failed to receive an item");
-            if (buf_type == RINGBUF_TYPE_BYTEBUF) {
+            if (buf_type == RINGBUF_TYPE_BYTEBUF || buf_type == RINGBUF_TYPE_BYTEBUF_SPSC) {
                 TEST_ASSERT_MESSAGE(item_size <= max_rec_size, "Received data exceeds max size");
             }
             for (int i = 0; i < item_size; i++) {
@@ -1377,3 +1378,361 @@ TEST_CASE("Test ring buffer reset unblocks sender ", "[esp_ringbuf][linux]")
     vRingbufferDelete(rb);
     vTaskDelay(1);
 }
+
+/* --------------------- Test single-producer/single-consumer byte buffers ----------------------
+ * The following test cases test the behavior of SPSC byte buffers and compare their throughput
+ * with byte buffers, with one task sending chunks of a fixed size and another task receiving
+ * them.
+ */
+
+TEST_CASE("Test SPSC byte buffer", "[esp_ringbuf][linux]")
+{
+    RingbufHandle_t rb = xRingbufferCreate(BUFFER_SIZE, RINGBUF_TYPE_BYTEBUF_SPSC);
+    TEST_ASSERT_MESSAGE(rb != NULL, "Failed to create ring buffer");
+
+    //One byte is kept free
+    TEST_ASSERT_EQUAL(BUFFER_SIZE - 1, xRingbufferGetMaxItemSize(rb));
+    TEST_ASSERT_EQUAL(BUFFER_SIZE - 1, xRingbufferGetCurFreeSize(rb));
+    TEST_ASSERT_EQUAL(pdFALSE, xRingbufferAddToQueueSetRead(rb, (QueueSetHandle_t)rb));
+
+    //Send and receive items until the data wraps around a few times
+    int no_of_items = (3 * BUFFER_SIZE) / LARGE_ITEM_SIZE;
+    for (int i = 0; i < no_of_items; i++) {
+        send_item_and_check(rb, large_item, LARGE_ITEM_SIZE, TIMEOUT_TICKS, false);
+        UBaseType_t bytes_waiting;
+        vRingbufferGetInfo(rb, NULL, NULL, NULL, NULL, &bytes_waiting);
+        TEST_ASSERT_EQUAL(LARGE_ITEM_SIZE, bytes_waiting);
+        receive_check_and_return_item_byte_buffer(rb, large_item, LARGE_ITEM_SIZE, TIMEOUT_TICKS, i % 2);
+    }
+
+    //Fill the buffer
+    size_t free_size = xRingbufferGetCurFreeSize(rb);
+    while (free_size >= SMALL_ITEM_SIZE) {
+        send_item_and_check(rb, small_item, SMALL_ITEM_SIZE, 0, false);
+        TEST_ASSERT_EQUAL(free_size - SMALL_ITEM_SIZE, xRingbufferGetCurFreeSize(rb));
+        free_size -= SMALL_ITEM_SIZE;
+    }
+    send_item_and_check_failure(rb, small_item, SMALL_ITEM_SIZE, TIMEOUT_TICKS, false);
+    send_item_and_check_failure(rb, small_item, SMALL_ITEM_SIZE, 0, true);
+
+    //Only one retrieval is allowed before returning the data
+    size_t item_size;
+    void *item = xRingbufferReceiveUpTo(rb, &item_size, 0, SMALL_ITEM_SIZE);
+    TEST_ASSERT_NOT_NULL(item);
+    TEST_ASSERT_NULL(xRingbufferReceiveUpTo(rb, &item_size, 0, SMALL_ITEM_SIZE));
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_STATE, vRingbufferReset(rb));
+    vRingbufferReturnItem(rb, item);
+    TEST_ASSERT_EQUAL(free_size + item_size, xRingbufferGetCurFreeSize(rb));
+
+    //Reset and check the buffer is empty
+    TEST_ASSERT_EQUAL(ESP_OK, vRingbufferReset(rb));
+    TEST_ASSERT_EQUAL(BUFFER_SIZE - 1, xRingbufferGetCurFreeSize(rb));
+    TEST_ASSERT_NULL(xRingbufferReceive(rb, &item_size, TIMEOUT_TICKS));
+
+    vRingbufferDelete(rb);
+}
+
+#define THROUGHPUT_BUFFER_SIZE          4096
+#define THROUGHPUT_DATA_LEN             (1024 * 1024)
+
+typedef struct {
+    RingbufHandle_t buffer;
+    size_t chunk_size;
+    SemaphoreHandle_t done;
+} throughput_args_t;
+
+static void throughput_send_task(void *args)
+{
+    throughput_args_t *targs = (throughput_args_t *)args;
+    uint8_t *chunk = malloc(targs->chunk_size);
+    TEST_ASSERT_NOT_NULL(chunk);
+    uint8_t seq = 0;
+
+    for (size_t sent = 0; sent < THROUGHPUT_DATA_LEN; sent += targs->chunk_size) {
+        for (size_t i = 0; i < targs->chunk_size; i++) {
+            chunk[i] = seq++;
+        }
+        TEST_ASSERT_EQUAL(pdTRUE, xRingbufferSend(targs->buffer, chunk, targs->chunk_size, portMAX_DELAY));
+    }
+    free(chunk);
+    xSemaphoreGive(targs->done);
+    vTaskDelete(NULL);
+}
+
+static void throughput_rec_task(void *args)
+{
+    throughput_args_t *targs = (throughput_args_t *)args;
+    uint8_t seq = 0;
+
+    for (size_t received = 0; received < THROUGHPUT_DATA_LEN;) {
+        size_t item_size;
+        uint8_t *item = xRingbufferReceiveUpTo(targs->buffer, &item_size, portMAX_DELAY, targs->chunk_size);
+        TEST_ASSERT_NOT_NULL(item);
+        for (size_t i = 0; i < item_size; i++) {
+            TEST_ASSERT_EQUAL_UINT8(seq++, item[i]);
+        }
+        received += item_size;
+        vRingbufferReturnItem(targs->buffer, item);
+    }
+    xSemaphoreGive(targs->done);
+    vTaskDelete(NULL);
+}
+
+static uint32_t measure_throughput(RingbufferType_t buf_type, size_t chunk_size)
+{
+    throughput_args_t targs = {
+        .buffer = xRingbufferCreate(THROUGHPUT_BUFFER_SIZE, buf_type),
+        .chunk_size = chunk_size,
+        .done = xSemaphoreCreateCounting(2, 0),
+    };
+    TEST_ASSERT_NOT_NULL(targs.buffer);
+    TEST_ASSERT_NOT_NULL(targs.done);
+
+    TickType_t start = xTaskGetTickCount();
+    xTaskCreatePinnedToCore(throughput_rec_task, "rec tsk", 4096, &targs, 10, NULL, 0);
+    xTaskCreatePinnedToCore(throughput_send_task, "send tsk", 4096, &targs, 10, NULL, CONFIG_FREERTOS_NUMBER_OF_CORES - 1);
+    xSemaphoreTake(targs.done, portMAX_DELAY);
+    xSemaphoreTake(targs.done, portMAX_DELAY);
+    TickType_t ticks = xTaskGetTickCount() - start;
+
+    vTaskDelay(5);  //Allow idle to clean up
+    vSemaphoreDelete(targs.done);
+    vRingbufferDelete(targs.buffer);
+    return (uint32_t)(((uint64_t)THROUGHPUT_DATA_LEN * configTICK_RATE_HZ) / (ticks ? ticks : 1));
+}
+
+TEST_CASE("Test SPSC byte buffer throughput", "[esp_ringbuf][linux]")
+{
+    for (size_t chunk_size = 16; chunk_size <= 1024; chunk_size *= 4) {
+        uint32_t bytebuf = measure_throughput(RINGBUF_TYPE_BYTEBUF, chunk_size);
+        uint32_t spsc = measure_throughput(RINGBUF_TYPE_BYTEBUF_SPSC, chunk_size);
+        printf("%4u byte chunks: BYTEBUF %" PRIu32 " bytes/s, BYTEBUF_SPSC %" PRIu32 " bytes/s\n",
+               (unsigned)chunk_size, bytebuf, spsc);
+    }
+}
+
+/* --------------------- Test batch send/receive ----------------------
+ * The following test cases test sending, receiving and returning several items of a no-split
+ * buffer at once, retrieving the data that wraps around a byte buffer in a single call, and
+ * compare the throughput of no-split buffers for different batch sizes.
+ */
+
+TEST_CASE("Test no-split buffer batch send and receive", "[esp_ringbuf][linux]")
+{
+    RingbufHandle_t rb = xRingbufferCreate(BUFFER_SIZE, RINGBUF_TYPE_NOSPLIT);
+    TEST_ASSERT_MESSAGE(rb != NULL, "Failed to create ring buffer");
+    size_t initial_free_size = xRingbufferGetCurFreeSize(rb);
+    void *tx_items[MAX_NUM_ITEMS + 1];
+    void *rx_items[MAX_NUM_ITEMS + 1];
+    size_t rx_sizes[MAX_NUM_ITEMS + 1];
+
+    //Nothing to receive in an empty buffer
+    TEST_ASSERT_EQUAL(0, xRingbufferReceiveMultiple(rb, rx_items, rx_sizes, MAX_NUM_ITEMS, TIMEOUT_TICKS));
+
+    //Fill the buffer in a single batch
+    TEST_ASSERT_EQUAL(MAX_NUM_ITEMS, xRingbufferSendAcquireMultiple(rb, tx_items, MEDIUM_ITEM_SIZE, MAX_NUM_ITEMS + 1, TIMEOUT_TICKS));
+    TEST_ASSERT_EQUAL(0, xRingbufferSendAcquireMultiple(rb, &tx_items[MAX_NUM_ITEMS], MEDIUM_ITEM_SIZE, 1, 0));
+
+    //Items are only received up to the first item that is not sent yet
+    TEST_ASSERT_EQUAL(pdTRUE, xRingbufferSendCompleteMultiple(rb, &tx_items[1], MAX_NUM_ITEMS - 1));
+    TEST_ASSERT_EQUAL(0, xRingbufferReceiveMultiple(rb, rx_items, rx_sizes, MAX_NUM_ITEMS, 0));
+    TEST_ASSERT_EQUAL(pdTRUE, xRingbufferSendCompleteMultiple(rb, tx_items, 1));
+    TEST_ASSERT_EQUAL(MAX_NUM_ITEMS, xRingbufferReceiveMultiple(rb, rx_items, rx_sizes, MAX_NUM_ITEMS + 1, 0));
+    for (int i = 0; i < MAX_NUM_ITEMS; i++) {
+        TEST_ASSERT_EQUAL_PTR(tx_items[i], rx_items[i]);
+        TEST_ASSERT_EQUAL(MEDIUM_ITEM_SIZE, rx_sizes[i]);
+    }
+    vRingbufferReturnItemMultiple(rb, rx_items, MAX_NUM_ITEMS);
+    TEST_ASSERT_EQUAL(initial_free_size, xRingbufferGetCurFreeSize(rb));
+
+    //Send and receive batches of different sizes until the buffer wraps around a few times
+    uint8_t seq = 0;
+    for (int round = 0; round < 3 * MAX_NUM_ITEMS; round++) {
+        UBaseType_t batch = (round % MAX_NUM_ITEMS) + 1;
+        UBaseType_t count = xRingbufferSendAcquireMultiple(rb, tx_items, MEDIUM_ITEM_SIZE, batch, TIMEOUT_TICKS);
+        TEST_ASSERT(count > 0 && count <= batch);
+        for (int i = 0; i < count; i++) {
+            memset(tx_items[i], seq + i, MEDIUM_ITEM_SIZE);
+        }
+        TEST_ASSERT_EQUAL(pdTRUE, xRingbufferSendCompleteMultiple(rb, tx_items, count));
+
+        TEST_ASSERT_EQUAL(count, xRingbufferReceiveMultiple(rb, rx_items, rx_sizes, MAX_NUM_ITEMS + 1, TIMEOUT_TICKS));
+        for (int i = 0; i < count; i++) {
+            TEST_ASSERT_EQUAL(MEDIUM_ITEM_SIZE, rx_sizes[i]);
+            for (int j = 0; j < MEDIUM_ITEM_SIZE; j++) {
+                TEST_ASSERT_EQUAL_UINT8(seq, ((uint8_t *)rx_items[i])[j]);
+            }
+            seq++;
+        }
+        vRingbufferReturnItemMultiple(rb, rx_items, count);
+        TEST_ASSERT_EQUAL(initial_free_size, xRingbufferGetCurFreeSize(rb));
+    }
+
+    vRingbufferDelete(rb);
+}
+
+static void receive_split_and_check(RingbufHandle_t rb, const uint8_t *expected, size_t max_size, size_t head_size, size_t tail_size)
+{
+    void *head;
+    void *tail;
+    size_t head_item_size;
+    size_t tail_item_size;
+
+    TEST_ASSERT_EQUAL(pdTRUE, xRingbufferReceiveUpToSplit(rb, &head, &tail, &head_item_size, &tail_item_size, TIMEOUT_TICKS, max_size));
+    TEST_ASSERT_NOT_NULL(head);
+    TEST_ASSERT_EQUAL(head_size, head_item_size);
+    TEST_ASSERT_EQUAL_MEMORY(expected, head, head_size);
+    TEST_ASSERT_EQUAL(tail_size, tail_item_size);
+    if (tail_size == 0) {
+        TEST_ASSERT_NULL(tail);
+    } else {
+        TEST_ASSERT_NOT_NULL(tail);
+        TEST_ASSERT_EQUAL_MEMORY(expected + head_size, tail, tail_size);
+    }
+    vRingbufferReturnItem(rb, head);
+}
+
+TEST_CASE("Test byte buffer receive with wrap around", "[esp_ringbuf][linux]")
+{
+    static uint8_t data[BUFFER_SIZE];
+    const size_t half = (BUFFER_SIZE) / 2;
+    for (int i = 0; i < (BUFFER_SIZE); i++) {
+        data[i] = i;
+    }
+
+    RingbufferType_t buf_types[] = {RINGBUF_TYPE_BYTEBUF, RINGBUF_TYPE_BYTEBUF_SPSC};
+    for (int type = 0; type < sizeof(buf_types) / sizeof(buf_types[0]); type++) {
+        RingbufHandle_t rb = xRingbufferCreate(BUFFER_SIZE, buf_types[type]);
+        TEST_ASSERT_MESSAGE(rb != NULL, "Failed to create ring buffer");
+        size_t initial_free_size = xRingbufferGetCurFreeSize(rb);
+
+        //Nothing to receive in an empty buffer
+        void *head;
+        void *tail;
+        size_t head_size;
+        size_t tail_size;
+        TEST_ASSERT_EQUAL(pdFALSE, xRingbufferReceiveUpToSplit(rb, &head, &tail, &head_size, &tail_size, TIMEOUT_TICKS, BUFFER_SIZE));
+        TEST_ASSERT_NULL(head);
+
+        //Data that does not wrap around is retrieved in a single part
+        send_item_and_check(rb, data, half, TIMEOUT_TICKS, false);
+        receive_split_and_check(rb, data, BUFFER_SIZE, half, 0);
+
+        //Data that wraps around is retrieved in two parts, both freed by returning the first part
+        send_item_and_check(rb, data, half + SMALL_ITEM_SIZE, TIMEOUT_TICKS, false);
+        receive_split_and_check(rb, data, BUFFER_SIZE, half, SMALL_ITEM_SIZE);
+        TEST_ASSERT_EQUAL(initial_free_size, xRingbufferGetCurFreeSize(rb));
+
+        //The maximum size limits the size of both parts
+        send_item_and_check(rb, data, half - SMALL_ITEM_SIZE, TIMEOUT_TICKS, false);
+        receive_split_and_check(rb, data, BUFFER_SIZE, half - SMALL_ITEM_SIZE, 0);
+        send_item_and_check(rb, data, half + SMALL_ITEM_SIZE, TIMEOUT_TICKS, false);
+        receive_split_and_check(rb, data, SMALL_ITEM_SIZE, SMALL_ITEM_SIZE, 0);
+        receive_split_and_check(rb, data + SMALL_ITEM_SIZE, half - 2, half - SMALL_ITEM_SIZE, SMALL_ITEM_SIZE - 2);
+        receive_split_and_check(rb, data + half + SMALL_ITEM_SIZE - 2, BUFFER_SIZE, 2, 0);
+        TEST_ASSERT_EQUAL(initial_free_size, xRingbufferGetCurFreeSize(rb));
+
+        vRingbufferDelete(rb);
+    }
+}
+
+#define BATCH_ITEM_SIZE                 16
+#define BATCH_ITEM_COUNT                (64 * 1024)
+#define BATCH_MAX_SIZE                  64
+
+typedef struct {
+    RingbufHandle_t buffer;
+    UBaseType_t batch_size;
+    SemaphoreHandle_t done;
+} batch_args_t;
+
+static void batch_send_task(void *args)
+{
+    batch_args_t *bargs = (batch_args_t *)args;
+    void *items[BATCH_MAX_SIZE];
+    uint32_t seq = 0;
+
+    while (seq < BATCH_ITEM_COUNT) {
+        UBaseType_t batch = bargs->batch_size;
+        if (batch > BATCH_ITEM_COUNT - seq) {
+            batch = BATCH_ITEM_COUNT - seq;
+        }
+        UBaseType_t count;
+        if (batch == 1) {
+            count = xRingbufferSendAcquire(bargs->buffer, &items[0], BATCH_ITEM_SIZE, portMAX_DELAY);
+        } else {
+            count = xRingbufferSendAcquireMultiple(bargs->buffer, items, BATCH_ITEM_SIZE, batch, portMAX_DELAY);
+        }
+        TEST_ASSERT(count > 0);
+        for (int i = 0; i < count; i++) {
+            *(uint32_t *)items[i] = seq++;
+        }
+        if (batch == 1) {
+            TEST_ASSERT_EQUAL(pdTRUE, xRingbufferSendComplete(bargs->buffer, items[0]));
+        } else {
+            TEST_ASSERT_EQUAL(pdTRUE, xRingbufferSendCompleteMultiple(bargs->buffer, items, count));
+        }
+    }
+    xSemaphoreGive(bargs->done);
+    vTaskDelete(NULL);
+}
+
+static void batch_rec_task(void *args)
+{
+    batch_args_t *bargs = (batch_args_t *)args;
+    void *items[BATCH_MAX_SIZE];
+    size_t item_sizes[BATCH_MAX_SIZE];
+    uint32_t seq = 0;
+
+    while (seq < BATCH_ITEM_COUNT) {
+        UBaseType_t count;
+        if (bargs->batch_size == 1) {
+            items[0] = xRingbufferReceive(bargs->buffer, &item_sizes[0], portMAX_DELAY);
+            count = (items[0] != NULL);
+        } else {
+            count = xRingbufferReceiveMultiple(bargs->buffer, items, item_sizes, bargs->batch_size, portMAX_DELAY);
+        }
+        TEST_ASSERT(count > 0);
+        for (int i = 0; i < count; i++) {
+            TEST_ASSERT_EQUAL(BATCH_ITEM_SIZE, item_sizes[i]);
+            TEST_ASSERT_EQUAL_UINT32(seq++, *(uint32_t *)items[i]);
+        }
+        if (bargs->batch_size == 1) {
+            vRingbufferReturnItem(bargs->buffer, items[0]);
+        } else {
+            vRingbufferReturnItemMultiple(bargs->buffer, items, count);
+        }
+    }
+    xSemaphoreGive(bargs->done);
+    vTaskDelete(NULL);
+}
+
+static uint32_t measure_batch_throughput(UBaseType_t batch_size)
+{
+    batch_args_t bargs = {
+        .buffer = xRingbufferCreate(THROUGHPUT_BUFFER_SIZE, RINGBUF_TYPE_NOSPLIT),
+        .batch_size = batch_size,
+        .done = xSemaphoreCreateCounting(2, 0),
+    };
+    TEST_ASSERT_NOT_NULL(bargs.buffer);
+    TEST_ASSERT_NOT_NULL(bargs.done);
+
+    TickType_t start = xTaskGetTickCount();
+    xTaskCreatePinnedToCore(batch_rec_task, "rec tsk", 4096, &bargs, 10, NULL, 0);
+    xTaskCreatePinnedToCore(batch_send_task, "send tsk", 4096, &bargs, 10, NULL, CONFIG_FREERTOS_NUMBER_OF_CORES - 1);
+    xSemaphoreTake(bargs.done, portMAX_DELAY);
+    xSemaphoreTake(bargs.done, portMAX_DELAY);
+    TickType_t ticks = xTaskGetTickCount() - start;
+
+    vTaskDelay(5);  //Allow idle to clean up
+    vSemaphoreDelete(bargs.done);
+    vRingbufferDelete(bargs.buffer);
+    return (uint32_t)(((uint64_t)BATCH_ITEM_COUNT * configTICK_RATE_HZ) / (ticks ? ticks : 1));
+}
+
+TEST_CASE("Test no-split buffer batch throughput", "[esp_ringbuf][linux]")
+{
+    for (UBaseType_t batch_size = 1; batch_size <= BATCH_MAX_SIZE; batch_size *= 4) {
+        printf("%2u item batches: %" PRIu32 " items/s\n", (unsigned)batch_size, measure_batch_throughput(batch_size));
+    }
+}
@@ -16,6 +16,10 @@
 #include "private_include/diskio_private.h"
 #include "ffconf.h"
 #include "ff.h"
+#include "sdkconfig.h"
+#if CONFIG_FATFS_DISKIO_CACHE
+#include "private_include/diskio_cache.h"
+#endif
 
 static ff_diskio_impl_t * s_impls[FF_VOLUMES] = { NULL };
 
@@ -70,6 +74,9 @@ void ff_diskio_register(BYTE pdrv, const ff_diskio_impl_t* discio_impl)
 
     if (s_impls[pdrv]) {
         ff_diskio_impl_t* im = s_impls[pdrv];
+#if CONFIG_FATFS_DISKIO_CACHE
+        ff_diskio_cache_deinit(pdrv, im);
+#endif
         s_impls[pdrv] = NULL;
         free(im);
     }
@@ -82,10 +89,16 @@ void ff_diskio_register(BYTE pdrv, const ff_diskio_impl_t* discio_impl)
     assert(impl != NULL);
     memcpy(impl, discio_impl, sizeof(ff_diskio_impl_t));
     s_impls[pdrv] = impl;
+#if CONFIG_FATFS_DISKIO_CACHE
+    ff_diskio_cache_init(pdrv);
+#endif
 }
 
 DSTATUS ff_disk_initialize (BYTE pdrv)
 {
+#if CONFIG_FATFS_DISKIO_CACHE
+    ff_diskio_cache_invalidate(pdrv, s_impls[pdrv]);
+#endif
     return s_impls[pdrv]->init(pdrv);
 }
 DSTATUS ff_disk_status (BYTE pdrv)
@@ -94,17 +107,38 @@ DSTATUS ff_disk_status (BYTE pdrv)
 }
 DRESULT ff_disk_read (BYTE pdrv, BYTE* buff, LBA_t sector, UINT count)
 {
+#if CONFIG_FATFS_DISKIO_CACHE
+    return ff_diskio_cache_read(pdrv, s_impls[pdrv], buff, sector, count);
+#else
     return s_impls[pdrv]->read(pdrv, buff, sector, count);
+#endif
 }
 DRESULT ff_disk_write (BYTE pdrv, const BYTE* buff, LBA_t sector, UINT count)
 {
+#if CONFIG_FATFS_DISKIO_CACHE
+    return ff_diskio_cache_write(pdrv, s_impls[pdrv], buff, sector, count);
+#else
     return s_impls[pdrv]->write(pdrv, buff, sector, count);
+#endif
 }
 DRESULT ff_disk_ioctl (BYTE pdrv, BYTE cmd, void* buff)
 {
+#if CONFIG_FATFS_DISKIO_CACHE
+    return ff_diskio_cache_ioctl(pdrv, s_impls[pdrv], cmd, buff);
+#else
     return s_impls[pdrv]->ioctl(pdrv, cmd, buff);
+#endif
 }
 
+#if !CONFIG_FATFS_DISKIO_CACHE
+esp_err_t ff_diskio_get_cache_stats(BYTE pdrv, ff_diskio_cache_stats_t* stats)
+{
+    (void) pdrv;
+    (void) stats;
+    return ESP_ERR_NOT_SUPPORTED;
+}
+#endif
+
 DWORD get_fattime(void)
 {
     time_t t = time(NULL);
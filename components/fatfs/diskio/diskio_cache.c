@@ -0,0 +1,298 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdbool.h>
+#include <string.h>
+#include <stdlib.h>
+#include <sys/lock.h>
+#include <sys/param.h>
+#include "diskio_impl.h"
+#include "ffconf.h"
+#include "ff.h"
+#include "esp_log.h"
+#include "esp_compiler.h"
+#include "sdkconfig.h"
+#include "private_include/diskio_cache.h"
+
+static const char *TAG = "ff_diskio_cache";
+
+#define READ_AHEAD_SECTORS      CONFIG_FATFS_DISKIO_CACHE_READ_AHEAD_SECTORS
+#define WRITE_BUFFER_SECTORS    CONFIG_FATFS_DISKIO_CACHE_WRITE_BUFFER_SECTORS
+
+typedef struct {
+    _lock_t lock;
+    UINT sector_size;           /* 0 until the buffers are allocated */
+    LBA_t sector_count;         /* size of the drive, prefetching stops at its end */
+    BYTE *read_buf;             /* READ_AHEAD_SECTORS sectors */
+    LBA_t read_start;           /* sectors [read_start, read_start + read_count) are in read_buf */
+    UINT read_count;
+    LBA_t next_read;            /* sector following the previous read request */
+    BYTE *write_buf;            /* WRITE_BUFFER_SECTORS sectors */
+    LBA_t write_start;          /* sectors [write_start, write_start + write_count) are pending in write_buf */
+    UINT write_count;
+    ff_diskio_cache_stats_t stats;
+} ff_diskio_cache_t;
+
+static ff_diskio_cache_t *s_caches[FF_VOLUMES] = { NULL };
+
+static bool ranges_overlap(LBA_t start1, UINT count1, LBA_t start2, UINT count2)
+{
+    return start1 < start2 + count2 && start2 < start1 + count1;
+}
+
+/* Allocate the buffers once the sector size is known. Returns false if the cache can't be used. */
+static bool cache_setup(BYTE pdrv, ff_diskio_cache_t *cache, const ff_diskio_impl_t *impl)
+{
+    if (cache->sector_size != 0) {
+        return true;
+    }
+#if FF_MAX_SS != FF_MIN_SS
+    WORD sector_size = 0;
+    if (impl->ioctl(pdrv, GET_SECTOR_SIZE, &sector_size) != RES_OK || sector_size == 0) {
+        return false;
+    }
+#else
+    WORD sector_size = FF_MAX_SS;
+#endif
+    LBA_t sector_count = 0;
+    if (impl->ioctl(pdrv, GET_SECTOR_COUNT, &sector_count) != RES_OK || sector_count == 0) {
+        return false;
+    }
+    cache->read_buf = malloc(READ_AHEAD_SECTORS * sector_size);
+    cache->write_buf = malloc(WRITE_BUFFER_SECTORS * sector_size);
+    if (cache->read_buf == NULL || cache->write_buf == NULL) {
+        ESP_LOGW(TAG, "not enough memory for the cache of drive %d, using direct access", pdrv);
+        free(cache->read_buf);
+        free(cache->write_buf);
+        cache->read_buf = NULL;
+        cache->write_buf = NULL;
+        return false;
+    }
+    cache->sector_size = sector_size;
+    cache->sector_count = sector_count;
+    cache->read_count = 0;
+    cache->write_count = 0;
+    return true;
+}
+
+static DRESULT flush_writes(BYTE pdrv, ff_diskio_cache_t *cache, const ff_diskio_impl_t *impl)
+{
+    if (cache->write_count == 0) {
+        return RES_OK;
+    }
+    DRESULT res = impl->write(pdrv, cache->write_buf, cache->write_start, cache->write_count);
+    cache->stats.device_writes++;
+    if (unlikely(res != RES_OK)) {
+        // Keep the sectors, the write is retried on the next flush
+        ESP_LOGE(TAG, "writing %u sectors at %u failed (%d)", (unsigned) cache->write_count, (unsigned) cache->write_start, res);
+        return res;
+    }
+    cache->write_count = 0;
+    return RES_OK;
+}
+
+void ff_diskio_cache_init(BYTE pdrv)
+{
+    ff_diskio_cache_t *cache = calloc(1, sizeof(ff_diskio_cache_t));
+    if (cache == NULL) {
+        ESP_LOGW(TAG, "not enough memory for the cache of drive %d, using direct access", pdrv);
+        return;
+    }
+    _lock_init(&cache->lock);
+    s_caches[pdrv] = cache;
+}
+
+void ff_diskio_cache_deinit(BYTE pdrv, const ff_diskio_impl_t *impl)
+{
+    ff_diskio_cache_t *cache = s_caches[pdrv];
+    if (cache == NULL) {
+        return;
+    }
+    s_caches[pdrv] = NULL;
+    flush_writes(pdrv, cache, impl);
+    _lock_close(&cache->lock);
+    free(cache->read_buf);
+    free(cache->write_buf);
+    free(cache);
+}
+
+DRESULT ff_diskio_cache_invalidate(BYTE pdrv, const ff_diskio_impl_t *impl)
+{
+    ff_diskio_cache_t *cache = s_caches[pdrv];
+    if (cache == NULL) {
+        return RES_OK;
+    }
+    _lock_acquire(&cache->lock);
+    DRESULT res = flush_writes(pdrv, cache, impl);
+    cache->read_count = 0;
+    cache->next_read = 0;
+    if (res == RES_OK) {
+        // The media may have been replaced, get its geometry again on next access
+        free(cache->read_buf);
+        free(cache->write_buf);
+        cache->read_buf = NULL;
+        cache->write_buf = NULL;
+        cache->sector_size = 0;
+    }
+    _lock_release(&cache->lock);
+    return res;
+}
+
+DRESULT ff_diskio_cache_read(BYTE pdrv, const ff_diskio_impl_t *impl, BYTE *buff, LBA_t sector, UINT count)
+{
+    ff_diskio_cache_t *cache = s_caches[pdrv];
+    if (cache == NULL) {
+        return impl->read(pdrv, buff, sector, count);
+    }
+    DRESULT res = RES_OK;
+    _lock_acquire(&cache->lock);
+    if (!cache_setup(pdrv, cache, impl)) {
+        res = impl->read(pdrv, buff, sector, count);
+        goto out;
+    }
+    cache->stats.read_requests++;
+
+    // Pending sectors must reach the device before they are read back
+    if (cache->write_count != 0 && ranges_overlap(sector, count, cache->write_start, cache->write_count)) {
+        res = flush_writes(pdrv, cache, impl);
+        if (res != RES_OK) {
+            goto out;
+        }
+    }
+
+    bool sequential = (sector == cache->next_read);
+    cache->next_read = sector + count;
+    while (count > 0) {
+        if (cache->read_count != 0 && sector >= cache->read_start && sector < cache->read_start + cache->read_count) {
+            UINT n = MIN(count, cache->read_start + cache->read_count - sector);
+            memcpy(buff, &cache->read_buf[(sector - cache->read_start) * cache->sector_size], n * cache->sector_size);
+            cache->stats.read_hits += n;
+            buff += n * cache->sector_size;
+            sector += n;
+            count -= n;
+            continue;
+        }
+        if (!sequential || count >= READ_AHEAD_SECTORS || sector >= cache->sector_count) {
+            // Random or large reads go directly to the device
+            res = impl->read(pdrv, buff, sector, count);
+            cache->stats.device_reads++;
+            goto out;
+        }
+        // Sequential access: read the requested sectors and the following ones in a single operation
+        UINT prefetch = MIN(READ_AHEAD_SECTORS, cache->sector_count - sector);
+        cache->read_count = 0;
+        res = impl->read(pdrv, cache->read_buf, sector, prefetch);
+        cache->stats.device_reads++;
+        if (res != RES_OK) {
+            goto out;
+        }
+        cache->read_start = sector;
+        cache->read_count = prefetch;
+        // Pending sectors past the requested ones are newer than what was just read from the device
+        if (cache->write_count != 0 && ranges_overlap(sector, prefetch, cache->write_start, cache->write_count)) {
+            LBA_t start = MAX(sector, cache->write_start);
+            LBA_t end = MIN(sector + prefetch, cache->write_start + cache->write_count);
+            memcpy(&cache->read_buf[(start - sector) * cache->sector_size],
+                   &cache->write_buf[(start - cache->write_start) * cache->sector_size], (end - start) * cache->sector_size);
+        }
+    }
+
+out:
+    _lock_release(&cache->lock);
+    return res;
+}
+
+DRESULT ff_diskio_cache_write(BYTE pdrv, const ff_diskio_impl_t *impl, const BYTE *buff, LBA_t sector, UINT count)
+{
+    ff_diskio_cache_t *cache = s_caches[pdrv];
+    if (cache == NULL) {
+        return impl->write(pdrv, buff, sector, count);
+    }
+    DRESULT res = RES_OK;
+    _lock_acquire(&cache->lock);
+    if (!cache_setup(pdrv, cache, impl)) {
+        res = impl->write(pdrv, buff, sector, count);
+        goto out;
+    }
+    cache->stats.write_requests++;
+
+    // Keep the read-ahead data up to date
+    if (cache->read_count != 0 && ranges_overlap(sector, count, cache->read_start, cache->read_count)) {
+        LBA_t start = MAX(sector, cache->read_start);
+        LBA_t end = MIN(sector + count, cache->read_start + cache->read_count);
+        memcpy(&cache->read_buf[(start - cache->read_start) * cache->sector_size],
+               &buff[(start - sector) * cache->sector_size], (end - start) * cache->sector_size);
+    }
+
+    if (count >= WRITE_BUFFER_SECTORS) {
+        // Large writes go directly to the device, after the pending sectors which they may overwrite
+        res = flush_writes(pdrv, cache, impl);
+        if (res == RES_OK) {
+            res = impl->write(pdrv, buff, sector, count);
+            cache->stats.device_writes++;
+        }
+        goto out;
+    }
+
+    if (cache->write_count != 0) {
+        LBA_t write_end = cache->write_start + cache->write_count;
+        if (sector >= cache->write_start && sector <= write_end &&
+                sector + count <= cache->write_start + WRITE_BUFFER_SECTORS) {
+            // Rewrite of pending sectors or append to them
+            memcpy(&cache->write_buf[(sector - cache->write_start) * cache->sector_size], buff, count * cache->sector_size);
+            cache->write_count = MAX(write_end, sector + count) - cache->write_start;
+            cache->stats.merged_writes++;
+            goto out;
+        }
+        res = flush_writes(pdrv, cache, impl);
+        if (res != RES_OK) {
+            goto out;
+        }
+    }
+    memcpy(cache->write_buf, buff, count * cache->sector_size);
+    cache->write_start = sector;
+    cache->write_count = count;
+
+out:
+    _lock_release(&cache->lock);
+    return res;
+}
+
+DRESULT ff_diskio_cache_ioctl(BYTE pdrv, const ff_diskio_impl_t *impl, BYTE cmd, void *buff)
+{
+    ff_diskio_cache_t *cache = s_caches[pdrv];
+    if (cache == NULL || cmd == GET_SECTOR_COUNT || cmd == GET_SECTOR_SIZE || cmd == GET_BLOCK_SIZE) {
+        return impl->ioctl(pdrv, cmd, buff);
+    }
+    // Other commands (sync, trim, ...) expect all the data written so far to be on the device
+    _lock_acquire(&cache->lock);
+    DRESULT res = flush_writes(pdrv, cache, impl);
+    if (res == RES_OK) {
+#if FF_USE_TRIM
+        if (cmd == CTRL_TRIM) {
+            cache->read_count = 0;
+        }
+#endif
+        res = impl->ioctl(pdrv, cmd, buff);
+    }
+    _lock_release(&cache->lock);
+    return res;
+}
+
+esp_err_t ff_diskio_get_cache_stats(BYTE pdrv, ff_diskio_cache_stats_t *stats)
+{
+    if (pdrv >= FF_VOLUMES || stats == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    ff_diskio_cache_t *cache = s_caches[pdrv];
+    if (cache == NULL) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    _lock_acquire(&cache->lock);
+    *stats = cache->stats;
+    _lock_release(&cache->lock);
+    return ESP_OK;
+}
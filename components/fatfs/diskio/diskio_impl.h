@@ -56,6 +56,31 @@ void ff_diskio_register(BYTE pdrv, const ff_diskio_impl_t* discio_impl);
  */
 esp_err_t ff_diskio_get_drive(BYTE* out_pdrv);
 
+/**
+ * Statistics of the diskio cache (CONFIG_FATFS_DISKIO_CACHE) of a drive
+ */
+typedef struct {
+    uint32_t read_requests;     /*!< number of read requests from FatFs */
+    uint32_t write_requests;    /*!< number of write requests from FatFs */
+    uint32_t read_hits;         /*!< number of sectors served from the read-ahead buffer */
+    uint32_t device_reads;      /*!< number of read calls to the driver */
+    uint32_t device_writes;     /*!< number of write calls to the driver */
+    uint32_t merged_writes;     /*!< number of write requests merged into pending sectors */
+} ff_diskio_cache_stats_t;
+
+/**
+ * Get statistics of the diskio cache of a drive
+ *
+ * @param   pdrv                drive number
+ * @param   stats               pointer to the structure to fill
+ *
+ * @return  ESP_OK                  on success
+ *          ESP_ERR_INVALID_ARG     if pdrv or stats is invalid
+ *          ESP_ERR_INVALID_STATE   if the drive is not registered or its cache couldn't be allocated
+ *          ESP_ERR_NOT_SUPPORTED   if CONFIG_FATFS_DISKIO_CACHE is disabled
+ */
+esp_err_t ff_diskio_get_cache_stats(BYTE pdrv, ff_diskio_cache_stats_t* stats);
+
 
 #ifdef __cplusplus
 }
@@ -66,8 +66,14 @@ static DRESULT ff_wl_ioctl (BYTE pdrv, BYTE cmd, void *buff)
     ESP_LOGV(TAG, "ff_wl_ioctl: cmd=%i", cmd);
     assert(wl_handle != WL_INVALID_HANDLE);
     switch (cmd) {
-    case CTRL_SYNC:
+    case CTRL_SYNC: {
+        esp_err_t err = wl_flush(wl_handle);
+        if (unlikely(err != ESP_OK)) {
+            ESP_LOGE(TAG, "wl_flush failed (0x%x)", err);
+            return RES_ERROR;
+        }
         return RES_OK;
+    }
     case GET_SECTOR_COUNT:
         *((DWORD *) buff) = wl_size(wl_handle) / wl_sector_size(wl_handle);
         return RES_OK;
@@ -76,6 +82,19 @@ static DRESULT ff_wl_ioctl (BYTE pdrv, BYTE cmd, void *buff)
         return RES_OK;
     case GET_BLOCK_SIZE:
         return RES_ERROR;
+#if FF_USE_TRIM
+    case CTRL_TRIM: {
+        LBA_t start_sector = ((LBA_t *) buff)[0];
+        LBA_t end_sector = ((LBA_t *) buff)[1];
+        size_t sector_size = wl_sector_size(wl_handle);
+        esp_err_t err = wl_discard(wl_handle, start_sector * sector_size, (end_sector - start_sector + 1) * sector_size);
+        if (unlikely(err != ESP_OK)) {
+            ESP_LOGE(TAG, "wl_discard failed (0x%x)", err);
+            return RES_ERROR;
+        }
+        return RES_OK;
+    }
+#endif //FF_USE_TRIM
     }
     return RES_ERROR;
 }
@@ -0,0 +1,45 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "diskio_impl.h"
+
+/*
+ * Block cache between FatFs and the registered diskio drivers.
+ *
+ * Sequential reads are served from a read-ahead buffer which is filled with multi-sector reads,
+ * and adjacent sector writes are merged into a single multi-sector write. Each drive has its own
+ * buffers, which are allocated on first access, once the sector size of the drive is known.
+ */
+
+/**
+ * @brief Create the cache of a drive. Called when a driver is registered.
+ */
+void ff_diskio_cache_init(BYTE pdrv);
+
+/**
+ * @brief Write the pending sectors using the driver and free the cache of a drive.
+ *        Called before a driver is unregistered.
+ */
+void ff_diskio_cache_deinit(BYTE pdrv, const ff_diskio_impl_t *impl);
+
+/**
+ * @brief Write the pending sectors and drop the read-ahead data, e.g., when the media is initialized again.
+ */
+DRESULT ff_diskio_cache_invalidate(BYTE pdrv, const ff_diskio_impl_t *impl);
+
+DRESULT ff_diskio_cache_read(BYTE pdrv, const ff_diskio_impl_t *impl, BYTE *buff, LBA_t sector, UINT count);
+DRESULT ff_diskio_cache_write(BYTE pdrv, const ff_diskio_impl_t *impl, const BYTE *buff, LBA_t sector, UINT count);
+DRESULT ff_diskio_cache_ioctl(BYTE pdrv, const ff_diskio_impl_t *impl, BYTE cmd, void *buff);
+
+#ifdef __cplusplus
+}
+#endif
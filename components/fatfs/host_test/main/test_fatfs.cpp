@@ -5,9 +5,11 @@
  */
 #include <stdio.h>
 #include <string.h>
+#include <time.h>
 
 #include "ff.h"
 #include "esp_partition.h"
+#include "esp_private/partition_linux.h"
 #include "wear_levelling.h"
 #include "diskio_impl.h"
 #include "diskio_wl.h"
@@ -239,3 +241,153 @@ TEST_CASE("Test mounting 2 volumes, writing data and formatting the 2nd one, rea
     REQUIRE(wl_unmount(wl_handle0) == ESP_OK);
     REQUIRE(wl_unmount(wl_handle1) == ESP_OK);
 }
+
+#if CONFIG_FATFS_DISKIO_CACHE
+TEST_CASE("Sequential access in small chunks is merged by the diskio cache", "[fatfs]")
+{
+    BYTE pdrv;
+    FATFS fs;
+    FIL file;
+    UINT bw;
+
+    const esp_partition_t *partition = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_DATA_FAT, "storage");
+
+    wl_handle_t wl_handle;
+    REQUIRE(wl_mount(partition, &wl_handle) == ESP_OK);
+    REQUIRE(ff_diskio_get_drive(&pdrv) == ESP_OK);
+    REQUIRE(ff_diskio_register_wl_partition(pdrv, wl_handle) == ESP_OK);
+
+    LBA_t part_list[] = {100, 0, 0, 0};
+    BYTE work_area[FF_MAX_SS];
+    REQUIRE(f_fdisk(pdrv, part_list, work_area) == FR_OK);
+    const MKFS_PARM opt = {(BYTE)(FM_ANY | FM_SFD), 0, 0, 128, 0};
+    REQUIRE(f_mkfs("", &opt, work_area, sizeof(work_area)) == FR_OK);
+    REQUIRE(f_mount(&fs, "", 0) == FR_OK);
+
+    // Chunks smaller than a sector, so that FatFs accesses the disk one sector at a time
+    const uint32_t chunk_size = 1000;
+    const uint32_t chunk_count = 64;
+    char *data = (char*) malloc(chunk_size);
+    char *read = (char*) malloc(chunk_size);
+
+    ff_diskio_cache_stats_t before, after;
+    REQUIRE(ff_diskio_get_cache_stats(pdrv, &before) == ESP_OK);
+
+    REQUIRE(f_open(&file, "seq.bin", FA_CREATE_ALWAYS | FA_WRITE) == FR_OK);
+    for (uint32_t i = 0; i < chunk_count; i++) {
+        memset(data, 'a' + i % 26, chunk_size);
+        REQUIRE(f_write(&file, data, chunk_size, &bw) == FR_OK);
+        REQUIRE(bw == chunk_size);
+    }
+    REQUIRE(f_close(&file) == FR_OK);
+
+    REQUIRE(ff_diskio_get_cache_stats(pdrv, &after) == ESP_OK);
+    printf("writes: %u requests, %u device writes\n",
+           (unsigned) (after.write_requests - before.write_requests), (unsigned) (after.device_writes - before.device_writes));
+    REQUIRE(after.device_writes - before.device_writes < after.write_requests - before.write_requests);
+    before = after;
+
+    REQUIRE(f_open(&file, "seq.bin", FA_READ) == FR_OK);
+    for (uint32_t i = 0; i < chunk_count; i++) {
+        REQUIRE(f_read(&file, read, chunk_size, &bw) == FR_OK);
+        REQUIRE(bw == chunk_size);
+        memset(data, 'a' + i % 26, chunk_size);
+        REQUIRE(memcmp(data, read, chunk_size) == 0);
+    }
+    REQUIRE(f_close(&file) == FR_OK);
+
+    REQUIRE(ff_diskio_get_cache_stats(pdrv, &after) == ESP_OK);
+    printf("reads: %u requests, %u device reads\n",
+           (unsigned) (after.read_requests - before.read_requests), (unsigned) (after.device_reads - before.device_reads));
+    REQUIRE(after.read_hits > before.read_hits);
+    REQUIRE(after.device_reads - before.device_reads < after.read_requests - before.read_requests);
+
+    free(read);
+    free(data);
+
+    REQUIRE(f_mount(0, "", 0) == FR_OK);
+    ff_diskio_unregister(pdrv);
+    ff_diskio_clear_pdrv_wl(wl_handle);
+    REQUIRE(wl_unmount(wl_handle) == ESP_OK);
+}
+#else
+TEST_CASE("Diskio cache statistics are not available without the cache", "[fatfs]")
+{
+    ff_diskio_cache_stats_t stats;
+    REQUIRE(ff_diskio_get_cache_stats(0, &stats) == ESP_ERR_NOT_SUPPORTED);
+}
+#endif // CONFIG_FATFS_DISKIO_CACHE
+
+static double get_time_s(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// Benchmark only, run it with both the default and the "cache" configuration to compare the results
+TEST_CASE("Sequential read and write throughput", "[fatfs]")
+{
+    BYTE pdrv;
+    FATFS fs;
+    FIL file;
+    UINT bw;
+
+    const esp_partition_t *partition = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_DATA_FAT, "storage");
+
+    wl_handle_t wl_handle;
+    REQUIRE(wl_mount(partition, &wl_handle) == ESP_OK);
+    REQUIRE(ff_diskio_get_drive(&pdrv) == ESP_OK);
+    REQUIRE(ff_diskio_register_wl_partition(pdrv, wl_handle) == ESP_OK);
+
+    LBA_t part_list[] = {100, 0, 0, 0};
+    BYTE work_area[FF_MAX_SS];
+    REQUIRE(f_fdisk(pdrv, part_list, work_area) == FR_OK);
+    const MKFS_PARM opt = {(BYTE)(FM_ANY | FM_SFD), 0, 0, 128, 0};
+    REQUIRE(f_mkfs("", &opt, work_area, sizeof(work_area)) == FR_OK);
+    REQUIRE(f_mount(&fs, "", 0) == FR_OK);
+
+    const uint32_t chunk_size = 1000;
+    const uint32_t chunk_count = 512;
+    char *data = (char*) malloc(chunk_size);
+    memset(data, 0x5a, chunk_size);
+
+    esp_partition_clear_stats();
+    double start = get_time_s();
+    REQUIRE(f_open(&file, "bench.bin", FA_CREATE_ALWAYS | FA_WRITE) == FR_OK);
+    for (uint32_t i = 0; i < chunk_count; i++) {
+        REQUIRE(f_write(&file, data, chunk_size, &bw) == FR_OK);
+        REQUIRE(bw == chunk_size);
+    }
+    REQUIRE(f_close(&file) == FR_OK);
+    double write_time = get_time_s() - start;
+    size_t write_ops = esp_partition_get_write_ops();
+
+    esp_partition_clear_stats();
+    start = get_time_s();
+    REQUIRE(f_open(&file, "bench.bin", FA_READ) == FR_OK);
+    for (uint32_t i = 0; i < chunk_count; i++) {
+        REQUIRE(f_read(&file, data, chunk_size, &bw) == FR_OK);
+        REQUIRE(bw == chunk_size);
+    }
+    REQUIRE(f_close(&file) == FR_OK);
+    double read_time = get_time_s() - start;
+    size_t read_ops = esp_partition_get_read_ops();
+
+#if CONFIG_FATFS_DISKIO_CACHE
+    const char *cache_state = "enabled";
+#else
+    const char *cache_state = "disabled";
+#endif
+    printf("diskio cache %s: sequential write %.0f kB/s (%zu partition writes), read %.0f kB/s (%zu partition reads)\n",
+           cache_state,
+           chunk_size * chunk_count / 1000.0 / write_time, write_ops,
+           chunk_size * chunk_count / 1000.0 / read_time, read_ops);
+
+    free(data);
+
+    REQUIRE(f_mount(0, "", 0) == FR_OK);
+    ff_diskio_unregister(pdrv);
+    ff_diskio_clear_pdrv_wl(wl_handle);
+    REQUIRE(wl_unmount(wl_handle) == ESP_OK);
+}
@@ -6,6 +6,7 @@ from pytest_embedded_idf.utils import idf_parametrize
 
 
 @pytest.mark.host_test
+@pytest.mark.parametrize('config', ['default', 'cache'])
 @idf_parametrize('target', ['linux'], indirect=['target'])
 def test_fatfs_linux(dut: Dut) -> None:
     dut.expect_exact('All tests passed', timeout=120)
@@ -405,6 +405,24 @@ void heap_caps_get_info( multi_heap_info_t *info, uint32_t caps )
     }
 }
 
+void heap_caps_cache_get_stats( multi_heap_cache_stats_t *stats )
+{
+#if CONFIG_HEAP_CACHE
+    multi_heap_cache_get_stats(&small_block_cache, stats);
+#else
+    memset(stats, 0, sizeof(multi_heap_cache_stats_t));
+#endif
+}
+
+size_t heap_caps_cache_trim( void )
+{
+#if CONFIG_HEAP_CACHE
+    return multi_heap_cache_trim(&small_block_cache, heap_caps_cache_free_block);
+#else
+    return 0;
+#endif
+}
+
 void heap_caps_print_heap_info( uint32_t caps )
 {
     multi_heap_info_t info;
@@ -79,6 +79,14 @@ HEAP_IRAM_ATTR void heap_caps_free( void *ptr)
     heap_t *heap = find_containing_heap(block_owner_ptr);
     assert(heap != NULL && "free() target pointer is outside heap areas");
 
+#if CONFIG_HEAP_CACHE
+    //Keep small blocks from the default heaps for the next allocation of the same size class on this core
+    if ((get_all_caps(heap) & HEAP_CACHE_CAPS) == HEAP_CACHE_CAPS &&
+        multi_heap_cache_put(&small_block_cache, ptr, multi_heap_get_allocated_size(heap->heap, ptr))) {
+        return;
+    }
+#endif
+
 #if CONFIG_HEAP_TASK_TRACKING
     heap_caps_update_per_task_info_free(heap, ptr);
 #endif
@@ -88,6 +96,15 @@ HEAP_IRAM_ATTR void heap_caps_free( void *ptr)
     CALL_HOOK(esp_heap_trace_free_hook, ptr);
 }
 
+#if CONFIG_HEAP_CACHE
+HEAP_IRAM_ATTR void heap_caps_cache_free_block(void *ptr)
+{
+    heap_t *heap = find_containing_heap(ptr);
+    assert(heap != NULL);
+    multi_heap_free(heap->heap, ptr);
+}
+#endif
+
 HEAP_IRAM_ATTR static inline void *aligned_or_unaligned_alloc(multi_heap_handle_t heap, size_t size, size_t alignment, size_t offset) {
     if (alignment<=UNALIGNED_MEM_ALIGNMENT_BYTES) { //alloc and friends align to 32-bit by default
         return multi_heap_malloc(heap, size);
@@ -139,6 +156,21 @@ HEAP_IRAM_ATTR NOINLINE_ATTR void *heap_caps_aligned_alloc_base(size_t alignment
         size = (size + 3) & (~3); // int overflow checked above
     }
 
+#if CONFIG_HEAP_CACHE
+    if (alignment <= UNALIGNED_MEM_ALIGNMENT_BYTES && (caps & ~HEAP_CACHE_CAPS) == 0) {
+        int size_class = multi_heap_cache_get_class(size);
+        if (size_class >= 0) {
+            ret = multi_heap_cache_get(&small_block_cache, size_class);
+            if (ret != NULL) {
+                return ret;
+            }
+            //Allocate the full size of the class, so that the block can be cached when it is freed
+            size = multi_heap_cache_class_size(size_class);
+        }
+    }
+retry:
+#endif
+
     for (int prio = 0; prio < SOC_MEMORY_TYPE_NO_PRIOS; prio++) {
         //Iterate over heaps and check capabilities at this priority
         heap_t *heap;
@@ -198,6 +230,13 @@ HEAP_IRAM_ATTR NOINLINE_ATTR void *heap_caps_aligned_alloc_base(size_t alignment
         }
     }
 
+#if CONFIG_HEAP_CACHE
+    //Blocks held by the cache may be what prevents this allocation, return them to the heaps and try again
+    if (multi_heap_cache_trim(&small_block_cache, heap_caps_cache_free_block) > 0) {
+        goto retry;
+    }
+#endif
+
     //Nothing usable found.
     return NULL;
 }
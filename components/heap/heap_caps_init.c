@@ -22,6 +22,10 @@ static const char *TAG = "heap_init";
 /* Linked-list of registered heaps */
 struct registered_heap_ll registered_heaps;
 
+#if CONFIG_HEAP_CACHE
+multi_heap_cache_t small_block_cache;
+#endif
+
 ESP_SYSTEM_INIT_FN(init_heap, CORE, BIT(0), 100)
 {
     heap_caps_init();
@@ -172,6 +176,10 @@ void heap_caps_init(void)
        Allocate this part of data contiguously, even though it's a linked list... */
     assert(SLIST_EMPTY(&registered_heaps));
 
+#if CONFIG_HEAP_CACHE
+    multi_heap_cache_init(&small_block_cache, CONFIG_HEAP_CACHE_DEPTH);
+#endif
+
     heap_t *heaps_array = NULL;
     heap_t *used_heap = NULL;
     for (size_t i = 0; i < num_heaps; i++) {
@@ -44,6 +44,18 @@ typedef struct heap_t_ {
 */
 extern SLIST_HEAD(registered_heap_ll, heap_t_) registered_heaps;
 
+#if CONFIG_HEAP_CACHE
+#include "multi_heap_cache.h"
+
+/* Per-core cache of small blocks in front of the heaps with these capabilities */
+#define HEAP_CACHE_CAPS (MALLOC_CAP_DEFAULT | MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT | MALLOC_CAP_32BIT)
+
+extern multi_heap_cache_t small_block_cache;
+
+/* Free a block released from small_block_cache to its heap */
+void heap_caps_cache_free_block(void *ptr);
+#endif
+
 bool heap_caps_match(const heap_t *heap, uint32_t caps);
 
 FORCE_INLINE_ATTR uint32_t get_ored_caps(const uint32_t caps[SOC_MEMORY_TYPE_NO_PRIOS])
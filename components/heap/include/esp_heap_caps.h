@@ -284,6 +284,25 @@ esp_err_t heap_caps_monitor_local_minimum_free_size_stop(void);
  */
 void heap_caps_get_info( multi_heap_info_t *info, uint32_t caps );
 
+/**
+ * @brief Get the statistics of the small block cache.
+ *
+ * The cache is enabled with CONFIG_HEAP_CACHE. If it is disabled, all the statistics are zero.
+ *
+ * @param stats Pointer to a structure which will be filled with the statistics, summed over all cores.
+ */
+void heap_caps_cache_get_stats( multi_heap_cache_stats_t *stats );
+
+/**
+ * @brief Return all the blocks held by the small block cache to the heaps.
+ *
+ * Cached blocks are counted as allocated memory. Call this function before checking the free heap size,
+ * e.g., when looking for memory leaks. The cache is also trimmed automatically when an allocation fails.
+ *
+ * @return Number of blocks returned to the heaps. Always 0 if CONFIG_HEAP_CACHE is disabled.
+ */
+size_t heap_caps_cache_trim( void );
+
 
 /**
  * @brief Print a summary of all memory with the given capabilities.
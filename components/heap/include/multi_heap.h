@@ -170,6 +170,16 @@ typedef struct {
     size_t total_blocks;          ///<  Total number of (variable size) blocks in the heap.
 } multi_heap_info_t;
 
+/** @brief Structure to access the statistics of the small block cache, see heap_caps_cache_get_stats() */
+typedef struct {
+    size_t hits;                  ///<  Allocations served from the cache.
+    size_t misses;                ///<  Cacheable allocations which found the cache empty and went to the heap.
+    size_t cached_frees;          ///<  Frees which kept the block in the cache.
+    size_t overflows;             ///<  Cacheable frees which went to the heap because the cache was full.
+    size_t cached_blocks;         ///<  Number of blocks currently held by the cache.
+    size_t cached_bytes;          ///<  Size of the blocks currently held by the cache, counted by their size class.
+} multi_heap_cache_stats_t;
+
 /** @brief Return metadata about a given heap
  *
  * Fills a multi_heap_info_t structure with information about the specified heap.
@@ -0,0 +1,147 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <string.h>
+#include "esp_attr.h"
+#include "multi_heap_cache.h"
+
+/* Size classes grow by 1.5x or 2x, which bounds the memory wasted by rounding a request up to its class.
+   In DRAM, as the functions using it are placed in IRAM and may run while the flash cache is disabled. */
+static const DRAM_ATTR uint16_t s_class_size[MULTI_HEAP_CACHE_NUM_CLASSES + 1] = {
+    16, 32, 48, 64, 96, 128, 192, 256,
+    320, // upper bound (exclusive) for the block size of the last class
+};
+
+_Static_assert(MULTI_HEAP_CACHE_MAX_SIZE == 256, "MULTI_HEAP_CACHE_MAX_SIZE must match the last size class");
+
+void multi_heap_cache_init(multi_heap_cache_t *cache, size_t depth)
+{
+    memset(cache, 0, sizeof(*cache));
+    for (int i = 0; i < MULTI_HEAP_CACHE_NUM_SLOTS; i++) {
+        MULTI_HEAP_LOCK_INIT(&cache->slots[i].lock);
+    }
+    cache->depth = depth;
+}
+
+int multi_heap_cache_get_class(size_t size)
+{
+    if (size == 0 || size > MULTI_HEAP_CACHE_MAX_SIZE) {
+        return -1;
+    }
+    int size_class = 0;
+    while (s_class_size[size_class] < size) {
+        size_class++;
+    }
+    return size_class;
+}
+
+size_t multi_heap_cache_class_size(int size_class)
+{
+    return s_class_size[size_class];
+}
+
+/* Size class of a free block: the largest class the block can serve. Blocks larger than the upper bound
+   of the last class are not cached, so that they do not waste memory. */
+static int get_block_class(size_t block_size)
+{
+    if (block_size < s_class_size[0] || block_size >= s_class_size[MULTI_HEAP_CACHE_NUM_CLASSES]) {
+        return -1;
+    }
+    int size_class = MULTI_HEAP_CACHE_NUM_CLASSES - 1;
+    while (s_class_size[size_class] > block_size) {
+        size_class--;
+    }
+    return size_class;
+}
+
+void *multi_heap_cache_get(multi_heap_cache_t *cache, int size_class)
+{
+    /* A task may migrate to another core after reading the slot ID. This only costs locality,
+       as the slot is still protected by its lock. */
+    multi_heap_cache_slot_t *slot = &cache->slots[MULTI_HEAP_CACHE_SLOT_ID()];
+    MULTI_HEAP_LOCK(&slot->lock);
+    multi_heap_cache_block_t *block = slot->free_list[size_class];
+    if (block != NULL) {
+        slot->free_list[size_class] = block->next;
+        slot->free_count[size_class]--;
+        slot->stats.hits++;
+        slot->stats.cached_blocks--;
+        slot->stats.cached_bytes -= s_class_size[size_class];
+    } else {
+        slot->stats.misses++;
+    }
+    MULTI_HEAP_UNLOCK(&slot->lock);
+    return block;
+}
+
+bool multi_heap_cache_put(multi_heap_cache_t *cache, void *p, size_t block_size)
+{
+    int size_class = get_block_class(block_size);
+    if (size_class < 0) {
+        return false;
+    }
+    bool cached = false;
+    multi_heap_cache_slot_t *slot = &cache->slots[MULTI_HEAP_CACHE_SLOT_ID()];
+    MULTI_HEAP_LOCK(&slot->lock);
+    if (slot->free_count[size_class] < cache->depth) {
+        multi_heap_cache_block_t *block = (multi_heap_cache_block_t *)p;
+        block->next = slot->free_list[size_class];
+        slot->free_list[size_class] = block;
+        slot->free_count[size_class]++;
+        slot->stats.cached_frees++;
+        slot->stats.cached_blocks++;
+        slot->stats.cached_bytes += s_class_size[size_class];
+        cached = true;
+    } else {
+        slot->stats.overflows++;
+    }
+    MULTI_HEAP_UNLOCK(&slot->lock);
+    return cached;
+}
+
+size_t multi_heap_cache_trim(multi_heap_cache_t *cache, void (*free_fn)(void *p))
+{
+    size_t released = 0;
+    for (int i = 0; i < MULTI_HEAP_CACHE_NUM_SLOTS; i++) {
+        multi_heap_cache_slot_t *slot = &cache->slots[i];
+        multi_heap_cache_block_t *free_list[MULTI_HEAP_CACHE_NUM_CLASSES];
+
+        // Detach the lists under the lock, free the blocks after it is released
+        MULTI_HEAP_LOCK(&slot->lock);
+        memcpy(free_list, slot->free_list, sizeof(free_list));
+        memset(slot->free_list, 0, sizeof(slot->free_list));
+        memset(slot->free_count, 0, sizeof(slot->free_count));
+        slot->stats.cached_blocks = 0;
+        slot->stats.cached_bytes = 0;
+        MULTI_HEAP_UNLOCK(&slot->lock);
+
+        for (int size_class = 0; size_class < MULTI_HEAP_CACHE_NUM_CLASSES; size_class++) {
+            multi_heap_cache_block_t *block = free_list[size_class];
+            while (block != NULL) {
+                multi_heap_cache_block_t *next = block->next;
+                free_fn(block);
+                block = next;
+                released++;
+            }
+        }
+    }
+    return released;
+}
+
+void multi_heap_cache_get_stats(multi_heap_cache_t *cache, multi_heap_cache_stats_t *stats)
+{
+    memset(stats, 0, sizeof(*stats));
+    for (int i = 0; i < MULTI_HEAP_CACHE_NUM_SLOTS; i++) {
+        multi_heap_cache_slot_t *slot = &cache->slots[i];
+        MULTI_HEAP_LOCK(&slot->lock);
+        stats->hits += slot->stats.hits;
+        stats->misses += slot->stats.misses;
+        stats->cached_frees += slot->stats.cached_frees;
+        stats->overflows += slot->stats.overflows;
+        stats->cached_blocks += slot->stats.cached_blocks;
+        stats->cached_bytes += slot->stats.cached_bytes;
+        MULTI_HEAP_UNLOCK(&slot->lock);
+    }
+}
@@ -0,0 +1,103 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "multi_heap.h"
+#include "multi_heap_platform.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Cache of free small blocks, kept in front of a heap allocator.
+
+   Each core has its own slot with a list of free blocks per size class, so allocating and freeing small
+   blocks only takes the (uncontended) lock of the current core's slot instead of the lock of the heap.
+   The cache does not allocate memory by itself: the caller allocates a block of
+   multi_heap_cache_class_size() bytes from the heap when multi_heap_cache_get() misses, and
+   returns blocks to the heap when multi_heap_cache_put() refuses them or when the cache is trimmed.
+*/
+
+#ifdef MULTI_HEAP_FREERTOS
+#define MULTI_HEAP_CACHE_NUM_SLOTS      (CONFIG_FREERTOS_NUMBER_OF_CORES)
+#define MULTI_HEAP_CACHE_SLOT_ID()      (xPortGetCoreID())
+typedef multi_heap_lock_t multi_heap_cache_lock_t;
+#else
+#define MULTI_HEAP_CACHE_NUM_SLOTS      (1)
+#define MULTI_HEAP_CACHE_SLOT_ID()      (0)
+typedef int multi_heap_cache_lock_t;
+#endif
+
+#define MULTI_HEAP_CACHE_NUM_CLASSES    (8)     ///< Number of size classes, see multi_heap_cache_class_size()
+#define MULTI_HEAP_CACHE_MAX_SIZE       (256)   ///< Largest size served by the cache
+
+typedef struct multi_heap_cache_block {
+    struct multi_heap_cache_block *next;
+} multi_heap_cache_block_t;
+
+typedef struct {
+    multi_heap_cache_lock_t lock;
+    multi_heap_cache_block_t *free_list[MULTI_HEAP_CACHE_NUM_CLASSES];
+    uint16_t free_count[MULTI_HEAP_CACHE_NUM_CLASSES];
+    multi_heap_cache_stats_t stats;
+} multi_heap_cache_slot_t;
+
+typedef struct {
+    size_t depth;                   ///< Maximum number of blocks per size class in each slot, 0 disables the cache
+    multi_heap_cache_slot_t slots[MULTI_HEAP_CACHE_NUM_SLOTS];
+} multi_heap_cache_t;
+
+/** @brief Initialize an empty cache.
+ *
+ * @param cache Cache to initialize.
+ * @param depth Maximum number of blocks kept per size class and per core.
+ */
+void multi_heap_cache_init(multi_heap_cache_t *cache, size_t depth);
+
+/** @brief Get the size class of an allocation request.
+ *
+ * @param size Requested size in bytes.
+ * @return Index of the smallest size class which fits size, or -1 if size is not served by the cache.
+ */
+int multi_heap_cache_get_class(size_t size);
+
+/** @brief Get the block size of a size class.
+ *
+ * On a miss, the caller should allocate this size from the heap, so that the block can be
+ * cached in the same class when it is freed.
+ */
+size_t multi_heap_cache_class_size(int size_class);
+
+/** @brief Take a block of the given size class from the cache of the current core.
+ *
+ * @return Block of at least multi_heap_cache_class_size() bytes, or NULL if there is none (counted as a miss).
+ */
+void *multi_heap_cache_get(multi_heap_cache_t *cache, int size_class);
+
+/** @brief Keep a free block in the cache of the current core.
+ *
+ * @param p Block to keep. It must not be used by the caller any more if the function returns true.
+ * @param block_size Usable size of the block, as returned by multi_heap_get_allocated_size().
+ * @return true if the block was cached, false if the caller must free it to the heap.
+ */
+bool multi_heap_cache_put(multi_heap_cache_t *cache, void *p, size_t block_size);
+
+/** @brief Release all blocks held by the cache.
+ *
+ * @param free_fn Function called for each released block, outside of the cache locks.
+ * @return Number of released blocks.
+ */
+size_t multi_heap_cache_trim(multi_heap_cache_t *cache, void (*free_fn)(void *p));
+
+/** @brief Get the statistics of the cache, summed over all cores. */
+void multi_heap_cache_get_stats(multi_heap_cache_t *cache, multi_heap_cache_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
@@ -8,6 +8,7 @@
 #include "multi_heap.h"
 
 #include "../multi_heap_config.h"
+#include "../multi_heap_cache.h"
 #include "../tlsf/include/tlsf.h"
 #include "../tlsf/tlsf_block_functions.h"
 #include "../tlsf/tlsf_control_functions.h"
@@ -643,3 +644,172 @@ TEST_CASE("multi_heap poisoning detection", "[multi_heap]")
         REQUIRE(is_heap_ok == true);
     }
 }
+
+static void *cache_test_heap_malloc(multi_heap_cache_t *cache, multi_heap_handle_t heap, size_t size)
+{
+    int size_class = multi_heap_cache_get_class(size);
+    if (size_class < 0) {
+        return multi_heap_malloc(heap, size);
+    }
+    void *p = multi_heap_cache_get(cache, size_class);
+    if (p == NULL) {
+        p = multi_heap_malloc(heap, multi_heap_cache_class_size(size_class));
+    }
+    return p;
+}
+
+static multi_heap_handle_t cache_test_heap;
+
+static void cache_test_heap_free(multi_heap_cache_t *cache, void *p)
+{
+    if (!multi_heap_cache_put(cache, p, multi_heap_get_allocated_size(cache_test_heap, p))) {
+        multi_heap_free(cache_test_heap, p);
+    }
+}
+
+static void cache_test_release_block(void *p)
+{
+    multi_heap_free(cache_test_heap, p);
+}
+
+TEST_CASE("multi_heap_cache size classes", "[multi_heap]")
+{
+    REQUIRE(multi_heap_cache_get_class(0) == -1);
+    REQUIRE(multi_heap_cache_get_class(MULTI_HEAP_CACHE_MAX_SIZE + 1) == -1);
+
+    size_t prev_class_size = 0;
+    for (size_t size = 1; size <= MULTI_HEAP_CACHE_MAX_SIZE; size++) {
+        int size_class = multi_heap_cache_get_class(size);
+        REQUIRE(size_class >= 0);
+        REQUIRE(size_class < MULTI_HEAP_CACHE_NUM_CLASSES);
+        size_t class_size = multi_heap_cache_class_size(size_class);
+        REQUIRE(class_size >= size);
+        REQUIRE(class_size >= prev_class_size);
+        if (size_class > 0) {
+            /* smallest class which fits */
+            REQUIRE(multi_heap_cache_class_size(size_class - 1) < size);
+        }
+        prev_class_size = class_size;
+    }
+    REQUIRE(multi_heap_cache_class_size(MULTI_HEAP_CACHE_NUM_CLASSES - 1) == MULTI_HEAP_CACHE_MAX_SIZE);
+}
+
+TEST_CASE("multi_heap_cache hits, misses and trim", "[multi_heap]")
+{
+    const size_t depth = 4;
+    uint8_t *heap_mem = (uint8_t *)__malloc__(8192);
+    cache_test_heap = multi_heap_register(heap_mem, 8192);
+    const size_t initial_free = multi_heap_free_size(cache_test_heap);
+
+    multi_heap_cache_t cache;
+    multi_heap_cache_init(&cache, depth);
+    multi_heap_cache_stats_t stats;
+
+    void *p[depth + 2];
+    for (size_t i = 0; i < depth + 2; i++) {
+        p[i] = cache_test_heap_malloc(&cache, cache_test_heap, 40);
+        REQUIRE(p[i] != NULL);
+    }
+    multi_heap_cache_get_stats(&cache, &stats);
+    REQUIRE(stats.hits == 0);
+    REQUIRE(stats.misses == depth + 2);
+
+    /* only 'depth' blocks are kept, the others go back to the heap */
+    for (size_t i = 0; i < depth + 2; i++) {
+        cache_test_heap_free(&cache, p[i]);
+    }
+    multi_heap_cache_get_stats(&cache, &stats);
+    REQUIRE(stats.cached_frees == depth);
+    REQUIRE(stats.overflows == 2);
+    REQUIRE(stats.cached_blocks == depth);
+    REQUIRE(stats.cached_bytes == depth * multi_heap_cache_class_size(multi_heap_cache_get_class(40)));
+    REQUIRE(multi_heap_free_size(cache_test_heap) < initial_free);
+
+    /* any size of the same class is served from the cache, with the most recently freed block first */
+    void *q = cache_test_heap_malloc(&cache, cache_test_heap, 33);
+    REQUIRE(q == p[depth - 1]);
+    memset(q, 0xAA, 33);
+    multi_heap_cache_get_stats(&cache, &stats);
+    REQUIRE(stats.hits == 1);
+    REQUIRE(stats.cached_blocks == depth - 1);
+
+    /* another size class misses */
+    void *r = cache_test_heap_malloc(&cache, cache_test_heap, 200);
+    REQUIRE(r != NULL);
+    multi_heap_cache_get_stats(&cache, &stats);
+    REQUIRE(stats.hits == 1);
+    REQUIRE(stats.misses == depth + 3);
+
+    /* blocks which are too large are never cached */
+    void *large = multi_heap_malloc(cache_test_heap, 1024);
+    REQUIRE(large != NULL);
+    REQUIRE(multi_heap_cache_put(&cache, large, multi_heap_get_allocated_size(cache_test_heap, large)) == false);
+    multi_heap_free(cache_test_heap, large);
+
+    cache_test_heap_free(&cache, q);
+    cache_test_heap_free(&cache, r);
+
+    /* trim returns all the cached blocks to the heap */
+    REQUIRE(multi_heap_cache_trim(&cache, cache_test_release_block) == depth + 1);
+    multi_heap_cache_get_stats(&cache, &stats);
+    REQUIRE(stats.cached_blocks == 0);
+    REQUIRE(stats.cached_bytes == 0);
+    REQUIRE(multi_heap_free_size(cache_test_heap) == initial_free);
+    REQUIRE(multi_heap_cache_trim(&cache, cache_test_release_block) == 0);
+    REQUIRE(multi_heap_check(cache_test_heap, true));
+
+    __free__(heap_mem);
+}
+
+TEST_CASE("multi_heap_cache serves a repeated workload without touching the heap", "[multi_heap]")
+{
+    const size_t heap_size = 64 * 1024;
+    const int rounds = 100;
+    const int num_blocks = 32;
+    const size_t sizes[] = { 16, 24, 40, 64, 100, 128, 160, 250 };
+    void *p[num_blocks];
+
+    uint8_t *heap_mem = (uint8_t *)__malloc__(heap_size);
+    cache_test_heap = multi_heap_register(heap_mem, heap_size);
+    const size_t initial_free = multi_heap_free_size(cache_test_heap);
+    multi_heap_cache_t cache;
+    multi_heap_cache_init(&cache, num_blocks);
+    multi_heap_cache_stats_t stats;
+
+    /* the first round fills the cache from the heap */
+    for (int i = 0; i < num_blocks; i++) {
+        p[i] = cache_test_heap_malloc(&cache, cache_test_heap, sizes[i % 8]);
+        REQUIRE(p[i] != NULL);
+    }
+    for (int i = 0; i < num_blocks; i++) {
+        cache_test_heap_free(&cache, p[i]);
+    }
+    multi_heap_cache_get_stats(&cache, &stats);
+    REQUIRE(stats.hits == 0);
+    REQUIRE(stats.misses == num_blocks);
+    REQUIRE(stats.cached_blocks == num_blocks);
+    const size_t cached_free = multi_heap_free_size(cache_test_heap);
+
+    /* afterwards every allocation is a hit and every free is cached, the heap is not used at all */
+    for (int round = 1; round <= rounds; round++) {
+        for (int i = 0; i < num_blocks; i++) {
+            p[i] = cache_test_heap_malloc(&cache, cache_test_heap, sizes[(i + round) % 8]);
+            REQUIRE(p[i] != NULL);
+        }
+        REQUIRE(multi_heap_free_size(cache_test_heap) == cached_free);
+        for (int i = 0; i < num_blocks; i++) {
+            cache_test_heap_free(&cache, p[i]);
+        }
+    }
+    multi_heap_cache_get_stats(&cache, &stats);
+    REQUIRE(stats.hits == rounds * num_blocks);
+    REQUIRE(stats.misses == num_blocks);
+    REQUIRE(stats.overflows == 0);
+    REQUIRE(stats.cached_blocks == num_blocks);
+    REQUIRE(multi_heap_free_size(cache_test_heap) == cached_free);
+
+    REQUIRE(multi_heap_cache_trim(&cache, cache_test_release_block) == num_blocks);
+    REQUIRE(multi_heap_free_size(cache_test_heap) == initial_free);
+    REQUIRE(multi_heap_check(cache_test_heap, true));
+    __free__(heap_mem);
+}
@@ -9,6 +9,12 @@
 #include <cstdio>
 #include <regex>
 #include <iostream>
+#include <chrono>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <vector>
+#include <string>
 #include "esp_rom_sys.h"
 #include "esp_log.h"
 #include "esp_private/log_util.h"
@@ -60,11 +66,17 @@ public:
 
     string get_print_buffer_string() const
     {
+#if CONFIG_LOG_ASYNC
+        esp_log_async_flush();
+#endif
         return string(print_buffer);
     }
 
     void reset_buffer()
     {
+#if CONFIG_LOG_ASYNC
+        esp_log_async_flush();
+#endif
         std::memset(print_buffer, 0, BUFFER_SIZE);
         buffer_idx = 0;
         additional_reset();
@@ -91,6 +103,9 @@ struct PrintFixture : BasicLogFixture {
 
     virtual ~PrintFixture()
     {
+#if CONFIG_LOG_ASYNC
+        esp_log_async_flush();
+#endif
         esp_log_set_vprintf(old_vprintf);
         instance = nullptr;
     }
@@ -416,6 +431,69 @@ TEST_CASE("esp_log_timestamp_str")
 }
 
 #if ESP_LOG_VERSION == 2
+#define CHECK_ARG_TYPES(format, ...) do { \
+        const char *arg_types = ESP_LOG_ARGS_TYPE_ARRAY(__VA_ARGS__); \
+        const char *fmt = format; \
+        for (unsigned idx = 0; ; idx++) { \
+            esp_log_args_type_t arg_type = esp_log_args_get_type(arg_types, idx); \
+            CHECK(arg_type == esp_log_util_get_arg_type(&fmt)); \
+            if (arg_type == ESP_LOG_ARGS_TYPE_NONE) { \
+                break; \
+            } \
+        } \
+    } while(0)
+
+TEST_CASE("compile-time argument types match the format string")
+{
+    char c = 'a';
+    short sh = -1;
+    long l = -2;
+    size_t z = 3;
+    int64_t i64 = 4;
+    float f = 5.0f;
+    char array[8] = "array";
+    const char *str = "str";
+    const uint8_t *bytes = (const uint8_t *)str;
+    void *ptr = &c;
+    bool flag = true;
+
+    CHECK_ARG_TYPES("no arguments");
+    CHECK_ARG_TYPES("%c %hd %ld %zu %" PRId64 " %f", c, sh, l, z, i64, f);
+    CHECK_ARG_TYPES("%s %s %s %s", array, str, "literal", bytes);
+    CHECK_ARG_TYPES("%p %d %lu %llx %u %g", ptr, flag, 6UL, 7ULL, 8U, 9.0);
+}
+
+TEST_CASE("compile-time argument types benchmark")
+{
+    const int ITERATIONS = 100000;
+    const char *format = "%d %s %" PRIu32 " %p %llu %f";
+    const char *arg_types = ESP_LOG_ARGS_TYPE_ARRAY(1, "str", (uint32_t)2, (void *)format, 3ULL, 4.0);
+    volatile unsigned sum = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < ITERATIONS; i++) {
+        const char *fmt = format;
+        esp_log_args_type_t arg_type;
+        while ((arg_type = esp_log_util_get_arg_type(&fmt)) != ESP_LOG_ARGS_TYPE_NONE) {
+            sum = sum + arg_type;
+        }
+    }
+    auto parsed = std::chrono::steady_clock::now();
+    for (int i = 0; i < ITERATIONS; i++) {
+        esp_log_args_type_t arg_type;
+        for (unsigned idx = 0; (arg_type = esp_log_args_get_type(arg_types, idx)) != ESP_LOG_ARGS_TYPE_NONE; idx++) {
+            sum = sum + arg_type;
+        }
+    }
+    auto unpacked = std::chrono::steady_clock::now();
+
+    auto parse_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(parsed - start).count() / ITERATIONS;
+    auto unpack_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(unpacked - parsed).count() / ITERATIONS;
+    printf("argument types of \"%s\": format parsing %lld ns, compile-time array %lld ns\n",
+           format, (long long)parse_ns, (long long)unpack_ns);
+    CHECK(sum != 0);
+}
+
 TEST_CASE("esp_log with formatting")
 {
     PrintFixture fix(ESP_LOG_INFO);
@@ -520,4 +598,119 @@ TEST_CASE("esp_log TAG can be NULL")
     CHECK(regex_search(fix.get_print_buffer_string(), test_print) == true);
     fix.reset_buffer();
 }
+
+#if CONFIG_LOG_ASYNC
+TEST_CASE("async log copies strings which are not in flash")
+{
+    PrintFixture fix(ESP_LOG_INFO);
+    char tag[] = "stack_tag";
+    char str[] = "stack string";
+
+    ESP_LOGI(tag, "%s %d %.2f %zu", str, -7, 1.5, (size_t)42);
+    strcpy(tag, "changed");
+    strcpy(str, "changed");
+
+    const std::regex test_print("I " TIMESTAMP_FORMAT "stack_tag: stack string -7 1.50 42", std::regex::ECMAScript);
+    CHECK(regex_search(fix.get_print_buffer_string(), test_print) == true);
+}
+
+// Output which is held back until the test opens the gate, collecting the messages written to it
+static std::mutex s_gate_mutex;
+static std::condition_variable s_gate_cv;
+static bool s_gate_open;
+static std::vector<std::string> s_gate_output;
+
+static int gated_vprintf(const char *format, va_list args)
+{
+    char buffer[128];
+    int len = vsnprintf(buffer, sizeof(buffer), format, args);
+    std::unique_lock<std::mutex> lock(s_gate_mutex);
+    // The timeout keeps a caller which waits for the output from blocking the test forever
+    s_gate_cv.wait_for(lock, std::chrono::seconds(5), [] { return s_gate_open; });
+    s_gate_output.push_back(buffer);
+    return len;
+}
+
+TEST_CASE("async log caller doesn't wait for the output")
+{
+    const int MESSAGES = 16;
+    esp_log_async_flush();
+    vprintf_like_t old_vprintf = esp_log_set_vprintf(gated_vprintf);
+    uint32_t dropped = esp_log_async_get_dropped();
+    {
+        std::lock_guard<std::mutex> lock(s_gate_mutex);
+        s_gate_open = false;
+        s_gate_output.clear();
+    }
+
+    for (int i = 0; i < MESSAGES; i++) {
+        ESP_LOGI(TEST_TAG, "message %d", i);
+    }
+    {
+        // The caller returned while the output is still blocked
+        std::lock_guard<std::mutex> lock(s_gate_mutex);
+        CHECK(s_gate_output.empty());
+        s_gate_open = true;
+    }
+    s_gate_cv.notify_all();
+    esp_log_async_flush();
+    esp_log_set_vprintf(old_vprintf);
+
+    // All the messages are output in order once the output is released
+    CHECK(esp_log_async_get_dropped() == dropped);
+    std::string output;
+    for (const std::string &piece : s_gate_output) {
+        output += piece;
+    }
+    size_t pos = 0;
+    for (int i = 0; i < MESSAGES; i++) {
+        const std::string expected = std::string(TEST_TAG) + ": message " + std::to_string(i) + "\n";
+        pos = output.find(expected, pos);
+        CHECK(pos != std::string::npos);
+        if (pos == std::string::npos) {
+            break;
+        }
+        pos += expected.size();
+    }
+}
+
+static int null_vprintf(const char *format, va_list args)
+{
+    char buffer[128];
+    return vsnprintf(buffer, sizeof(buffer), format, args);
+}
+
+TEST_CASE("async log caller latency benchmark")
+{
+    const int BATCHES = 200;
+    const int BATCH_SIZE = 16;
+    esp_log_async_flush();
+    vprintf_like_t old_vprintf = esp_log_set_vprintf(null_vprintf);
+    uint32_t dropped = esp_log_async_get_dropped();
+
+    std::chrono::nanoseconds async_time(0);
+    std::chrono::nanoseconds sync_time(0);
+    for (int batch = 0; batch < BATCHES; batch++) {
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < BATCH_SIZE; i++) {
+            ESP_LOGI(TEST_TAG, "message %d", i);
+        }
+        async_time += std::chrono::steady_clock::now() - start;
+        // The output time of the consumer is not part of the caller latency
+        esp_log_async_flush();
+
+        // A '*' width can't be deferred, such messages are output by the caller as without CONFIG_LOG_ASYNC
+        start = std::chrono::steady_clock::now();
+        for (int i = 0; i < BATCH_SIZE; i++) {
+            ESP_LOGI(TEST_TAG, "message %*d", 1, i);
+        }
+        sync_time += std::chrono::steady_clock::now() - start;
+    }
+    esp_log_set_vprintf(old_vprintf);
+
+    printf("ESP_LOGI caller latency: async %lld ns, sync %lld ns per call\n",
+           (long long)(async_time.count() / (BATCHES * BATCH_SIZE)), (long long)(sync_time.count() / (BATCHES * BATCH_SIZE)));
+    CHECK(esp_log_async_get_dropped() == dropped);
+}
+#endif // CONFIG_LOG_ASYNC
 #endif // ESP_LOG_VERSION == 2
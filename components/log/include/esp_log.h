@@ -17,6 +17,7 @@
 #include "esp_log_buffer.h"
 #include "esp_log_timestamp.h"
 #include "esp_log_write.h"
+#include "esp_log_async.h"
 #include "esp_log_format.h"
 #include "esp_log_args.h"
 #include "esp_log_attr.h"
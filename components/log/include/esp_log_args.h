@@ -7,6 +7,8 @@
 #pragma once
 
 #include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
 #include <string.h>
 #include <assert.h>
 #include "esp_assert.h"
@@ -88,11 +90,32 @@ typedef struct {
  * va_list.
  */
 #if ESP_LOG_MODE_BINARY_EN
-#define ESP_LOG_ARGS_TYPE(...) (__extension__({ static const char __c[] = { __VA_OPT__(ESP_LOG_INIT_ARG_TYPE(ESP_VA_NARG(__VA_ARGS__), __VA_ARGS__), ) 0 }; (const char*)&__c; }))
+#define ESP_LOG_ARGS_TYPE(...) ESP_LOG_ARGS_TYPE_ARRAY(__VA_ARGS__)
 #else
 #define ESP_LOG_ARGS_TYPE(...)
 #endif
 
+/**
+ * @brief Defines a static array of argument types regardless of the log mode.
+ *
+ * The array is built at compile time from the types of the arguments, see ESP_LOG_ARGS_TYPE.
+ * Use esp_log_args_get_type() to read the type of an argument from it.
+ */
+#define ESP_LOG_ARGS_TYPE_ARRAY(...) (__extension__({ static const char __c[] = { __VA_OPT__(ESP_LOG_INIT_ARG_TYPE(ESP_VA_NARG(__VA_ARGS__), __VA_ARGS__), ) 0 }; (const char*)&__c; }))
+
+/**
+ * @brief Get the type of an argument from the array of argument types.
+ *
+ * @param arg_types Array of argument types built by ESP_LOG_ARGS_TYPE.
+ * @param idx       Index of the argument.
+ *
+ * @return The type of the argument, or ESP_LOG_ARGS_TYPE_NONE if there are no more arguments.
+ */
+static inline esp_log_args_type_t esp_log_args_get_type(const char *arg_types, unsigned idx)
+{
+    return (esp_log_args_type_t)((arg_types[idx / 4] >> ((idx % 4) * ESP_LOG_ARGS_TYPE_LEN)) & ESP_LOG_ARGS_TYPE_MASK);
+}
+
 #define ESP_LOG_INIT_ARG_TYPE_N(n)                ESP_LOG_INIT_ARG_TYPE_##n
 #define ESP_LOG_INIT_ARG_TYPE(n, ...)             ESP_LOG_INIT_ARG_TYPE_N(n)(__VA_ARGS__)
 #define ESP_LOG_INIT_ARG_TYPE_1(a)                ESP_LOG_PACK_4_TYPES(a, (esp_log_args_end_t){0}, (esp_log_args_end_t){0}, (esp_log_args_end_t){0})
@@ -156,6 +179,8 @@ typedef struct {
 #define ESP_LOG_INIT_ARG_TYPE_59(a, b, c, d, ...) ESP_LOG_INIT_ARG_TYPE_4(a, b, c, d), ESP_LOG_INIT_ARG_TYPE_55(__VA_ARGS__)
 #define ESP_LOG_INIT_ARG_TYPE_60(a, b, c, d, ...) ESP_LOG_INIT_ARG_TYPE_4(a, b, c, d), ESP_LOG_INIT_ARG_TYPE_56(__VA_ARGS__)
 
+#define ESP_LOG_DETECT_TYPE_BY_SIZE(size) ((size) > sizeof(uint32_t) ? ESP_LOG_ARGS_TYPE_64BITS : ESP_LOG_ARGS_TYPE_32BITS)
+
 // Pack 4 types into a single byte (8 bits)
 #define ESP_LOG_PACK_4_TYPES(a, b, c, d) (char) ( \
         (ESP_LOG_DETECT_TYPE(a) << (0 * ESP_LOG_ARGS_TYPE_LEN)) | \
@@ -164,18 +189,21 @@ typedef struct {
         (ESP_LOG_DETECT_TYPE(d) << (3 * ESP_LOG_ARGS_TYPE_LEN))) \
 
 #ifndef __cplusplus
+/* Types which are not listed explicitly are classified by their size, so that long, size_t, int64_t and
+ * pointers take 64 bits on 64-bit hosts, the same as the runtime format string parser. The comma operator
+ * converts arrays to pointers before the size is taken. */
 #define ESP_LOG_DETECT_TYPE(arg) ( \
     _Generic((arg), \
         esp_log_args_end_t: ESP_LOG_ARGS_TYPE_NONE, \
         char*: ESP_LOG_ARGS_TYPE_POINTER, \
         const char*: ESP_LOG_ARGS_TYPE_POINTER, \
+        signed char*: ESP_LOG_ARGS_TYPE_POINTER, \
+        const signed char*: ESP_LOG_ARGS_TYPE_POINTER, \
         uint8_t*: ESP_LOG_ARGS_TYPE_POINTER, \
         const uint8_t*: ESP_LOG_ARGS_TYPE_POINTER, \
-        long long int: ESP_LOG_ARGS_TYPE_64BITS, \
-        long long unsigned int: ESP_LOG_ARGS_TYPE_64BITS, \
         double: ESP_LOG_ARGS_TYPE_64BITS, \
         float: ESP_LOG_ARGS_TYPE_64BITS, /* float is a 32 bits var but in va_list it takes 64 bits */ \
-        default: ESP_LOG_ARGS_TYPE_32BITS \
+        default: ESP_LOG_DETECT_TYPE_BY_SIZE(sizeof((void)0, (arg))) \
     ))
 #else // __cplusplus
 extern "C++" {
@@ -208,13 +236,33 @@ extern "C++" {
     };
 
     template <>
-    struct EspLogArgType<long long int> {
-        constexpr static unsigned long long log_type = ESP_LOG_ARGS_TYPE_64BITS;
+    struct EspLogArgType<signed char*> {
+        constexpr static unsigned long long log_type = ESP_LOG_ARGS_TYPE_POINTER;
     };
 
     template <>
-    struct EspLogArgType<long long unsigned int> {
-        constexpr static unsigned long long log_type = ESP_LOG_ARGS_TYPE_64BITS;
+    struct EspLogArgType<const signed char*> {
+        constexpr static unsigned long long log_type = ESP_LOG_ARGS_TYPE_POINTER;
+    };
+
+    template <size_t N>
+    struct EspLogArgType<char[N]> {
+        constexpr static unsigned long long log_type = ESP_LOG_ARGS_TYPE_POINTER;
+    };
+
+    template <size_t N>
+    struct EspLogArgType<const char[N]> {
+        constexpr static unsigned long long log_type = ESP_LOG_ARGS_TYPE_POINTER;
+    };
+
+    template <size_t N>
+    struct EspLogArgType<uint8_t[N]> {
+        constexpr static unsigned long long log_type = ESP_LOG_ARGS_TYPE_POINTER;
+    };
+
+    template <size_t N>
+    struct EspLogArgType<const uint8_t[N]> {
+        constexpr static unsigned long long log_type = ESP_LOG_ARGS_TYPE_POINTER;
     };
 
     template <>
@@ -227,9 +275,10 @@ extern "C++" {
         constexpr static unsigned long long log_type = ESP_LOG_ARGS_TYPE_64BITS;
     };
 
+    // Other types are classified by their size, e.g. long, size_t and pointers take 64 bits on 64-bit hosts
     template <typename T>
     struct EspLogArgType {
-        constexpr static unsigned long long log_type = ESP_LOG_ARGS_TYPE_32BITS;
+        constexpr static unsigned long long log_type = ESP_LOG_DETECT_TYPE_BY_SIZE(sizeof(T));
     };
 
     template<typename T>
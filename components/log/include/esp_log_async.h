@@ -0,0 +1,39 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include "sdkconfig.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if CONFIG_LOG_ASYNC || __DOXYGEN__
+
+/**
+ * @brief Wait until all the log messages deferred so far are output.
+ *
+ * With CONFIG_LOG_ASYNC enabled, ESP_LOGx messages are formatted and output by a low-priority task.
+ * Call this function before the output of that task is needed, e.g., before a restart or deep sleep.
+ *
+ * @note Must not be called from an ISR or from the vprintf-like function set by esp_log_set_vprintf().
+ */
+void esp_log_async_flush(void);
+
+/**
+ * @brief Get the number of log messages dropped because the asynchronous logging buffer was full.
+ *
+ * @return The total number of dropped messages since startup.
+ */
+uint32_t esp_log_async_get_dropped(void);
+
+#endif // CONFIG_LOG_ASYNC || __DOXYGEN__
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,77 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include "esp_private/log_message.h"
+#include "sdkconfig.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @cond */
+#if CONFIG_IDF_TARGET_LINUX
+#define ESP_LOG_ASYNC_NUM_BUFFERS   (1)
+#else
+#define ESP_LOG_ASYNC_NUM_BUFFERS   (CONFIG_FREERTOS_NUMBER_OF_CORES)
+#endif
+/** @endcond */
+
+/**
+ * @brief Defer a log message to the asynchronous logging task.
+ *
+ * Copies the format string pointer and the raw arguments of the message into the buffer
+ * of the current core. Strings which are not located in flash are copied as well.
+ * If the buffer is full, the message is dropped and counted.
+ *
+ * @param message Pointer to log message structure.
+ *
+ * @return
+ *      - true if the message was deferred or dropped.
+ *      - false if the message must be output synchronously (the logging task is not running yet,
+ *        or the format string contains unsupported conversions).
+ */
+bool esp_log_async_write(esp_log_msg_t *message);
+
+/**
+ * @brief Output the deferred log messages. Runs in the asynchronous logging task and never returns.
+ */
+void esp_log_async_handler(void);
+
+/**
+ * @brief Create the asynchronous logging task, which calls esp_log_async_handler().
+ *
+ * @return true if the task was created.
+ */
+bool esp_log_async_port_start(void);
+
+/**
+ * @brief Get the index of the buffer for the calling task (the current core).
+ *
+ * @return Index in the range [0, ESP_LOG_ASYNC_NUM_BUFFERS).
+ */
+unsigned esp_log_async_port_get_buffer_idx(void);
+
+/**
+ * @brief Wake up the asynchronous logging task.
+ */
+void esp_log_async_port_notify(void);
+
+/**
+ * @brief Block the asynchronous logging task until it is notified or a timeout expires.
+ */
+void esp_log_async_port_wait(void);
+
+/**
+ * @brief Let the asynchronous logging task run for a while, used when waiting for it to flush.
+ */
+void esp_log_async_port_delay(void);
+
+#ifdef __cplusplus
+}
+#endif
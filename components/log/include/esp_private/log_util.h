@@ -1,5 +1,5 @@
 /*
- * SPDX-FileCopyrightText: 2023-2024 Espressif Systems (Shanghai) CO LTD
+ * SPDX-FileCopyrightText: 2023-2025 Espressif Systems (Shanghai) CO LTD
  *
  * SPDX-License-Identifier: Apache-2.0
  */
@@ -7,6 +7,7 @@
 #pragma once
 
 #include <stdbool.h>
+#include "esp_log_args.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -66,6 +67,20 @@ int esp_log_util_cvt_hex(unsigned long long val, int pad, char *buf);
  */
 int esp_log_util_cvt_dec(unsigned long long val, int pad, char *buf);
 
+/**
+ * @brief Get the type of the next argument from a printf-like format string.
+ *
+ * This function skips the format string up to the next conversion specification and
+ * returns the type of the argument it consumes. The conversion character is the last
+ * character before the updated `*format_ptr`.
+ *
+ * @param[in,out] format_ptr Pointer to the format string pointer. It is advanced past the
+ *                           conversion specification, or to the end of the string.
+ *
+ * @return The type of the argument, or ESP_LOG_ARGS_TYPE_NONE if there are no more conversions.
+ */
+esp_log_args_type_t esp_log_util_get_arg_type(const char **format_ptr);
+
 /**
  * @typedef esp_log_cache_enabled_t
  * @brief Callback function type for checking the state of the SPI flash cache.
@@ -0,0 +1,71 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+#include "esp_private/log_async.h"
+
+// Maximum time the thread waits for a notification. Records are also output when it expires.
+#define ASYNC_WAIT_MS 100
+
+static pthread_mutex_t s_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t s_cond = PTHREAD_COND_INITIALIZER;
+static bool s_notified = false;
+
+static void *log_async_thread(void *arg)
+{
+    (void)arg;
+    esp_log_async_handler();
+    return NULL;
+}
+
+bool esp_log_async_port_start(void)
+{
+    pthread_t thread;
+    if (pthread_create(&thread, NULL, log_async_thread, NULL) != 0) {
+        return false;
+    }
+    pthread_detach(thread);
+    return true;
+}
+
+unsigned esp_log_async_port_get_buffer_idx(void)
+{
+    return 0;
+}
+
+void esp_log_async_port_notify(void)
+{
+    pthread_mutex_lock(&s_mutex);
+    s_notified = true;
+    pthread_cond_signal(&s_cond);
+    pthread_mutex_unlock(&s_mutex);
+}
+
+void esp_log_async_port_wait(void)
+{
+    struct timespec deadline;
+    clock_gettime(CLOCK_REALTIME, &deadline);
+    deadline.tv_nsec += ASYNC_WAIT_MS * 1000000L;
+    if (deadline.tv_nsec >= 1000000000L) {
+        deadline.tv_sec++;
+        deadline.tv_nsec -= 1000000000L;
+    }
+    pthread_mutex_lock(&s_mutex);
+    while (!s_notified) {
+        if (pthread_cond_timedwait(&s_cond, &s_mutex, &deadline) != 0) {
+            break;
+        }
+    }
+    s_notified = false;
+    pthread_mutex_unlock(&s_mutex);
+}
+
+void esp_log_async_port_delay(void)
+{
+    usleep(1000);
+}
@@ -18,6 +18,7 @@
 #include "esp_private/log_print.h"
 #include "esp_private/log_message.h"
 #include "esp_private/log_format.h"
+#include "esp_private/log_async.h"
 #include "esp_log_write.h"
 #include "esp_rom_sys.h"
 #include "sdkconfig.h"
@@ -68,6 +69,11 @@ void __attribute__((optimize("-O3"))) esp_log_va(esp_log_config_t config, const
             message.arg_types = va_arg(message.args, const char *);
         }
         esp_log_format_binary(&message);
+#elif CONFIG_LOG_ASYNC && !BOOTLOADER_BUILD
+        // Defer the message to the asynchronous logging task, unless it cannot run in this context
+        if (config.opts.constrained_env || !esp_log_async_write(&message)) {
+            esp_log_format(&message);
+        }
 #else
         esp_log_format(&message);
 #endif // ESP_LOG_MODE_BINARY_EN
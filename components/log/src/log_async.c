@@ -0,0 +1,530 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdbool.h>
+#include <stdarg.h>
+#include <stdint.h>
+#include <string.h>
+#include <stdio.h>
+#include <sys/param.h>
+#include "esp_log_config.h"
+#include "esp_log_args.h"
+#include "esp_log_async.h"
+#include "esp_private/log_async.h"
+#include "esp_private/log_format.h"
+#include "esp_private/log_message.h"
+#include "esp_private/log_timestamp.h"
+#include "esp_private/log_util.h"
+#include "sdkconfig.h"
+#if !CONFIG_IDF_TARGET_LINUX
+#include "soc/soc.h"
+#endif
+
+/*
+Deferred messages are stored as records in one buffer per core. Producers (the logging tasks)
+reserve space for a record with a compare-and-swap on the reserve index, write the record, and
+then commit it by storing its header. The consumer (the asynchronous logging task) outputs the
+committed records in order, clears their memory and advances the read index. A record is never
+split: if it does not fit before the end of the buffer, the remaining space is filled with a
+padding record.
+
+Record layout:
+    log_async_record_t  - header, config, timestamp, tag and format pointers
+    [tag]               - NUL-terminated tag, if copied (RECORD_TAG_COPIED)
+    [format]            - NUL-terminated format string, if copied (RECORD_FORMAT_COPIED)
+    [arguments...]      - 32-bit and 64-bit arguments, and string arguments as
+                          STR_POINTER + pointer or STR_COPIED + NUL-terminated string
+*/
+
+#define BUFFER_SIZE             (CONFIG_LOG_ASYNC_BUFFER_SIZE)
+#define BUFFER_MASK             (BUFFER_SIZE - 1)
+#define RECORD_ALIGN            (sizeof(uint64_t))
+#define RECORD_MAX_SIZE         (CONFIG_LOG_ASYNC_MAX_MSG_SIZE)
+#define LINE_MAX_SIZE           (CONFIG_LOG_ASYNC_MAX_MSG_SIZE)
+#define SPEC_MAX_LEN            (16)
+
+_Static_assert((BUFFER_SIZE & BUFFER_MASK) == 0, "CONFIG_LOG_ASYNC_BUFFER_SIZE must be a power of two");
+_Static_assert(RECORD_MAX_SIZE <= BUFFER_SIZE / 2, "CONFIG_LOG_ASYNC_MAX_MSG_SIZE must not exceed half of CONFIG_LOG_ASYNC_BUFFER_SIZE");
+
+#define RECORD_SIZE_MASK        (0x0000FFFF)
+#define RECORD_COMMITTED        (1 << 16)
+#define RECORD_PADDING          (1 << 17)
+#define RECORD_TAG_COPIED       (1 << 18)
+#define RECORD_FORMAT_COPIED    (1 << 19)
+
+#define STR_POINTER             (0)
+#define STR_COPIED              (1)
+
+#if CONFIG_IDF_TARGET_LINUX
+#define IS_IN_FLASH(addr) (false)
+#else
+#define IS_IN_FLASH(addr) ( \
+    (((addr) >= SOC_DROM_LOW) && ((addr) < SOC_DROM_HIGH)) || \
+    (((addr) >= SOC_IROM_LOW) && ((addr) < SOC_IROM_HIGH)) \
+)
+#endif
+
+typedef struct {
+    uint32_t header;            /**< Record size, and RECORD_x flags. Written last, when the record is committed */
+    esp_log_config_t config;    /**< Log configuration */
+    uint64_t timestamp;         /**< Log timestamp, taken when the message was logged */
+    const char *tag;            /**< Log tag, if not copied */
+    const char *format;         /**< Log format string, if not copied */
+} log_async_record_t;
+
+typedef struct {
+    uint32_t reserve;           /**< Bytes reserved by producers since startup */
+    uint32_t read;              /**< Bytes output by the consumer since startup */
+    uint32_t dropped;           /**< Messages dropped since startup */
+    uint32_t reported;          /**< Dropped messages reported by the consumer */
+    uint8_t buffer[BUFFER_SIZE] __attribute__((aligned(RECORD_ALIGN)));
+} log_async_buffer_t;
+
+typedef struct {
+    uint8_t *dst;               /**< Write position, NULL while calculating the size of the record */
+    size_t len;                 /**< Size of the record so far */
+    size_t str_budget;          /**< Bytes left for copied strings */
+} record_writer_t;
+
+typedef enum {
+    ASYNC_STATE_STOPPED,
+    ASYNC_STATE_STARTING,
+    ASYNC_STATE_RUNNING,
+    ASYNC_STATE_FAILED,
+} async_state_t;
+
+static log_async_buffer_t s_buffers[ESP_LOG_ASYNC_NUM_BUFFERS];
+static uint32_t s_state = ASYNC_STATE_STOPPED;
+static uint32_t s_consumer_idle = false;
+
+// ----------------------------------------------- Producer (caller side) -----------------------------------------------
+
+static void put(record_writer_t *writer, const void *src, size_t len)
+{
+    if (writer->dst) {
+        memcpy(writer->dst + writer->len, src, len);
+    }
+    writer->len += len;
+}
+
+static void put_str(record_writer_t *writer, const char *str, bool can_truncate)
+{
+    size_t len = strlen(str);
+    if (!can_truncate) {
+        put(writer, str, len + 1);
+        return;
+    }
+    if (writer->dst) {
+        // Truncate the string to the remaining budget
+        len = MIN(len, writer->str_budget);
+        writer->str_budget -= len;
+        memcpy(writer->dst + writer->len, str, len);
+        writer->dst[writer->len + len] = '\0';
+    } else {
+        writer->str_budget += len;  // Count the full length of strings in the size calculation stage
+    }
+    writer->len += len + 1;
+}
+
+static bool is_conversion_supported(char conversion)
+{
+    return strchr("cdiuxXopsSfFeEgG", conversion) != NULL;
+}
+
+/*
+ * Walks the format string in the same way as the binary log formatter, and stores the raw arguments.
+ * With writer->dst == NULL, only the size of the record is calculated.
+ * Returns false if the format string contains conversions which cannot be deferred (e.g., "%*d", "%n").
+ */
+static bool put_arguments(record_writer_t *writer, const char *format, va_list args)
+{
+    while (1) {
+        esp_log_args_type_t arg_type = esp_log_util_get_arg_type(&format);
+        if (arg_type == ESP_LOG_ARGS_TYPE_NONE) {
+            return true;
+        }
+        char conversion = format[-1];
+        if (!is_conversion_supported(conversion)) {
+            return false;
+        }
+        switch (arg_type) {
+        case ESP_LOG_ARGS_TYPE_32BITS: {
+            uint32_t val = va_arg(args, uint32_t);
+            put(writer, &val, sizeof(val));
+            break;
+        }
+        case ESP_LOG_ARGS_TYPE_64BITS: {
+            uint64_t val;
+            if (strchr("fFeEgG", conversion)) {
+                double dval = va_arg(args, double);
+                memcpy(&val, &dval, sizeof(val));
+            } else {
+                val = va_arg(args, uint64_t);
+            }
+            put(writer, &val, sizeof(val));
+            break;
+        }
+        case ESP_LOG_ARGS_TYPE_POINTER: {
+            const char *str = va_arg(args, const char *);
+            uint8_t kind = (str == NULL || IS_IN_FLASH((uintptr_t)str)) ? STR_POINTER : STR_COPIED;
+            put(writer, &kind, sizeof(kind));
+            if (kind == STR_POINTER) {
+                put(writer, &str, sizeof(str));
+            } else {
+                put_str(writer, str, true);
+            }
+            break;
+        }
+        default:
+            return false;
+        }
+    }
+}
+
+static bool put_record(record_writer_t *writer, esp_log_msg_t *message, uint32_t *flags)
+{
+    writer->len = sizeof(log_async_record_t);
+    if (*flags & RECORD_TAG_COPIED) {
+        put_str(writer, message->tag, true);
+    }
+    if (*flags & RECORD_FORMAT_COPIED) {
+        put_str(writer, message->format, false);    // The arguments are parsed from the format string
+    }
+    va_list args;
+    va_copy(args, message->args);
+    bool ret = put_arguments(writer, message->format, args);
+    va_end(args);
+    return ret;
+}
+
+static uint32_t calc_record_size(esp_log_msg_t *message, uint32_t *flags, size_t *str_budget)
+{
+    record_writer_t writer = { .dst = NULL, .len = 0, .str_budget = 0 };
+    if (message->tag != NULL && !IS_IN_FLASH((uintptr_t)message->tag)) {
+        *flags |= RECORD_TAG_COPIED;
+    }
+    if (!IS_IN_FLASH((uintptr_t)message->format)) {
+        *flags |= RECORD_FORMAT_COPIED;
+    }
+    if (!put_record(&writer, message, flags)) {
+        return 0;
+    }
+    size_t fixed_len = writer.len - writer.str_budget;
+    if (fixed_len > RECORD_MAX_SIZE) {
+        return 0;   // Too many arguments to defer the message
+    }
+    // Strings are truncated if the record does not fit in RECORD_MAX_SIZE
+    *str_budget = RECORD_MAX_SIZE - fixed_len;
+    return (MIN(writer.len, RECORD_MAX_SIZE) + RECORD_ALIGN - 1) & ~(RECORD_ALIGN - 1);
+}
+
+static bool start_consumer(void)
+{
+    uint32_t state = __atomic_load_n(&s_state, __ATOMIC_ACQUIRE);
+    if (state == ASYNC_STATE_STOPPED) {
+        // The first caller creates the task. Messages are output synchronously until it is running.
+        if (__atomic_compare_exchange_n(&s_state, &state, ASYNC_STATE_STARTING, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+            state = esp_log_async_port_start() ? ASYNC_STATE_RUNNING : ASYNC_STATE_FAILED;
+            __atomic_store_n(&s_state, state, __ATOMIC_RELEASE);
+        }
+    }
+    return state == ASYNC_STATE_RUNNING;
+}
+
+static void notify_consumer(void)
+{
+    // Pairs with the fence in esp_log_async_handler(), so that either the consumer sees the new record
+    // before it blocks, or we see that it is idle and wake it up.
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&s_consumer_idle, __ATOMIC_RELAXED) && __atomic_exchange_n(&s_consumer_idle, false, __ATOMIC_RELAXED)) {
+        esp_log_async_port_notify();
+    }
+}
+
+bool esp_log_async_write(esp_log_msg_t *message)
+{
+    if (!start_consumer()) {
+        return false;
+    }
+
+    uint32_t flags = 0;
+    size_t str_budget = 0;
+    uint32_t size = calc_record_size(message, &flags, &str_budget);
+    if (size == 0) {
+        return false;
+    }
+
+    log_async_buffer_t *buf = &s_buffers[esp_log_async_port_get_buffer_idx()];
+    uint32_t reserve = __atomic_load_n(&buf->reserve, __ATOMIC_RELAXED);
+    uint32_t pad;
+    do {
+        uint32_t offset = reserve & BUFFER_MASK;
+        pad = (offset + size > BUFFER_SIZE) ? BUFFER_SIZE - offset : 0;
+        uint32_t free_size = BUFFER_SIZE - (reserve - __atomic_load_n(&buf->read, __ATOMIC_ACQUIRE));
+        if (pad + size > free_size) {
+            // Do not block the caller. The consumer reports the dropped messages.
+            __atomic_fetch_add(&buf->dropped, 1, __ATOMIC_RELAXED);
+            notify_consumer();
+            return true;
+        }
+    } while (!__atomic_compare_exchange_n(&buf->reserve, &reserve, reserve + pad + size, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+
+    if (pad) {
+        uint32_t *pad_header = (uint32_t *)&buf->buffer[reserve & BUFFER_MASK];
+        __atomic_store_n(pad_header, pad | RECORD_PADDING | RECORD_COMMITTED, __ATOMIC_RELEASE);
+    }
+    log_async_record_t *record = (log_async_record_t *)&buf->buffer[(reserve + pad) & BUFFER_MASK];
+    record->config = message->config;
+    record->timestamp = message->timestamp;
+    record->tag = (flags & RECORD_TAG_COPIED) ? NULL : message->tag;
+    record->format = (flags & RECORD_FORMAT_COPIED) ? NULL : message->format;
+    record_writer_t writer = { .dst = (uint8_t *)record, .len = 0, .str_budget = str_budget };
+    put_record(&writer, message, &flags);
+    __atomic_store_n(&record->header, size | flags | RECORD_COMMITTED, __ATOMIC_RELEASE);
+
+    notify_consumer();
+    return true;
+}
+
+// --------------------------------------------- Consumer (logging task) ------------------------------------------------
+
+static void append(char *line, size_t *pos, const char *format, ...)
+{
+    if (*pos >= LINE_MAX_SIZE - 1) {
+        return;
+    }
+    va_list args;
+    va_start(args, format);
+    int len = vsnprintf(line + *pos, LINE_MAX_SIZE - *pos, format, args);
+    va_end(args);
+    if (len > 0) {
+        *pos = MIN(*pos + len, LINE_MAX_SIZE - 1);
+    }
+}
+
+static void append_literal(char *line, size_t *pos, const char *start, const char *end)
+{
+    while (start < end && *pos < LINE_MAX_SIZE - 1) {
+        line[(*pos)++] = *start;
+        start += (start[0] == '%' && start[1] == '%') ? 2 : 1;   // "%%" outputs '%'
+    }
+    line[*pos] = '\0';
+}
+
+static const uint8_t *get(const uint8_t *src, void *dst, size_t len)
+{
+    memcpy(dst, src, len);
+    return src + len;
+}
+
+/*
+ * Formats the message into line[], one conversion at a time, with the arguments stored in the record.
+ */
+static void format_line(const char *format, const uint8_t *data, char *line)
+{
+    size_t pos = 0;
+    line[0] = '\0';
+    while (*format) {
+        const char *segment = format;
+        esp_log_args_type_t arg_type = esp_log_util_get_arg_type(&format);
+        if (arg_type == ESP_LOG_ARGS_TYPE_NONE) {
+            append_literal(line, &pos, segment, format);
+            break;
+        }
+        // Find the start of the conversion specification, after the literal text
+        const char *spec = segment;
+        while (spec[0] != '%' || spec[1] == '%') {
+            spec += (spec[0] == '%') ? 2 : 1;
+        }
+        append_literal(line, &pos, segment, spec);
+
+        char spec_str[SPEC_MAX_LEN + 1];
+        size_t spec_len = MIN((size_t)(format - spec), SPEC_MAX_LEN);
+        memcpy(spec_str, spec, spec_len);
+        spec_str[spec_len] = '\0';
+        char conversion = format[-1];
+        switch (arg_type) {
+        case ESP_LOG_ARGS_TYPE_32BITS: {
+            uint32_t val;
+            data = get(data, &val, sizeof(val));
+            if (conversion == 'p') {
+                append(line, &pos, spec_str, (void *)(uintptr_t)val);
+            } else {
+                append(line, &pos, spec_str, val);
+            }
+            break;
+        }
+        case ESP_LOG_ARGS_TYPE_64BITS: {
+            uint64_t val;
+            data = get(data, &val, sizeof(val));
+            if (strchr("fFeEgG", conversion)) {
+                double dval;
+                memcpy(&dval, &val, sizeof(dval));
+                append(line, &pos, spec_str, dval);
+            } else if (conversion == 'p') {
+                append(line, &pos, spec_str, (void *)(uintptr_t)val);
+            } else {
+                append(line, &pos, spec_str, val);
+            }
+            break;
+        }
+        case ESP_LOG_ARGS_TYPE_POINTER: {
+            uint8_t kind;
+            const char *str;
+            data = get(data, &kind, sizeof(kind));
+            if (kind == STR_POINTER) {
+                data = get(data, &str, sizeof(str));
+            } else {
+                str = (const char *)data;
+                data += strlen(str) + 1;
+            }
+            append(line, &pos, spec_str, str);
+            break;
+        }
+        default:
+            return;
+        }
+    }
+}
+
+static void output_line(esp_log_msg_t *message, ...)
+{
+    va_start(message->args, message);
+    esp_log_format(message);
+    va_end(message->args);
+}
+
+static void output_record(const log_async_record_t *record, char *line)
+{
+    const uint8_t *data = (const uint8_t *)(record + 1);
+    const char *tag = record->tag;
+    const char *format = record->format;
+    if (record->header & RECORD_TAG_COPIED) {
+        tag = (const char *)data;
+        data += strlen(tag) + 1;
+    }
+    if (record->header & RECORD_FORMAT_COPIED) {
+        format = (const char *)data;
+        data += strlen(format) + 1;
+    }
+    format_line(format, data, line);
+
+    esp_log_msg_t message = {
+        .config = record->config,
+        .tag = tag,
+        .format = "%s",
+        .timestamp = record->timestamp,
+        .arg_types = NULL,
+    };
+    output_line(&message, line);
+}
+
+static void output_dropped(log_async_buffer_t *buf)
+{
+    uint32_t dropped = __atomic_load_n(&buf->dropped, __ATOMIC_RELAXED) - buf->reported;
+    if (dropped == 0) {
+        return;
+    }
+    esp_log_msg_t message = {
+        .config = ESP_LOG_CONFIG_INIT(ESP_LOG_WARN | ESP_LOG_CONFIGS_DEFAULT),
+        .tag = "log",
+        .format = "%" PRIu32 " message(s) dropped, the asynchronous log buffer is full",
+        .timestamp = esp_log_timestamp64(false),
+        .arg_types = NULL,
+    };
+    output_line(&message, dropped);
+    __atomic_store_n(&buf->reported, buf->reported + dropped, __ATOMIC_RELEASE);
+}
+
+static uint32_t get_committed_header(log_async_buffer_t *buf)
+{
+    if (buf->read == __atomic_load_n(&buf->reserve, __ATOMIC_ACQUIRE)) {
+        return 0;
+    }
+    uint32_t header = __atomic_load_n((uint32_t *)&buf->buffer[buf->read & BUFFER_MASK], __ATOMIC_ACQUIRE);
+    return (header & RECORD_COMMITTED) ? header : 0;
+}
+
+static bool process_buffer(log_async_buffer_t *buf, char *line)
+{
+    bool processed = false;
+    uint32_t header;
+    // Records are output in order. A record which is reserved but not yet committed stops the output
+    // until its producer commits it and notifies the consumer.
+    while ((header = get_committed_header(buf)) != 0) {
+        uint8_t *record = &buf->buffer[buf->read & BUFFER_MASK];
+        size_t size = header & RECORD_SIZE_MASK;
+        if ((header & RECORD_PADDING) == 0) {
+            output_record((const log_async_record_t *)record, line);
+        }
+        // Producers rely on the memory being zeroed to detect uncommitted records
+        memset(record, 0, size);
+        __atomic_store_n(&buf->read, buf->read + size, __ATOMIC_RELEASE);
+        processed = true;
+    }
+    output_dropped(buf);
+    return processed;
+}
+
+static bool has_committed_records(void)
+{
+    for (int i = 0; i < ESP_LOG_ASYNC_NUM_BUFFERS; i++) {
+        if (get_committed_header(&s_buffers[i]) != 0 ||
+                __atomic_load_n(&s_buffers[i].dropped, __ATOMIC_RELAXED) != s_buffers[i].reported) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void esp_log_async_handler(void)
+{
+    static char line[LINE_MAX_SIZE];
+    while (1) {
+        bool processed = false;
+        for (int i = 0; i < ESP_LOG_ASYNC_NUM_BUFFERS; i++) {
+            processed |= process_buffer(&s_buffers[i], line);
+        }
+        if (processed) {
+            continue;
+        }
+        __atomic_store_n(&s_consumer_idle, true, __ATOMIC_RELAXED);
+        __atomic_thread_fence(__ATOMIC_SEQ_CST);
+        if (!has_committed_records()) {
+            esp_log_async_port_wait();
+        }
+        __atomic_store_n(&s_consumer_idle, false, __ATOMIC_RELAXED);
+    }
+}
+
+// ------------------------------------------------------ Public API ----------------------------------------------------
+
+void esp_log_async_flush(void)
+{
+    if (__atomic_load_n(&s_state, __ATOMIC_ACQUIRE) != ASYNC_STATE_RUNNING || esp_log_util_is_constrained()) {
+        return;
+    }
+    for (int i = 0; i < ESP_LOG_ASYNC_NUM_BUFFERS; i++) {
+        log_async_buffer_t *buf = &s_buffers[i];
+        uint32_t target = __atomic_load_n(&buf->reserve, __ATOMIC_ACQUIRE);
+        uint32_t dropped = __atomic_load_n(&buf->dropped, __ATOMIC_RELAXED);
+        while ((int32_t)(__atomic_load_n(&buf->read, __ATOMIC_ACQUIRE) - target) < 0 ||
+                (int32_t)(__atomic_load_n(&buf->reported, __ATOMIC_ACQUIRE) - dropped) < 0) {
+            __atomic_store_n(&s_consumer_idle, false, __ATOMIC_RELAXED);
+            esp_log_async_port_notify();
+            esp_log_async_port_delay();
+        }
+    }
+}
+
+uint32_t esp_log_async_get_dropped(void)
+{
+    uint32_t dropped = 0;
+    for (int i = 0; i < ESP_LOG_ASYNC_NUM_BUFFERS; i++) {
+        dropped += __atomic_load_n(&s_buffers[i].dropped, __ATOMIC_RELAXED);
+    }
+    return dropped;
+}
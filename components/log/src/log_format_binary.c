@@ -135,55 +135,6 @@ static unsigned output_pointer(const char *ptr, pkg_info_t *pkg_info)
     return pkg_len;
 }
 
-static esp_log_args_type_t get_arg_type_from_format_string(const char **format_ptr)
-{
-    if (!format_ptr || !(*format_ptr)) {
-        return ESP_LOG_ARGS_TYPE_NONE;
-    }
-
-    const char *format = *format_ptr;
-    while (*format) {
-        if (*format++ == '%') {
-            if (*format == '%') { // Skip "%%"
-                format++;
-                continue;
-            }
-
-            // Handle optional flags, width, and precision
-            while (*format == '-' || *format == '.' || ((*format) >= '0' && (*format) <= '9')) {
-                format++;
-            }
-
-            // Handle length modifiers
-            int is_long_long = 0;
-            while (*format == 'l') {
-                is_long_long++;
-                format++;
-            }
-            while (*format == 'h' || *format == 'z') {
-                format++;
-            }
-
-            switch (*format++) {
-            case 'f': case 'F': case 'e': case 'E': case 'g': case 'G':
-                *format_ptr = format;
-                return ESP_LOG_ARGS_TYPE_64BITS;
-            case 'c': case 'p': case 'd': case 'i': case 'u': case 'x': case 'X': case 'o':
-                *format_ptr = format;
-                return is_long_long >= 2 ? ESP_LOG_ARGS_TYPE_64BITS : ESP_LOG_ARGS_TYPE_32BITS;
-            case 's': case 'S':
-                *format_ptr = format;
-                return ESP_LOG_ARGS_TYPE_POINTER;
-            default:
-                *format_ptr = format;
-                return ESP_LOG_ARGS_TYPE_32BITS;
-            }
-        }
-    }
-    *format_ptr = format;
-    return ESP_LOG_ARGS_TYPE_NONE;
-}
-
 static unsigned output_arguments(esp_log_msg_t *message, va_list args, pkg_info_t *pkg_info)
 {
     unsigned pkg_len = 0;
@@ -193,10 +144,9 @@ static unsigned output_arguments(esp_log_msg_t *message, va_list args, pkg_info_
         esp_log_args_type_t arg_type;
         if (!message->config.opts.binary_mode) {
             assert(!IS_LOCATED_IN_NOLOAD_SECTION((uintptr_t)format) && "Misconfiguration: format must be on flash");
-            arg_type = get_arg_type_from_format_string(&format);
+            arg_type = esp_log_util_get_arg_type(&format);
         } else {
-            arg_type = (message->arg_types[idx_arg / 4] >> ((idx_arg % 4) * ESP_LOG_ARGS_TYPE_LEN)) & 0x03;
-            idx_arg++;
+            arg_type = esp_log_args_get_type(message->arg_types, idx_arg++);
         }
         switch (arg_type) {
         case ESP_LOG_ARGS_TYPE_32BITS: {
@@ -0,0 +1,47 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_private/log_async.h"
+#include "sdkconfig.h"
+
+// Maximum time the task waits for a notification. Records are also output when it expires.
+#define ASYNC_WAIT_TICKS pdMS_TO_TICKS(100)
+
+static TaskHandle_t s_log_async_task = NULL;
+
+static void log_async_task(void *arg)
+{
+    (void)arg;
+    esp_log_async_handler();
+}
+
+bool esp_log_async_port_start(void)
+{
+    return xTaskCreatePinnedToCore(log_async_task, "log_async", CONFIG_LOG_ASYNC_TASK_STACK_SIZE, NULL,
+                                   CONFIG_LOG_ASYNC_TASK_PRIORITY, &s_log_async_task, tskNO_AFFINITY) == pdPASS;
+}
+
+unsigned esp_log_async_port_get_buffer_idx(void)
+{
+    return xPortGetCoreID();
+}
+
+void esp_log_async_port_notify(void)
+{
+    xTaskNotifyGive(s_log_async_task);
+}
+
+void esp_log_async_port_wait(void)
+{
+    ulTaskNotifyTake(pdTRUE, ASYNC_WAIT_TICKS);
+}
+
+void esp_log_async_port_delay(void)
+{
+    vTaskDelay(1);
+}
@@ -1,11 +1,13 @@
 /*
- * SPDX-FileCopyrightText: 2023-2024 Espressif Systems (Shanghai) CO LTD
+ * SPDX-FileCopyrightText: 2023-2025 Espressif Systems (Shanghai) CO LTD
  *
  * SPDX-License-Identifier: Apache-2.0
  */
 
 #include <stdint.h>
+#include <stddef.h>
 #include "esp_rom_sys.h"
+#include "esp_private/log_util.h"
 
 int esp_log_util_cvt(unsigned long long val, long radix, int pad, const char *digits, char *buf)
 {
@@ -21,3 +23,60 @@ int esp_log_util_cvt_dec(unsigned long long val, int pad, char *buf)
 {
     return esp_rom_cvt(val, 10, pad, "0123456789", buf);
 }
+
+esp_log_args_type_t esp_log_util_get_arg_type(const char **format_ptr)
+{
+    if (!format_ptr || !(*format_ptr)) {
+        return ESP_LOG_ARGS_TYPE_NONE;
+    }
+
+    const char *format = *format_ptr;
+    while (*format) {
+        if (*format++ == '%') {
+            if (*format == '%') { // Skip "%%"
+                format++;
+                continue;
+            }
+
+            // Handle optional flags, width, and precision
+            while (*format == '-' || *format == '+' || *format == ' ' || *format == '#' || *format == '.' || ((*format) >= '0' && (*format) <= '9')) {
+                format++;
+            }
+
+            // Handle length modifiers
+            int is_long_long = 0;
+            bool is_size = false;
+            while (*format == 'l') {
+                is_long_long++;
+                format++;
+            }
+            while (*format == 'h' || *format == 'z') {
+                is_size |= (*format == 'z');
+                format++;
+            }
+            // long, size_t and pointers are 64 bits wide on 64-bit hosts (Linux target)
+            bool is_64bits = (is_long_long >= 2) || (is_long_long == 1 && sizeof(long) == sizeof(uint64_t))
+                             || (is_size && sizeof(size_t) == sizeof(uint64_t));
+
+            switch (*format++) {
+            case 'f': case 'F': case 'e': case 'E': case 'g': case 'G':
+                *format_ptr = format;
+                return ESP_LOG_ARGS_TYPE_64BITS;
+            case 'p':
+                *format_ptr = format;
+                return (sizeof(void *) == sizeof(uint64_t)) ? ESP_LOG_ARGS_TYPE_64BITS : ESP_LOG_ARGS_TYPE_32BITS;
+            case 'c': case 'd': case 'i': case 'u': case 'x': case 'X': case 'o':
+                *format_ptr = format;
+                return is_64bits ? ESP_LOG_ARGS_TYPE_64BITS : ESP_LOG_ARGS_TYPE_32BITS;
+            case 's': case 'S':
+                *format_ptr = format;
+                return ESP_LOG_ARGS_TYPE_POINTER;
+            default:
+                *format_ptr = format;
+                return ESP_LOG_ARGS_TYPE_32BITS;
+            }
+        }
+    }
+    *format_ptr = format;
+    return ESP_LOG_ARGS_TYPE_NONE;
+}
@@ -18,6 +18,9 @@
 #include <string.h>
 #include <string>
 #include <random>
+#include <chrono>
+#include <vector>
+#include <algorithm>
 #include "test_fixtures.hpp"
 #include "spi_flash_mmap.h"
 
@@ -26,6 +29,7 @@ using namespace std;
 #define TEST_DEFAULT_PARTITION_NAME "nvs"               // Default partition name used in the tests - 10 sectors
 #define TEST_SECONDARY_PARTITION_NAME "nvs_sec"         // Secondary partition name used in the tests - 10 sectors
 #define TEST_3SEC_PARTITION_NAME "nvs_3sec"             // Partition used in the space constrained tests - 3 sectors
+#define TEST_64SEC_PARTITION_NAME "nvs_64sec"           // Partition used in the benchmarks scaling with partition size - 64 sectors
 
 #define TEST_ESP_ERR(rc, res) CHECK((rc) == (res))
 #define TEST_ESP_OK(rc) CHECK((rc) == ESP_OK)
@@ -338,6 +342,11 @@ public:
     {
         return mBlockList.size();
     }
+
+    size_t getAllocatedSize()
+    {
+        return mBlockList.size() * sizeof(HashListBlock);
+    }
 };
 
 TEST_CASE("HashList is cleaned up as soon as items are erased", "[nvs]")
@@ -381,6 +390,107 @@ TEST_CASE("HashList is cleaned up as soon as items are erased", "[nvs]")
     CHECK(hashlist.getBlockCount() == 0);
 }
 
+class HashTableTestHelper : public nvs::HashTable {
+public:
+    bool isAllocated()
+    {
+        return mData != nullptr;
+    }
+
+    size_t getAllocatedSize()
+    {
+        return mData ? sizeof(HashTableData) : 0;
+    }
+};
+
+TEST_CASE("HashTable finds the same items as HashList", "[nvs]")
+{
+    // TC verifies that HashTable behaves like HashList for the sequences of operations done by Page.
+    // Like on a page, items are inserted at increasing entry indices and erased at random ones,
+    // both structures are cleared once all entries were used.
+    // The test verifies following:
+    // - find() gives the same results in both structures, also for items with the same hash
+    // - find() respects the start index
+    // - the table is released as soon as the last item is erased
+
+    HashListTestHelper hashlist;
+    HashTableTestHelper hashtable;
+    std::mt19937 gen(42);
+    bool used[nvs::Page::ENTRY_COUNT] = {};
+    size_t nextFree = 0;
+    char key[16];
+
+    for (size_t round = 0; round < 5000; ++round) {
+        // few distinct keys, so that items with the same hash occur in the structures
+        snprintf(key, sizeof(key), "k%u", (unsigned) (gen() % 40));
+        nvs::Item item(1, nvs::ItemType::U32, 1, key);
+        size_t index = gen() % nvs::Page::ENTRY_COUNT;
+        if (used[index]) {
+            CHECK(hashlist.erase(index) == true);
+            CHECK(hashtable.erase(index) == true);
+            used[index] = false;
+        } else if (nextFree < nvs::Page::ENTRY_COUNT) {
+            TEST_ESP_OK(hashlist.insert(item, nextFree));
+            TEST_ESP_OK(hashtable.insert(item, nextFree));
+            used[nextFree++] = true;
+        } else {
+            hashlist.clear();
+            hashtable.clear();
+            std::fill_n(used, nvs::Page::ENTRY_COUNT, false);
+            nextFree = 0;
+        }
+
+        size_t start = gen() % nvs::Page::ENTRY_COUNT;
+        CHECK(hashlist.find(start, item) == hashtable.find(start, item));
+        CHECK(hashlist.find(0, item) == hashtable.find(0, item));
+    }
+
+    for (size_t index = 0; index < nvs::Page::ENTRY_COUNT; ++index) {
+        if (used[index]) {
+            CHECK(hashtable.erase(index) == true);
+        }
+        CHECK(hashtable.erase(index) == false);
+    }
+    CHECK(hashtable.isAllocated() == false);
+}
+
+TEST_CASE("benchmark HashList and HashTable memory use and lookup time", "[nvs][benchmark]")
+{
+    // TC fills both structures with the items of a fully written page and reports
+    // the heap occupied by the structure and the average time of a successful find().
+
+    HashListTestHelper hashlist;
+    HashTableTestHelper hashtable;
+    const size_t lookups = 100000;
+    char key[16];
+
+    std::vector<nvs::Item> items;
+
+    for (size_t i = 0; i < nvs::Page::ENTRY_COUNT; ++i) {
+        snprintf(key, sizeof(key), "key%u", (unsigned) i);
+        items.emplace_back(1, nvs::ItemType::U32, 1, key);
+        TEST_ESP_OK(hashlist.insert(items.back(), i));
+        TEST_ESP_OK(hashtable.insert(items.back(), i));
+    }
+
+    // the hash of the searched item is calculated within find(), it is part of the measured time
+    auto measure = [&](auto& structure) {
+        size_t found = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (size_t n = 0; n < lookups; ++n) {
+            found += (structure.find(0, items[n % nvs::Page::ENTRY_COUNT]) == n % nvs::Page::ENTRY_COUNT);
+        }
+        auto time = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+        CHECK(found == lookups);
+        return time / lookups;
+    };
+
+    s_perf << "HashList, " << nvs::Page::ENTRY_COUNT << " items: " << hashlist.getAllocatedSize() << " bytes in "
+           << hashlist.getBlockCount() << " allocations, find " << measure(hashlist) << " ns" << std::endl;
+    s_perf << "HashTable, " << nvs::Page::ENTRY_COUNT << " items: " << hashtable.getAllocatedSize() << " bytes in 1 allocation, find "
+           << measure(hashtable) << " ns" << std::endl;
+}
+
 TEST_CASE("can init PageManager in empty flash", "[nvs]")
 {
     // TC verifies that PageManager can be initialized in empty flash.
@@ -5007,6 +5117,702 @@ TEST_CASE("nvs handle purge test", "[nvs]")
     TEST_ESP_OK(nvs_flash_erase_partition(part_name));
 }
 
+TEST_CASE("storage finds items after pages were relocated and reloaded", "[nvs]")
+{
+    // TC verifies that lookups through Storage stay consistent while items move between pages.
+    // Items are spread over several pages, part of them is overwritten many times to force
+    // reclaiming of pages (items are copied to a new page) and part of them is erased.
+    // The test verifies following:
+    // - every live item is found with its latest value, before and after the storage is reloaded
+    // - erased items are not found
+    // - items with the same key in a different namespace are not mixed up
+
+    NVSPartitionTestHelper h(TEST_DEFAULT_PARTITION_NAME);
+    const bool purgeAfterErase = TEST_DEFAULT_PURGE_AFTER_ERASE;
+    const size_t itemCount = 300;
+    char key[16];
+
+    nvs::Storage storage(&h);
+    TEST_ESP_OK(storage.init(0, h.get_sectors()));
+
+    for (size_t i = 0; i < itemCount; ++i) {
+        snprintf(key, sizeof(key), "key%u", (unsigned) i);
+        TEST_ESP_OK(storage.writeItem(1, key, static_cast<uint32_t>(i), purgeAfterErase));
+        TEST_ESP_OK(storage.writeItem(2, key, static_cast<uint32_t>(i + itemCount), purgeAfterErase));
+    }
+
+    // overwrite every 10th item until pages had to be reclaimed several times
+    for (size_t round = 0; round < 20; ++round) {
+        for (size_t i = 0; i < itemCount; i += 10) {
+            snprintf(key, sizeof(key), "key%u", (unsigned) i);
+            TEST_ESP_OK(storage.writeItem(1, key, static_cast<uint32_t>(i + round * 1000), purgeAfterErase));
+        }
+    }
+
+    // erase every 7th item
+    for (size_t i = 0; i < itemCount; i += 7) {
+        snprintf(key, sizeof(key), "key%u", (unsigned) i);
+        TEST_ESP_OK(storage.eraseItem(1, key, purgeAfterErase));
+    }
+
+    auto check = [&](nvs::Storage& s) {
+        for (size_t i = 0; i < itemCount; ++i) {
+            uint32_t value;
+            snprintf(key, sizeof(key), "key%u", (unsigned) i);
+            if (i % 7 == 0) {
+                TEST_ESP_ERR(s.readItem(1, key, value), ESP_ERR_NVS_NOT_FOUND);
+            } else {
+                TEST_ESP_OK(s.readItem(1, key, value));
+                CHECK(value == ((i % 10 == 0) ? i + 19 * 1000 : i));
+            }
+            TEST_ESP_OK(s.readItem(2, key, value));
+            CHECK(value == i + itemCount);
+        }
+    };
+
+    check(storage);
+
+    nvs::Storage reloaded(&h);
+    TEST_ESP_OK(reloaded.init(0, h.get_sectors()));
+    check(reloaded);
+}
+
+TEST_CASE("benchmark key lookup time against number of pages", "[nvs][benchmark]")
+{
+    // TC measures the time of Storage.readItem for existing and for missing keys on partitions
+    // of different sizes filled with items up to the same fill level.
+    // The wall clock time covers the search over pages plus the emulated flash reads,
+    // the number of flash read operations per lookup is reported as well.
+
+    const char* part_names[] = {TEST_3SEC_PARTITION_NAME, TEST_DEFAULT_PARTITION_NAME, TEST_64SEC_PARTITION_NAME};
+    const size_t lookups = 10000;
+    char key[16];
+
+    for (auto part_name : part_names) {
+        NVSPartitionTestHelper h(part_name);
+        const bool purgeAfterErase = TEST_DEFAULT_PURGE_AFTER_ERASE;
+
+        nvs::Storage storage(&h);
+        TEST_ESP_OK(storage.init(0, h.get_sectors()));
+
+        // keep one page free, it is reserved for reclaiming of space
+        const size_t itemCount = (h.get_sectors() - 1) * (nvs::Page::ENTRY_COUNT - 2);
+        for (size_t i = 0; i < itemCount; ++i) {
+            snprintf(key, sizeof(key), "k%u", (unsigned) i);
+            TEST_ESP_OK(storage.writeItem(1, key, static_cast<uint32_t>(i), purgeAfterErase));
+        }
+
+        NVSPartitionTestHelper::clear_stats();
+        auto start = std::chrono::steady_clock::now();
+        for (size_t n = 0; n < lookups; ++n) {
+            uint32_t value;
+            snprintf(key, sizeof(key), "k%u", (unsigned) (n % itemCount));
+            TEST_ESP_OK(storage.readItem(1, key, value));
+        }
+        auto hitTime = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+        size_t hitReads = NVSPartitionTestHelper::get_read_ops();
+
+        NVSPartitionTestHelper::clear_stats();
+        start = std::chrono::steady_clock::now();
+        for (size_t n = 0; n < lookups; ++n) {
+            uint32_t value;
+            snprintf(key, sizeof(key), "m%u", (unsigned) (n % itemCount));
+            TEST_ESP_ERR(storage.readItem(1, key, value), ESP_ERR_NVS_NOT_FOUND);
+        }
+        auto missTime = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+        size_t missReads = NVSPartitionTestHelper::get_read_ops();
+
+        s_perf << "Key lookup, " << h.get_sectors() << " pages, " << itemCount << " items: hit "
+               << hitTime / lookups << " ns (" << (double) hitReads / lookups << " reads), miss "
+               << missTime / lookups << " ns (" << (double) missReads / lookups << " reads)" << std::endl;
+    }
+}
+
+TEST_CASE("nvs transaction writes staged values on commit", "[nvs][transaction]")
+{
+    // TC verifies the transaction API of the NVS handle.
+    // The test verifies following:
+    // - values set after nvs_transaction_begin are not visible before nvs_commit
+    // - nvs_commit writes all staged values, setting a key twice keeps the last value
+    // - nvs_transaction_abort drops the staged values
+    // - begin/abort are rejected in the wrong state and on read only handles
+
+    TEST_ESP_OK(nvs_flash_erase_partition(TEST_DEFAULT_PARTITION_NAME));
+    TEST_ESP_OK(nvs_flash_init_partition(TEST_DEFAULT_PARTITION_NAME));
+
+    nvs_handle_t handle;
+    TEST_ESP_OK(nvs_open_from_partition(TEST_DEFAULT_PARTITION_NAME, "txn", NVS_READWRITE, &handle));
+    TEST_ESP_OK(nvs_set_u32(handle, "u32", 1));
+
+    TEST_ESP_ERR(nvs_transaction_abort(handle), ESP_ERR_INVALID_STATE);
+    TEST_ESP_OK(nvs_transaction_begin(handle));
+    TEST_ESP_ERR(nvs_transaction_begin(handle), ESP_ERR_INVALID_STATE);
+
+    const uint8_t blob[] = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31, 32, 33};
+    TEST_ESP_OK(nvs_set_u8(handle, "u8", 8));
+    TEST_ESP_OK(nvs_set_u32(handle, "u32", 2));
+    TEST_ESP_OK(nvs_set_i64(handle, "i64", -64));
+    TEST_ESP_OK(nvs_set_str(handle, "str", "first"));
+    TEST_ESP_OK(nvs_set_str(handle, "str", "transaction string"));
+    TEST_ESP_OK(nvs_set_blob(handle, "blob", blob, sizeof(blob)));
+
+    uint8_t u8;
+    uint32_t u32;
+    TEST_ESP_ERR(nvs_get_u8(handle, "u8", &u8), ESP_ERR_NVS_NOT_FOUND);
+    TEST_ESP_OK(nvs_get_u32(handle, "u32", &u32));
+    CHECK(u32 == 1);
+
+    TEST_ESP_OK(nvs_commit(handle));
+    TEST_ESP_ERR(nvs_transaction_abort(handle), ESP_ERR_INVALID_STATE);
+
+    auto check = [&](nvs_handle_t h) {
+        uint8_t u8_read;
+        uint32_t u32_read;
+        int64_t i64_read;
+        char str[32];
+        size_t size = sizeof(str);
+        uint8_t blob_read[sizeof(blob)];
+        size_t blob_size = sizeof(blob_read);
+        TEST_ESP_OK(nvs_get_u8(h, "u8", &u8_read));
+        CHECK(u8_read == 8);
+        TEST_ESP_OK(nvs_get_u32(h, "u32", &u32_read));
+        CHECK(u32_read == 2);
+        TEST_ESP_OK(nvs_get_i64(h, "i64", &i64_read));
+        CHECK(i64_read == -64);
+        TEST_ESP_OK(nvs_get_str(h, "str", str, &size));
+        CHECK(strcmp(str, "transaction string") == 0);
+        TEST_ESP_OK(nvs_get_blob(h, "blob", blob_read, &blob_size));
+        CHECK(blob_size == sizeof(blob));
+        CHECK(memcmp(blob_read, blob, sizeof(blob)) == 0);
+    };
+    check(handle);
+
+    // staged values are dropped
+    TEST_ESP_OK(nvs_transaction_begin(handle));
+    TEST_ESP_OK(nvs_set_u8(handle, "u8", 9));
+    TEST_ESP_OK(nvs_set_str(handle, "str", "aborted"));
+    TEST_ESP_OK(nvs_transaction_abort(handle));
+    check(handle);
+
+    // a transaction of unchanged values doesn't write anything
+    TEST_ESP_OK(nvs_transaction_begin(handle));
+    TEST_ESP_OK(nvs_set_u8(handle, "u8", 8));
+    TEST_ESP_OK(nvs_set_blob(handle, "blob", blob, sizeof(blob)));
+    NVSPartitionTestHelper::clear_stats();
+    TEST_ESP_OK(nvs_commit(handle));
+    CHECK(NVSPartitionTestHelper::get_write_ops() == 0);
+    CHECK(NVSPartitionTestHelper::get_erase_ops() == 0);
+
+    nvs_close(handle);
+    TEST_ESP_OK(nvs_flash_deinit_partition(TEST_DEFAULT_PARTITION_NAME));
+
+    // the values survive re-initialization
+    TEST_ESP_OK(nvs_flash_init_partition(TEST_DEFAULT_PARTITION_NAME));
+    TEST_ESP_OK(nvs_open_from_partition(TEST_DEFAULT_PARTITION_NAME, "txn", NVS_READONLY, &handle));
+    check(handle);
+    TEST_ESP_ERR(nvs_transaction_begin(handle), ESP_ERR_NVS_READ_ONLY);
+    nvs_close(handle);
+    TEST_ESP_OK(nvs_flash_deinit_partition(TEST_DEFAULT_PARTITION_NAME));
+}
+
+// Stages one generation of values: integers, a string and a blob in namespace 1
+static void stage_transaction_values(nvs::Transaction& transaction, uint32_t generation)
+{
+    char key[16];
+    for (uint32_t i = 0; i < 12; ++i) {
+        snprintf(key, sizeof(key), "k%u", (unsigned) i);
+        uint32_t value = generation * 100 + i;
+        TEST_ESP_OK(transaction.add(1, nvs::ItemType::U32, key, &value, sizeof(value)));
+    }
+    const std::string str = "string of generation " + std::to_string(generation);
+    TEST_ESP_OK(transaction.add(1, nvs::ItemType::SZ, "str", str.c_str(), str.size() + 1));
+    uint8_t blob[70];
+    memset(blob, generation, sizeof(blob));
+    TEST_ESP_OK(transaction.add(1, nvs::ItemType::BLOB, "blob", blob, sizeof(blob)));
+}
+
+// Returns the generation of the stored values, or -1 if values of different generations are mixed
+static int read_transaction_generation(nvs::Storage& storage)
+{
+    char key[16];
+    int generation = -1;
+    for (uint32_t i = 0; i < 12; ++i) {
+        uint32_t value;
+        snprintf(key, sizeof(key), "k%u", (unsigned) i);
+        if (storage.readItem(1, key, value) != ESP_OK) {
+            return -1;
+        }
+        if (i == 0) {
+            generation = value / 100;
+        } else if (value != static_cast<uint32_t>(generation) * 100 + i) {
+            return -1;
+        }
+    }
+    char str[32];
+    if (storage.readItem(1, nvs::ItemType::SZ, "str", str, sizeof(str)) != ESP_OK
+            || std::string(str) != "string of generation " + std::to_string(generation)) {
+        return -1;
+    }
+    uint8_t blob[70];
+    if (storage.readItem(1, nvs::ItemType::BLOB, "blob", blob, sizeof(blob)) != ESP_OK
+            || std::any_of(blob, blob + sizeof(blob), [=](uint8_t b) { return b != (uint8_t) generation; })) {
+        return -1;
+    }
+    return generation;
+}
+
+TEST_CASE("nvs transaction is atomic when the power is lost", "[nvs][transaction]")
+{
+    // TC verifies that a transaction written by nvs::Storage is all-or-nothing.
+    // The power-off is emulated at every write operation of the transaction in turn.
+    // The test verifies following:
+    // - after re-initialization either all previous or all new values are present
+    // - the storage is consistent and accepts the next transaction
+    // - both outcomes, the rollback and the completion of a committed transaction, are exercised
+
+    const bool purgeAfterErase = TEST_DEFAULT_PURGE_AFTER_ERASE;
+    size_t rollbacks = 0;
+    size_t commits = 0;
+
+    for (size_t failAfter = 0; ; ++failAfter) {
+        INFO(failAfter);
+        NVSPartitionTestHelper h(TEST_3SEC_PARTITION_NAME);
+        {
+            nvs::Storage storage(&h);
+            TEST_ESP_OK(storage.init(0, h.get_sectors()));
+
+            nvs::Transaction first;
+            stage_transaction_values(first, 1);
+            TEST_ESP_OK(storage.writeTransaction(first, purgeAfterErase));
+
+            // unrelated items between the old and the new values
+            for (uint64_t i = 0; i < 40; ++i) {
+                char key[16];
+                snprintf(key, sizeof(key), "f%u", (unsigned) (i % 13));
+                TEST_ESP_OK(storage.writeItem(2, key, i, purgeAfterErase));
+            }
+
+            nvs::Transaction second;
+            stage_transaction_values(second, 2);
+            NVSPartitionTestHelper::fail_after(failAfter, ESP_PARTITION_FAIL_AFTER_MODE_BOTH);
+            esp_err_t err = storage.writeTransaction(second, purgeAfterErase);
+            NVSPartitionTestHelper::fail_after(SIZE_MAX, ESP_PARTITION_FAIL_AFTER_MODE_BOTH);
+            if (err == ESP_OK) {
+                // failAfter is high enough to not trigger the power-off any more
+                CHECK(read_transaction_generation(storage) == 2);
+                break;
+            }
+        }
+
+        nvs::Storage storage(&h);
+        TEST_ESP_OK(storage.init(0, h.get_sectors()));
+        const int generation = read_transaction_generation(storage);
+        CHECK((generation == 1 || generation == 2));
+        if (generation == 2) {
+            ++commits;
+        } else {
+            ++rollbacks;
+        }
+
+        nvs::Transaction third;
+        stage_transaction_values(third, 3);
+        TEST_ESP_OK(storage.writeTransaction(third, purgeAfterErase));
+        CHECK(read_transaction_generation(storage) == 3);
+
+        nvs::Storage reloaded(&h);
+        TEST_ESP_OK(reloaded.init(0, h.get_sectors()));
+        CHECK(read_transaction_generation(reloaded) == 3);
+    }
+
+    CHECK(rollbacks > 0);
+    CHECK(commits > 0);
+}
+
+TEST_CASE("benchmark flash writes of a transaction against single writes", "[nvs][transaction][benchmark]")
+{
+    // TC compares the number of flash write operations needed to update a set of keys
+    // one by one and as one transaction, with and without purging of the erased values.
+
+    const size_t itemCount = 20;
+    char key[16];
+
+    for (bool purgeAfterErase : {true, false}) {
+        NVSPartitionTestHelper h(TEST_DEFAULT_PARTITION_NAME);
+        nvs::Storage storage(&h);
+        TEST_ESP_OK(storage.init(0, h.get_sectors()));
+
+        for (size_t i = 0; i < itemCount; ++i) {
+            snprintf(key, sizeof(key), "k%u", (unsigned) i);
+            TEST_ESP_OK(storage.writeItem(1, key, static_cast<uint32_t>(i), purgeAfterErase));
+        }
+
+        NVSPartitionTestHelper::clear_stats();
+        for (size_t i = 0; i < itemCount; ++i) {
+            snprintf(key, sizeof(key), "k%u", (unsigned) i);
+            TEST_ESP_OK(storage.writeItem(1, key, static_cast<uint32_t>(i + 1), purgeAfterErase));
+        }
+        const size_t singleWrites = NVSPartitionTestHelper::get_write_ops();
+
+        nvs::Transaction transaction;
+        for (size_t i = 0; i < itemCount; ++i) {
+            snprintf(key, sizeof(key), "k%u", (unsigned) i);
+            uint32_t value = i + 2;
+            TEST_ESP_OK(transaction.add(1, nvs::ItemType::U32, key, &value, sizeof(value)));
+        }
+        NVSPartitionTestHelper::clear_stats();
+        TEST_ESP_OK(storage.writeTransaction(transaction, purgeAfterErase));
+        const size_t transactionWrites = NVSPartitionTestHelper::get_write_ops();
+
+        for (size_t i = 0; i < itemCount; ++i) {
+            uint32_t value;
+            snprintf(key, sizeof(key), "k%u", (unsigned) i);
+            TEST_ESP_OK(storage.readItem(1, key, value));
+            CHECK(value == i + 2);
+        }
+        CHECK(transactionWrites < singleWrites);
+
+        s_perf << "Update of " << itemCount << " keys" << (purgeAfterErase ? " with purge" : "") << ": "
+               << singleWrites << " writes one by one, " << transactionWrites << " writes as transaction" << std::endl;
+    }
+}
+
+// Collects the pieces passed to nvs_read_cb_t, optionally failing after stop_after pieces
+struct StreamCollector {
+    std::vector<uint8_t> data;
+    size_t pieces = 0;
+    size_t total_length = 0;
+    size_t stop_after = SIZE_MAX;
+    bool offsets_ok = true;
+
+    static esp_err_t callback(const void *piece, size_t length, size_t offset, size_t total_length, void *arg)
+    {
+        StreamCollector *self = static_cast<StreamCollector *>(arg);
+        self->offsets_ok = self->offsets_ok && offset == self->data.size();
+        self->total_length = total_length;
+        self->data.insert(self->data.end(), static_cast<const uint8_t *>(piece), static_cast<const uint8_t *>(piece) + length);
+        return (++self->pieces < self->stop_after) ? ESP_OK : ESP_ERR_INVALID_STATE;
+    }
+};
+
+// Partition which can't be memory mapped, like an encrypted one, so that values are streamed through the buffer
+class UnmappedPartitionTestHelper : public NVSPartitionTestHelper {
+public:
+    UnmappedPartitionTestHelper(const char *part_name) : NVSPartitionTestHelper(part_name) { }
+
+    esp_err_t mmap_data(const void** ptr, uint32_t* handle) override
+    {
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+};
+
+TEST_CASE("nvs_get_str_stream and nvs_get_blob_stream pass the value piece by piece", "[nvs][stream]")
+{
+    // TC verifies the streaming read API.
+    // The test verifies following:
+    // - strings, single chunk and multi-page blobs are passed completely and in order of offset
+    // - an error returned by the callback stops reading and is returned
+    // - missing keys, type mismatch and invalid arguments are reported
+
+    TEST_ESP_OK(nvs_flash_erase_partition(TEST_DEFAULT_PARTITION_NAME));
+    TEST_ESP_OK(nvs_flash_init_partition(TEST_DEFAULT_PARTITION_NAME));
+
+    nvs_handle_t handle;
+    TEST_ESP_OK(nvs_open_from_partition(TEST_DEFAULT_PARTITION_NAME, "stream", NVS_READWRITE, &handle));
+
+    const char str[] = "value passed to the callback";
+    std::vector<uint8_t> blob(nvs::Page::CHUNK_MAX_SIZE * 2 + 100);
+    for (size_t i = 0; i < blob.size(); ++i) {
+        blob[i] = static_cast<uint8_t>(i * 7 + 3);
+    }
+    TEST_ESP_OK(nvs_set_str(handle, "str", str));
+    TEST_ESP_OK(nvs_set_blob(handle, "blob", blob.data(), blob.size()));
+    TEST_ESP_OK(nvs_set_blob(handle, "empty", blob.data(), 0));
+
+    StreamCollector s;
+    TEST_ESP_OK(nvs_get_str_stream(handle, "str", StreamCollector::callback, &s));
+    CHECK(s.data.size() == sizeof(str));
+    CHECK(memcmp(s.data.data(), str, sizeof(str)) == 0);
+    CHECK(s.total_length == sizeof(str));
+
+    StreamCollector b;
+    TEST_ESP_OK(nvs_get_blob_stream(handle, "blob", StreamCollector::callback, &b));
+    CHECK(b.data == blob);
+    CHECK(b.offsets_ok);
+    CHECK(b.total_length == blob.size());
+    CHECK(b.pieces >= 3);
+
+    StreamCollector e;
+    TEST_ESP_OK(nvs_get_blob_stream(handle, "empty", StreamCollector::callback, &e));
+    CHECK(e.pieces == 0);
+
+    StreamCollector stopped;
+    stopped.stop_after = 1;
+    TEST_ESP_ERR(nvs_get_blob_stream(handle, "blob", StreamCollector::callback, &stopped), ESP_ERR_INVALID_STATE);
+    CHECK(stopped.pieces == 1);
+
+    StreamCollector n;
+    TEST_ESP_ERR(nvs_get_blob_stream(handle, "missing", StreamCollector::callback, &n), ESP_ERR_NVS_NOT_FOUND);
+    TEST_ESP_ERR(nvs_get_str_stream(handle, "blob", StreamCollector::callback, &n), ESP_ERR_NVS_NOT_FOUND);
+    TEST_ESP_ERR(nvs_get_blob_stream(handle, "blob", nullptr, nullptr), ESP_ERR_INVALID_ARG);
+    CHECK(n.pieces == 0);
+
+    nvs_close(handle);
+    TEST_ESP_OK(nvs_flash_deinit_partition(TEST_DEFAULT_PARTITION_NAME));
+}
+
+TEST_CASE("streamed read through the buffer detects corrupted data", "[nvs][stream]")
+{
+    // TC verifies nvs::Storage::readItemStream on a partition which can't be memory mapped.
+    // The test verifies following:
+    // - values are passed in pieces not larger than the internal buffer
+    // - a CRC error of the data is reported as ESP_ERR_NVS_NOT_FOUND and the item is erased
+
+    UnmappedPartitionTestHelper h(TEST_DEFAULT_PARTITION_NAME);
+    const bool purgeAfterErase = TEST_DEFAULT_PURGE_AFTER_ERASE;
+
+    nvs::Storage storage(&h);
+    TEST_ESP_OK(storage.init(0, h.get_sectors()));
+
+    const char str[] = "0123456789abcdef0123456789abcdef0123456789";
+    TEST_ESP_OK(storage.writeItem(1, nvs::ItemType::SZ, "str", str, sizeof(str), purgeAfterErase));
+
+    std::vector<uint8_t> blob(nvs::Page::CHUNK_MAX_SIZE + 500);
+    for (size_t i = 0; i < blob.size(); ++i) {
+        blob[i] = static_cast<uint8_t>(i + 1);
+    }
+    TEST_ESP_OK(storage.writeItem(1, nvs::ItemType::BLOB, "blob", blob.data(), blob.size(), purgeAfterErase));
+
+    StreamCollector b;
+    TEST_ESP_OK(storage.readItemStream(1, nvs::ItemType::BLOB, "blob", StreamCollector::callback, &b));
+    CHECK(b.data == blob);
+    CHECK(b.offsets_ok);
+    CHECK(b.pieces >= blob.size() / nvs::Storage::STREAM_BUFFER_SIZE);
+
+    // clear bits in the first data entry of the string
+    nvs::Page p;
+    TEST_ESP_OK(p.load(&h, 0));
+    size_t itemIndex = 0;
+    nvs::Item item;
+    TEST_ESP_OK(p.findItem(1, nvs::ItemType::SZ, "str", itemIndex, item));
+    const uint8_t zeroes[4] = {0};
+    TEST_ESP_OK(h.write_raw(64 + (itemIndex + 1) * nvs::Page::ENTRY_SIZE, zeroes, sizeof(zeroes)));
+
+    StreamCollector s;
+    TEST_ESP_ERR(storage.readItemStream(1, nvs::ItemType::SZ, "str", StreamCollector::callback, &s), ESP_ERR_NVS_NOT_FOUND);
+    TEST_ESP_ERR(storage.readItemStream(1, nvs::ItemType::SZ, "str", StreamCollector::callback, &s), ESP_ERR_NVS_NOT_FOUND);
+}
+
+// Partition which is mapped as garbage, like a plain partition mapped while flash encryption is enabled
+class GarbageMappedPartitionTestHelper : public NVSPartitionTestHelper {
+public:
+    GarbageMappedPartitionTestHelper(const char *part_name) : NVSPartitionTestHelper(part_name), garbage(get_size(), 0x5a) { }
+
+    esp_err_t mmap_data(const void** ptr, uint32_t* handle) override
+    {
+        *ptr = garbage.data();
+        *handle = 0;
+        return ESP_OK;
+    }
+
+    void munmap_data(uint32_t handle) override { }
+
+    std::vector<uint8_t> garbage;
+};
+
+TEST_CASE("streamed read doesn't erase items which only the mapping shows as corrupted", "[nvs][stream]")
+{
+    // TC verifies that a CRC mismatch in the memory mapped partition is checked again by reading the partition.
+    // The value is passed to the callback and the item is kept.
+
+    GarbageMappedPartitionTestHelper h(TEST_DEFAULT_PARTITION_NAME);
+    const bool purgeAfterErase = TEST_DEFAULT_PURGE_AFTER_ERASE;
+
+    nvs::Storage storage(&h);
+    TEST_ESP_OK(storage.init(0, h.get_sectors()));
+
+    const char str[] = "0123456789abcdef0123456789abcdef0123456789";
+    TEST_ESP_OK(storage.writeItem(1, nvs::ItemType::SZ, "str", str, sizeof(str), purgeAfterErase));
+
+    for (int i = 0; i < 2; ++i) {
+        StreamCollector s;
+        TEST_ESP_OK(storage.readItemStream(1, nvs::ItemType::SZ, "str", StreamCollector::callback, &s));
+        CHECK(s.data == std::vector<uint8_t>(str, str + sizeof(str)));
+        CHECK(s.offsets_ok);
+    }
+}
+
+TEST_CASE("benchmark streamed read of a large blob against nvs_get_blob", "[nvs][stream][benchmark]")
+{
+    // TC compares reading a multi-page blob with nvs_get_blob, including the length query, with the
+    // streamed read from the memory mapped partition and through the buffer of a partition which can't be mapped.
+    // Reported are the wall clock time, flash read operations and bytes read per read of the blob,
+    // and the RAM needed to hold the data.
+
+    const size_t reads = 200;
+    std::vector<uint8_t> blob(nvs::Page::CHUNK_MAX_SIZE * 3);
+    for (size_t i = 0; i < blob.size(); ++i) {
+        blob[i] = static_cast<uint8_t>(i);
+    }
+    auto ignore = [](const void *, size_t, size_t, size_t, void *) -> esp_err_t {
+        return ESP_OK;
+    };
+
+    {
+        TEST_ESP_OK(nvs_flash_erase_partition(TEST_DEFAULT_PARTITION_NAME));
+        TEST_ESP_OK(nvs_flash_init_partition(TEST_DEFAULT_PARTITION_NAME));
+        nvs_handle_t handle;
+        TEST_ESP_OK(nvs_open_from_partition(TEST_DEFAULT_PARTITION_NAME, "bench", NVS_READWRITE, &handle));
+        TEST_ESP_OK(nvs_set_blob(handle, "blob", blob.data(), blob.size()));
+
+        NVSPartitionTestHelper::clear_stats();
+        auto start = std::chrono::steady_clock::now();
+        for (size_t n = 0; n < reads; ++n) {
+            size_t length = 0;
+            TEST_ESP_OK(nvs_get_blob(handle, "blob", nullptr, &length));
+            std::vector<uint8_t> out(length);
+            TEST_ESP_OK(nvs_get_blob(handle, "blob", out.data(), &length));
+        }
+        auto time = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+        s_perf << "Read of " << blob.size() << " bytes blob, nvs_get_blob: " << time / reads / 1000 << " us, "
+               << NVSPartitionTestHelper::get_read_ops() / reads << " reads, " << NVSPartitionTestHelper::get_read_bytes() / reads
+               << " bytes read, " << blob.size() << " bytes of RAM" << std::endl;
+
+        NVSPartitionTestHelper::clear_stats();
+        start = std::chrono::steady_clock::now();
+        for (size_t n = 0; n < reads; ++n) {
+            TEST_ESP_OK(nvs_get_blob_stream(handle, "blob", ignore, nullptr));
+        }
+        time = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+        s_perf << "Read of " << blob.size() << " bytes blob, nvs_get_blob_stream mapped: " << time / reads / 1000 << " us, "
+               << NVSPartitionTestHelper::get_read_ops() / reads << " reads, " << NVSPartitionTestHelper::get_read_bytes() / reads
+               << " bytes read, 0 bytes of RAM" << std::endl;
+
+        nvs_close(handle);
+        TEST_ESP_OK(nvs_flash_deinit_partition(TEST_DEFAULT_PARTITION_NAME));
+    }
+
+    {
+        UnmappedPartitionTestHelper h(TEST_DEFAULT_PARTITION_NAME);
+        nvs::Storage storage(&h);
+        TEST_ESP_OK(storage.init(0, h.get_sectors()));
+        TEST_ESP_OK(storage.writeItem(1, nvs::ItemType::BLOB, "blob", blob.data(), blob.size(), TEST_DEFAULT_PURGE_AFTER_ERASE));
+
+        NVSPartitionTestHelper::clear_stats();
+        auto start = std::chrono::steady_clock::now();
+        for (size_t n = 0; n < reads; ++n) {
+            TEST_ESP_OK(storage.readItemStream(1, nvs::ItemType::BLOB, "blob", ignore, nullptr));
+        }
+        auto time = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+        s_perf << "Read of " << blob.size() << " bytes blob, streamed through buffer: " << time / reads / 1000 << " us, "
+               << NVSPartitionTestHelper::get_read_ops() / reads << " reads, " << NVSPartitionTestHelper::get_read_bytes() / reads
+               << " bytes read, " << nvs::Storage::STREAM_BUFFER_SIZE << " bytes of RAM" << std::endl;
+    }
+}
+
+// Fills the storage up to the given number of free pages with integers, strings and multi-page blobs
+static void fill_storage_for_mount(nvs::Storage& storage, size_t freePages)
+{
+    const bool purgeAfterErase = TEST_DEFAULT_PURGE_AFTER_ERASE;
+    char key[16];
+    const char str[] = "string value used to fill the partition";
+    std::vector<uint8_t> blob(nvs::Page::CHUNK_MAX_SIZE + 600, 0x5a);
+    nvs_stats_t stats;
+    for (size_t i = 0;; ++i) {
+        TEST_ESP_OK(storage.fillStats(stats));
+        if (stats.free_entries < (freePages + 1) * nvs::Page::ENTRY_COUNT) {
+            break;
+        }
+        snprintf(key, sizeof(key), "k%u", (unsigned) i);
+        if (i % 50 == 49) {
+            TEST_ESP_OK(storage.writeItem(1, nvs::ItemType::BLOB, key, blob.data(), blob.size(), purgeAfterErase));
+        } else if (i % 4 == 3) {
+            TEST_ESP_OK(storage.writeItem(1, nvs::ItemType::SZ, key, str, sizeof(str), purgeAfterErase));
+        } else {
+            TEST_ESP_OK(storage.writeItem(1, key, static_cast<uint32_t>(i), purgeAfterErase));
+        }
+    }
+}
+
+TEST_CASE("PageManager loads the same pages with concurrent page scan", "[nvs]")
+{
+    // TC verifies that scanning the pages on several tasks gives the same result as the sequential scan.
+    // The test verifies following:
+    // - the pages are ordered by their seq number in both cases
+    // - used and erased entry counts of the pages and the key index size match
+    // - items can be read from a storage which was initialized with the concurrent scan
+
+    NVSPartitionTestHelper h(TEST_64SEC_PARTITION_NAME);
+    {
+        nvs::Storage storage(&h);
+        TEST_ESP_OK(storage.init(0, h.get_sectors()));
+        fill_storage_for_mount(storage, 2);
+        // erase some items so that pages hold erased entries as well
+        char key[16];
+        for (size_t i = 0; i < 1000; i += 7) {
+            snprintf(key, sizeof(key), "k%u", (unsigned) i);
+            storage.eraseItem(1, key, TEST_DEFAULT_PURGE_AFTER_ERASE);
+        }
+    }
+
+    nvs::PageManager sequential;
+    TEST_ESP_OK(sequential.load(&h, 0, h.get_sectors(), 1));
+    nvs::PageManager concurrent;
+    TEST_ESP_OK(concurrent.load(&h, 0, h.get_sectors(), 4));
+
+    auto it = std::begin(sequential);
+    auto jt = std::begin(concurrent);
+    for (; it != std::end(sequential) && jt != std::end(concurrent); ++it, ++jt) {
+        uint32_t seqNo;
+        uint32_t otherSeqNo;
+        TEST_ESP_OK(it->getSeqNumber(seqNo));
+        TEST_ESP_OK(jt->getSeqNumber(otherSeqNo));
+        CHECK(seqNo == otherSeqNo);
+        CHECK(it->getUsedEntryCount() == jt->getUsedEntryCount());
+        CHECK(it->getErasedEntryCount() == jt->getErasedEntryCount());
+    }
+    CHECK(it == std::end(sequential));
+    CHECK(jt == std::end(concurrent));
+    CHECK(sequential.getKeyIndex().size() == concurrent.getKeyIndex().size());
+}
+
+TEST_CASE("benchmark partition mount time against partition size", "[nvs][benchmark]")
+{
+    // TC measures the time of loading all pages of partitions of different sizes filled up to the same level,
+    // with the pages scanned sequentially and by several concurrent tasks.
+    // Reported are the wall clock time per mount, and for the sequential scan the number of flash reads and
+    // the flash time emulated for an ESP8266 at 80 MHz flash frequency.
+
+    const char* part_names[] = {TEST_3SEC_PARTITION_NAME, TEST_DEFAULT_PARTITION_NAME, TEST_64SEC_PARTITION_NAME};
+    const size_t scanTasks[] = {1, 2, 4};
+    const size_t mounts = 20;
+
+    for (auto part_name : part_names) {
+        NVSPartitionTestHelper h(part_name);
+        {
+            nvs::Storage storage(&h);
+            TEST_ESP_OK(storage.init(0, h.get_sectors()));
+            fill_storage_for_mount(storage, 1);
+        }
+
+        for (auto tasks : scanTasks) {
+            NVSPartitionTestHelper::clear_stats();
+            auto start = std::chrono::steady_clock::now();
+            for (size_t n = 0; n < mounts; ++n) {
+                nvs::PageManager pm;
+                TEST_ESP_OK(pm.load(&h, 0, h.get_sectors(), tasks));
+            }
+            auto time = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+
+            s_perf << "Mount of " << h.get_sectors() << " pages, " << tasks << " scan task(s): " << time / mounts / 1000 << " us";
+            if (tasks == 1) {
+                // statistics of the emulated flash aren't collected reliably by concurrent readers
+                s_perf << ", " << NVSPartitionTestHelper::get_read_ops() / mounts << " reads, emulated flash time "
+                       << NVSPartitionTestHelper::get_total_time() / mounts << " us";
+            }
+            s_perf << std::endl;
+        }
+    }
+}
 
 // Add new tests above
 // This test has to be the final one
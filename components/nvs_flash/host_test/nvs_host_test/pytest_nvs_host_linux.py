@@ -12,6 +12,9 @@ from pytest_embedded_idf.utils import idf_parametrize
         'default_set_key',
         'legacy_set_key',
         'esp_blockdev',
+        'key_index',
+        'hash_table',
+        'page_scan',
     ],
     indirect=True,
 )
@@ -127,6 +127,19 @@ typedef struct {
  */
 typedef struct nvs_opaque_iterator_t *nvs_iterator_t;
 
+/**
+ * @brief Callback receiving the value of a string or blob piece by piece, see nvs_get_blob_stream
+ *
+ * @param data          Pointer to the piece of the value, only valid during the call
+ * @param length        Length of the piece in bytes
+ * @param offset        Offset of the piece within the value
+ * @param total_length  Length of the whole value in bytes
+ * @param arg           User argument passed to nvs_get_str_stream or nvs_get_blob_stream
+ *
+ * @return ESP_OK to continue reading, any other value stops reading and is returned to the caller
+ */
+typedef esp_err_t (*nvs_read_cb_t)(const void *data, size_t length, size_t offset, size_t total_length, void *arg);
+
 /**
  * @brief      Open non-volatile storage with a given namespace from the default NVS partition
  *
@@ -504,6 +517,48 @@ esp_err_t nvs_get_str (nvs_handle_t handle, const char* key, char* out_value, si
 esp_err_t nvs_get_blob(nvs_handle_t handle, const char* key, void* out_value, size_t* length);
 /**@}*/
 
+/**@{*/
+/**
+ * @brief      read string value for given key piece by piece
+ *
+ * These functions pass the value of a string or blob to the callback in pieces, in ascending order of offset,
+ * without copying the whole value into a caller provided buffer. Values of unknown length, e.g. certificates or
+ * calibration tables, can be parsed in a single call.
+ *
+ * If the partition can be memory mapped, the pieces point directly into the mapped flash, one piece for each
+ * chunk of a blob. Otherwise, e.g. for encrypted partitions, the data is read through a small internal buffer.
+ * The CRC of every chunk is verified. With the internal buffer, it is verified once all pieces of the chunk
+ * have been passed to the callback, so data received so far has to be discarded if an error is returned.
+ * For strings, the last piece includes the zero terminator.
+ *
+ * The callback is called while NVS is locked, it must not call NVS functions.
+ *
+ * @param[in]     handle     Handle obtained from nvs_open function.
+ * @param[in]     key        Key name. Maximum length is (NVS_KEY_NAME_MAX_SIZE-1) characters. Shouldn't be empty.
+ * @param[in]     callback   Function receiving the pieces of the value.
+ * @param[in]     arg        User argument passed to the callback.
+ *
+ * @return
+ *             - ESP_OK if the whole value was passed to the callback
+ *             - ESP_FAIL if there is an internal error; most likely due to corrupted
+ *               NVS partition (only if NVS assertion checks are disabled)
+ *             - ESP_ERR_NVS_NOT_FOUND if the requested key doesn't exist or its data is corrupted
+ *             - ESP_ERR_NVS_INVALID_HANDLE if handle has been closed or is NULL
+ *             - ESP_ERR_NVS_INVALID_NAME if key name doesn't satisfy constraints
+ *             - ESP_ERR_INVALID_ARG if callback is NULL
+ *             - ESP_ERR_NO_MEM if memory for the internal buffer could not be allocated
+ *             - other error codes returned by the callback
+ */
+esp_err_t nvs_get_str_stream(nvs_handle_t handle, const char* key, nvs_read_cb_t callback, void* arg);
+
+/**
+ * @brief      read blob value for given key piece by piece
+ *
+ * This function behaves the same as \c nvs_get_str_stream, except for the data type.
+ */
+esp_err_t nvs_get_blob_stream(nvs_handle_t handle, const char* key, nvs_read_cb_t callback, void* arg);
+/**@}*/
+
 /**
  * @brief      Lookup key-value pair with given key name.
  *
@@ -587,16 +642,60 @@ esp_err_t nvs_purge_all(nvs_handle_t handle);
  * to non-volatile storage. Individual implementations may write to storage at other times,
  * but this is not guaranteed.
  *
+ * If a transaction was started with nvs_transaction_begin(), the values staged since then
+ * are written atomically and the transaction ends, also if an error is returned.
+ *
  * @param[in]  handle  Storage handle obtained with nvs_open.
  *                     Handles that were opened read only cannot be used.
  *
  * @return
  *             - ESP_OK if the changes have been written successfully
  *             - ESP_ERR_NVS_INVALID_HANDLE if handle has been closed or is NULL
+ *             - ESP_ERR_NVS_NOT_ENOUGH_SPACE if the staged values don't fit into one page
+ *               or there is not enough space left
+ *             - ESP_ERR_NVS_REMOVE_FAILED if the staged values were written, but a previous value
+ *               couldn't be erased because flash write operation has failed
  *             - other error codes from the underlying storage driver
  */
 esp_err_t nvs_commit(nvs_handle_t handle);
 
+/**
+ * @brief      Start a transaction on the handle
+ *
+ * The nvs_set_* functions called with the handle afterwards stage the values in RAM instead of
+ * writing them. nvs_commit() writes all staged values as one run of entries with a single update of
+ * the entry state table, which saves flash operations compared to writing the values one by one.
+ * After a power loss either all or none of the staged values are present.
+ * Setting a key again replaces the staged value. Get, find and erase functions are not part of
+ * the transaction, they operate on the committed values.
+ *
+ * All staged values, each blob as a whole, have to fit into a single page. Values equal to the stored
+ * ones are skipped by nvs_commit().
+ *
+ * @param[in]  handle  Storage handle obtained with nvs_open.
+ *                     Handles that were opened read only cannot be used.
+ *
+ * @return
+ *             - ESP_OK if the transaction was started
+ *             - ESP_ERR_NVS_INVALID_HANDLE if handle has been closed or is NULL
+ *             - ESP_ERR_NVS_READ_ONLY if storage handle was opened as read only
+ *             - ESP_ERR_INVALID_STATE if a transaction has already been started on the handle
+ *             - ESP_ERR_NO_MEM if memory for the transaction could not be allocated
+ */
+esp_err_t nvs_transaction_begin(nvs_handle_t handle);
+
+/**
+ * @brief      Drop the values staged since nvs_transaction_begin() and end the transaction
+ *
+ * @param[in]  handle  Storage handle obtained with nvs_open.
+ *
+ * @return
+ *             - ESP_OK if the transaction was dropped
+ *             - ESP_ERR_NVS_INVALID_HANDLE if handle has been closed or is NULL
+ *             - ESP_ERR_INVALID_STATE if no transaction has been started on the handle
+ */
+esp_err_t nvs_transaction_abort(nvs_handle_t handle);
+
 /**
  * @brief      Close the storage handle and free any allocated resources
  *
@@ -183,6 +183,27 @@ public:
      */
     virtual esp_err_t get_item_size(ItemType datatype, const char *key, size_t &size) = 0;
 
+    /**
+     * @brief Passes the data of a string or blob to the callback piece by piece.
+     *
+     * The pieces point into the memory mapped partition if it can be mapped, otherwise they are read through
+     * a small internal buffer. The callback is called while NVS is locked and must not call NVS functions.
+     *
+     * @param[in]     datatype   ItemType::SZ or ItemType::BLOB.
+     * @param[in]     key        Key name. Maximum length is (NVS_KEY_NAME_MAX_SIZE-1) characters. Shouldn't be empty.
+     * @param[in]     callback   Function receiving the pieces of the value.
+     * @param[in]     arg        User argument passed to the callback.
+     *
+     * @return      - ESP_OK if the whole value was passed to the callback.
+     *              - ESP_ERR_NVS_NOT_FOUND if the requested key doesn't exist or its data is corrupted.
+     *              - ESP_ERR_INVALID_ARG if callback is nullptr or datatype is neither string nor blob.
+     *              - ESP_ERR_NO_MEM if memory for the internal buffer couldn't be allocated.
+     *              - other error codes returned by the callback.
+     *
+     * @note compare to \ref nvs_get_blob_stream in nvs.h
+     */
+    virtual esp_err_t get_item_stream(ItemType datatype, const char *key, nvs_read_cb_t callback, void *arg) = 0;
+
     /**
      * @brief Checks whether key exists and optionally returns also data type of associated entry.
      *
@@ -219,9 +240,40 @@ public:
      * Commits all changes done through this handle so far.
      * Currently, NVS writes to storage right after the set and get functions,
      * but this is not guaranteed.
+     *
+     * If a transaction was started with begin_transaction, the values staged since then are written atomically
+     * and the transaction ends, also if writing fails.
      */
     virtual esp_err_t commit() = 0;
 
+    /**
+     * @brief      Starts a transaction for this handle
+     *
+     * Values set through this handle are staged in RAM until commit is called, which writes all of them
+     * with a single update of the entry state table. After a power loss either all or none of the staged
+     * values are present. Values set later for the same key replace the staged ones. Reads and erase
+     * functions aren't part of the transaction, they operate on the committed values.
+     *
+     * All staged values have to fit into a single page, blobs are limited to one page as well.
+     *
+     * @return
+     *             - ESP_OK if the transaction was started
+     *             - ESP_ERR_NVS_INVALID_HANDLE if the handle has been closed
+     *             - ESP_ERR_NVS_READ_ONLY if the handle was opened as read only
+     *             - ESP_ERR_INVALID_STATE if a transaction has already been started
+     *             - ESP_ERR_NO_MEM if memory couldn't be allocated
+     */
+    virtual esp_err_t begin_transaction() = 0;
+
+    /**
+     * @brief      Drops all values staged since begin_transaction and ends the transaction
+     *
+     * @return
+     *             - ESP_OK if the transaction was dropped
+     *             - ESP_ERR_INVALID_STATE if no transaction has been started
+     */
+    virtual esp_err_t abort_transaction() = 0;
+
     /**
      * @brief      Calculate all entries in the scope of the handle.
      *
@@ -461,6 +461,30 @@ extern "C" esp_err_t nvs_commit(nvs_handle_t c_handle)
     return handle->commit();
 }
 
+extern "C" esp_err_t nvs_transaction_begin(nvs_handle_t c_handle)
+{
+    Lock lock;
+    ESP_LOGD(TAG, "%s", __func__);
+    NVSHandleSimple *handle;
+    auto err = nvs_find_ns_handle(c_handle, &handle);
+    if (err != ESP_OK) {
+        return err;
+    }
+    return handle->begin_transaction();
+}
+
+extern "C" esp_err_t nvs_transaction_abort(nvs_handle_t c_handle)
+{
+    Lock lock;
+    ESP_LOGD(TAG, "%s", __func__);
+    NVSHandleSimple *handle;
+    auto err = nvs_find_ns_handle(c_handle, &handle);
+    if (err != ESP_OK) {
+        return err;
+    }
+    return handle->abort_transaction();
+}
+
 extern "C" esp_err_t nvs_set_str(nvs_handle_t c_handle, const char* key, const char* value)
 {
     Lock lock;
@@ -579,6 +603,29 @@ extern "C" esp_err_t nvs_get_blob(nvs_handle_t c_handle, const char* key, void*
     return nvs_get_str_or_blob(c_handle, nvs::ItemType::BLOB, key, out_value, length);
 }
 
+static esp_err_t nvs_get_str_or_blob_stream(nvs_handle_t c_handle, nvs::ItemType type, const char* key, nvs_read_cb_t callback, void* arg)
+{
+    Lock lock;
+    ESP_LOGD(TAG, "%s %s", __func__, key);
+    NVSHandleSimple *handle;
+    auto err = nvs_find_ns_handle(c_handle, &handle);
+    if (err != ESP_OK) {
+        return err;
+    }
+
+    return handle->get_item_stream(type, key, callback, arg);
+}
+
+extern "C" esp_err_t nvs_get_str_stream(nvs_handle_t c_handle, const char* key, nvs_read_cb_t callback, void* arg)
+{
+    return nvs_get_str_or_blob_stream(c_handle, nvs::ItemType::SZ, key, callback, arg);
+}
+
+extern "C" esp_err_t nvs_get_blob_stream(nvs_handle_t c_handle, const char* key, nvs_read_cb_t callback, void* arg)
+{
+    return nvs_get_str_or_blob_stream(c_handle, nvs::ItemType::BLOB, key, callback, arg);
+}
+
 extern "C" esp_err_t nvs_get_stats(const char* part_name, nvs_stats_t* nvs_stats)
 {
     Lock lock;
@@ -66,6 +66,16 @@ public:
      */
     esp_err_t write(size_t dst_offset, const void* src, size_t size) override;
 
+    /**
+     * The mapped data would be encrypted, so mapping is not supported.
+     *
+     * @return ESP_ERR_NOT_SUPPORTED
+     */
+    esp_err_t mmap_data(const void** ptr, uint32_t* handle) override
+    {
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+
 protected:
     XTS_CONTEXT mEctxt;     // AES context for encryption
     XTS_CONTEXT mDctxt;     // AES context for decryption
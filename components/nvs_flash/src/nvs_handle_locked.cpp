@@ -39,6 +39,11 @@ esp_err_t NVSHandleLocked::get_item_size(ItemType datatype, const char *key, siz
     return handle->get_item_size(datatype, key, size);
 }
 
+esp_err_t NVSHandleLocked::get_item_stream(ItemType datatype, const char *key, nvs_read_cb_t callback, void *arg) {
+    Lock lock;
+    return handle->get_item_stream(datatype, key, callback, arg);
+}
+
 esp_err_t NVSHandleLocked::find_key(const char* key, nvs_type_t &nvstype)
 {
     Lock lock;
@@ -65,6 +70,16 @@ esp_err_t NVSHandleLocked::commit() {
     return handle->commit();
 }
 
+esp_err_t NVSHandleLocked::begin_transaction() {
+    Lock lock;
+    return handle->begin_transaction();
+}
+
+esp_err_t NVSHandleLocked::abort_transaction() {
+    Lock lock;
+    return handle->abort_transaction();
+}
+
 esp_err_t NVSHandleLocked::get_used_entry_count(size_t& usedEntries) {
     Lock lock;
     return handle->get_used_entry_count(usedEntries);
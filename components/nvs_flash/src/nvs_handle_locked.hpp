@@ -40,6 +40,8 @@ public:
 
     esp_err_t get_item_size(ItemType datatype, const char *key, size_t &size) override;
 
+    esp_err_t get_item_stream(ItemType datatype, const char *key, nvs_read_cb_t callback, void *arg) override;
+
     esp_err_t find_key(const char* key, nvs_type_t &nvstype) override;
 
     esp_err_t erase_item(const char* key) override;
@@ -50,6 +52,10 @@ public:
 
     esp_err_t commit() override;
 
+    esp_err_t begin_transaction() override;
+
+    esp_err_t abort_transaction() override;
+
     esp_err_t get_used_entry_count(size_t& usedEntries) override;
 
 protected:
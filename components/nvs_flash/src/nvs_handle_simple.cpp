@@ -10,6 +10,7 @@
 namespace nvs {
 
 NVSHandleSimple::~NVSHandleSimple() {
+    delete mTransaction;
     NVSPartitionManager::get_instance()->close_handle(this);
 }
 
@@ -18,6 +19,10 @@ esp_err_t NVSHandleSimple::set_typed_item(ItemType datatype, const char *key, co
     if (!valid) return ESP_ERR_NVS_INVALID_HANDLE;
     if (mReadOnly) return ESP_ERR_NVS_READ_ONLY;
 
+    if (mTransaction) {
+        return mTransaction->add(mNsIndex, datatype, key, data, dataSize);
+    }
+
     return mStoragePtr->writeItem(mNsIndex, datatype, key, data, dataSize, mPurgeAfterErase);
 }
 
@@ -33,6 +38,10 @@ esp_err_t NVSHandleSimple::set_string(const char *key, const char* str)
     if (!valid) return ESP_ERR_NVS_INVALID_HANDLE;
     if (mReadOnly) return ESP_ERR_NVS_READ_ONLY;
 
+    if (mTransaction) {
+        return mTransaction->add(mNsIndex, nvs::ItemType::SZ, key, str, strlen(str) + 1);
+    }
+
     return mStoragePtr->writeItem(mNsIndex, nvs::ItemType::SZ, key, str, strlen(str) + 1, mPurgeAfterErase);
 }
 
@@ -41,6 +50,10 @@ esp_err_t NVSHandleSimple::set_blob(const char *key, const void* blob, size_t le
     if (!valid) return ESP_ERR_NVS_INVALID_HANDLE;
     if (mReadOnly) return ESP_ERR_NVS_READ_ONLY;
 
+    if (mTransaction) {
+        return mTransaction->add(mNsIndex, nvs::ItemType::BLOB, key, blob, len);
+    }
+
     return mStoragePtr->writeItem(mNsIndex, nvs::ItemType::BLOB, key, blob, len, mPurgeAfterErase);
 }
 
@@ -65,6 +78,13 @@ esp_err_t NVSHandleSimple::get_item_size(ItemType datatype, const char *key, siz
     return mStoragePtr->getItemDataSize(mNsIndex, datatype, key, size);
 }
 
+esp_err_t NVSHandleSimple::get_item_stream(ItemType datatype, const char *key, nvs_read_cb_t callback, void *arg)
+{
+    if (!valid) return ESP_ERR_NVS_INVALID_HANDLE;
+
+    return mStoragePtr->readItemStream(mNsIndex, datatype, key, callback, arg);
+}
+
 esp_err_t NVSHandleSimple::find_key(const char* key, nvs_type_t &nvstype)
 {
     if (!valid) return ESP_ERR_NVS_INVALID_HANDLE;
@@ -110,6 +130,35 @@ esp_err_t NVSHandleSimple::commit()
 {
     if (!valid) return ESP_ERR_NVS_INVALID_HANDLE;
 
+    if (!mTransaction) {
+        return ESP_OK;
+    }
+
+    esp_err_t err = mStoragePtr->writeTransaction(*mTransaction, mPurgeAfterErase);
+    delete mTransaction;
+    mTransaction = nullptr;
+    return err;
+}
+
+esp_err_t NVSHandleSimple::begin_transaction()
+{
+    if (!valid) return ESP_ERR_NVS_INVALID_HANDLE;
+    if (mReadOnly) return ESP_ERR_NVS_READ_ONLY;
+    if (mTransaction) return ESP_ERR_INVALID_STATE;
+
+    mTransaction = new (std::nothrow) Transaction;
+    if (!mTransaction) {
+        return ESP_ERR_NO_MEM;
+    }
+    return ESP_OK;
+}
+
+esp_err_t NVSHandleSimple::abort_transaction()
+{
+    if (!mTransaction) return ESP_ERR_INVALID_STATE;
+
+    delete mTransaction;
+    mTransaction = nullptr;
     return ESP_OK;
 }
 
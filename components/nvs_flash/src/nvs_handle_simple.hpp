@@ -7,6 +7,7 @@
 
 #include "intrusive_list.h"
 #include "nvs_storage.hpp"
+#include "nvs_transaction.hpp"
 #include "nvs_platform.hpp"
 
 #include "nvs_memory_management.hpp"
@@ -32,7 +33,8 @@ public:
         mNsIndex(nsIndex),
         mReadOnly(readOnly),
         mPurgeAfterErase(purgeAfterErase),
-        valid(1)
+        valid(1),
+        mTransaction(nullptr)
     { }
 
     ~NVSHandleSimple();
@@ -51,6 +53,8 @@ public:
 
     esp_err_t get_item_size(ItemType datatype, const char *key, size_t &size) override;
 
+    esp_err_t get_item_stream(ItemType datatype, const char *key, nvs_read_cb_t callback, void *arg) override;
+
     esp_err_t find_key(const char *key, nvs_type_t &nvstype) override;
 
     esp_err_t erase_item(const char *key) override;
@@ -61,6 +65,10 @@ public:
 
     esp_err_t commit() override;
 
+    esp_err_t begin_transaction() override;
+
+    esp_err_t abort_transaction() override;
+
     esp_err_t get_used_entry_count(size_t &usedEntries) override;
 
     esp_err_t getItemDataSize(ItemType datatype, const char *key, size_t &dataSize);
@@ -108,6 +116,11 @@ private:
      * Upon opening, a handle is valid. It becomes invalid if the underlying storage is de-initialized.
      */
     uint8_t valid;
+
+    /**
+     * Values staged by the transaction in progress, nullptr if there is none.
+     */
+    Transaction *mTransaction;
 };
 
 } // nvs
@@ -12,9 +12,36 @@ HashList::HashList()
 {
 }
 
+esp_err_t HashList::setKeyIndex(KeyIndex* keyIndex, Page* page)
+{
+    mKeyIndex = keyIndex;
+    mPage = page;
+    if (!mKeyIndex) {
+        return ESP_OK;
+    }
+    for (auto it = mBlockList.begin(); it != mBlockList.end(); ++it) {
+        for (size_t i = 0; i < it->mCount; ++i) {
+            if (it->mNodes[i].mIndex != 0xff) {
+                esp_err_t err = mKeyIndex->insert(it->mNodes[i].mHash, mPage, it->mNodes[i].mIndex);
+                if (err != ESP_OK) {
+                    return err;
+                }
+            }
+        }
+    }
+    return ESP_OK;
+}
+
 void HashList::clear()
 {
     for (auto it = mBlockList.begin(); it != mBlockList.end();) {
+        if (mKeyIndex) {
+            for (size_t i = 0; i < it->mCount; ++i) {
+                if (it->mNodes[i].mIndex != 0xff) {
+                    mKeyIndex->erase(it->mNodes[i].mHash, mPage, it->mNodes[i].mIndex);
+                }
+            }
+        }
         auto tmp = it;
         ++it;
         mBlockList.erase(tmp);
@@ -35,7 +62,14 @@ HashList::HashListBlock::HashListBlock()
 
 esp_err_t HashList::insert(const Item& item, size_t index)
 {
-    const uint32_t hash_24 = item.calculateCrc32WithoutValue() & 0xffffff;
+    const uint32_t hash_24 = KeyIndex::hashOf(item);
+    // register the item in the key index first, so that both stay consistent if an allocation fails
+    if (mKeyIndex) {
+        esp_err_t err = mKeyIndex->insert(hash_24, mPage, index);
+        if (err != ESP_OK) {
+            return err;
+        }
+    }
     // add entry to the end of last block if possible
     if (mBlockList.size()) {
         auto& block = mBlockList.back();
@@ -47,7 +81,12 @@ esp_err_t HashList::insert(const Item& item, size_t index)
     // if the above failed, create a new block and add entry to it
     HashListBlock* newBlock = new (std::nothrow) HashListBlock;
 
-    if (!newBlock) return ESP_ERR_NO_MEM;
+    if (!newBlock) {
+        if (mKeyIndex) {
+            mKeyIndex->erase(hash_24, mPage, index);
+        }
+        return ESP_ERR_NO_MEM;
+    }
 
     mBlockList.push_back(newBlock);
     newBlock->mNodes[0] = HashListNode(hash_24, index);
@@ -63,6 +102,9 @@ bool HashList::erase(size_t index)
         bool foundIndex = false;
         for (size_t i = 0; i < it->mCount; ++i) {
             if (it->mNodes[i].mIndex == index) {
+                if (mKeyIndex) {
+                    mKeyIndex->erase(it->mNodes[i].mHash, mPage, index);
+                }
                 it->mNodes[i].mIndex = 0xff;
                 foundIndex = true;
                 /* found the item and removed it */
@@ -96,7 +138,7 @@ bool HashList::erase(size_t index)
 
 size_t HashList::find(size_t start, const Item& item)
 {
-    const uint32_t hash_24 = item.calculateCrc32WithoutValue() & 0xffffff;
+    const uint32_t hash_24 = KeyIndex::hashOf(item);
     for (auto it = mBlockList.begin(); it != mBlockList.end(); ++it) {
         for (size_t index = 0; index < it->mCount; ++index) {
             HashListNode& e = it->mNodes[index];
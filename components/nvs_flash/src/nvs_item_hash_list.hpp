@@ -9,10 +9,13 @@
 #include "nvs_types.hpp"
 #include "nvs_memory_management.hpp"
 #include "intrusive_list.h"
+#include "nvs_key_index.hpp"
 
 namespace nvs
 {
 
+class Page;
+
 class HashList
 {
 public:
@@ -24,6 +27,13 @@ public:
     size_t find(size_t start, const Item& item);
     void clear();
 
+    /**
+     * Mirror all insertions and removals into the partition-wide key index on behalf of the owning page.
+     * Items already in the hash list are added to the index, so that a page can be loaded without the index
+     * and attached to it afterwards.
+     */
+    esp_err_t setKeyIndex(KeyIndex* keyIndex, Page* page);
+
 private:
     HashList(const HashList& other);
     const HashList& operator= (const HashList& rhs);
@@ -57,6 +67,9 @@ protected:
 
     typedef intrusive_list<HashListBlock> TBlockList;
     TBlockList mBlockList;
+
+    KeyIndex* mKeyIndex = nullptr;
+    Page* mPage = nullptr;
 }; // class HashList
 
 } // namespace nvs
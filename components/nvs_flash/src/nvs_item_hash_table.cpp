@@ -0,0 +1,157 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include "nvs_item_hash_table.hpp"
+
+namespace nvs
+{
+
+HashTable::HashTable()
+{
+}
+
+HashTable::~HashTable()
+{
+    clear();
+}
+
+HashTable::HashTableData::HashTableData()
+{
+    for (size_t i = 0; i < SLOT_COUNT; ++i) {
+        mSlots[i].mIndex = NO_SLOT;
+        mSlots[i].mHash = 0;
+    }
+    std::fill_n(mSlotOfIndex, ENTRY_COUNT, NO_SLOT);
+}
+
+esp_err_t HashTable::setKeyIndex(KeyIndex* keyIndex, Page* page)
+{
+    mKeyIndex = keyIndex;
+    mPage = page;
+    if (!mData || !mKeyIndex) {
+        return ESP_OK;
+    }
+    for (size_t i = 0; i < SLOT_COUNT; ++i) {
+        if (mData->mSlots[i].mIndex != NO_SLOT) {
+            esp_err_t err = mKeyIndex->insert(mData->mSlots[i].mHash, mPage, mData->mSlots[i].mIndex);
+            if (err != ESP_OK) {
+                return err;
+            }
+        }
+    }
+    return ESP_OK;
+}
+
+void HashTable::clear()
+{
+    if (mData && mKeyIndex) {
+        for (size_t i = 0; i < SLOT_COUNT; ++i) {
+            if (mData->mSlots[i].mIndex != NO_SLOT) {
+                mKeyIndex->erase(mData->mSlots[i].mHash, mPage, mData->mSlots[i].mIndex);
+            }
+        }
+    }
+    delete mData;
+    mData = nullptr;
+    mCount = 0;
+}
+
+esp_err_t HashTable::insert(const Item& item, size_t index)
+{
+    if (index >= ENTRY_COUNT) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    // an entry holds one item at a time, a stale hash of an entry which is being rewritten is replaced
+    if (mData && mData->mSlotOfIndex[index] != NO_SLOT) {
+        erase(index);
+    }
+
+    if (!mData) {
+        mData = new (std::nothrow) HashTableData;
+        if (!mData) {
+            return ESP_ERR_NO_MEM;
+        }
+    }
+
+    const uint32_t hash_24 = KeyIndex::hashOf(item);
+    if (mKeyIndex) {
+        esp_err_t err = mKeyIndex->insert(hash_24, mPage, index);
+        if (err != ESP_OK) {
+            if (mCount == 0) {
+                clear();
+            }
+            return err;
+        }
+    }
+
+    // the table holds at most ENTRY_COUNT items, so there is always an empty slot
+    size_t pos = homeSlot(hash_24);
+    while (mData->mSlots[pos].mIndex != NO_SLOT) {
+        pos = (pos + 1) % SLOT_COUNT;
+    }
+    mData->mSlots[pos].mIndex = (uint32_t) index;
+    mData->mSlots[pos].mHash = hash_24;
+    mData->mSlotOfIndex[index] = (uint8_t) pos;
+    ++mCount;
+    return ESP_OK;
+}
+
+bool HashTable::erase(size_t index)
+{
+    if (!mData || index >= ENTRY_COUNT || mData->mSlotOfIndex[index] == NO_SLOT) {
+        // item hasn't been present in the table
+        return false;
+    }
+
+    HashTableSlot* slots = mData->mSlots;
+    size_t hole = mData->mSlotOfIndex[index];
+    mData->mSlotOfIndex[index] = NO_SLOT;
+    if (mKeyIndex) {
+        mKeyIndex->erase(slots[hole].mHash, mPage, index);
+    }
+
+    // Backward shift deletion: move following items of the probe sequence into the hole
+    // as long as this doesn't place them before their home slot. No tombstones are needed then.
+    for (size_t next = (hole + 1) % SLOT_COUNT; slots[next].mIndex != NO_SLOT; next = (next + 1) % SLOT_COUNT) {
+        const size_t home = homeSlot(slots[next].mHash);
+        const bool homeInRange = (hole <= next) ? (home > hole && home <= next) : (home > hole || home <= next);
+        if (homeInRange) {
+            continue;
+        }
+        slots[hole] = slots[next];
+        mData->mSlotOfIndex[slots[hole].mIndex] = (uint8_t) hole;
+        hole = next;
+    }
+    slots[hole].mIndex = NO_SLOT;
+    slots[hole].mHash = 0;
+
+    if (--mCount == 0) {
+        /* no items left, release the table */
+        clear();
+    }
+    return true;
+}
+
+size_t HashTable::find(size_t start, const Item& item)
+{
+    if (!mData) {
+        return SIZE_MAX;
+    }
+
+    // Items with the same hash are not ordered within the probe sequence,
+    // return the lowest entry index not below start, like the list would.
+    const uint32_t hash_24 = KeyIndex::hashOf(item);
+    size_t result = SIZE_MAX;
+    for (size_t pos = homeSlot(hash_24); mData->mSlots[pos].mIndex != NO_SLOT; pos = (pos + 1) % SLOT_COUNT) {
+        const HashTableSlot& e = mData->mSlots[pos];
+        if (e.mHash == hash_24 && e.mIndex >= start && e.mIndex < result) {
+            result = e.mIndex;
+        }
+    }
+    return result;
+}
+
+} // namespace nvs
@@ -0,0 +1,77 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include "nvs.h"
+#include "nvs_types.hpp"
+#include "nvs_constants.h"
+#include "nvs_memory_management.hpp"
+#include "nvs_key_index.hpp"
+
+namespace nvs
+{
+
+class Page;
+
+/**
+ * Drop-in alternative to HashList with the same interface.
+ *
+ * Hashes of the items of one page are kept in a fixed-capacity open addressing table with linear probing,
+ * sized so that a completely written page keeps the load factor below 2/3. The table is allocated with
+ * the first item and released as soon as the last one is erased. An additional map from entry index to slot
+ * makes erasing by entry index constant-time as well.
+ */
+class HashTable
+{
+public:
+    HashTable();
+    ~HashTable();
+
+    esp_err_t insert(const Item& item, size_t index);
+    bool erase(const size_t index);
+    size_t find(size_t start, const Item& item);
+    void clear();
+
+    esp_err_t setKeyIndex(KeyIndex* keyIndex, Page* page);
+
+private:
+    HashTable(const HashTable& other);
+    const HashTable& operator= (const HashTable& rhs);
+
+protected:
+    static const size_t ENTRY_COUNT = NVS_CONST_ENTRY_COUNT;
+    static const size_t SLOT_COUNT = 192;
+    static constexpr uint8_t NO_SLOT = 0xff;
+
+    static_assert(ENTRY_COUNT < NO_SLOT, "entry index must fit into the slot");
+    static_assert(SLOT_COUNT < NO_SLOT, "slot position must fit into the reverse map");
+
+    struct HashTableSlot {
+        uint32_t mIndex : 8;
+        uint32_t mHash  : 24;
+    };
+
+    struct HashTableData : public ExceptionlessAllocatable {
+        HashTableData();
+
+        HashTableSlot mSlots[SLOT_COUNT];
+        uint8_t mSlotOfIndex[ENTRY_COUNT];
+    };
+
+    static size_t homeSlot(uint32_t hash)
+    {
+        // maps the 24-bit hash uniformly to [0, SLOT_COUNT) without a division
+        return (static_cast<size_t>(hash) * SLOT_COUNT) >> 24;
+    }
+
+    HashTableData* mData = nullptr;
+    size_t mCount = 0;
+
+    KeyIndex* mKeyIndex = nullptr;
+    Page* mPage = nullptr;
+}; // class HashTable
+
+} // namespace nvs
@@ -0,0 +1,144 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include "nvs_key_index.hpp"
+#include "nvs_internal.h"
+
+namespace nvs
+{
+
+KeyIndex::KeyIndex()
+{
+}
+
+KeyIndex::~KeyIndex()
+{
+    delete [] mSlots;
+}
+
+void KeyIndex::clear()
+{
+    delete [] mSlots;
+    mSlots = nullptr;
+    mCapacity = 0;
+    mCount = 0;
+    mDeleted = 0;
+}
+
+esp_err_t KeyIndex::resize(size_t capacity)
+{
+    Slot* newSlots = new (std::nothrow) Slot[capacity];
+    if (!newSlots) {
+        return ESP_ERR_NO_MEM;
+    }
+
+    // re-insert live slots only, this also drops all deleted markers
+    const size_t mask = capacity - 1;
+    for (size_t i = 0; i < mCapacity; ++i) {
+        const Slot& slot = mSlots[i];
+        if (slot.mPage == nullptr) {
+            continue;
+        }
+        size_t pos = slot.mHash & mask;
+        while (newSlots[pos].mPage != nullptr) {
+            pos = (pos + 1) & mask;
+        }
+        newSlots[pos] = slot;
+    }
+
+    delete [] mSlots;
+    mSlots = newSlots;
+    mCapacity = capacity;
+    mDeleted = 0;
+    return ESP_OK;
+}
+
+esp_err_t KeyIndex::insert(uint32_t hash, Page* page, size_t index)
+{
+    NVS_ASSERT_OR_RETURN(page != nullptr && index < SLOT_DELETED, ESP_FAIL);
+
+    // keep the load factor including deleted markers below 3/4 so that probe sequences stay short
+    if ((mCount + mDeleted + 1) * 4 > mCapacity * 3) {
+        size_t capacity = (mCapacity == 0) ? MIN_CAPACITY : mCapacity;
+        while ((mCount + 1) * 2 > capacity) {
+            capacity *= 2;
+        }
+        esp_err_t err = resize(capacity);
+        if (err != ESP_OK) {
+            return err;
+        }
+    }
+
+    const size_t mask = mCapacity - 1;
+    size_t pos = hash & mask;
+    while (mSlots[pos].mPage != nullptr) {
+        pos = (pos + 1) & mask;
+    }
+    if (mSlots[pos].mIndex == SLOT_DELETED) {
+        --mDeleted;
+    }
+    mSlots[pos].mPage = page;
+    mSlots[pos].mIndex = (uint32_t) index;
+    mSlots[pos].mHash = hash;
+    ++mCount;
+    return ESP_OK;
+}
+
+bool KeyIndex::erase(uint32_t hash, const Page* page, size_t index)
+{
+    if (mCount == 0) {
+        return false;
+    }
+
+    const size_t mask = mCapacity - 1;
+    for (size_t pos = hash & mask, probes = 0; probes < mCapacity; pos = (pos + 1) & mask, ++probes) {
+        Slot& slot = mSlots[pos];
+        if (slot.mPage == nullptr) {
+            if (slot.mIndex == SLOT_EMPTY) {
+                break;
+            }
+            continue;
+        }
+        if (slot.mPage == page && slot.mIndex == index && slot.mHash == hash) {
+            // the slot can't become empty as it may be part of another probe sequence
+            slot.mPage = nullptr;
+            slot.mIndex = SLOT_DELETED;
+            --mCount;
+            ++mDeleted;
+            return true;
+        }
+    }
+
+    // item hasn't been present in the index
+    return false;
+}
+
+bool KeyIndex::find(uint32_t hash, size_t& cursor, Page*& page, size_t& index) const
+{
+    if (mCount == 0) {
+        return false;
+    }
+
+    const size_t mask = mCapacity - 1;
+    for (; cursor < mCapacity; ++cursor) {
+        const Slot& slot = mSlots[(hash + cursor) & mask];
+        if (slot.mPage == nullptr) {
+            if (slot.mIndex == SLOT_EMPTY) {
+                cursor = mCapacity;
+                break;
+            }
+            continue;
+        }
+        if (slot.mHash == hash) {
+            page = slot.mPage;
+            index = slot.mIndex;
+            ++cursor;
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace nvs
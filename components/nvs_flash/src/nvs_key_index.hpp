@@ -0,0 +1,89 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include "nvs.h"
+#include "nvs_types.hpp"
+#include "nvs_memory_management.hpp"
+
+namespace nvs
+{
+
+class Page;
+
+/**
+ * Partition-wide index of the items held by the HashLists of all pages.
+ *
+ * Maps the 24-bit hash of (namespace index, key, chunk index) to the page and the entry index on that page,
+ * so that Storage can locate an item without asking every page of the partition.
+ * The index is an open addressing table with linear probing which grows on demand.
+ * Several slots may carry the same hash, e.g. for hash collisions or duplicate items during recovery.
+ */
+class KeyIndex
+{
+public:
+    KeyIndex();
+    ~KeyIndex();
+
+    static uint32_t hashOf(const Item& item)
+    {
+        return item.calculateCrc32WithoutValue() & 0xffffff;
+    }
+
+    esp_err_t insert(uint32_t hash, Page* page, size_t index);
+
+    bool erase(uint32_t hash, const Page* page, size_t index);
+
+    /**
+     * Returns the next slot carrying the hash, starting at the probe position given by cursor.
+     * The cursor has to be initialized to 0 before the first call, it is advanced past the returned slot.
+     * Erasing slots in between the calls is allowed, inserting is not.
+     *
+     * @return true if a slot was found, page and index are set. false if there are no more slots with the hash.
+     */
+    bool find(uint32_t hash, size_t& cursor, Page*& page, size_t& index) const;
+
+    void clear();
+
+    size_t size() const
+    {
+        return mCount;
+    }
+
+    size_t capacity() const
+    {
+        return mCapacity;
+    }
+
+private:
+    KeyIndex(const KeyIndex& other);
+    const KeyIndex& operator= (const KeyIndex& rhs);
+
+    esp_err_t resize(size_t capacity);
+
+protected:
+    static const size_t MIN_CAPACITY = 32;
+    static const uint8_t SLOT_EMPTY = 0xff;
+    static const uint8_t SLOT_DELETED = 0xfe;
+
+    struct Slot : public ExceptionlessAllocatable {
+        Slot() :
+            mPage(nullptr), mIndex(SLOT_EMPTY), mHash(0)
+        {
+        }
+
+        Page* mPage;
+        uint32_t mIndex : 8;
+        uint32_t mHash  : 24;
+    };
+
+    Slot* mSlots = nullptr;
+    size_t mCapacity = 0;
+    size_t mCount = 0;
+    size_t mDeleted = 0;
+}; // class KeyIndex
+
+} // namespace nvs
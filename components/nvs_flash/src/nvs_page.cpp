@@ -13,6 +13,10 @@
 
 namespace nvs {
 
+// Key of the marker entry which starts the run of entries written by a transaction, see Page::beginTransaction.
+// The marker is stored with namespace index NS_ANY, which is never assigned to a namespace.
+static const char TRANSACTION_MARKER_KEY[] = "nvs.txn";
+
 Page::Page() : mPartition(nullptr) { }
 
 uint32_t Page::Header::calculateCrc32()
@@ -32,6 +36,12 @@ esp_err_t Page::load(Partition *partition, uint32_t sectorNumber)
     mBaseAddress = sectorNumber * SEC_SIZE;
     mUsedEntryCount = 0;
     mErasedEntryCount = 0;
+    mTransactionBegin = INVALID_ENTRY;
+    mTransactionEnd = INVALID_ENTRY;
+    mTransactionCommitted = false;
+    releaseTransactionBuffer();
+    mDeferEntryTableWrites = false;
+    mDirtyEntryTableWords = 0;
 
     Header header;
     auto rc = mPartition->read_raw(mBaseAddress, &header, sizeof(header));
@@ -248,6 +258,333 @@ esp_err_t Page::writeItem(uint8_t nsIndex, ItemType datatype, const char* key, c
     return ESP_OK;
 }
 
+esp_err_t Page::writeUncommittedEntries(size_t index, const void* data, size_t size)
+{
+    NVS_ASSERT_OR_RETURN(size % ENTRY_SIZE == 0, ESP_FAIL);
+
+    esp_err_t rc;
+    const size_t bufferSize = TRANSACTION_BUFFER_ENTRY_COUNT * ENTRY_SIZE;
+
+    // entries are appended to the buffer as long as they follow the buffered ones
+    if (mTransactionBuffer != nullptr) {
+        if (mBufferedSize > 0 && (index != mBufferedEntry + mBufferedSize / ENTRY_SIZE || mBufferedSize + size > bufferSize)) {
+            rc = flushTransactionBuffer();
+            if (rc != ESP_OK) {
+                return rc;
+            }
+        }
+        if (mBufferedSize + size <= bufferSize) {
+            if (mBufferedSize == 0) {
+                mBufferedEntry = index;
+            }
+            memcpy(mTransactionBuffer + mBufferedSize, data, size);
+            mBufferedSize += size;
+            return ESP_OK;
+        }
+    }
+
+    uint32_t phyAddr;
+    rc = getEntryAddress(index, &phyAddr);
+    if (rc == ESP_OK) {
+        rc = mPartition->write(phyAddr, data, size);
+    }
+    if (rc != ESP_OK) {
+        mState = PageState::INVALID;
+    }
+    return rc;
+}
+
+esp_err_t Page::flushTransactionBuffer()
+{
+    if (mTransactionBuffer == nullptr || mBufferedSize == 0) {
+        return ESP_OK;
+    }
+
+    uint32_t phyAddr;
+    esp_err_t rc = getEntryAddress(mBufferedEntry, &phyAddr);
+    if (rc == ESP_OK) {
+        rc = mPartition->write(phyAddr, mTransactionBuffer, mBufferedSize);
+    }
+    mBufferedSize = 0;
+    mBufferedEntry = INVALID_ENTRY;
+    if (rc != ESP_OK) {
+        mState = PageState::INVALID;
+    }
+    return rc;
+}
+
+void Page::releaseTransactionBuffer()
+{
+    delete [] mTransactionBuffer;
+    mTransactionBuffer = nullptr;
+    mBufferedSize = 0;
+    mBufferedEntry = INVALID_ENTRY;
+}
+
+bool Page::isTransactionMarker(const Item& item)
+{
+    return item.nsIndex == NS_ANY
+           && item.datatype == ItemType::U32
+           && strncmp(item.key, TRANSACTION_MARKER_KEY, Item::MAX_KEY_LENGTH) == 0;
+}
+
+size_t Page::getTransactionEnd(const Item& marker, size_t index)
+{
+    uint32_t count;
+    memcpy(&count, marker.data, sizeof(count));
+    if (count == 0) {
+        count = 1;
+    }
+    return (count > ENTRY_COUNT - index) ? ENTRY_COUNT : index + count;
+}
+
+esp_err_t Page::beginTransaction(size_t entryCount)
+{
+    esp_err_t err;
+
+    if (mState == PageState::INVALID) {
+        return ESP_ERR_NVS_INVALID_STATE;
+    }
+
+    if (mState == PageState::UNINITIALIZED) {
+        err = initialize();
+        if (err != ESP_OK) {
+            return err;
+        }
+    }
+
+    if (mState == PageState::FULL) {
+        return ESP_ERR_NVS_PAGE_FULL;
+    }
+
+    // previous transaction wasn't finished
+    if (mTransactionBegin != INVALID_ENTRY) {
+        return ESP_ERR_NVS_INVALID_STATE;
+    }
+
+    // entryCount covers the items, one more entry is needed for the marker
+    if (mNextFreeEntry == INVALID_ENTRY || mNextFreeEntry + entryCount + 1 > ENTRY_COUNT) {
+        return ESP_ERR_NVS_PAGE_FULL;
+    }
+
+    Item marker(NS_ANY, ItemType::U32, 1, TRANSACTION_MARKER_KEY);
+    const uint32_t runLength = entryCount + 1;
+    memcpy(marker.data, &runLength, sizeof(runLength));
+    marker.crc32 = marker.calculateCrc32();
+
+    // without the buffer, every entry is written on its own
+    if (runLength > 1) {
+        mTransactionBuffer = new (std::nothrow) uint8_t[TRANSACTION_BUFFER_ENTRY_COUNT * ENTRY_SIZE];
+    }
+
+    err = writeUncommittedEntries(mNextFreeEntry, &marker, sizeof(marker));
+    if (err != ESP_OK) {
+        releaseTransactionBuffer();
+        return err;
+    }
+
+    mTransactionBegin = mNextFreeEntry;
+    mTransactionEnd = mNextFreeEntry + runLength;
+    mTransactionCommitted = false;
+    ++mNextFreeEntry;
+    return ESP_OK;
+}
+
+esp_err_t Page::writeTransactionItem(uint8_t nsIndex, ItemType datatype, const char* key, const void* data, size_t dataSize, uint8_t chunkIdx)
+{
+    esp_err_t err;
+
+    if (mState == PageState::INVALID) {
+        return ESP_ERR_NVS_INVALID_STATE;
+    }
+
+    if (mTransactionBegin == INVALID_ENTRY || mTransactionCommitted) {
+        return ESP_ERR_NVS_INVALID_STATE;
+    }
+
+    const size_t keySize = strlen(key);
+    if (keySize > Item::MAX_KEY_LENGTH) {
+        return ESP_ERR_NVS_KEY_TOO_LONG;
+    }
+
+    if (dataSize > Page::CHUNK_MAX_SIZE) {
+        return ESP_ERR_NVS_VALUE_TOO_LONG;
+    }
+
+    if ((!isVariableLengthType(datatype)) && dataSize > 8) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    size_t entriesCount = 1;
+    if (isVariableLengthType(datatype)) {
+        entriesCount += (dataSize + ENTRY_SIZE - 1) / ENTRY_SIZE;
+    }
+
+    // entries of all items were reserved by beginTransaction
+    if (mNextFreeEntry + entriesCount > mTransactionEnd) {
+        return ESP_ERR_NVS_PAGE_FULL;
+    }
+
+    Item item(nsIndex, datatype, entriesCount, key, chunkIdx);
+    if (!isVariableLengthType(datatype)) {
+        memcpy(item.data, data, dataSize);
+    } else {
+        item.varLength.dataCrc32 = Item::calculateCrc32(static_cast<const uint8_t*>(data), dataSize);
+        item.varLength.dataSize = dataSize;
+        item.varLength.reserved = 0xffff;
+    }
+    item.crc32 = item.calculateCrc32();
+
+    err = mHashList.insert(item, mNextFreeEntry);
+    if (err != ESP_OK) {
+        return err;
+    }
+
+    err = writeUncommittedEntries(mNextFreeEntry, &item, sizeof(item));
+    if (err != ESP_OK) {
+        return err;
+    }
+
+    if (isVariableLengthType(datatype)) {
+        size_t rest = dataSize % ENTRY_SIZE;
+        size_t left = dataSize - rest;
+        if (left > 0) {
+            err = writeUncommittedEntries(mNextFreeEntry + 1, data, left);
+            if (err != ESP_OK) {
+                return err;
+            }
+        }
+        if (rest > 0) {
+            std::fill_n(item.rawData, ENTRY_SIZE, 0xff);
+            memcpy(item.rawData, static_cast<const uint8_t*>(data) + left, rest);
+            err = writeUncommittedEntries(mNextFreeEntry + entriesCount - 1, item.rawData, ENTRY_SIZE);
+            if (err != ESP_OK) {
+                return err;
+            }
+        }
+    }
+
+    mNextFreeEntry += entriesCount;
+    return ESP_OK;
+}
+
+esp_err_t Page::commitTransaction()
+{
+    if (mState == PageState::INVALID) {
+        return ESP_ERR_NVS_INVALID_STATE;
+    }
+
+    if (mTransactionBegin == INVALID_ENTRY || mTransactionCommitted) {
+        return ESP_ERR_NVS_INVALID_STATE;
+    }
+
+    NVS_ASSERT_OR_RETURN(mNextFreeEntry == mTransactionEnd, ESP_FAIL);
+
+    esp_err_t err = flushTransactionBuffer();
+    releaseTransactionBuffer();
+    if (err != ESP_OK) {
+        return err;
+    }
+
+    // single pass over the entry table, the word holding the marker state is written last
+    err = alterEntryRangeState(mTransactionBegin, mTransactionEnd, EntryState::WRITTEN);
+    if (err != ESP_OK) {
+        mState = PageState::INVALID;
+        return err;
+    }
+
+    if (mFirstUsedEntry == INVALID_ENTRY) {
+        mFirstUsedEntry = mTransactionBegin;
+    }
+    mUsedEntryCount += mTransactionEnd - mTransactionBegin;
+    mTransactionCommitted = true;
+    return ESP_OK;
+}
+
+esp_err_t Page::abortTransaction()
+{
+    if (mTransactionBegin == INVALID_ENTRY) {
+        return ESP_OK;
+    }
+
+    NVS_ASSERT_OR_RETURN(!mTransactionCommitted, ESP_FAIL);
+
+    const size_t begin = mTransactionBegin;
+    const size_t end = mTransactionEnd;
+    mTransactionBegin = INVALID_ENTRY;
+    mTransactionEnd = INVALID_ENTRY;
+    releaseTransactionBuffer();
+
+    if (mState == PageState::INVALID) {
+        // the entries are rolled back when the page is loaded again
+        return ESP_ERR_NVS_INVALID_STATE;
+    }
+    return rollbackTransaction(begin, end);
+}
+
+esp_err_t Page::finishTransaction()
+{
+    if (mTransactionBegin == INVALID_ENTRY) {
+        return ESP_OK;
+    }
+
+    NVS_ASSERT_OR_RETURN(mTransactionCommitted, ESP_FAIL);
+
+    esp_err_t err = eraseEntryAndSpan(mTransactionBegin, DEFAULT_PURGE_AFTER_ERASE);
+    if (err != ESP_OK) {
+        return err;
+    }
+
+    mTransactionBegin = INVALID_ENTRY;
+    mTransactionEnd = INVALID_ENTRY;
+    mTransactionCommitted = false;
+    return ESP_OK;
+}
+
+esp_err_t Page::rollbackTransaction(size_t begin, size_t end)
+{
+    EntryState state;
+    esp_err_t err;
+
+    for (size_t i = begin; i < end; ++i) {
+        err = mEntryTable.get(i, &state);
+        if (err != ESP_OK) {
+            return err;
+        }
+        if (state == EntryState::WRITTEN) {
+            --mUsedEntryCount;
+        }
+        if (state != EntryState::ERASED) {
+            ++mErasedEntryCount;
+        }
+        mHashList.erase(i);
+    }
+
+    err = alterEntryRangeState(begin, end, EntryState::ERASED);
+    if (err != ESP_OK) {
+        mState = PageState::INVALID;
+        return err;
+    }
+
+    if (DEFAULT_PURGE_AFTER_ERASE) {
+        err = purgeEntryRange(begin, end);
+        if (err != ESP_OK) {
+            return err;
+        }
+    }
+
+    if (mNextFreeEntry == INVALID_ENTRY || mNextFreeEntry < end) {
+        mNextFreeEntry = end;
+    }
+
+    if (mFirstUsedEntry != INVALID_ENTRY && mFirstUsedEntry >= begin && mFirstUsedEntry < end) {
+        // no written entry precedes the range, look for the first one behind it
+        mFirstUsedEntry = begin;
+        return updateFirstUsedEntry(begin, end - begin);
+    }
+    return ESP_OK;
+}
+
 // Reads the data entries of the variable length item.
 // The metadata entry is already read in the item object.
 // index is the index of the metadata entry on the page.
@@ -285,6 +622,76 @@ esp_err_t Page::readVariableLengthItemData(const Item& item, const size_t index,
     return ESP_OK;
 }
 
+// Passes the data of the variable length item to the stream callback.
+// Data of the mapped storage is checked before it is passed on in one piece,
+// data read into the buffer is checked after the last piece. Data which doesn't match
+// the CRC in the mapping is read into the buffer, only a mismatch there erases the item.
+esp_err_t Page::readVariableLengthItemData(const Item& item, const size_t index, ItemDataStream& stream)
+{
+    if (mState == PageState::INVALID) {
+        return ESP_ERR_NVS_INVALID_STATE;
+    }
+
+    esp_err_t rc;
+    const size_t size = item.varLength.dataSize;
+    uint32_t crc32 = 0xffffffff;
+    uint32_t phyAddr = 0;
+    if (size > 0) {
+        NVS_ASSERT_OR_RETURN((size + ENTRY_SIZE - 1) / ENTRY_SIZE < item.span, ESP_FAIL);
+        rc = getEntryAddress(index + 1, &phyAddr);
+        if (rc != ESP_OK) {
+            return rc;
+        }
+    }
+
+    if (stream.mapped != nullptr) {
+        const uint8_t* src = stream.mapped + phyAddr;
+        crc32 = Item::calculateCrc32(src, size, &crc32);
+        if (crc32 == item.varLength.dataCrc32) {
+            if (size > 0) {
+                rc = stream.callback(src, size, stream.offset, stream.totalSize, stream.arg);
+                if (rc != ESP_OK) {
+                    return rc;
+                }
+                stream.offset += size;
+            }
+            return ESP_OK;
+        }
+        // The mapping alone is no proof of corrupted data, so the item is read and checked again below
+        crc32 = 0xffffffff;
+    }
+
+    uint8_t entryBuffer[ENTRY_SIZE];
+    uint8_t* buffer = (stream.buffer != nullptr) ? stream.buffer : entryBuffer;
+    const size_t bufferSize = (stream.buffer != nullptr) ? stream.bufferSize : sizeof(entryBuffer);
+    size_t left = size;
+    while (left > 0) {
+        const size_t toRead = std::min(bufferSize, (left + ENTRY_SIZE - 1) & ~(ENTRY_SIZE - 1));
+        const size_t piece = std::min(left, toRead);
+        rc = mPartition->read(phyAddr, buffer, toRead);
+        if (rc != ESP_OK) {
+            return rc;
+        }
+        crc32 = Item::calculateCrc32(buffer, piece, &crc32);
+        rc = stream.callback(buffer, piece, stream.offset, stream.totalSize, stream.arg);
+        if (rc != ESP_OK) {
+            return rc;
+        }
+        stream.offset += piece;
+        phyAddr += toRead;
+        left -= piece;
+    }
+
+    if (crc32 != item.varLength.dataCrc32) {
+        rc = eraseEntryAndSpan(index, DEFAULT_PURGE_AFTER_ERASE);
+        if (rc != ESP_OK) {
+            return rc;
+        }
+        return ESP_ERR_NVS_NOT_FOUND;
+    }
+    return ESP_OK;
+}
+
 esp_err_t Page::readItem(uint8_t nsIndex, ItemType datatype, const char* key, void* data, size_t dataSize, uint8_t chunkIdx, VerOffset chunkStart)
 {
     size_t index = 0;
@@ -606,6 +1013,12 @@ esp_err_t Page::copyItems(Page &other)
             return err;
         }
 
+        // transaction marker refers to entry positions on this page
+        if (isTransactionMarker(entry)) {
+            readEntryIndex++;
+            continue;
+        }
+
         err = other.mHashList.insert(entry, other.mNextFreeEntry);
         if (err != ESP_OK) {
             return err;
@@ -700,6 +1113,22 @@ esp_err_t Page::mLoadEntryTable()
                 return rc;
             }
             if (header != 0xffffffff) {
+                // transaction which wasn't committed is rolled back as a whole, the marker tells its extent
+                Item marker;
+                rc = readEntry(mNextFreeEntry, marker);
+                if (rc != ESP_OK) {
+                    mState = PageState::INVALID;
+                    return rc;
+                }
+                if (marker.checkHeaderConsistency(mNextFreeEntry) && isTransactionMarker(marker)) {
+                    err = rollbackTransaction(mNextFreeEntry, getTransactionEnd(marker, mNextFreeEntry));
+                    if (err != ESP_OK) {
+                        mState = PageState::INVALID;
+                        return err;
+                    }
+                    continue;
+                }
+
                 auto oldState = state;
                 rc = mEntryTable.get(mNextFreeEntry, &oldState);
                 if (rc != ESP_OK) {
@@ -773,6 +1202,15 @@ esp_err_t Page::mLoadEntryTable()
                 continue;
             }
 
+            // transaction was committed, but previous values of its items may not have been erased yet
+            if (isTransactionMarker(item)) {
+                mTransactionBegin = i;
+                mTransactionEnd = getTransactionEnd(item, i);
+                mTransactionCommitted = true;
+                lastItemIndex = INVALID_ENTRY;
+                continue;
+            }
+
             err = mHashList.insert(item, i);
             if (err != ESP_OK) {
                 mState = PageState::INVALID;
@@ -855,6 +1293,13 @@ esp_err_t Page::mLoadEntryTable()
 
             NVS_ASSERT_OR_RETURN(item.span > 0, ESP_FAIL);
 
+            if (isTransactionMarker(item)) {
+                mTransactionBegin = i;
+                mTransactionEnd = getTransactionEnd(item, i);
+                mTransactionCommitted = true;
+                continue;
+            }
+
             err = mHashList.insert(item, i);
             if (err != ESP_OK) {
                 mState = PageState::INVALID;
@@ -912,10 +1357,7 @@ esp_err_t Page::alterEntryState(size_t index, EntryState state)
     if (err != ESP_OK) {
         return err;
     }
-    size_t wordToWrite = mEntryTable.getWordIndex(index);
-    uint32_t word = mEntryTable.data()[wordToWrite];
-    err = mPartition->write_raw(mBaseAddress + ENTRY_TABLE_OFFSET + static_cast<uint32_t>(wordToWrite) * 4,
-                                &word, sizeof(word));
+    err = writeEntryTableWord(mEntryTable.getWordIndex(index));
     if (err != ESP_OK) {
         mState = PageState::INVALID;
         return err;
@@ -941,9 +1383,7 @@ esp_err_t Page::alterEntryRangeState(size_t begin, size_t end, EntryState state)
             nextWordIndex = mEntryTable.getWordIndex(i - 1);
         }
         if (nextWordIndex != wordIndex) {
-            uint32_t word = mEntryTable.data()[wordIndex];
-            auto rc = mPartition->write_raw(mBaseAddress + ENTRY_TABLE_OFFSET + static_cast<uint32_t>(wordIndex) * 4,
-                                            &word, 4);
+            auto rc = writeEntryTableWord(wordIndex);
             if (rc != ESP_OK) {
                 return rc;
             }
@@ -953,6 +1393,41 @@ esp_err_t Page::alterEntryRangeState(size_t begin, size_t end, EntryState state)
     return ESP_OK;
 }
 
+esp_err_t Page::writeEntryTableWord(size_t wordIndex)
+{
+    if (mDeferEntryTableWrites) {
+        mDirtyEntryTableWords |= static_cast<uint8_t>(1 << wordIndex);
+        return ESP_OK;
+    }
+    uint32_t word = mEntryTable.data()[wordIndex];
+    return mPartition->write_raw(mBaseAddress + ENTRY_TABLE_OFFSET + static_cast<uint32_t>(wordIndex) * 4,
+                                 &word, sizeof(word));
+}
+
+void Page::deferEntryTableWrites()
+{
+    mDeferEntryTableWrites = true;
+}
+
+esp_err_t Page::flushEntryTableWrites()
+{
+    mDeferEntryTableWrites = false;
+    for (ptrdiff_t i = ENTRY_TABLE_WORD_COUNT - 1; i >= 0 && mDirtyEntryTableWords != 0; --i) {
+        const uint8_t bit = static_cast<uint8_t>(1 << i);
+        if ((mDirtyEntryTableWords & bit) == 0) {
+            continue;
+        }
+        mDirtyEntryTableWords &= ~bit;
+        auto rc = writeEntryTableWord(i);
+        if (rc != ESP_OK) {
+            mDirtyEntryTableWords = 0;
+            mState = PageState::INVALID;
+            return rc;
+        }
+    }
+    return ESP_OK;
+}
+
 esp_err_t Page::alterPageState(PageState state)
 {
     uint32_t state_val = static_cast<uint32_t>(state);
@@ -1179,6 +1654,12 @@ esp_err_t Page::erase()
     mErasedEntryCount = 0;
     mFirstUsedEntry = INVALID_ENTRY;
     mNextFreeEntry = INVALID_ENTRY;
+    mTransactionBegin = INVALID_ENTRY;
+    mTransactionEnd = INVALID_ENTRY;
+    mTransactionCommitted = false;
+    releaseTransactionBuffer();
+    mDeferEntryTableWrites = false;
+    mDirtyEntryTableWords = 0;
     mState = PageState::UNINITIALIZED;
     mHashList.clear();
     return ESP_OK;
@@ -1211,6 +1692,16 @@ size_t Page::getVarDataTailroom() const
     return ((mNextFreeEntry < (ENTRY_COUNT - 1)) ? ((ENTRY_COUNT - mNextFreeEntry - 1) * ENTRY_SIZE) : 0);
 }
 
+size_t Page::getFreeEntryCount() const
+{
+    if (mState == PageState::UNINITIALIZED) {
+        return ENTRY_COUNT;
+    } else if (mState != PageState::ACTIVE || mNextFreeEntry >= ENTRY_COUNT) {
+        return 0;
+    }
+    return ENTRY_COUNT - mNextFreeEntry;
+}
+
 const char* Page::pageStateToName(PageState ps)
 {
     switch (ps) {
@@ -5,15 +5,29 @@
  */
 #pragma once
 
+#include "sdkconfig.h"                  // For CONFIG_NVS_ITEM_HASH_TABLE
 #include "nvs.h"
 #include "nvs_types.hpp"
 #include "intrusive_list.h"
 #include "nvs_item_hash_list.hpp"
+#include "nvs_item_hash_table.hpp"
 #include "partition.hpp"
 
 namespace nvs
 {
 
+/**
+ * Destination of the data of variable length items which is passed to a callback piece by piece.
+ */
+struct ItemDataStream {
+    const uint8_t* mapped = nullptr;    // storage mapped to memory, nullptr if the data is read into buffer
+    uint8_t* buffer = nullptr;          // used if the storage isn't mapped, bufferSize is a multiple of the entry size
+    size_t bufferSize = 0;
+    nvs_read_cb_t callback = nullptr;
+    void* arg = nullptr;
+    size_t offset = 0;                  // offset of the next piece within the value
+    size_t totalSize = 0;               // size of the whole value, as passed to the callback
+};
 
 class Page : public intrusive_list_node<Page>, public ExceptionlessAllocatable
 {
@@ -74,6 +88,11 @@ public:
 
     esp_err_t load(Partition *partition, uint32_t sectorNumber);
 
+    esp_err_t setKeyIndex(KeyIndex* keyIndex)
+    {
+        return mHashList.setKeyIndex(keyIndex, this);
+    }
+
     esp_err_t getSeqNumber(uint32_t& seqNumber) const;
 
     esp_err_t setSeqNumber(uint32_t seqNumber);
@@ -84,6 +103,8 @@ public:
 
     esp_err_t readVariableLengthItemData(const Item& item, const size_t index, void* data);
 
+    esp_err_t readVariableLengthItemData(const Item& item, const size_t index, ItemDataStream& stream);
+
     esp_err_t readItem(uint8_t nsIndex, ItemType datatype, const char* key, void* data, size_t dataSize, uint8_t chunkIdx = CHUNK_ANY, VerOffset chunkStart = VerOffset::VER_ANY);
 
     esp_err_t cmpItem(uint8_t nsIndex, ItemType datatype, const char* key, const void* data, size_t dataSize, uint8_t chunkIdx = CHUNK_ANY, VerOffset chunkStart = VerOffset::VER_ANY);
@@ -98,6 +119,43 @@ public:
 
     esp_err_t eraseEntryAndSpan(size_t index, const bool purgeAfterErase);
 
+    /**
+     * Transactions write several items as one run of entries which becomes valid with a single entry table update.
+     *
+     * The run starts with a marker entry holding the number of entries of the run. The marker and all items are
+     * written without touching the entry table, then commitTransaction sets the state of the whole run to WRITTEN.
+     * Entry states are written backwards, the word holding the marker state is written last and commits the run.
+     * While loading the page, a run whose marker isn't WRITTEN is erased as a whole. A run with a WRITTEN marker
+     * is reported by getPendingTransaction until finishTransaction erases the marker, giving the caller a chance
+     * to erase the previous values of the items.
+     */
+    esp_err_t beginTransaction(size_t entryCount);
+
+    esp_err_t writeTransactionItem(uint8_t nsIndex, ItemType datatype, const char* key, const void* data, size_t dataSize, uint8_t chunkIdx = CHUNK_ANY);
+
+    esp_err_t commitTransaction();
+
+    esp_err_t abortTransaction();
+
+    esp_err_t finishTransaction();
+
+    bool getPendingTransaction(size_t& begin, size_t& end) const
+    {
+        begin = mTransactionBegin;
+        end = mTransactionEnd;
+        return mTransactionBegin != INVALID_ENTRY && mTransactionCommitted;
+    }
+
+    size_t getFreeEntryCount() const;
+
+    /**
+     * While deferred, entry state changes only update the entry table in RAM. flushEntryTableWrites writes each
+     * modified word of the entry table once, from the last word to the first one, and ends the deferral.
+     */
+    void deferEntryTableWrites();
+
+    esp_err_t flushEntryTableWrites();
+
     template<typename T>
     esp_err_t writeItem(uint8_t nsIndex, const char* key, const T& value)
     {
@@ -192,6 +250,20 @@ protected:
 
     esp_err_t writeEntryData(const uint8_t* data, size_t size);
 
+    esp_err_t writeEntryTableWord(size_t wordIndex);
+
+    esp_err_t writeUncommittedEntries(size_t index, const void* data, size_t size);
+
+    esp_err_t flushTransactionBuffer();
+
+    void releaseTransactionBuffer();
+
+    esp_err_t rollbackTransaction(size_t begin, size_t end);
+
+    static bool isTransactionMarker(const Item& item);
+
+    static size_t getTransactionEnd(const Item& marker, size_t index);
+
     esp_err_t updateFirstUsedEntry(size_t index, size_t span);
 
     static constexpr size_t getAlignmentForType(ItemType type)
@@ -220,11 +292,31 @@ protected:
     size_t mFirstUsedEntry = INVALID_ENTRY;
     uint16_t mUsedEntryCount = 0;
     uint16_t mErasedEntryCount = 0;
+    size_t mTransactionBegin = INVALID_ENTRY;
+    size_t mTransactionEnd = INVALID_ENTRY;
+    bool mTransactionCommitted = false;
+
+    // Entries of an uncommitted transaction are collected here and written to flash in a few larger writes
+    static const size_t TRANSACTION_BUFFER_ENTRY_COUNT = 8;
+    uint8_t* mTransactionBuffer = nullptr;
+    size_t mBufferedEntry = INVALID_ENTRY;
+    size_t mBufferedSize = 0;
+
+    static const size_t ENTRY_TABLE_WORD_COUNT = TEntryTable::byteSize() / sizeof(uint32_t);
+    static_assert(ENTRY_TABLE_WORD_COUNT <= 8, "modified entry table words must fit into the mask");
+    bool mDeferEntryTableWrites = false;
+    uint8_t mDirtyEntryTableWords = 0;
+
+#ifdef CONFIG_NVS_ITEM_HASH_TABLE
+    typedef HashTable TItemHashList;
+#else
+    typedef HashList TItemHashList;
+#endif
 
     /**
      * This hash list stores hashes of namespace index, key, and ChunkIndex for quick lookup when searching items.
      */
-    HashList mHashList;
+    TItemHashList mHashList;
 
     Partition *mPartition;
 
@@ -3,13 +3,56 @@
  *
  * SPDX-License-Identifier: Apache-2.0
  */
+#include <algorithm>
+#include <atomic>
 #include "nvs_pagemanager.hpp"
+#include "nvs_platform.hpp"
 
 using namespace std;
 
 namespace nvs
 {
-esp_err_t PageManager::load(Partition *partition, uint32_t baseSector, uint32_t sectorCount)
+
+struct PageManager::PageScan {
+    PageScan(Page* pages, Partition* partition, uint32_t baseSector, uint32_t sectorCount) :
+        mPages(pages), mPartition(partition), mBaseSector(baseSector), mSectorCount(sectorCount)
+    {
+    }
+
+    Page* mPages;
+    Partition* mPartition;
+    uint32_t mBaseSector;
+    uint32_t mSectorCount;
+    std::atomic<uint32_t> mNextPage{0};
+    std::atomic<size_t> mNextTask{0};
+    std::atomic<bool> mFailed{false};
+    // first failure seen by each task, pages are claimed in ascending order so this is also the lowest one
+    uint32_t mFailedPage[MAX_SCAN_TASKS];
+    esp_err_t mError[MAX_SCAN_TASKS];
+};
+
+void PageManager::scanPages(void* arg)
+{
+    PageScan* scan = static_cast<PageScan*>(arg);
+    const size_t task = scan->mNextTask.fetch_add(1);
+    scan->mFailedPage[task] = UINT32_MAX;
+    scan->mError[task] = ESP_OK;
+
+    while (!scan->mFailed.load(std::memory_order_relaxed)) {
+        const uint32_t i = scan->mNextPage.fetch_add(1);
+        if (i >= scan->mSectorCount) {
+            break;
+        }
+        auto err = scan->mPages[i].load(scan->mPartition, scan->mBaseSector + i);
+        if (err != ESP_OK) {
+            scan->mFailedPage[task] = i;
+            scan->mError[task] = err;
+            scan->mFailed.store(true, std::memory_order_relaxed);
+        }
+    }
+}
+
+esp_err_t PageManager::load(Partition *partition, uint32_t baseSector, uint32_t sectorCount, size_t scanTasks)
 {
     if (partition == nullptr) {
         return ESP_ERR_INVALID_ARG;
@@ -20,30 +63,70 @@ esp_err_t PageManager::load(Partition *partition, uint32_t baseSector, uint32_t
     mPageList.clear();
     mFreePageList.clear();
     mPages.reset(new (nothrow) Page[sectorCount]);
+    mKeyIndex.clear();
 
     if (!mPages) return ESP_ERR_NO_MEM;
 
+    // scan stage: pages only touch their own state while they are loaded, so they are scanned concurrently
+    if (scanTasks < 1) {
+        scanTasks = 1;
+    } else if (scanTasks > MAX_SCAN_TASKS) {
+        scanTasks = MAX_SCAN_TASKS;
+    }
+    if (scanTasks > sectorCount) {
+        scanTasks = sectorCount;
+    }
+    PageScan scan(mPages.get(), partition, baseSector, sectorCount);
+    if (scanTasks > 1) {
+        runConcurrently(scanPages, &scan, scanTasks);
+    } else {
+        scanPages(&scan);
+    }
+
+    // merge stage: report the failure of the lowest page, like a sequential scan would
+    uint32_t failedPage = UINT32_MAX;
+    esp_err_t failure = ESP_OK;
+    for (size_t task = 0; task < scan.mNextTask.load(); ++task) {
+        if (scan.mFailedPage[task] < failedPage) {
+            failedPage = scan.mFailedPage[task];
+            failure = scan.mError[task];
+        }
+    }
+    if (failure != ESP_OK) {
+        return failure;
+    }
+
+    std::unique_ptr<Page*[]> usedPages(new (nothrow) Page*[sectorCount]);
+    if (!usedPages) return ESP_ERR_NO_MEM;
+    size_t usedCount = 0;
+
     for (uint32_t i = 0; i < sectorCount; ++i) {
-        auto err = mPages[i].load(partition, baseSector + i);
+#ifdef CONFIG_NVS_KEY_INDEX
+        auto err = mPages[i].setKeyIndex(&mKeyIndex);
         if (err != ESP_OK) {
             return err;
         }
+#endif
         uint32_t seqNumber;
         if (mPages[i].getSeqNumber(seqNumber) != ESP_OK) {
             mFreePageList.push_back(&mPages[i]);
         } else {
-            auto pos = std::find_if(std::begin(mPageList), std::end(mPageList), [=](const Page& page) -> bool {
-                uint32_t otherSeqNumber;
-                return page.getSeqNumber(otherSeqNumber) == ESP_OK && otherSeqNumber > seqNumber;
-            });
-            if (pos == mPageList.end()) {
-                mPageList.push_back(&mPages[i]);
-            } else {
-                mPageList.insert(pos, &mPages[i]);
-            }
+            usedPages[usedCount++] = &mPages[i];
         }
     }
 
+    // pages with equal sequence numbers keep the order of their sectors
+    std::stable_sort(usedPages.get(), usedPages.get() + usedCount, [](const Page* a, const Page* b) -> bool {
+        uint32_t seqA;
+        uint32_t seqB;
+        a->getSeqNumber(seqA);
+        b->getSeqNumber(seqB);
+        return seqA < seqB;
+    });
+    for (size_t i = 0; i < usedCount; ++i) {
+        mPageList.push_back(usedPages[i]);
+    }
+
     if (mPageList.empty()) {
         mSeqNumber = 0;
         return activatePage();
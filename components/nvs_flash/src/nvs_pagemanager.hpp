@@ -7,8 +7,10 @@
 
 #include <memory>
 #include <list>
+#include "sdkconfig.h"                  // For CONFIG_NVS_KEY_INDEX and CONFIG_NVS_PAGE_SCAN_TASKS
 #include "nvs_types.hpp"
 #include "nvs_page.hpp"
+#include "nvs_key_index.hpp"
 #include "partition.hpp"
 #include "intrusive_list.h"
 
@@ -20,9 +22,21 @@ class PageManager
     using TPageListIterator = TPageList::iterator;
 public:
 
+#ifdef CONFIG_NVS_PAGE_SCAN_TASKS
+    static const size_t DEFAULT_SCAN_TASKS = CONFIG_NVS_PAGE_SCAN_TASKS;
+#else
+    static const size_t DEFAULT_SCAN_TASKS = 1;
+#endif
+    static const size_t MAX_SCAN_TASKS = 8;
+
     PageManager() {}
 
-    esp_err_t load(Partition *partition, uint32_t baseSector, uint32_t sectorCount);
+    /**
+     * Loads all pages of the partition in two stages. Each page is scanned on its own by one of scanTasks
+     * concurrent tasks, then a short sequential merge attaches the pages to the key index and orders them
+     * by sequence number. Recovery after a power loss happens after the merge.
+     */
+    esp_err_t load(Partition *partition, uint32_t baseSector, uint32_t sectorCount, size_t scanTasks = DEFAULT_SCAN_TASKS);
 
     TPageListIterator begin()
     {
@@ -52,13 +66,24 @@ public:
         return mBaseSector;
     }
 
+    const KeyIndex& getKeyIndex() const
+    {
+        return mKeyIndex;
+    }
+
 protected:
     friend class Iterator;
 
+    struct PageScan;
+
+    static void scanPages(void* arg);
+
     esp_err_t activatePage();
 
     TPageList mPageList;
     TPageList mFreePageList;
+    // declared before mPages, the pages detach from the index when they are destroyed
+    KeyIndex mKeyIndex;
     std::unique_ptr<Page[]> mPages;
     uint32_t mBaseSector;
     uint32_t mPageCount;
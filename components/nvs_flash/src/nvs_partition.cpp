@@ -11,6 +11,9 @@
 #ifdef CONFIG_NVS_BDL_STACK
     #include "esp_partition.h"  // For esp_blockdev_handle_t
 #endif // CONFIG_NVS_BDL_STACK
+#if !(LINUX_TARGET || ESP_TEE_BUILD)
+    #include "esp_flash_encrypt.h"  // For esp_flash_encryption_enabled
+#endif
 
 #define TAG "NVSPartition"
 
@@ -111,6 +114,31 @@ uint32_t NVSPartition::get_address()
     return mESPPartition->address;
 }
 
+esp_err_t NVSPartition::mmap_data(const void** ptr, uint32_t* handle)
+{
+#if ESP_TEE_BUILD
+    // Flash encryption state isn't known here, the data is read without mapping
+    return ESP_ERR_NOT_SUPPORTED;
+#elif !LINUX_TARGET
+    // Reads through the cache are always decrypted if flash encryption is enabled,
+    // a partition which is not encrypted would be mapped as garbage
+    if (esp_flash_encryption_enabled() && !mESPPartition->encrypted) {
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+#endif
+    esp_partition_mmap_handle_t mmap_handle;
+    esp_err_t err = esp_partition_mmap(mESPPartition, 0, mESPPartition->size, ESP_PARTITION_MMAP_DATA, ptr, &mmap_handle);
+    if (err == ESP_OK) {
+        *handle = mmap_handle;
+    }
+    return err;
+}
+
+void NVSPartition::munmap_data(uint32_t handle)
+{
+    esp_partition_munmap(handle);
+}
+
 uint32_t NVSPartition::get_size()
 {
     return mESPPartition->size;
@@ -164,6 +164,30 @@ public:
      */
     uint32_t get_address() override;
 
+#ifndef CONFIG_NVS_BDL_STACK
+    /**
+     * Maps the whole partition into the data address space using esp_partition_mmap.
+     * Not available if the block device layer is enabled, or if flash encryption is enabled
+     * and the partition is not encrypted.
+     *
+     * @param ptr set to the beginning of the mapped partition
+     * @param handle set to the handle to be passed to munmap_data
+     *
+     * @return
+     *      - ESP_OK on success
+     *      - ESP_ERR_NOT_SUPPORTED if the mapped data would be decrypted
+     *      - other error codes from the esp_partition API
+     */
+    esp_err_t mmap_data(const void** ptr, uint32_t* handle) override;
+
+    /**
+     * Releases the mapping created by mmap_data.
+     *
+     * @param handle the handle returned by mmap_data
+     */
+    void munmap_data(uint32_t handle) override;
+#endif // CONFIG_NVS_BDL_STACK
+
     /**
      * Returns total size of the storage in bytes.
      *
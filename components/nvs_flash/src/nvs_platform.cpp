@@ -1,5 +1,5 @@
 /*
- * SPDX-FileCopyrightText: 2024 Espressif Systems (Shanghai) CO LTD
+ * SPDX-FileCopyrightText: 2024-2025 Espressif Systems (Shanghai) CO LTD
  *
  * SPDX-License-Identifier: Apache-2.0
  */
@@ -48,3 +48,95 @@ void Lock::uninit()
 _lock_t Lock::mSemaphore = 0;
 
 #endif
+
+#if ESP_TEE_BUILD
+void nvs::runConcurrently(void (*job)(void*), void* arg, size_t taskCount)
+{
+    job(arg);
+}
+#elif LINUX_TARGET
+
+#include <pthread.h>
+
+namespace {
+struct ConcurrentJob {
+    void (*job)(void*);
+    void* arg;
+};
+
+void* concurrentJobThread(void* param)
+{
+    ConcurrentJob* ctx = static_cast<ConcurrentJob*>(param);
+    ctx->job(ctx->arg);
+    return nullptr;
+}
+} // namespace
+
+void nvs::runConcurrently(void (*job)(void*), void* arg, size_t taskCount)
+{
+    const size_t MAX_THREADS = 16;
+    ConcurrentJob ctx = {job, arg};
+    pthread_t threads[MAX_THREADS];
+    size_t started = 0;
+    for (size_t i = 1; i < taskCount && started < MAX_THREADS; ++i) {
+        if (pthread_create(&threads[started], nullptr, concurrentJobThread, &ctx) == 0) {
+            ++started;
+        }
+    }
+    job(arg);
+    for (size_t i = 0; i < started; ++i) {
+        pthread_join(threads[i], nullptr);
+    }
+}
+#else
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "sdkconfig.h"
+
+#ifndef CONFIG_NVS_PAGE_SCAN_TASK_STACK_SIZE
+#define CONFIG_NVS_PAGE_SCAN_TASK_STACK_SIZE 3072
+#endif
+
+namespace {
+struct ConcurrentJob {
+    void (*job)(void*);
+    void* arg;
+    SemaphoreHandle_t done;
+};
+
+void concurrentJobTask(void* param)
+{
+    ConcurrentJob* ctx = static_cast<ConcurrentJob*>(param);
+    ctx->job(ctx->arg);
+    xSemaphoreGive(ctx->done);
+    vTaskDelete(NULL);
+}
+} // namespace
+
+void nvs::runConcurrently(void (*job)(void*), void* arg, size_t taskCount)
+{
+    ConcurrentJob ctx = {job, arg, NULL};
+    size_t started = 0;
+    if (taskCount > 1) {
+        ctx.done = xSemaphoreCreateCounting(taskCount - 1, 0);
+    }
+    if (ctx.done) {
+        for (size_t i = 1; i < taskCount; ++i) {
+            // no core affinity, the scheduler spreads the tasks over the available cores
+            if (xTaskCreate(concurrentJobTask, "nvs_worker", CONFIG_NVS_PAGE_SCAN_TASK_STACK_SIZE, &ctx,
+                            uxTaskPriorityGet(NULL), NULL) == pdPASS) {
+                ++started;
+            }
+        }
+    }
+    job(arg);
+    for (size_t i = 0; i < started; ++i) {
+        xSemaphoreTake(ctx.done, portMAX_DELAY);
+    }
+    if (ctx.done) {
+        vSemaphoreDelete(ctx.done);
+    }
+}
+#endif
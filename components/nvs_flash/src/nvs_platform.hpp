@@ -5,6 +5,7 @@
  */
 #pragma once
 
+#include <cstddef>
 #include "esp_err.h"
 #ifndef LINUX_TARGET
 #include <sys/lock.h>
@@ -24,4 +25,11 @@ namespace nvs
         static _lock_t mSemaphore;
 #endif
     };
+
+    /**
+     * Calls job(arg) on taskCount tasks at the same time, the calling task being one of them, and returns when all
+     * calls have finished. If fewer tasks can be created, the job runs on fewer tasks, so it has to share its work
+     * dynamically between the calls.
+     */
+    void runConcurrently(void (*job)(void*), void* arg, size_t taskCount);
 } // namespace nvs
@@ -243,6 +243,17 @@ esp_err_t Storage::init(uint32_t baseSector, uint32_t sectorCount)
 
     mState = StorageState::ACTIVE;
 
+    // A transaction may have been committed, but power went out before the previous values of its items were erased
+    if(!mPartition->get_readonly()) {
+        for(auto it = mPageManager.begin(); it != mPageManager.end(); ++it) {
+            err = finishTransaction(*it, Page::DEFAULT_PURGE_AFTER_ERASE);
+            if(err != ESP_OK) {
+                mState = StorageState::INVALID;
+                return err;
+            }
+        }
+    }
+
 #ifdef DEBUG_STORAGE
     debugCheck();
 #endif
@@ -256,6 +267,14 @@ bool Storage::isValid() const
 
 esp_err_t Storage::findItem(uint8_t nsIndex, ItemType datatype, const char* key, Page* &page, Item& item, uint8_t chunkIdx, VerOffset chunkStart, size_t* itemIndex)
 {
+#ifdef CONFIG_NVS_KEY_INDEX
+    // The key index mirrors the hash lists of all pages. It can be used under the same conditions as
+    // the hash list in Page::findItem, for all other searches every page has to be visited.
+    if(nsIndex != Page::NS_ANY && key != nullptr && (datatype != ItemType::BLOB_DATA || chunkIdx != Page::CHUNK_ANY)) {
+        return findIndexedItem(nsIndex, datatype, key, page, item, chunkIdx, chunkStart, itemIndex);
+    }
+#endif
+
     for(auto it = std::begin(mPageManager); it != std::end(mPageManager); ++it) {
         size_t tmpItemIndex = 0;
         auto err = it->findItem(nsIndex, datatype, key, tmpItemIndex, item, chunkIdx, chunkStart);
@@ -270,6 +289,56 @@ esp_err_t Storage::findItem(uint8_t nsIndex, ItemType datatype, const char* key,
     return ESP_ERR_NVS_NOT_FOUND;
 }
 
+#ifdef CONFIG_NVS_KEY_INDEX
+esp_err_t Storage::findIndexedItem(uint8_t nsIndex, ItemType datatype, const char* key, Page* &page, Item& item, uint8_t chunkIdx, VerOffset chunkStart, size_t* itemIndex)
+{
+    const KeyIndex& keyIndex = mPageManager.getKeyIndex();
+    const uint32_t hash = KeyIndex::hashOf(Item(nsIndex, datatype, 0, key, chunkIdx));
+
+    // Pages are kept in the order of their sequence numbers, the page with the lowest sequence number
+    // holding the item is the one the linear search over all pages would have returned.
+    Page* foundPage = nullptr;
+    uint32_t foundSeqNumber = UINT32_MAX;
+    size_t foundItemIndex = 0;
+    Page* lastVisitedPage = nullptr;
+
+    size_t cursor = 0;
+    Page* candidate;
+    size_t candidateIndex;
+    while(keyIndex.find(hash, cursor, candidate, candidateIndex)) {
+        // several slots with the same hash on one page are typically adjacent
+        if(candidate == lastVisitedPage) {
+            continue;
+        }
+        lastVisitedPage = candidate;
+
+        uint32_t seqNumber;
+        if(candidate->getSeqNumber(seqNumber) != ESP_OK || seqNumber >= foundSeqNumber) {
+            continue;
+        }
+
+        size_t tmpItemIndex = 0;
+        Item tmpItem;
+        if(candidate->findItem(nsIndex, datatype, key, tmpItemIndex, tmpItem, chunkIdx, chunkStart) == ESP_OK) {
+            foundPage = candidate;
+            foundSeqNumber = seqNumber;
+            foundItemIndex = tmpItemIndex;
+            item = tmpItem;
+        }
+    }
+
+    if(foundPage == nullptr) {
+        return ESP_ERR_NVS_NOT_FOUND;
+    }
+
+    page = foundPage;
+    if(itemIndex) {
+        *itemIndex = foundItemIndex;
+    }
+    return ESP_OK;
+}
+#endif // CONFIG_NVS_KEY_INDEX
+
 esp_err_t Storage::writeMultiPageBlob(uint8_t nsIndex, const char* key, const void* data, size_t dataSize, VerOffset chunkStart, const bool purgeAfterErase)
 {
     uint8_t chunkCount = 0;
@@ -595,6 +664,202 @@ esp_err_t Storage::writeItem(uint8_t nsIndex, ItemType datatype, const char* key
     return err;
 }
 
+esp_err_t Storage::writeTransaction(Transaction& transaction, const bool purgeAfterErase)
+{
+    if(mState != StorageState::ACTIVE) {
+        return ESP_ERR_NVS_NOT_INITIALIZED;
+    }
+
+    esp_err_t err;
+
+    // Skip the items which don't change the stored value and choose the version of new blob chunks.
+    // Blobs are written as a single chunk followed by the blob index.
+    size_t entryCount = 0;
+    for(auto it = transaction.begin(); it != transaction.end(); ++it) {
+        Page* findPage = nullptr;
+        Item item;
+
+        it->unchanged = false;
+        it->chunkStart = VerOffset::VER_0_OFFSET;
+        if(it->datatype == ItemType::BLOB) {
+            err = findItem(it->nsIndex, ItemType::BLOB_IDX, it->key, findPage, item);
+            if(err == ESP_OK) {
+                if(cmpMultiPageBlob(it->nsIndex, it->key, it->getData(), it->dataSize) == ESP_OK) {
+                    it->unchanged = true;
+                } else if(item.blobIndex.chunkStart == VerOffset::VER_0_OFFSET) {
+                    it->chunkStart = VerOffset::VER_1_OFFSET;
+                }
+            }
+        } else {
+            err = findItem(it->nsIndex, it->datatype, it->key, findPage, item);
+            if(err == ESP_OK && findPage->cmpItem(it->nsIndex, it->datatype, it->key, it->getData(), it->dataSize) == ESP_OK) {
+                it->unchanged = true;
+            }
+        }
+        if(err != ESP_OK && err != ESP_ERR_NVS_NOT_FOUND) {
+            return err;
+        }
+        if(!it->unchanged) {
+            entryCount += it->getEntryCount();
+        }
+    }
+
+    if(entryCount == 0) {
+        return ESP_OK;
+    }
+
+    // the items and the transaction marker have to fit into one page
+    if(entryCount + 1 > Page::ENTRY_COUNT) {
+        return ESP_ERR_NVS_NOT_ENOUGH_SPACE;
+    }
+
+    // Get a page with enough room first, reclaiming space relocates items and must not happen in the middle of the transaction
+    for(size_t attempt = 0; getCurrentPage().getFreeEntryCount() < entryCount + 1; ++attempt) {
+        if(attempt == mPageManager.getPageCount()) {
+            return ESP_ERR_NVS_NOT_ENOUGH_SPACE;
+        }
+        Page& page = getCurrentPage();
+        if(page.state() != Page::PageState::FULL) {
+            err = page.markFull();
+            if(err != ESP_OK) {
+                return err;
+            }
+        }
+        err = mPageManager.requestNewPage();
+        if(err != ESP_OK) {
+            return err;
+        }
+    }
+
+    Page& page = getCurrentPage();
+    err = page.beginTransaction(entryCount);
+    if(err != ESP_OK) {
+        return err;
+    }
+
+    for(auto it = transaction.begin(); it != transaction.end(); ++it) {
+        if(it->unchanged) {
+            continue;
+        }
+        if(it->datatype == ItemType::BLOB) {
+            err = page.writeTransactionItem(it->nsIndex, ItemType::BLOB_DATA, it->key, it->getData(), it->dataSize, static_cast<uint8_t> (it->chunkStart));
+            if(err == ESP_OK) {
+                Item item;
+                std::fill_n(item.data, sizeof(item.data), 0xff);
+                item.blobIndex.dataSize = it->dataSize;
+                item.blobIndex.chunkCount = 1;
+                item.blobIndex.chunkStart = it->chunkStart;
+                err = page.writeTransactionItem(it->nsIndex, ItemType::BLOB_IDX, it->key, item.data, sizeof(item.data));
+            }
+        } else {
+            err = page.writeTransactionItem(it->nsIndex, it->datatype, it->key, it->getData(), it->dataSize);
+        }
+        if(err != ESP_OK) {
+            page.abortTransaction();
+            return err;
+        }
+    }
+
+    err = page.commitTransaction();
+    if(err != ESP_OK) {
+        page.abortTransaction();
+        return err;
+    }
+
+    // All new values are valid now, the previous ones can be erased
+    err = finishTransaction(page, purgeAfterErase);
+    if(err == ESP_ERR_FLASH_OP_FAIL) {
+        return ESP_ERR_NVS_REMOVE_FAILED;
+    }
+    if(err != ESP_OK) {
+        return err;
+    }
+
+#ifdef DEBUG_STORAGE
+    debugCheck();
+#endif
+    return ESP_OK;
+}
+
+esp_err_t Storage::finishTransaction(Page& page, const bool purgeAfterErase)
+{
+    size_t runBegin;
+    size_t runEnd;
+    if(!page.getPendingTransaction(runBegin, runEnd)) {
+        return ESP_OK;
+    }
+
+    // Erase the previous value of every item in the run, blob data chunks are erased along with their blob index.
+    // Previous values are often next to each other, so entry states are collected and each modified word
+    // of the entry tables is written once.
+    for(auto it = mPageManager.begin(); it != mPageManager.end(); ++it) {
+        it->deferEntryTableWrites();
+    }
+
+    esp_err_t err = ESP_OK;
+    Item item;
+    size_t itemIndex = runBegin + 1;
+    while(itemIndex < runEnd
+            && page.findItem(Page::NS_ANY, ItemType::ANY, nullptr, itemIndex, item) == ESP_OK
+            && itemIndex < runEnd) {
+        if(item.datatype != ItemType::BLOB_DATA) {
+            char key[Item::MAX_KEY_LENGTH + 1];
+            item.getKey(key, sizeof(key));
+            err = eraseStaleItem(item.nsIndex, item.datatype, key, page, runBegin, runEnd, purgeAfterErase);
+            if(err != ESP_OK) {
+                break;
+            }
+        }
+        itemIndex += item.span;
+    }
+
+    for(auto it = mPageManager.begin(); it != mPageManager.end(); ++it) {
+        auto flushErr = it->flushEntryTableWrites();
+        if(err == ESP_OK) {
+            err = flushErr;
+        }
+    }
+    if(err != ESP_OK) {
+        return err;
+    }
+
+    // the marker is erased only when the previous values are gone from flash
+    return page.finishTransaction();
+}
+
+esp_err_t Storage::eraseStaleItem(uint8_t nsIndex, ItemType datatype, const char* key, const Page& page, size_t runBegin, size_t runEnd, const bool purgeAfterErase)
+{
+    Page* findPage = nullptr;
+    size_t itemIndex = 0;
+    Item item;
+
+    // Lookups return the oldest matching item. If it belongs to the run, there is no previous value.
+    auto isStale = [&](esp_err_t err) -> bool {
+        return err == ESP_OK && !(findPage == &page && itemIndex >= runBegin && itemIndex < runEnd);
+    };
+
+    bool found = isStale(findItem(nsIndex, datatype, key, findPage, item, Page::CHUNK_ANY, VerOffset::VER_ANY, &itemIndex));
+#ifdef CONFIG_NVS_LEGACY_DUP_KEYS_COMPATIBILITY
+    if(!found && datatype == ItemType::BLOB_IDX) {
+        // the previous blob may have been stored in the old format
+        found = isStale(findItem(nsIndex, ItemType::BLOB, key, findPage, item, Page::CHUNK_ANY, VerOffset::VER_ANY, &itemIndex));
+    }
+#else
+    if(!found) {
+        found = isStale(findItem(nsIndex, ItemType::ANY, key, findPage, item, Page::CHUNK_ANY, VerOffset::VER_ANY, &itemIndex));
+    }
+#endif
+
+    if(!found) {
+        return ESP_OK;
+    }
+
+    if(item.datatype == ItemType::BLOB_IDX) {
+        return eraseMultiPageBlob(nsIndex, key, purgeAfterErase, item.blobIndex.chunkStart);
+    }
+    return findPage->eraseEntryAndSpan(itemIndex, purgeAfterErase);
+}
+
 esp_err_t Storage::createOrOpenNamespace(const char* nsName, bool canCreate, uint8_t& nsIndex)
 {
     if(mState != StorageState::ACTIVE) {
@@ -704,6 +969,107 @@ esp_err_t Storage::readMultiPageBlob(uint8_t nsIndex, const char* key, void* dat
     return err;
 }
 
+esp_err_t Storage::readMultiPageBlobStream(uint8_t nsIndex, const char* key, const Item& blobIndex, ItemDataStream& stream)
+{
+    Item item;
+    Page* findPage = nullptr;
+    size_t itemIndex = 0;
+    esp_err_t err = ESP_OK;
+
+    uint8_t chunkCount = blobIndex.blobIndex.chunkCount;
+    VerOffset chunkStart = blobIndex.blobIndex.chunkStart;
+    stream.totalSize = blobIndex.blobIndex.dataSize;
+
+    for(uint8_t chunkNum = 0; chunkNum < chunkCount; chunkNum++) {
+        err = findItem(nsIndex, ItemType::BLOB_DATA, key, findPage, item, static_cast<uint8_t> (chunkStart) + chunkNum, nvs::VerOffset::VER_ANY, &itemIndex);
+        if(err != ESP_OK) {
+            break;
+        }
+
+        if(item.varLength.dataSize > stream.totalSize - stream.offset) {
+            err = ESP_ERR_NVS_INVALID_LENGTH;
+            break;
+        }
+
+        err = findPage->readVariableLengthItemData(item, itemIndex, stream);
+        if(err != ESP_OK) {
+            return err;
+        }
+    }
+
+    if(err == ESP_OK && stream.offset != stream.totalSize) {
+        err = ESP_ERR_NVS_INVALID_LENGTH;
+    }
+    if(err == ESP_ERR_NVS_NOT_FOUND || err == ESP_ERR_NVS_INVALID_LENGTH) {
+        // cleanup if a chunk is not found or the size is inconsistent
+        eraseMultiPageBlob(nsIndex, key, Page::DEFAULT_PURGE_AFTER_ERASE);
+        return ESP_ERR_NVS_NOT_FOUND;
+    }
+    return err;
+}
+
+esp_err_t Storage::readItemStream(uint8_t nsIndex, ItemType datatype, const char* key, nvs_read_cb_t callback, void* arg)
+{
+    if(mState != StorageState::ACTIVE) {
+        return ESP_ERR_NVS_NOT_INITIALIZED;
+    }
+
+    if(callback == nullptr || (datatype != ItemType::SZ && datatype != ItemType::BLOB)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    Item item;
+    Page* findPage = nullptr;
+    size_t itemIndex = 0;
+    bool multiPageBlob = false;
+
+    // locate the item first, so that nothing is mapped or allocated for missing keys
+    esp_err_t err = ESP_ERR_NVS_NOT_FOUND;
+    if(datatype == ItemType::BLOB) {
+        err = findItem(nsIndex, ItemType::BLOB_IDX, key, findPage, item);
+        if(err != ESP_OK && err != ESP_ERR_NVS_NOT_FOUND) {
+            return err;
+        }
+        multiPageBlob = (err == ESP_OK);
+    }
+    if(!multiPageBlob) {
+        // strings, and blobs stored in the format without blob index
+        err = findItem(nsIndex, datatype, key, findPage, item, Page::CHUNK_ANY, VerOffset::VER_ANY, &itemIndex);
+        if(err != ESP_OK) {
+            return err;
+        }
+    }
+
+    ItemDataStream stream;
+    stream.callback = callback;
+    stream.arg = arg;
+
+    uint32_t mmapHandle = 0;
+    const void* mapped = nullptr;
+    if(mPartition->mmap_data(&mapped, &mmapHandle) == ESP_OK) {
+        stream.mapped = static_cast<const uint8_t*>(mapped);
+    } else {
+        stream.buffer = new (std::nothrow) uint8_t[STREAM_BUFFER_SIZE];
+        if(!stream.buffer) {
+            return ESP_ERR_NO_MEM;
+        }
+        stream.bufferSize = STREAM_BUFFER_SIZE;
+    }
+
+    if(multiPageBlob) {
+        err = readMultiPageBlobStream(nsIndex, key, item, stream);
+    } else {
+        stream.totalSize = item.varLength.dataSize;
+        err = findPage->readVariableLengthItemData(item, itemIndex, stream);
+    }
+
+    if(stream.mapped) {
+        mPartition->munmap_data(mmapHandle);
+    }
+    delete [] stream.buffer;
+    return err;
+}
+
 esp_err_t Storage::cmpMultiPageBlob(uint8_t nsIndex, const char* key, const void* data, size_t dataSize)
 {
     Item item;
@@ -1099,6 +1465,7 @@ bool Storage::findEntryNs(nvs_opaque_iterator_t* it, uint8_t nsIndex)
 inline bool isIterableItem(Item& item)
 {
     return (item.nsIndex != 0 &&
+            item.nsIndex != Page::NS_ANY &&
             item.datatype != ItemType::BLOB &&
             item.datatype != ItemType::BLOB_IDX);
 }
@@ -12,6 +12,7 @@
 #include "nvs_types.hpp"
 #include "nvs_page.hpp"
 #include "nvs_pagemanager.hpp"
+#include "nvs_transaction.hpp"
 #include "nvs_memory_management.hpp"
 #include "partition.hpp"
 
@@ -55,6 +56,8 @@ class Storage : public intrusive_list_node<Storage>, public ExceptionlessAllocat
     typedef intrusive_list<BlobIndexNode> TBlobIndexList;
 
 public:
+    static const size_t STREAM_BUFFER_SIZE = 8 * Page::ENTRY_SIZE;
+
     ~Storage();
 
     Storage(Partition *partition) : mPartition(partition) {
@@ -71,8 +74,21 @@ public:
 
     esp_err_t writeItem(uint8_t nsIndex, ItemType datatype, const char* key, const void* data, size_t dataSize, const bool purgeAfterErase);
 
+    /**
+     * Writes all items staged in the transaction atomically: after a power loss either all of them or none of them
+     * are present. Items which equal the stored values are skipped, the others are written to a single page and
+     * the previous values are erased afterwards.
+     */
+    esp_err_t writeTransaction(Transaction& transaction, const bool purgeAfterErase);
+
     esp_err_t readItem(uint8_t nsIndex, ItemType datatype, const char* key, void* data, size_t dataSize);
 
+    /**
+     * Passes the value of a string or blob to the callback piece by piece. The pieces point into the memory
+     * mapped partition if it can be mapped, otherwise the data is read through a buffer of STREAM_BUFFER_SIZE bytes.
+     */
+    esp_err_t readItemStream(uint8_t nsIndex, ItemType datatype, const char* key, nvs_read_cb_t callback, void* arg);
+
     esp_err_t findKey(const uint8_t nsIndex, const char* key, ItemType* datatype);
 
     esp_err_t getItemDataSize(uint8_t nsIndex, ItemType datatype, const char* key, size_t& dataSize);
@@ -119,6 +135,8 @@ public:
 
     esp_err_t readMultiPageBlob(uint8_t nsIndex, const char* key, void* data, size_t dataSize);
 
+    esp_err_t readMultiPageBlobStream(uint8_t nsIndex, const char* key, const Item& blobIndex, ItemDataStream& stream);
+
     esp_err_t cmpMultiPageBlob(uint8_t nsIndex, const char* key, const void* data, size_t dataSize);
 
     esp_err_t eraseMultiPageBlob(uint8_t nsIndex, const char* key, const bool purgeAfterErase, VerOffset chunkStart = VerOffset::VER_ANY);
@@ -156,6 +174,14 @@ protected:
 
     esp_err_t findItem(uint8_t nsIndex, ItemType datatype, const char* key, Page* &page, Item& item, uint8_t chunkIdx = Page::CHUNK_ANY, VerOffset chunkStart = VerOffset::VER_ANY, size_t* itemIndex = NULL);
 
+    esp_err_t finishTransaction(Page& page, const bool purgeAfterErase);
+
+    esp_err_t eraseStaleItem(uint8_t nsIndex, ItemType datatype, const char* key, const Page& page, size_t runBegin, size_t runEnd, const bool purgeAfterErase);
+
+#ifdef CONFIG_NVS_KEY_INDEX
+    esp_err_t findIndexedItem(uint8_t nsIndex, ItemType datatype, const char* key, Page* &page, Item& item, uint8_t chunkIdx, VerOffset chunkStart, size_t* itemIndex);
+#endif
+
 protected:
     Partition *mPartition;
     size_t mPageCount;
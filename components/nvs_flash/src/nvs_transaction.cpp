@@ -0,0 +1,92 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <cstring>
+#include "nvs_transaction.hpp"
+#include "nvs_page.hpp"
+
+namespace nvs
+{
+
+size_t Transaction::TransactionItem::getEntryCount() const
+{
+    if (!isVariableLengthType(datatype)) {
+        return 1;
+    }
+    size_t count = 1 + (dataSize + Page::ENTRY_SIZE - 1) / Page::ENTRY_SIZE;
+    if (datatype == ItemType::BLOB) {
+        // blob index
+        ++count;
+    }
+    return count;
+}
+
+Transaction::~Transaction()
+{
+    clear();
+}
+
+void Transaction::clear()
+{
+    mItems.clearAndFreeNodes();
+}
+
+esp_err_t Transaction::add(uint8_t nsIndex, ItemType datatype, const char* key, const void* data, size_t dataSize)
+{
+    if (datatype == ItemType::ANY || datatype == ItemType::BLOB_IDX || datatype == ItemType::BLOB_DATA) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    if (strlen(key) > Item::MAX_KEY_LENGTH) {
+        return ESP_ERR_NVS_KEY_TOO_LONG;
+    }
+
+    if (!isVariableLengthType(datatype) && dataSize > sizeof(TransactionItem::mValue)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    TransactionItem* item = new (std::nothrow) TransactionItem;
+    if (!item) {
+        return ESP_ERR_NO_MEM;
+    }
+
+    item->nsIndex = nsIndex;
+    item->datatype = datatype;
+    strncpy(item->key, key, sizeof(item->key) - 1);
+    item->key[sizeof(item->key) - 1] = 0;
+    item->dataSize = dataSize;
+
+    // all items of a transaction and its marker entry are written to the same page
+    if (item->getEntryCount() + 1 > Page::ENTRY_COUNT) {
+        delete item;
+        return ESP_ERR_NVS_VALUE_TOO_LONG;
+    }
+
+    if (isVariableLengthType(datatype)) {
+        if (dataSize > 0) {
+            item->mVarData = new (std::nothrow) uint8_t[dataSize];
+            if (!item->mVarData) {
+                delete item;
+                return ESP_ERR_NO_MEM;
+            }
+            memcpy(item->mVarData, data, dataSize);
+        }
+    } else {
+        memcpy(item->mValue, data, dataSize);
+    }
+
+    auto it = std::find_if(mItems.begin(), mItems.end(), [=](const TransactionItem& e) -> bool {
+        return e.nsIndex == nsIndex && strncmp(e.key, item->key, sizeof(e.key) - 1) == 0;
+    });
+    if (it != mItems.end()) {
+        TransactionItem* replaced = static_cast<TransactionItem*>(it);
+        mItems.erase(it);
+        delete replaced;
+    }
+    mItems.push_back(item);
+    return ESP_OK;
+}
+
+} // namespace nvs
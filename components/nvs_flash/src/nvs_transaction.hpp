@@ -0,0 +1,89 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include "nvs.h"
+#include "nvs_types.hpp"
+#include "intrusive_list.h"
+#include "nvs_memory_management.hpp"
+
+namespace nvs
+{
+
+/**
+ * Items staged in RAM by a handle between nvs_transaction_begin and nvs_commit.
+ *
+ * The staged items are written by Storage::writeTransaction as one contiguous run of entries on a single page.
+ * A later value for the same namespace and key replaces the staged one.
+ */
+class Transaction : public ExceptionlessAllocatable
+{
+public:
+    struct TransactionItem : public intrusive_list_node<TransactionItem>, public ExceptionlessAllocatable {
+    public:
+        ~TransactionItem()
+        {
+            delete [] mVarData;
+        }
+
+        const void* getData() const
+        {
+            return isVariableLengthType(datatype) ? static_cast<const void*>(mVarData) : static_cast<const void*>(mValue);
+        }
+
+        // Number of entries the item occupies on the page, blobs are written as one data chunk and the blob index
+        size_t getEntryCount() const;
+
+        uint8_t nsIndex;
+        ItemType datatype;
+        char key[Item::MAX_KEY_LENGTH + 1];
+        size_t dataSize;
+
+        // Set by Storage while committing: item equals the stored value, or the version of the new blob chunk
+        bool unchanged = false;
+        VerOffset chunkStart = VerOffset::VER_0_OFFSET;
+
+    protected:
+        friend class Transaction;
+
+        uint8_t mValue[8];
+        uint8_t* mVarData = nullptr;
+    };
+
+    typedef intrusive_list<TransactionItem> TItemList;
+
+    ~Transaction();
+
+    /**
+     * Stages a value. Datatype BLOB is accepted for blobs, BLOB_IDX and BLOB_DATA are not.
+     *
+     * @return ESP_OK, ESP_ERR_NVS_KEY_TOO_LONG, ESP_ERR_NVS_VALUE_TOO_LONG if the value can't be written
+     *         as part of a transaction, ESP_ERR_NO_MEM
+     */
+    esp_err_t add(uint8_t nsIndex, ItemType datatype, const char* key, const void* data, size_t dataSize);
+
+    void clear();
+
+    size_t size() const
+    {
+        return mItems.size();
+    }
+
+    TItemList::iterator begin()
+    {
+        return mItems.begin();
+    }
+
+    TItemList::iterator end()
+    {
+        return mItems.end();
+    }
+
+protected:
+    TItemList mItems;
+}; // class Transaction
+
+} // namespace nvs
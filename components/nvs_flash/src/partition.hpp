@@ -116,6 +116,31 @@ public:
      */
     virtual uint32_t get_address() = 0;
 
+    /**
+     * Maps the whole storage into the address space for reading without copying.
+     * Offsets within the mapping equal offsets in the storage. The data isn't decrypted,
+     * storages which are encrypted or can't be mapped don't support it.
+     *
+     * @param ptr set to the beginning of the mapped storage
+     * @param handle set to the handle to be passed to munmap_data
+     *
+     * @return
+     *      - ESP_OK on success
+     *      - ESP_ERR_NOT_SUPPORTED if the storage can't be mapped
+     *      - other error codes from the implementation of the storage
+     */
+    virtual esp_err_t mmap_data(const void** ptr, uint32_t* handle)
+    {
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+
+    /**
+     * Releases the mapping created by mmap_data.
+     *
+     * @param handle the handle returned by mmap_data
+     */
+    virtual void munmap_data(uint32_t handle) { }
+
     /**
      * Returns total size of the storage in bytes.
      *
@@ -24,6 +24,7 @@
 #include "esp_rom_spiflash.h"
 
 #include "spiffs_api.h"
+#include "spiffs_snapshot.h"
 
 static const char* TAG = "SPIFFS";
 
@@ -93,7 +94,11 @@ static void esp_spiffs_free(esp_spiffs_t ** efs)
     *efs = NULL;
 
     if (e->fs) {
+#if CONFIG_SPIFFS_MOUNT_SNAPSHOT
+        spiffs_snapshot_unmount(e->fs);
+#else
         SPIFFS_unmount(e->fs);
+#endif
         free(e->fs);
     }
     vSemaphoreDelete(e->lock);
@@ -218,6 +223,10 @@ static esp_err_t esp_spiffs_init(const esp_vfs_spiffs_conf_t* conf)
     efs->cfg.phys_addr         = 0;
     efs->cfg.phys_erase_block  = flash_erase_sector_size;
     efs->cfg.phys_size         = partition->size;
+#if CONFIG_SPIFFS_MOUNT_SNAPSHOT
+    // The last sector holds the mount snapshot
+    efs->cfg.phys_size        -= flash_erase_sector_size;
+#endif
 
     efs->by_label = conf->partition_label != NULL;
 
@@ -265,12 +274,20 @@ static esp_err_t esp_spiffs_init(const esp_vfs_spiffs_conf_t* conf)
     efs->fs->user_data = (void *)efs;
     efs->partition = partition;
 
+#if CONFIG_SPIFFS_MOUNT_SNAPSHOT
+    s32_t res = spiffs_snapshot_mount(efs->fs, &efs->cfg, efs->work, efs->fds, efs->fds_sz,
+                            efs->cache, efs->cache_sz, spiffs_api_check, NULL);
+#else
     s32_t res = SPIFFS_mount(efs->fs, &efs->cfg, efs->work, efs->fds, efs->fds_sz,
                             efs->cache, efs->cache_sz, spiffs_api_check);
+#endif
 
     if (conf->format_if_mount_failed && res != SPIFFS_OK) {
         ESP_LOGW(TAG, "mount failed, %" PRId32 ". formatting...", SPIFFS_errno(efs->fs));
         SPIFFS_clearerr(efs->fs);
+#if CONFIG_SPIFFS_MOUNT_SNAPSHOT
+        spiffs_snapshot_invalidate(efs->fs);
+#endif
         res = SPIFFS_format(efs->fs);
         if (res != SPIFFS_OK) {
             ESP_LOGE(TAG, "format failed, %" PRId32, SPIFFS_errno(efs->fs));
@@ -352,6 +369,10 @@ esp_err_t esp_spiffs_format(const char* partition_label)
     }
 
     SPIFFS_unmount(_efs[index]->fs);
+#if CONFIG_SPIFFS_MOUNT_SNAPSHOT
+    // A snapshot stored before the format must not be used with the new file system
+    spiffs_snapshot_invalidate(_efs[index]->fs);
+#endif
 
     s32_t res = SPIFFS_format(_efs[index]->fs);
     if (res != SPIFFS_OK) {
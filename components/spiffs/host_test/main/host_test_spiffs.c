@@ -6,6 +6,7 @@
 #include <stdio.h>
 #include <string.h>
 #include <stdint.h>
+#include <inttypes.h>
 #include <stdlib.h>
 #include <sys/mman.h>
 #include <sys/stat.h>
@@ -13,6 +14,7 @@
 #include <dirent.h>
 #include <limits.h>
 #include <unistd.h>
+#include <time.h>
 
 #include "Mockqueue.h"
 
@@ -20,6 +22,8 @@
 #include "spiffs.h"
 #include "spiffs_nucleus.h"
 #include "spiffs_api.h"
+#include "spiffs_snapshot.h"
+#include "esp_private/partition_linux.h"
 
 #include "unity.h"
 #include "unity_fixture.h"
@@ -310,10 +314,201 @@ TEST(spiffs, erase_check)
 #endif
 }
 
+#if CONFIG_SPIFFS_MOUNT_SNAPSHOT
+static s32_t mount_spiffs_with_snapshot(spiffs *fs, uint32_t max_files, bool *out_restored)
+{
+    spiffs_config cfg = {};
+    s32_t spiffs_res;
+    u32_t flash_sector_size = 4096;
+
+    const esp_partition_t *partition = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_DATA_SPIFFS, "storage");
+    TEST_ASSERT_NOT_NULL(partition);
+
+    esp_spiffs_t *user_data = (esp_spiffs_t *) calloc(1, sizeof(*user_data));
+    user_data->partition = partition;
+    fs->user_data = (void *)user_data;
+
+    cfg.hal_erase_f = spiffs_api_erase;
+    cfg.hal_read_f = spiffs_api_read;
+    cfg.hal_write_f = spiffs_api_write;
+    cfg.log_block_size = flash_sector_size;
+    cfg.log_page_size = CONFIG_SPIFFS_PAGE_SIZE;
+    cfg.phys_addr = 0;
+    cfg.phys_erase_block = flash_sector_size;
+    // The last sector holds the snapshot
+    cfg.phys_size = partition->size - flash_sector_size;
+
+    uint8_t *work = (uint8_t *) malloc(cfg.log_page_size * 2);
+    uint32_t fds_sz = max_files * sizeof(spiffs_fd);
+    uint8_t *fds = (uint8_t *) malloc(fds_sz);
+#if CONFIG_SPIFFS_CACHE
+    uint32_t cache_sz = sizeof(spiffs_cache) + max_files * (sizeof(spiffs_cache_page)
+                        + cfg.log_page_size);
+    uint8_t *cache = (uint8_t *) malloc(cache_sz);
+#else
+    uint32_t cache_sz = 0;
+    uint8_t *cache = NULL;
+#endif
+
+    spiffs_res = spiffs_snapshot_mount(fs, &cfg, work, fds, fds_sz, cache, cache_sz, spiffs_api_check, out_restored);
+    if (spiffs_res == SPIFFS_ERR_NOT_A_FS) {
+        spiffs_res = SPIFFS_format(fs);
+        TEST_ASSERT_TRUE(spiffs_res >= SPIFFS_OK);
+        spiffs_res = spiffs_snapshot_mount(fs, &cfg, work, fds, fds_sz, cache, cache_sz, spiffs_api_check, out_restored);
+    }
+    return spiffs_res;
+}
+
+static uint64_t get_time_us(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+TEST(spiffs, mount_snapshot)
+{
+    spiffs fs;
+    bool restored;
+    char name[16];
+    uint32_t data[512];
+    u32_t total, used, total_after, used_after;
+
+    // The partition holds the image written by the previous test, which is formatted by the first mount
+    TEST_ASSERT_TRUE(mount_spiffs_with_snapshot(&fs, 5, &restored) >= SPIFFS_OK);
+    TEST_ASSERT_FALSE(restored);
+
+    for (int i = 0; i < 20; i++) {
+        for (int j = 0; j < sizeof(data) / sizeof(data[0]); j++) {
+            data[j] = i * 1000 + j;
+        }
+        snprintf(name, sizeof(name), "snap%d", i);
+        spiffs_file f = SPIFFS_open(&fs, name, SPIFFS_O_CREAT | SPIFFS_O_TRUNC | SPIFFS_O_RDWR, 0);
+        TEST_ASSERT_TRUE(f >= SPIFFS_OK);
+        TEST_ASSERT_EQUAL(sizeof(data), SPIFFS_write(&fs, f, data, sizeof(data)));
+        TEST_ASSERT_EQUAL(SPIFFS_OK, SPIFFS_close(&fs, f));
+    }
+    TEST_ASSERT_EQUAL(SPIFFS_OK, SPIFFS_info(&fs, &total, &used));
+
+    // Clean unmount stores the snapshot, the next mount doesn't scan the file system
+    spiffs_snapshot_unmount(&fs);
+    deinit_spiffs(&fs);
+
+    esp_partition_clear_stats();
+    uint64_t start = get_time_us();
+    TEST_ASSERT_TRUE(mount_spiffs_with_snapshot(&fs, 5, &restored) >= SPIFFS_OK);
+    uint64_t snapshot_time = get_time_us() - start;
+    size_t snapshot_reads = esp_partition_get_read_ops();
+    TEST_ASSERT_TRUE(restored);
+
+    TEST_ASSERT_EQUAL(SPIFFS_OK, SPIFFS_info(&fs, &total_after, &used_after));
+    TEST_ASSERT_EQUAL(total, total_after);
+    TEST_ASSERT_EQUAL(used, used_after);
+
+    // The restored file system is usable
+    spiffs_file f = SPIFFS_open(&fs, "snap7", SPIFFS_O_RDONLY, 0);
+    TEST_ASSERT_TRUE(f >= SPIFFS_OK);
+    TEST_ASSERT_EQUAL(sizeof(data), SPIFFS_read(&fs, f, data, sizeof(data)));
+    TEST_ASSERT_EQUAL(7 * 1000 + 511, data[511]);
+    TEST_ASSERT_EQUAL(SPIFFS_OK, SPIFFS_close(&fs, f));
+    TEST_ASSERT_EQUAL(SPIFFS_OK, SPIFFS_remove(&fs, "snap3"));
+    f = SPIFFS_open(&fs, "snap_new", SPIFFS_O_CREAT | SPIFFS_O_RDWR, 0);
+    TEST_ASSERT_TRUE(f >= SPIFFS_OK);
+    TEST_ASSERT_EQUAL(sizeof(data), SPIFFS_write(&fs, f, data, sizeof(data)));
+    TEST_ASSERT_EQUAL(SPIFFS_OK, SPIFFS_close(&fs, f));
+    TEST_ASSERT_EQUAL(SPIFFS_OK, SPIFFS_info(&fs, &total, &used));
+
+    // Without the snapshot unmount (as after a power loss), the snapshot is not used again and the file system is scanned
+    deinit_spiffs(&fs);
+
+    esp_partition_clear_stats();
+    start = get_time_us();
+    TEST_ASSERT_TRUE(mount_spiffs_with_snapshot(&fs, 5, &restored) >= SPIFFS_OK);
+    uint64_t scan_time = get_time_us() - start;
+    size_t scan_reads = esp_partition_get_read_ops();
+    TEST_ASSERT_FALSE(restored);
+
+    // The scan finds the same state the restored file system ended with
+    TEST_ASSERT_EQUAL(SPIFFS_OK, SPIFFS_info(&fs, &total_after, &used_after));
+    TEST_ASSERT_EQUAL(total, total_after);
+    TEST_ASSERT_EQUAL(used, used_after);
+
+    printf("mount from snapshot: %" PRIu64 " us, %zu reads; mount with scan: %" PRIu64 " us, %zu reads\n",
+           snapshot_time, snapshot_reads, scan_time, scan_reads);
+    TEST_ASSERT_LESS_THAN(scan_reads, snapshot_reads);
+
+    spiffs_snapshot_unmount(&fs);
+    deinit_spiffs(&fs);
+}
+
+TEST(spiffs, mount_snapshot_not_used_after_external_write)
+{
+    spiffs fs;
+    bool restored;
+    u32_t total, used, total_after, used_after;
+    const u32_t flash_sector_size = 4096;
+
+    TEST_ASSERT_TRUE(mount_spiffs_with_snapshot(&fs, 5, &restored) >= SPIFFS_OK);
+    spiffs_file f = SPIFFS_open(&fs, "external", SPIFFS_O_CREAT | SPIFFS_O_TRUNC | SPIFFS_O_RDWR, 0);
+    TEST_ASSERT_TRUE(f >= SPIFFS_OK);
+    TEST_ASSERT_EQUAL(8, SPIFFS_write(&fs, f, "external", 8));
+    TEST_ASSERT_EQUAL(SPIFFS_OK, SPIFFS_close(&fs, f));
+    TEST_ASSERT_EQUAL(SPIFFS_OK, SPIFFS_info(&fs, &total, &used));
+    spiffs_snapshot_unmount(&fs);
+    const esp_partition_t *partition = ((esp_spiffs_t *)fs.user_data)->partition;
+    deinit_spiffs(&fs);
+
+    // Keep the file system as an image to flash later
+    const size_t fs_size = partition->size - flash_sector_size;
+    uint8_t *image = (uint8_t *) malloc(fs_size);
+    TEST_ASSERT_NOT_NULL(image);
+    TEST_ASSERT_EQUAL(ESP_OK, esp_partition_read(partition, 0, image, fs_size));
+
+    // Change the file system, the clean unmount stores a snapshot of the new contents
+    TEST_ASSERT_TRUE(mount_spiffs_with_snapshot(&fs, 5, &restored) >= SPIFFS_OK);
+    TEST_ASSERT_TRUE(restored);
+    TEST_ASSERT_EQUAL(SPIFFS_OK, SPIFFS_remove(&fs, "external"));
+    spiffs_snapshot_unmount(&fs);
+    deinit_spiffs(&fs);
+
+    // Flash the image without erasing the snapshot sector: the snapshot doesn't belong to the image and is not used
+    TEST_ASSERT_EQUAL(ESP_OK, esp_partition_erase_range(partition, 0, fs_size));
+    TEST_ASSERT_EQUAL(ESP_OK, esp_partition_write(partition, 0, image, fs_size));
+    free(image);
+    TEST_ASSERT_TRUE(mount_spiffs_with_snapshot(&fs, 5, &restored) >= SPIFFS_OK);
+    TEST_ASSERT_FALSE(restored);
+    TEST_ASSERT_EQUAL(SPIFFS_OK, SPIFFS_info(&fs, &total_after, &used_after));
+    TEST_ASSERT_EQUAL(total, total_after);
+    TEST_ASSERT_EQUAL(used, used_after);
+    spiffs_stat stat;
+    TEST_ASSERT_EQUAL(SPIFFS_OK, SPIFFS_stat(&fs, "external", &stat));
+    spiffs_snapshot_unmount(&fs);
+    deinit_spiffs(&fs);
+
+    // Erasing the file system leaves no magic, the mount doesn't use the snapshot and fails as usual
+    TEST_ASSERT_EQUAL(ESP_OK, esp_partition_erase_range(partition, 0, fs_size));
+    TEST_ASSERT_TRUE(mount_spiffs_with_snapshot(&fs, 5, &restored) >= SPIFFS_OK);
+    TEST_ASSERT_FALSE(restored);
+    TEST_ASSERT_EQUAL(SPIFFS_ERR_NOT_FOUND, SPIFFS_stat(&fs, "external", &stat));
+    spiffs_snapshot_unmount(&fs);
+    deinit_spiffs(&fs);
+
+    // A snapshot of unchanged contents is still used
+    TEST_ASSERT_TRUE(mount_spiffs_with_snapshot(&fs, 5, &restored) >= SPIFFS_OK);
+    TEST_ASSERT_TRUE(restored);
+    spiffs_snapshot_unmount(&fs);
+    deinit_spiffs(&fs);
+}
+#endif // CONFIG_SPIFFS_MOUNT_SNAPSHOT
+
 TEST_GROUP_RUNNER(spiffs)
 {
     RUN_TEST_CASE(spiffs, format_disk_open_file_write_and_read_file);
     RUN_TEST_CASE(spiffs, can_read_spiffs_image);
+#if CONFIG_SPIFFS_MOUNT_SNAPSHOT
+    RUN_TEST_CASE(spiffs, mount_snapshot);
+    RUN_TEST_CASE(spiffs, mount_snapshot_not_used_after_external_write);
+#endif
     RUN_TEST_CASE(spiffs, erase_check);
 }
 
@@ -30,6 +30,10 @@ function(spiffs_create_partition_image partition base_dir)
             set(follow_symlinks "--follow-symlinks")
         endif()
 
+        if(CONFIG_SPIFFS_MOUNT_SNAPSHOT)
+            set(mount_snapshot "--mount-snapshot")
+        endif()
+
         # Execute SPIFFS image generation; this always executes as there is no way to specify for CMake to watch for
         # contents of the base dir changing.
         add_custom_target(spiffs_${partition}_bin ALL
@@ -40,6 +44,7 @@ function(spiffs_create_partition_image partition base_dir)
             ${follow_symlinks}
             ${use_magic}
             ${use_magic_len}
+            ${mount_snapshot}
             DEPENDS ${arg_DEPENDS}
             )
 
@@ -35,6 +35,9 @@ typedef struct {
     uint32_t fds_sz;                        /*!< File Descriptor Buffer Length */
     uint8_t *cache;                         /*!< Cache Buffer */
     uint32_t cache_sz;                      /*!< Cache Buffer Length */
+#if CONFIG_SPIFFS_MOUNT_SNAPSHOT
+    const void *mount_snapshot;             /*!< Snapshot to restore the state from, set only during spiffs_snapshot_mount */
+#endif
 } esp_spiffs_t;
 
 s32_t spiffs_api_read(spiffs *fs, uint32_t addr, uint32_t size, uint8_t *dst);
@@ -0,0 +1,324 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+#include <assert.h>
+#include "esp_log.h"
+#include "esp_partition.h"
+#include "esp_rom_crc.h"
+#include "spiffs.h"
+#include "spiffs_nucleus.h"
+#include "spiffs_api.h"
+#include "spiffs_snapshot.h"
+
+static const char* TAG = "SPIFFS";
+
+#define SNAPSHOT_MAGIC          0x534E5053  /* "SPNS" */
+#define SNAPSHOT_NOT_CONSUMED   0xFFFFFFFF
+
+/* Snapshot sector is an append-only log of these slots, it's erased only when all the slots are used */
+typedef struct {
+    uint32_t magic;
+    uint32_t generation;                /* incremented by each stored snapshot, the highest valid one is the latest */
+    uint32_t phys_size;
+    uint32_t log_block_size;
+    uint32_t log_page_size;
+    uint32_t free_cursor_block_ix;
+    uint32_t free_cursor_obj_lu_entry;
+    uint32_t cursor_block_ix;
+    uint32_t cursor_obj_lu_entry;
+    uint32_t free_blocks;
+    uint32_t stats_p_allocated;
+    uint32_t stats_p_deleted;
+    uint32_t max_erase_count;
+    uint32_t content_crc;               /* CRC32 of the flash contents the snapshot belongs to, see snapshot_content_crc */
+    uint32_t crc;                       /* CRC32 of the fields above */
+    uint32_t consumed;                  /* cleared when the snapshot is used by a mount, not covered by crc */
+} spiffs_snapshot_t;
+
+static_assert(sizeof(spiffs_snapshot_t) == 64, "spiffs_snapshot_t size must not change");
+
+static const esp_partition_t *snapshot_partition(spiffs *fs)
+{
+    return ((esp_spiffs_t *)(fs->user_data))->partition;
+}
+
+static uint32_t snapshot_crc(const spiffs_snapshot_t *snap)
+{
+    return esp_rom_crc32_le(0, (const uint8_t *)snap, offsetof(spiffs_snapshot_t, crc));
+}
+
+static bool snapshot_is_valid(const spiffs_snapshot_t *snap)
+{
+    return snap->magic == SNAPSHOT_MAGIC && snap->crc == snapshot_crc(snap);
+}
+
+static bool snapshot_is_erased(const spiffs_snapshot_t *snap)
+{
+    const uint8_t *p = (const uint8_t *)snap;
+    for (size_t i = 0; i < sizeof(*snap); i++) {
+        if (p[i] != 0xFF) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/* Returns index of the valid slot with the highest generation, or -1 if there is none */
+static int snapshot_find_latest(const spiffs_snapshot_t *slots, size_t slot_count)
+{
+    int latest = -1;
+    for (size_t i = 0; i < slot_count; i++) {
+        if (snapshot_is_valid(&slots[i]) && (latest < 0 || slots[i].generation > slots[latest].generation)) {
+            latest = i;
+        }
+    }
+    return latest;
+}
+
+/* Read the snapshot sector, the caller frees the returned buffer */
+static spiffs_snapshot_t *snapshot_read_sector(spiffs *fs, const spiffs_config *config)
+{
+    spiffs_snapshot_t *slots = malloc(config->phys_erase_block);
+    if (slots == NULL) {
+        return NULL;
+    }
+    esp_err_t err = esp_partition_read(snapshot_partition(fs), config->phys_addr + config->phys_size,
+                                       slots, config->phys_erase_block);
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "failed to read mount snapshot (0x%x)", err);
+        free(slots);
+        return NULL;
+    }
+    return slots;
+}
+
+static void snapshot_invalidate(spiffs *fs, const spiffs_config *config)
+{
+    esp_err_t err = esp_partition_erase_range(snapshot_partition(fs), config->phys_addr + config->phys_size,
+                                              config->phys_erase_block);
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "failed to erase mount snapshot (0x%x)", err);
+    }
+}
+
+/*
+ * CRC32 of the object lookup pages of block 0 and of the blocks the cursors point to. The lookup pages hold
+ * the erase count and the magic of the block, so flashing another image or formatting the partition without
+ * going through the snapshot (which rewrites at least block 0) changes the CRC. The magic of these blocks is
+ * checked as well, as SPIFFS_mount does for all the blocks. fs->cfg and fs->block_count must be set.
+ */
+static esp_err_t snapshot_content_crc(spiffs *fs, spiffs_block_ix free_cursor_block_ix, spiffs_block_ix cursor_block_ix,
+                                      uint32_t *out_crc)
+{
+    const spiffs_block_ix blocks[] = { 0, free_cursor_block_ix, cursor_block_ix };
+    const u32_t page_size = SPIFFS_CFG_LOG_PAGE_SZ(fs);
+    u8_t *page = malloc(page_size);
+    if (page == NULL) {
+        return ESP_ERR_NO_MEM;
+    }
+    esp_err_t err = ESP_OK;
+    uint32_t crc = 0;
+    for (size_t i = 0; i < sizeof(blocks) / sizeof(blocks[0]) && err == ESP_OK; i++) {
+        if ((i > 0 && blocks[i] == blocks[0]) || (i > 1 && blocks[i] == blocks[1])) {
+            continue;
+        }
+        for (u32_t lu_page = 0; lu_page < SPIFFS_OBJ_LOOKUP_PAGES(fs) && err == ESP_OK; lu_page++) {
+            err = esp_partition_read(snapshot_partition(fs), SPIFFS_BLOCK_TO_PADDR(fs, blocks[i]) + lu_page * page_size,
+                                     page, page_size);
+            crc = esp_rom_crc32_le(crc, page, page_size);
+        }
+#if SPIFFS_USE_MAGIC
+        // The last lookup page is still in the buffer, the magic is stored just before the erase count at its end
+        spiffs_obj_id magic;
+        memcpy(&magic, page + page_size - sizeof(spiffs_obj_id) * 2, sizeof(magic));
+        if (err == ESP_OK && magic != (spiffs_obj_id)SPIFFS_MAGIC(fs, blocks[i])) {
+            err = ESP_ERR_INVALID_STATE;
+        }
+#endif
+    }
+    free(page);
+    *out_crc = crc;
+    return err;
+}
+
+/*
+ * SPIFFS_mount gets the free block count, the page statistics and the cursors from spiffs_obj_lu_scan. The component
+ * is linked with --wrap=spiffs_obj_lu_scan (see CMakeLists.txt), so that while spiffs_snapshot_mount runs they are
+ * taken from the snapshot instead, if it matches the flash contents. Everything else is set up by SPIFFS_mount itself.
+ */
+s32_t __real_spiffs_obj_lu_scan(spiffs *fs);
+
+s32_t __wrap_spiffs_obj_lu_scan(spiffs *fs)
+{
+    esp_spiffs_t *efs = (esp_spiffs_t *)fs->user_data;
+    const spiffs_snapshot_t *snap = (efs != NULL) ? efs->mount_snapshot : NULL;
+    if (snap == NULL) {
+        return __real_spiffs_obj_lu_scan(fs);
+    }
+
+    // Nothing is written to the file system before the mount returns, a failed check just falls back to the scan
+    uint32_t content_crc;
+    esp_err_t err = snapshot_content_crc(fs, snap->free_cursor_block_ix, snap->cursor_block_ix, &content_crc);
+    if (err == ESP_OK && content_crc != snap->content_crc) {
+        err = ESP_ERR_INVALID_CRC;
+    }
+    if (err != ESP_OK) {
+        ESP_LOGD(TAG, "snapshot %" PRIu32 " doesn't match the file system (0x%x)", snap->generation, err);
+        return __real_spiffs_obj_lu_scan(fs);
+    }
+
+    fs->free_cursor_block_ix = snap->free_cursor_block_ix;
+    fs->free_cursor_obj_lu_entry = snap->free_cursor_obj_lu_entry;
+    fs->cursor_block_ix = snap->cursor_block_ix;
+    fs->cursor_obj_lu_entry = snap->cursor_obj_lu_entry;
+    fs->free_blocks = snap->free_blocks;
+    fs->stats_p_allocated = snap->stats_p_allocated;
+    fs->stats_p_deleted = snap->stats_p_deleted;
+    fs->max_erase_count = snap->max_erase_count;
+    // Tells spiffs_snapshot_mount that the state was restored
+    efs->mount_snapshot = NULL;
+    return SPIFFS_OK;
+}
+
+static bool snapshot_matches(const spiffs_snapshot_t *snap, const spiffs_config *config)
+{
+    return snap->phys_size == config->phys_size &&
+           snap->log_block_size == config->log_block_size &&
+           snap->log_page_size == config->log_page_size &&
+           snap->free_cursor_block_ix < config->phys_size / config->log_block_size &&
+           snap->cursor_block_ix < config->phys_size / config->log_block_size;
+}
+
+s32_t spiffs_snapshot_mount(spiffs *fs, spiffs_config *config, u8_t *work,
+                            u8_t *fd_space, u32_t fd_space_size,
+                            void *cache, u32_t cache_size,
+                            spiffs_check_callback check_cb_f, bool *out_restored)
+{
+    if (out_restored) {
+        *out_restored = false;
+    }
+
+    spiffs_snapshot_t *slots = snapshot_read_sector(fs, config);
+    if (slots == NULL) {
+        return SPIFFS_mount(fs, config, work, fd_space, fd_space_size, cache, cache_size, check_cb_f);
+    }
+    size_t slot_count = config->phys_erase_block / sizeof(spiffs_snapshot_t);
+    int latest = snapshot_find_latest(slots, slot_count);
+    if (latest < 0 || slots[latest].consumed != SNAPSHOT_NOT_CONSUMED) {
+        free(slots);
+        return SPIFFS_mount(fs, config, work, fd_space, fd_space_size, cache, cache_size, check_cb_f);
+    }
+    const spiffs_snapshot_t snap = slots[latest];
+    free(slots);
+
+    esp_spiffs_t *efs = (esp_spiffs_t *)fs->user_data;
+    bool restored = false;
+    s32_t res;
+    if (snapshot_matches(&snap, config)) {
+        efs->mount_snapshot = &snap;
+        res = SPIFFS_mount(fs, config, work, fd_space, fd_space_size, cache, cache_size, check_cb_f);
+        // Cleared by __wrap_spiffs_obj_lu_scan if the state was taken from the snapshot
+        restored = (efs->mount_snapshot == NULL);
+        efs->mount_snapshot = NULL;
+    } else {
+        res = SPIFFS_mount(fs, config, work, fd_space, fd_space_size, cache, cache_size, check_cb_f);
+    }
+
+    esp_err_t err = ESP_ERR_INVALID_STATE;
+    if (res == SPIFFS_OK && restored) {
+        // Mark the snapshot as used before the file system can change, an unclean shutdown then leads to a full scan
+        const uint32_t consumed = 0;
+        err = esp_partition_write(snapshot_partition(fs),
+                                  config->phys_addr + config->phys_size + latest * sizeof(spiffs_snapshot_t) + offsetof(spiffs_snapshot_t, consumed),
+                                  &consumed, sizeof(consumed));
+    }
+    if (err == ESP_OK) {
+        if (out_restored) {
+            *out_restored = true;
+        }
+        ESP_LOGD(TAG, "mounted from snapshot %" PRIu32, snap.generation);
+        return SPIFFS_OK;
+    }
+
+    // The snapshot wasn't used or can't be marked as consumed, make sure it is never used later
+    snapshot_invalidate(fs, config);
+    if (restored) {
+        SPIFFS_unmount(fs);
+        res = SPIFFS_mount(fs, config, work, fd_space, fd_space_size, cache, cache_size, check_cb_f);
+    }
+    return res;
+}
+
+void spiffs_snapshot_invalidate(spiffs *fs)
+{
+    snapshot_invalidate(fs, &fs->cfg);
+}
+
+void spiffs_snapshot_unmount(spiffs *fs)
+{
+    if (!SPIFFS_mounted(fs)) {
+        return;
+    }
+    // Files are closed (and cached writes flushed) by the unmount, so the state is final after it
+    SPIFFS_unmount(fs);
+
+    spiffs_snapshot_t *slots = snapshot_read_sector(fs, &fs->cfg);
+    if (slots == NULL) {
+        return;
+    }
+    size_t slot_count = fs->cfg.phys_erase_block / sizeof(spiffs_snapshot_t);
+    int latest = snapshot_find_latest(slots, slot_count);
+    int slot = -1;
+    for (size_t i = 0; i < slot_count; i++) {
+        if (snapshot_is_erased(&slots[i])) {
+            slot = i;
+            break;
+        }
+    }
+    const uint32_t generation = (latest >= 0) ? slots[latest].generation + 1 : 0;
+    free(slots);
+
+    uint32_t content_crc;
+    esp_err_t err = snapshot_content_crc(fs, fs->free_cursor_block_ix, fs->cursor_block_ix, &content_crc);
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "failed to check file system for mount snapshot (0x%x), next mount will scan the file system", err);
+        return;
+    }
+
+    const size_t sector_addr = fs->cfg.phys_addr + fs->cfg.phys_size;
+    if (slot < 0) {
+        err = esp_partition_erase_range(snapshot_partition(fs), sector_addr, fs->cfg.phys_erase_block);
+        slot = 0;
+    }
+
+    spiffs_snapshot_t snap = {
+        .magic = SNAPSHOT_MAGIC,
+        .generation = generation,
+        .phys_size = fs->cfg.phys_size,
+        .log_block_size = fs->cfg.log_block_size,
+        .log_page_size = fs->cfg.log_page_size,
+        .free_cursor_block_ix = fs->free_cursor_block_ix,
+        .free_cursor_obj_lu_entry = fs->free_cursor_obj_lu_entry,
+        .cursor_block_ix = fs->cursor_block_ix,
+        .cursor_obj_lu_entry = fs->cursor_obj_lu_entry,
+        .free_blocks = fs->free_blocks,
+        .stats_p_allocated = fs->stats_p_allocated,
+        .stats_p_deleted = fs->stats_p_deleted,
+        .max_erase_count = fs->max_erase_count,
+        .content_crc = content_crc,
+        .consumed = SNAPSHOT_NOT_CONSUMED,
+    };
+    snap.crc = snapshot_crc(&snap);
+    if (err == ESP_OK) {
+        err = esp_partition_write(snapshot_partition(fs), sector_addr + slot * sizeof(spiffs_snapshot_t), &snap, sizeof(snap));
+    }
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "failed to store mount snapshot (0x%x), next mount will scan the file system", err);
+    }
+}
@@ -0,0 +1,67 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include "spiffs.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Mount snapshot
+ *
+ * On a clean unmount, the state SPIFFS otherwise rebuilds by scanning all object lookup pages
+ * (free block count, page statistics and allocation cursors) is stored in the flash sector which
+ * follows the file system (at phys_addr + phys_size). The next mount restores this state instead
+ * of scanning the file system.
+ *
+ * A snapshot is used at most once: it is marked as consumed before the mount returns, so after
+ * an unclean shutdown the next mount falls back to the full scan.
+ *
+ * A snapshot also holds a CRC of the object lookup pages of block 0 and of the blocks its cursors
+ * point to, which is checked together with the magic of these blocks before it is used. If the
+ * partition was written by other means since the snapshot was stored (another image flashed,
+ * formatted without the snapshot support), the mount falls back to the full scan as well.
+ */
+
+/**
+ * @brief Mount SPIFFS, using the snapshot stored by the previous clean unmount if there is one
+ *
+ * Takes the same arguments as SPIFFS_mount. fs->user_data must point to the esp_spiffs_t
+ * of the partition.
+ *
+ * @param out_restored  optional, set to true if the state was restored from the snapshot,
+ *                      false if the file system was scanned
+ *
+ * @return SPIFFS_OK or the error returned by SPIFFS_mount
+ */
+s32_t spiffs_snapshot_mount(spiffs *fs, spiffs_config *config, u8_t *work,
+                            u8_t *fd_space, u32_t fd_space_size,
+                            void *cache, u32_t cache_size,
+                            spiffs_check_callback check_cb_f, bool *out_restored);
+
+/**
+ * @brief Erase the stored snapshot, so that the next mount scans the file system
+ *
+ * To be called before the file system is formatted. fs->cfg and fs->user_data must be set,
+ * as by a previous (possibly failed) mount.
+ */
+void spiffs_snapshot_invalidate(spiffs *fs);
+
+/**
+ * @brief Unmount SPIFFS and store the snapshot for the next mount
+ *
+ * Does nothing if the file system is not mounted. Failure to store the snapshot is not an error,
+ * the next mount scans the file system in that case.
+ */
+void spiffs_snapshot_unmount(spiffs *fs);
+
+#ifdef __cplusplus
+}
+#endif
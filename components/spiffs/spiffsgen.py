@@ -2,7 +2,7 @@
 #
 # spiffsgen is a tool used to generate a spiffs image from a directory
 #
-# SPDX-FileCopyrightText: 2019-2024 Espressif Systems (Shanghai) CO LTD
+# SPDX-FileCopyrightText: 2019-2025 Espressif Systems (Shanghai) CO LTD
 # SPDX-License-Identifier: Apache-2.0
 import argparse
 import io
@@ -559,6 +559,12 @@ def main():  # type: () -> None
                         action='store_true',
                         help='Use aligned object index tables. Specify if SPIFFS_ALIGNED_OBJECT_INDEX_TABLES is set.')
 
+    parser.add_argument('--mount-snapshot',
+                        action='store_true',
+                        help='Reserve the last sector of the image for the mount snapshot, and leave it erased so that '
+                             'flashing the image discards any snapshot of the previous contents. '
+                             'Specify if CONFIG_SPIFFS_MOUNT_SNAPSHOT.')
+
     parser.set_defaults(use_magic=True, use_magic_len=True)
 
     args = parser.parse_args()
@@ -574,14 +580,16 @@ def main():  # type: () -> None
                                                  True, True, 'big' if args.big_endian else 'little',
                                                  args.use_magic, args.use_magic_len, args.aligned_obj_ix_tables)
 
-        spiffs = SpiffsFS(image_size, spiffs_build_default)
+        # The file system covers the partition except for the snapshot sector, which is the size of a block
+        snapshot_size = args.block_size if args.mount_snapshot else 0
+        spiffs = SpiffsFS(image_size - snapshot_size, spiffs_build_default)
 
         for root, dirs, files in os.walk(args.base_dir, followlinks=args.follow_symlinks):
             for f in files:
                 full_path = os.path.join(root, f)
                 spiffs.create_file('/' + os.path.relpath(full_path, args.base_dir).replace('\\', '/'), full_path)
 
-        image = spiffs.to_binary()
+        image = spiffs.to_binary() + b'\xFF' * snapshot_size
 
         image_file.write(image)
 
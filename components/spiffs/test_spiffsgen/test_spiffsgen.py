@@ -1,8 +1,10 @@
 #!/usr/bin/env python
-# SPDX-FileCopyrightText: 2019-2022 Espressif Systems (Shanghai) CO LTD
+# SPDX-FileCopyrightText: 2019-2025 Espressif Systems (Shanghai) CO LTD
 # SPDX-License-Identifier: Apache-2.0
 import os
+import subprocess
 import sys
+import tempfile
 import unittest
 
 try:
@@ -65,6 +67,28 @@ class SpiffsgenTest(unittest.TestCase):
             # Note: it would be nice to compile spiffs for host with the given
             # config, and verify that the image is parsed correctly.
 
+    def test_mount_snapshot(self):  # type: () -> None
+        """With --mount-snapshot, the file system leaves out the last sector
+        of the image, which is erased.
+        """
+        spiffsgen_py = os.path.join(os.path.dirname(__file__), '..', 'spiffsgen.py')
+        image_size = 64 * 1024
+        block_size = 4096
+        base_dir = os.path.dirname(__file__)
+        with tempfile.TemporaryDirectory() as tmp_dir:
+            images = {}
+            for args in ([], ['--mount-snapshot']):
+                image_file = os.path.join(tmp_dir, 'image.bin')
+                subprocess.check_call([sys.executable, spiffsgen_py, str(image_size), base_dir, image_file] + args)
+                with open(image_file, 'rb') as f:
+                    images[bool(args)] = f.read()
+
+        self.assertEqual(len(images[False]), image_size)
+        self.assertEqual(len(images[True]), image_size)
+        self.assertEqual(images[True][-block_size:], b'\xFF' * block_size)
+        # The magic depends on the block count, so it differs from the image without the snapshot sector
+        self.assertNotEqual(images[True][:block_size], images[False][:block_size])
+
 
 if __name__ == '__main__':
     unittest.main()
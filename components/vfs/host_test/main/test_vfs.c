@@ -1,5 +1,5 @@
 /*
- * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ * SPDX-FileCopyrightText: 2025-2026 Espressif Systems (Shanghai) CO LTD
  *
  * SPDX-License-Identifier: Apache-2.0
  */
@@ -9,6 +9,9 @@
 #include <errno.h>
 #include <sys/stat.h>
 #include <unistd.h>
+#include <time.h>
+#include <pthread.h>
+#include <stdatomic.h>
 
 #include "esp_vfs.h"
 #include "test_vfs_linux_dev.h"
@@ -242,6 +245,143 @@ TEST(vfs_linux, test_ftruncate_via_vfs)
     linux_vfs_dev_unregister();
 }
 
+static const char* s_opened_prefix;
+
+static int prefix_open(void* ctx, const char* path, int flags, int mode)
+{
+    s_opened_prefix = (const char*) ctx;
+    return 0;
+}
+
+static int prefix_close(void* ctx, int fd)
+{
+    return 0;
+}
+
+static const char* open_and_get_prefix(const char* path)
+{
+    s_opened_prefix = NULL;
+    int fd = open(path, O_RDONLY);
+    if (fd >= 0) {
+        close(fd);
+    }
+    return s_opened_prefix;
+}
+
+TEST(vfs_linux, test_path_lookup_with_many_prefixes)
+{
+    static const char* prefixes[] = {
+        "/dev", "/dev/uart", "/data", "/data1", "/spiffs", "/sdcard", "/sdcard/log",
+    };
+    const size_t prefix_count = sizeof(prefixes) / sizeof(prefixes[0]);
+    esp_vfs_t vfs = {
+        .flags = ESP_VFS_FLAG_CONTEXT_PTR,
+        .open_p = &prefix_open,
+        .close_p = &prefix_close,
+    };
+    for (size_t i = 0; i < prefix_count; ++i) {
+        TEST_ASSERT_EQUAL(ESP_OK, esp_vfs_register(prefixes[i], &vfs, (void*) prefixes[i]));
+    }
+
+    // the longest prefix ending at a path separator wins
+    TEST_ASSERT_EQUAL_STRING("/dev", open_and_get_prefix("/dev/null"));
+    TEST_ASSERT_EQUAL_STRING("/dev/uart", open_and_get_prefix("/dev/uart/0"));
+    TEST_ASSERT_EQUAL_STRING("/dev/uart", open_and_get_prefix("/dev/uart"));
+    TEST_ASSERT_EQUAL_STRING("/dev", open_and_get_prefix("/dev/uart0"));
+    TEST_ASSERT_EQUAL_STRING("/data", open_and_get_prefix("/data/f.txt"));
+    TEST_ASSERT_EQUAL_STRING("/data1", open_and_get_prefix("/data1/f.txt"));
+    TEST_ASSERT_EQUAL_STRING("/sdcard/log", open_and_get_prefix("/sdcard/log/0001.txt"));
+    TEST_ASSERT_EQUAL_STRING("/sdcard", open_and_get_prefix("/sdcard/logs/0001.txt"));
+    TEST_ASSERT_NULL(open_and_get_prefix("/data2/f.txt"));
+    TEST_ASSERT_NULL(open_and_get_prefix("/de"));
+
+    static const char* paths[] = {
+        "/spiffs/config.json", "/sdcard/log/0001.txt", "/spiffs/www/index.html", "/dev/uart/0", "/data1/f.txt",
+    };
+    const size_t path_count = sizeof(paths) / sizeof(paths[0]);
+    const int iterations = 100000;
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int i = 0; i < iterations; ++i) {
+        open_and_get_prefix(paths[i % path_count]);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double elapsed_ns = (end.tv_sec - start.tv_sec) * 1e9 + (end.tv_nsec - start.tv_nsec);
+    printf("open+close with %zu registered prefixes: %.1f ns\n", prefix_count, elapsed_ns / iterations);
+
+    for (size_t i = 0; i < prefix_count; ++i) {
+        TEST_ASSERT_EQUAL(ESP_OK, esp_vfs_unregister(prefixes[i]));
+    }
+}
+
+#define FD_STRESS_TASKS         4
+#define FD_STRESS_ITERATIONS    20000
+#define FD_STRESS_WRITES        8
+
+static esp_vfs_id_t s_stress_vfs_id;
+static atomic_int s_stress_errors;
+
+static ssize_t stress_write(int fd, const void *data, size_t size)
+{
+    // report the local FD the VFS was called with, so that the caller can check it
+    return fd;
+}
+
+static int stress_close(int fd)
+{
+    return 0;
+}
+
+static void *fd_stress_task(void *arg)
+{
+    const int task = (int) (intptr_t) arg;
+    for (int i = 0; i < FD_STRESS_ITERATIONS; ++i) {
+        const int local_fd = task * 256 + (i % 256);
+        int fd = -1;
+        if (esp_vfs_register_fd_with_local_fd(s_stress_vfs_id, local_fd, false, &fd) != ESP_OK) {
+            atomic_fetch_add(&s_stress_errors, 1);
+            continue;
+        }
+        for (int j = 0; j < FD_STRESS_WRITES; ++j) {
+            if (write(fd, "x", 1) != local_fd) {
+                atomic_fetch_add(&s_stress_errors, 1);
+            }
+        }
+        if (close(fd) != 0) {
+            atomic_fetch_add(&s_stress_errors, 1);
+        }
+    }
+    return NULL;
+}
+
+TEST(vfs_linux, test_fd_table_concurrent_access)
+{
+    static const esp_vfs_fs_ops_t vfs = {
+        .write = &stress_write,
+        .close = &stress_close,
+    };
+    TEST_ASSERT_EQUAL(ESP_OK, esp_vfs_register_fs_with_id(&vfs, ESP_VFS_FLAG_STATIC, NULL, &s_stress_vfs_id));
+    atomic_store(&s_stress_errors, 0);
+
+    pthread_t tasks[FD_STRESS_TASKS];
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int i = 0; i < FD_STRESS_TASKS; ++i) {
+        TEST_ASSERT_EQUAL(0, pthread_create(&tasks[i], NULL, fd_stress_task, (void *) (intptr_t) i));
+    }
+    for (int i = 0; i < FD_STRESS_TASKS; ++i) {
+        TEST_ASSERT_EQUAL(0, pthread_join(tasks[i], NULL));
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    const int calls = FD_STRESS_TASKS * FD_STRESS_ITERATIONS * (FD_STRESS_WRITES + 2);
+    double elapsed_ns = (end.tv_sec - start.tv_sec) * 1e9 + (end.tv_nsec - start.tv_nsec);
+    printf("%d tasks: %.1f ns per fd register/write/close call\n", FD_STRESS_TASKS, elapsed_ns / calls);
+
+    TEST_ASSERT_EQUAL(0, atomic_load(&s_stress_errors));
+    TEST_ASSERT_EQUAL(ESP_OK, esp_vfs_unregister_with_id(s_stress_vfs_id));
+}
+
 TEST_GROUP_RUNNER(vfs_linux)
 {
     RUN_TEST_CASE(vfs_linux, test_linux_vfs_open);
@@ -251,6 +391,8 @@ TEST_GROUP_RUNNER(vfs_linux)
     RUN_TEST_CASE(vfs_linux, test_fstat_via_vfs);
     RUN_TEST_CASE(vfs_linux, test_fcntl_via_vfs);
     RUN_TEST_CASE(vfs_linux, test_ftruncate_via_vfs);
+    RUN_TEST_CASE(vfs_linux, test_path_lookup_with_many_prefixes);
+    RUN_TEST_CASE(vfs_linux, test_fd_table_concurrent_access);
 }
 
 static void run_all_tests(void)
@@ -1,5 +1,5 @@
 /*
- * SPDX-FileCopyrightText: 2015-2025 Espressif Systems (Shanghai) CO LTD
+ * SPDX-FileCopyrightText: 2015-2026 Espressif Systems (Shanghai) CO LTD
  *
  * SPDX-License-Identifier: Apache-2.0
  */
@@ -109,7 +109,7 @@ void unregister_fd(int fd);
 
 int get_local_fd(const vfs_entry_t *vfs, int fd);
 
-const fd_table_t *get_fd_entry(int fd);
+fd_table_t get_fd_entry(int fd);
 
 size_t get_vfs_count(void);
 
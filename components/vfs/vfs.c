@@ -1,5 +1,5 @@
 /*
- * SPDX-FileCopyrightText: 2015-2025 Espressif Systems (Shanghai) CO LTD
+ * SPDX-FileCopyrightText: 2015-2026 Espressif Systems (Shanghai) CO LTD
  *
  * SPDX-License-Identifier: Apache-2.0
  */
@@ -9,8 +9,8 @@
 #include <sys/errno.h>
 #include <sys/fcntl.h>
 #include <sys/reent.h>
-#include <sys/lock.h>
 #include <dirent.h>
+#include <stdatomic.h>
 #include "inttypes_ext.h"
 #include "freertos/FreeRTOS.h"
 #include "esp_vfs.h"
@@ -43,6 +43,21 @@ static const char *TAG = "vfs";
 #define LEN_PATH_PREFIX_IGNORED SIZE_MAX /* special length value for VFS which is never recognised by open() */
 #define FD_TABLE_ENTRY_UNUSED   (fd_table_t) { .permanent = false, .has_pending_close = false, .has_pending_select = false, .vfs_index = -1, .local_fd = -1 }
 
+/* Each entry of the FD table is packed into a single 32-bit word. Readers load the word without taking a lock
+ * and always see a VFS index together with the local FD belonging to it; writers update it with compare-and-swap.
+ */
+#define FD_WORD_PERMANENT       (1u << 26)
+#define FD_WORD_PENDING_CLOSE   (1u << 25)
+#define FD_WORD_PENDING_SELECT  (1u << 24)
+#define FD_WORD_PENDING_MASK    (FD_WORD_PENDING_CLOSE | FD_WORD_PENDING_SELECT)
+#define FD_WORD_VFS_INDEX_SHIFT 16
+#define FD_WORD_VFS_INDEX_MASK  (0xffu << FD_WORD_VFS_INDEX_SHIFT)
+#define FD_WORD_UNUSED          (FD_WORD_VFS_INDEX_MASK | (local_fd_t) -1)
+
+typedef uint32_t fd_word_t;
+
+_Static_assert(sizeof(local_fd_t) <= 2, "local FD doesn't fit into the FD table word");
+
 _Static_assert((1 << (sizeof(local_fd_t)*8)) >= MAX_FDS, "file descriptor type too small");
 
 _Static_assert((1 << (sizeof(vfs_index_t)*8)) >= VFS_MAX_COUNT, "VFS index type too small");
@@ -51,8 +66,74 @@ _Static_assert(((vfs_index_t) -1) < 0, "vfs_index_t must be a signed type");
 static vfs_entry_t* s_vfs[VFS_MAX_COUNT] = { 0 };
 static size_t s_vfs_count = 0;
 
-static fd_table_t s_fd_table[MAX_FDS] = { [0 ... MAX_FDS-1] = FD_TABLE_ENTRY_UNUSED };
-static _lock_t s_fd_table_lock;
+/* Hash table of the registered path prefixes, indices into s_vfs. Half of the slots always stay free,
+ * so that probing terminates. Rebuilt when a VFS with a path prefix is registered or unregistered.
+ */
+#define VFS_PATH_TABLE_SIZE     (2 * VFS_MAX_COUNT)
+#define VFS_PATH_HASH_INIT      2166136261u
+
+static vfs_index_t s_vfs_path_table[VFS_PATH_TABLE_SIZE] = { [0 ... VFS_PATH_TABLE_SIZE-1] = -1 };
+static vfs_index_t s_vfs_path_default = -1;     /* VFS registered with an empty path prefix */
+static size_t s_vfs_path_prefix_max_len = 0;    /* length of the longest registered path prefix */
+
+static _Atomic fd_word_t s_fd_table[MAX_FDS] = { [0 ... MAX_FDS-1] = FD_WORD_UNUSED };
+
+static inline fd_word_t fd_word_make(int vfs_index, int local_fd, bool permanent)
+{
+    return (permanent ? FD_WORD_PERMANENT : 0)
+           | ((fd_word_t) (uint8_t) vfs_index << FD_WORD_VFS_INDEX_SHIFT)
+           | (local_fd_t) local_fd;
+}
+
+static inline vfs_index_t fd_word_vfs_index(fd_word_t word)
+{
+    return (vfs_index_t) (uint8_t) (word >> FD_WORD_VFS_INDEX_SHIFT);
+}
+
+static inline fd_table_t fd_word_to_entry(fd_word_t word)
+{
+    return (fd_table_t) {
+        .permanent = (word & FD_WORD_PERMANENT) != 0,
+        .has_pending_close = (word & FD_WORD_PENDING_CLOSE) != 0,
+        .has_pending_select = (word & FD_WORD_PENDING_SELECT) != 0,
+        .vfs_index = fd_word_vfs_index(word),
+        .local_fd = (local_fd_t) word,
+    };
+}
+
+static inline fd_word_t fd_word_load(int fd)
+{
+    return atomic_load_explicit(&s_fd_table[fd], memory_order_acquire);
+}
+
+/* Replaces the word of the FD if it still equals *expected, otherwise loads the current word into *expected */
+static inline bool fd_word_replace(int fd, fd_word_t *expected, fd_word_t desired)
+{
+    return atomic_compare_exchange_weak_explicit(&s_fd_table[fd], expected, desired,
+                                                 memory_order_acq_rel, memory_order_acquire);
+}
+
+/* Assigns a free FD to the VFS. The pending flags are left as they are, like they were before the FD table
+ * became lock-free. Returns false if the FD is used by another VFS.
+ */
+static bool fd_claim(int fd, int vfs_index, int local_fd, bool permanent)
+{
+    fd_word_t word = fd_word_load(fd);
+    do {
+        if (fd_word_vfs_index(word) != -1) {
+            return false;
+        }
+    } while (!fd_word_replace(fd, &word, (word & FD_WORD_PENDING_MASK) | fd_word_make(vfs_index, local_fd, permanent)));
+    return true;
+}
+
+/* Marks the FD as unused, if it belongs to the given VFS */
+static void fd_release_if_owned(int fd, int vfs_index)
+{
+    fd_word_t word = fd_word_load(fd);
+    while (fd_word_vfs_index(word) == vfs_index && !fd_word_replace(fd, &word, FD_WORD_UNUSED)) {
+    }
+}
 
 static ssize_t esp_get_free_index(void) {
     for (ssize_t i = 0; i < VFS_MAX_COUNT; i++) {
@@ -373,6 +454,66 @@ fail:
     return ESP_ERR_NO_MEM;
 }
 
+static inline uint32_t vfs_path_hash_step(uint32_t hash, char c)
+{
+    return (hash ^ (uint8_t) c) * 16777619u;
+}
+
+static void vfs_path_table_rebuild(void)
+{
+    vfs_index_t table[VFS_PATH_TABLE_SIZE];
+    vfs_index_t fallback = -1;
+    size_t fallback_count = 0;
+    size_t max_len = 0;
+
+    for (size_t i = 0; i < VFS_PATH_TABLE_SIZE; ++i) {
+        table[i] = -1;
+    }
+
+    for (size_t i = 0; i < s_vfs_count; ++i) {
+        const vfs_entry_t* vfs = s_vfs[i];
+        if (vfs == NULL || vfs->path_prefix_len == LEN_PATH_PREFIX_IGNORED) {
+            continue;
+        }
+        if (vfs->path_prefix_len == 0) {
+            // same choice as the linear search used before: the second VFS registered with an
+            // empty prefix takes over from the first one, later ones are ignored
+            if (fallback_count++ < 2) {
+                fallback = i;
+            }
+            continue;
+        }
+
+        uint32_t hash = VFS_PATH_HASH_INIT;
+        for (size_t j = 0; j < vfs->path_prefix_len; ++j) {
+            hash = vfs_path_hash_step(hash, vfs->path_prefix[j]);
+        }
+
+        // if the same prefix is registered twice, the VFS registered first keeps handling it
+        size_t slot = hash % VFS_PATH_TABLE_SIZE;
+        bool duplicate = false;
+        while (table[slot] >= 0) {
+            const vfs_entry_t* other = s_vfs[table[slot]];
+            if (other->path_prefix_len == vfs->path_prefix_len &&
+                    memcmp(other->path_prefix, vfs->path_prefix, vfs->path_prefix_len) == 0) {
+                duplicate = true;
+                break;
+            }
+            slot = (slot + 1) % VFS_PATH_TABLE_SIZE;
+        }
+        if (!duplicate) {
+            table[slot] = i;
+        }
+        if (vfs->path_prefix_len > max_len) {
+            max_len = vfs->path_prefix_len;
+        }
+    }
+
+    memcpy(s_vfs_path_table, table, sizeof(table));
+    s_vfs_path_default = fallback;
+    s_vfs_path_prefix_max_len = max_len;
+}
+
 static bool is_path_prefix_valid(const char *path, size_t length) {
     return (length >= 2)
         && (length <= ESP_VFS_PATH_MAX)
@@ -437,6 +578,10 @@ static esp_err_t esp_vfs_register_fs_common(
 
     memcpy((char *)(entry->path_prefix), _base_path, base_path_len + 1);
 
+    if (base_path != NULL) {
+        vfs_path_table_rebuild();
+    }
+
     if (vfs_index) {
         *vfs_index = index;
     }
@@ -543,25 +688,17 @@ esp_err_t esp_vfs_register_fd_range(const esp_vfs_fs_ops_t *vfs, int flags, void
     esp_err_t ret = esp_vfs_register_fs_common(NULL, vfs, flags, ctx, &index);
 
     if (ret == ESP_OK) {
-        _lock_acquire(&s_fd_table_lock);
         for (int i = min_fd; i < max_fd; ++i) {
-            if (s_fd_table[i].vfs_index != -1) {
+            if (!fd_claim(i, index, i, true)) {
                 free(s_vfs[index]);
                 s_vfs[index] = NULL;
                 for (int j = min_fd; j < i; ++j) {
-                    if (s_fd_table[j].vfs_index == index) {
-                        s_fd_table[j] = FD_TABLE_ENTRY_UNUSED;
-                    }
+                    fd_release_if_owned(j, index);
                 }
-                _lock_release(&s_fd_table_lock);
                 ESP_LOGW(TAG, "esp_vfs_register_fd_range cannot set fd %d (used by other VFS)", i);
                 return ESP_ERR_INVALID_ARG;
             }
-            s_fd_table[i].permanent = true;
-            s_fd_table[i].vfs_index = index;
-            s_fd_table[i].local_fd = i;
         }
-        _lock_release(&s_fd_table_lock);
 
         ESP_LOGD(TAG, "esp_vfs_register_fd_range is successful for range <%d; %d) and VFS ID %d", min_fd, max_fd, index);
     }
@@ -585,17 +722,16 @@ esp_err_t esp_vfs_unregister_with_id(esp_vfs_id_t vfs_id)
         return ESP_ERR_INVALID_ARG;
     }
     vfs_entry_t* vfs = s_vfs[vfs_id];
-    esp_vfs_free_entry(vfs);
     s_vfs[vfs_id] = NULL;
+    if (vfs->path_prefix_len != LEN_PATH_PREFIX_IGNORED) {
+        vfs_path_table_rebuild();
+    }
+    esp_vfs_free_entry(vfs);
 
-    _lock_acquire(&s_fd_table_lock);
     // Delete all references from the FD lookup-table
-    for (int j = 0; j < VFS_MAX_COUNT; ++j) {
-        if (s_fd_table[j].vfs_index == vfs_id) {
-            s_fd_table[j] = FD_TABLE_ENTRY_UNUSED;
-        }
+    for (int j = 0; j < MAX_FDS; ++j) {
+        fd_release_if_owned(j, vfs_id);
     }
-    _lock_release(&s_fd_table_lock);
 
     return ESP_OK;
 
@@ -639,22 +775,13 @@ esp_err_t esp_vfs_register_fd_with_local_fd(esp_vfs_id_t vfs_id, int local_fd, b
     }
 
     esp_err_t ret = ESP_ERR_NO_MEM;
-    _lock_acquire(&s_fd_table_lock);
     for (int i = 0; i < MAX_FDS; ++i) {
-        if (s_fd_table[i].vfs_index == -1) {
-            s_fd_table[i].permanent = permanent;
-            s_fd_table[i].vfs_index = vfs_id;
-            if (local_fd >= 0) {
-                s_fd_table[i].local_fd = local_fd;
-            } else {
-                s_fd_table[i].local_fd = i;
-            }
+        if (fd_claim(i, vfs_id, local_fd >= 0 ? local_fd : i, permanent)) {
             *fd = i;
             ret = ESP_OK;
             break;
         }
     }
-    _lock_release(&s_fd_table_lock);
 
     ESP_LOGD(TAG, "esp_vfs_register_fd_with_local_fd(%d, %d, %d, 0x%p) finished with %s",
              vfs_id, local_fd, permanent, fd, esp_err_to_name(ret));
@@ -671,13 +798,13 @@ esp_err_t esp_vfs_unregister_fd(esp_vfs_id_t vfs_id, int fd)
         return ret;
     }
 
-    _lock_acquire(&s_fd_table_lock);
-    fd_table_t *item = s_fd_table + fd;
-    if (item->permanent == true && item->vfs_index == vfs_id && item->local_fd == fd) {
-        *item = FD_TABLE_ENTRY_UNUSED;
-        ret = ESP_OK;
+    fd_word_t word = fd_word_load(fd);
+    while ((word & FD_WORD_PERMANENT) && fd_word_vfs_index(word) == vfs_id && (local_fd_t) word == fd) {
+        if (fd_word_replace(fd, &word, FD_WORD_UNUSED)) {
+            ret = ESP_OK;
+            break;
+        }
     }
-    _lock_release(&s_fd_table_lock);
 
     ESP_LOGD(TAG, "esp_vfs_unregister_fd(%d, %d) finished with %s", vfs_id, fd, esp_err_to_name(ret));
 
@@ -690,18 +817,17 @@ void esp_vfs_dump_fds(FILE *fp)
     fprintf(fp, "------------------------------------------------------\n");
     fprintf(fp, "<VFS Path Prefix>-<FD seen by App>-<FD seen by driver>\n");
     fprintf(fp, "------------------------------------------------------\n");
-    _lock_acquire(&s_fd_table_lock);
     for (int index = 0; index < MAX_FDS; index++) {
-        if (s_fd_table[index].vfs_index != -1) {
-            vfs = s_vfs[s_fd_table[index].vfs_index];
+        const fd_table_t entry = fd_word_to_entry(fd_word_load(index));
+        if (entry.vfs_index != -1) {
+            vfs = s_vfs[entry.vfs_index];
             if (strcmp(vfs->path_prefix, "")) {
-                fprintf(fp, "(%s) - 0x%x - 0x%x\n", vfs->path_prefix, index, s_fd_table[index].local_fd);
+                fprintf(fp, "(%s) - 0x%x - 0x%x\n", vfs->path_prefix, index, entry.local_fd);
             } else {
-                fprintf(fp, "(socket) - 0x%x - 0x%x\n", index, s_fd_table[index].local_fd);
+                fprintf(fp, "(socket) - 0x%x - 0x%x\n", index, entry.local_fd);
             }
         }
     }
-    _lock_release(&s_fd_table_lock);
 }
 
 void esp_vfs_dump_registered_paths(FILE *fp)
@@ -754,37 +880,26 @@ const vfs_entry_t *get_vfs_for_index(int index)
 
 int register_fd(int vfs_index, int local_fd, bool permanent)
 {
-    _lock_acquire(&s_fd_table_lock);
     for (int i = 0; i < MAX_FDS; ++i) {
-        if (s_fd_table[i].vfs_index == -1) {
-            s_fd_table[i].permanent = permanent;
-            s_fd_table[i].vfs_index = vfs_index;
-            s_fd_table[i].local_fd = local_fd;
-            _lock_release(&s_fd_table_lock);
+        if (fd_claim(i, vfs_index, local_fd, permanent)) {
             return i;
         }
     }
-    _lock_release(&s_fd_table_lock);
     return -1;
 }
 
 void unregister_fd(int fd)
 {
-    _lock_acquire(&s_fd_table_lock);
-
-    // Do not close permanent FDs
-    if (s_fd_table[fd].permanent) {
-        _lock_release(&s_fd_table_lock);
-        return;
-    }
-
-    // If the FD is in use by select, mark it for closure
-    if (s_fd_table[fd].has_pending_select) {
-        s_fd_table[fd].has_pending_close = true;
-    } else {
-        s_fd_table[fd] = FD_TABLE_ENTRY_UNUSED;
-    }
-    _lock_release(&s_fd_table_lock);
+    fd_word_t word = fd_word_load(fd);
+    fd_word_t desired;
+    do {
+        // Do not close permanent FDs
+        if (word & FD_WORD_PERMANENT) {
+            return;
+        }
+        // If the FD is in use by select, mark it for closure
+        desired = (word & FD_WORD_PENDING_SELECT) ? (word | FD_WORD_PENDING_CLOSE) : FD_WORD_UNUSED;
+    } while (!fd_word_replace(fd, &word, desired));
 }
 
 static inline bool fd_valid(int fd)
@@ -792,17 +907,16 @@ static inline bool fd_valid(int fd)
     return (fd < MAX_FDS) && (fd >= 0);
 }
 
-const fd_table_t *get_fd_entry(int fd)
+fd_table_t get_fd_entry(int fd)
 {
-    return fd_valid(fd) ? &s_fd_table[fd] : NULL;
+    return fd_valid(fd) ? fd_word_to_entry(fd_word_load(fd)) : FD_TABLE_ENTRY_UNUSED;
 }
 
 const vfs_entry_t *get_vfs_for_fd(int fd)
 {
     const vfs_entry_t *vfs = NULL;
     if (fd_valid(fd)) {
-        const int index = s_fd_table[fd].vfs_index; // single read -> no locking is required
-        vfs = get_vfs_for_index(index);
+        vfs = get_vfs_for_index(fd_word_vfs_index(fd_word_load(fd)));
     }
     return vfs;
 }
@@ -812,7 +926,11 @@ int get_local_fd(const vfs_entry_t *vfs, int fd)
     int local_fd = -1;
 
     if (vfs && fd_valid(fd)) {
-        local_fd = s_fd_table[fd].local_fd; // single read -> no locking is required
+        const fd_word_t word = fd_word_load(fd);
+        // the FD may have been closed and reused by another VFS since get_vfs_for_fd() was called
+        if (fd_word_vfs_index(word) == vfs->offset) {
+            local_fd = (local_fd_t) word;
+        }
     }
 
     return local_fd;
@@ -830,42 +948,46 @@ const char* translate_path(const vfs_entry_t* vfs, const char* src_path)
 
 const vfs_entry_t* get_vfs_for_path(const char* path)
 {
-    const vfs_entry_t* best_match = NULL;
-    ssize_t best_match_prefix_len = -1;
-    size_t len = strlen(path);
-    for (size_t i = 0; i < s_vfs_count; ++i) {
-        const vfs_entry_t* vfs = s_vfs[i];
-        if (vfs == NULL || vfs->path_prefix_len == LEN_PATH_PREFIX_IGNORED) {
-            continue;
-        }
-        // match path prefix
-        if (len < vfs->path_prefix_len ||
-            memcmp(path, vfs->path_prefix, vfs->path_prefix_len) != 0) {
-            continue;
+    // Out of all registered path prefixes matching the path, select the longest one;
+    // i.e. if "/dev" and "/dev/uart" are both registered, choose "/dev/uart" for "/dev/uart/1".
+    // A prefix only matches up to a path separator or the end of the path, i.e. "/data" doesn't
+    // match "/data1/foo.txt". So the candidates are the parts of the path before each separator,
+    // which are looked up in the hash table from the longest one, up to the longest registered prefix.
+    size_t candidate_len[ESP_VFS_PATH_MAX];
+    uint32_t candidate_hash[ESP_VFS_PATH_MAX];
+    size_t candidates = 0;
+
+    uint32_t hash = VFS_PATH_HASH_INIT;
+    for (size_t i = 0; i <= s_vfs_path_prefix_max_len; ++i) {
+        const char c = path[i];
+        if ((c == '/' || c == '\0') && i >= 2) {
+            candidate_len[candidates] = i;
+            candidate_hash[candidates] = hash;
+            candidates++;
         }
-        // this is the default VFS and we don't have a better match yet.
-        if (vfs->path_prefix_len == 0 && !best_match) {
-            best_match = vfs;
-            continue;
-        }
-        // if path is not equal to the prefix, expect to see a path separator
-        // i.e. don't match "/data" prefix for "/data1/foo.txt" path
-        if (len > vfs->path_prefix_len &&
-                path[vfs->path_prefix_len] != '/') {
-            continue;
+        if (c == '\0') {
+            break;
         }
-        // Out of all matching path prefixes, select the longest one;
-        // i.e. if "/dev" and "/dev/uart" both match, for "/dev/uart/1" path,
-        // choose "/dev/uart",
-        // This causes all s_vfs_count VFS entries to be scanned when opening
-        // a file by name. This can be optimized by introducing a table for
-        // FS search order, sorted so that longer prefixes are checked first.
-        if (best_match_prefix_len < (ssize_t) vfs->path_prefix_len) {
-            best_match_prefix_len = (ssize_t) vfs->path_prefix_len;
-            best_match = vfs;
+        hash = vfs_path_hash_step(hash, c);
+    }
+
+    while (candidates > 0) {
+        candidates--;
+        const size_t len = candidate_len[candidates];
+        size_t slot = candidate_hash[candidates] % VFS_PATH_TABLE_SIZE;
+        vfs_index_t index;
+        while ((index = s_vfs_path_table[slot]) >= 0) {
+            const vfs_entry_t* vfs = s_vfs[index];
+            if (vfs != NULL && vfs->path_prefix_len == len &&
+                    memcmp(path, vfs->path_prefix, len) == 0) {
+                return vfs;
+            }
+            slot = (slot + 1) % VFS_PATH_TABLE_SIZE;
         }
     }
-    return best_match;
+
+    // the default VFS handles the paths not matched by any other VFS
+    return (s_vfs_path_default >= 0) ? s_vfs[s_vfs_path_default] : NULL;
 }
 
 size_t get_vfs_count(void)
@@ -875,28 +997,19 @@ size_t get_vfs_count(void)
 
 void close_pending(int nfds)
 {
-    _lock_acquire(&s_fd_table_lock);
     for (int fd = 0; fd < nfds; ++fd) {
-        if (s_fd_table[fd].has_pending_close) {
-            s_fd_table[fd] = FD_TABLE_ENTRY_UNUSED;
+        fd_word_t word = fd_word_load(fd);
+        while ((word & FD_WORD_PENDING_CLOSE) && !fd_word_replace(fd, &word, FD_WORD_UNUSED)) {
         }
     }
-    _lock_release(&s_fd_table_lock);
 }
 
 fd_table_t start_select(int fd, fd_set *errorfds)
 {
-    _lock_acquire(&s_fd_table_lock);
-
-    // Set flag
+    // Set flag and make a copy
     if (esp_vfs_safe_fd_isset(fd, errorfds)) {
-        s_fd_table[fd].has_pending_select = true;
+        return fd_word_to_entry(atomic_fetch_or_explicit(&s_fd_table[fd], FD_WORD_PENDING_SELECT, memory_order_acq_rel)
+                                | FD_WORD_PENDING_SELECT);
     }
-
-    // Make a copy
-    fd_table_t out = s_fd_table[fd];
-
-    _lock_release(&s_fd_table_lock);
-
-    return out;
+    return fd_word_to_entry(fd_word_load(fd));
 }
@@ -503,9 +503,9 @@ static int set_global_fd_sets(const fds_triple_t *vfs_fds_triple, int size, fd_s
         const fds_triple_t *item = &vfs_fds_triple[i];
         if (item->isset) {
             for (int fd = 0; fd < MAX_FDS; ++fd) {
-                const fd_table_t *fd_entry = get_fd_entry(fd);
-                if (fd_entry->vfs_index == i) {
-                    const int local_fd = fd_entry->local_fd; // single read -> no locking is required
+                const fd_table_t fd_entry = get_fd_entry(fd);
+                if (fd_entry.vfs_index == i) {
+                    const int local_fd = fd_entry.local_fd;
                     if (readfds && esp_vfs_safe_fd_isset(local_fd, &item->readfds)) {
                         ESP_LOGD(TAG, "FD %d in readfds was set from VFS ID %d", fd, i);
                         FD_SET(fd, readfds);
@@ -37,6 +37,11 @@ WL_Flash::WL_Flash()
 WL_Flash::~WL_Flash()
 {
     free(this->temp_buff);
+    free(this->discarded_map);
+    if (this->cache != NULL) {
+        free(this->cache[0].data);
+        free(this->cache);
+    }
 }
 
 esp_err_t WL_Flash::config(wl_config_t *cfg, Partition *partition)
@@ -106,6 +111,16 @@ esp_err_t WL_Flash::config(wl_config_t *cfg, Partition *partition)
         result = ESP_ERR_NO_MEM;
     }
     WL_RESULT_CHECK(result);
+
+    // Both maps are allocated at once, erased_map follows discarded_map
+    this->map_sector_count = this->flash_size / this->cfg.flash_sector_size;
+    size_t map_words = (this->map_sector_count + 31) / 32;
+    this->discarded_map = (uint32_t *)calloc(map_words * 2, sizeof(uint32_t));
+    if (this->discarded_map == NULL) {
+        result = ESP_ERR_NO_MEM;
+    }
+    WL_RESULT_CHECK(result);
+    this->erased_map = &this->discarded_map[map_words];
     this->configured = true;
     return ESP_OK;
 }
@@ -437,6 +452,9 @@ esp_err_t WL_Flash::updateWL()
     if (data_addr >= this->state.wl_part_max_sec_pos) {
         data_addr = 0;
     }
+    // Data which was discarded does not have to be copied, the block stays erased at its new place
+    size_t moved_addr = this->calcLogicalAddr(data_addr);
+    bool moved_discarded = this->isPageDiscarded(moved_addr);
     data_addr = this->cfg.wl_partition_start_addr + data_addr * this->cfg.wl_page_size;
     this->dummy_addr = this->cfg.wl_partition_start_addr + this->state.wl_dummy_sec_pos * this->cfg.wl_page_size;
     result = this->partition->erase_range(this->dummy_addr, this->cfg.wl_page_size);
@@ -446,7 +464,7 @@ esp_err_t WL_Flash::updateWL()
         return result;
     }
 
-    size_t copy_count = this->cfg.wl_page_size / this->cfg.wl_temp_buff_size;
+    size_t copy_count = moved_discarded ? 0 : this->cfg.wl_page_size / this->cfg.wl_temp_buff_size;
     for (size_t i = 0; i < copy_count; i++) {
         result = this->partition->read(data_addr + i * this->cfg.wl_temp_buff_size, this->temp_buff, this->cfg.wl_temp_buff_size);
         if (result != ESP_OK) {
@@ -481,6 +499,13 @@ esp_err_t WL_Flash::updateWL()
         return result;
     }
 
+    if (moved_discarded) {
+        ESP_LOGV(TAG, "%s - discarded block 0x%08" PRIx32 " not copied", __func__, (uint32_t) moved_addr);
+        for (size_t i = 0; i < this->cfg.wl_page_size / this->cfg.flash_sector_size; i++) {
+            this->setSectorFlag(this->erased_map, moved_addr / this->cfg.flash_sector_size + i, true);
+        }
+    }
+
     this->state.wl_dummy_sec_pos++;
     if (this->state.wl_dummy_sec_pos >= this->state.wl_part_max_sec_pos) {
         this->state.wl_dummy_sec_pos = 0;
@@ -523,6 +548,47 @@ size_t WL_Flash::calcAddr(size_t addr)
     return result;
 }
 
+// Inverse of calcAddr(): logical address of the data stored in the block at page_pos
+size_t WL_Flash::calcLogicalAddr(size_t page_pos)
+{
+    size_t result = page_pos * this->cfg.wl_page_size;
+    if (page_pos > this->state.wl_dummy_sec_pos) {
+        result -= this->cfg.wl_page_size;
+    }
+    return (result + this->state.wl_dummy_sec_move_count * this->cfg.wl_page_size) % this->flash_size;
+}
+
+bool WL_Flash::getSectorFlag(const uint32_t *map, size_t sector)
+{
+    if (sector >= this->map_sector_count) {
+        return false;
+    }
+    return (map[sector / 32] >> (sector % 32)) & 1;
+}
+
+void WL_Flash::setSectorFlag(uint32_t *map, size_t sector, bool value)
+{
+    if (sector >= this->map_sector_count) {
+        return;
+    }
+    if (value) {
+        map[sector / 32] |= (1UL << (sector % 32));
+    } else {
+        map[sector / 32] &= ~(1UL << (sector % 32));
+    }
+}
+
+bool WL_Flash::isPageDiscarded(size_t addr)
+{
+    size_t sector = addr / this->cfg.flash_sector_size;
+    for (size_t i = 0; i < this->cfg.wl_page_size / this->cfg.flash_sector_size; i++) {
+        if (!this->getSectorFlag(this->discarded_map, sector + i)) {
+            return false;
+        }
+    }
+    return true;
+}
+
 
 size_t WL_Flash::get_flash_size()
 {
@@ -547,11 +613,33 @@ esp_err_t WL_Flash::erase_sector(size_t sector)
         return ESP_ERR_INVALID_STATE;
     }
     ESP_LOGD(TAG, "%s - sector= 0x%08" PRIx32 , __func__, (uint32_t) sector);
-    result = this->updateWL();
+    if (this->cache_count == 0) {
+        return this->erase_sector_direct(sector);
+    }
+    cache_line_t *line = this->cache_find(sector);
+    if (line == NULL) {
+        result = this->cache_alloc(sector, &line);
+        WL_RESULT_CHECK(result);
+    }
+    memset(line->data, 0xff, this->cfg.flash_sector_size);
+    this->cache_stats.write_hits++;
+    return this->cache_modified(line);
+}
+
+esp_err_t WL_Flash::erase_sector_direct(size_t sector)
+{
+    this->setSectorFlag(this->discarded_map, sector, false);
+    if (this->getSectorFlag(this->erased_map, sector)) {
+        ESP_LOGV(TAG, "%s - sector= 0x%08" PRIx32 " already erased", __func__, (uint32_t) sector);
+        return ESP_OK;
+    }
+    esp_err_t result = this->updateWL();
     WL_RESULT_CHECK(result);
     size_t virt_addr = this->calcAddr(sector * this->cfg.flash_sector_size);
     result = this->partition->erase_sector((this->cfg.wl_partition_start_addr + virt_addr) / this->cfg.flash_sector_size);
     WL_RESULT_CHECK(result);
+    this->setSectorFlag(this->erased_map, sector, true);
+    this->cache_stats.flash_erases++;
     return result;
 }
 
@@ -579,6 +667,45 @@ esp_err_t WL_Flash::write(size_t dest_addr, const void *src, size_t size)
         return ESP_ERR_INVALID_STATE;
     }
     ESP_LOGD(TAG, "%s - dest_addr= 0x%08" PRIx32 ", size= 0x%08" PRIx32 , __func__, (uint32_t) dest_addr, (uint32_t) size);
+    if (this->cache_count == 0) {
+        return this->write_direct(dest_addr, src, size);
+    }
+    const uint8_t *src_bytes = (const uint8_t *)src;
+    while (size > 0) {
+        size_t sector = dest_addr / this->cfg.flash_sector_size;
+        size_t offset = dest_addr % this->cfg.flash_sector_size;
+        size_t chunk = this->cfg.flash_sector_size - offset;
+        if (chunk > size) {
+            chunk = size;
+        }
+        cache_line_t *line = this->cache_find(sector);
+        if (line != NULL) {
+            // Same result as programming flash: bits can only be cleared until the sector is erased
+            for (size_t i = 0; i < chunk; i++) {
+                line->data[offset + i] &= src_bytes[i];
+            }
+            this->cache_stats.write_hits++;
+            result = this->cache_modified(line);
+        } else {
+            this->cache_stats.write_misses++;
+            result = this->write_direct(dest_addr, src_bytes, chunk);
+        }
+        WL_RESULT_CHECK(result);
+        dest_addr += chunk;
+        src_bytes += chunk;
+        size -= chunk;
+    }
+    return ESP_OK;
+}
+
+esp_err_t WL_Flash::write_direct(size_t dest_addr, const void *src, size_t size)
+{
+    esp_err_t result = ESP_OK;
+    for (size_t sector = dest_addr / this->cfg.flash_sector_size;
+            sector <= (dest_addr + size - 1) / this->cfg.flash_sector_size; sector++) {
+        this->setSectorFlag(this->discarded_map, sector, false);
+        this->setSectorFlag(this->erased_map, sector, false);
+    }
     uint32_t count = (size - 1) / this->cfg.wl_page_size;
     for (size_t i = 0; i < count; i++) {
         size_t virt_addr = this->calcAddr(dest_addr + i * this->cfg.wl_page_size);
@@ -598,6 +725,38 @@ esp_err_t WL_Flash::read(size_t src_addr, void *dest, size_t size)
         return ESP_ERR_INVALID_STATE;
     }
     ESP_LOGD(TAG, "%s - src_addr= 0x%08" PRIx32 ", size= 0x%08" PRIx32 , __func__, (uint32_t) src_addr, (uint32_t) size);
+    if (this->cache_count == 0) {
+        return this->read_direct(src_addr, dest, size);
+    }
+    // Sectors which are not cached are read from flash without being added to the cache,
+    // so that reading file data does not evict the modified sectors
+    uint8_t *dest_bytes = (uint8_t *)dest;
+    while (size > 0) {
+        size_t sector = src_addr / this->cfg.flash_sector_size;
+        size_t offset = src_addr % this->cfg.flash_sector_size;
+        size_t chunk = this->cfg.flash_sector_size - offset;
+        if (chunk > size) {
+            chunk = size;
+        }
+        cache_line_t *line = this->cache_find(sector);
+        if (line != NULL) {
+            memcpy(dest_bytes, &line->data[offset], chunk);
+            this->cache_stats.read_hits++;
+        } else {
+            this->cache_stats.read_misses++;
+            result = this->read_direct(src_addr, dest_bytes, chunk);
+            WL_RESULT_CHECK(result);
+        }
+        src_addr += chunk;
+        dest_bytes += chunk;
+        size -= chunk;
+    }
+    return ESP_OK;
+}
+
+esp_err_t WL_Flash::read_direct(size_t src_addr, void *dest, size_t size)
+{
+    esp_err_t result = ESP_OK;
     uint32_t count = (size - 1) / this->cfg.wl_page_size;
     for (size_t i = 0; i < count; i++) {
         size_t virt_addr = this->calcAddr(src_addr + i * this->cfg.wl_page_size);
@@ -622,9 +781,144 @@ wl_config_t *WL_Flash::get_cfg()
 
 esp_err_t WL_Flash::flush()
 {
-    esp_err_t result = ESP_OK;
+    esp_err_t result = this->flush_cache();
+    WL_RESULT_CHECK(result);
     this->state.wl_sec_erase_cycle_count = this->state.wl_max_sec_erase_cycle_count - 1;
     result = this->updateWL();
     ESP_LOGD(TAG, "%s - result= 0x%08x, wl_dummy_sec_move_count= 0x%08" PRIx32, __func__, result, this->state.wl_dummy_sec_move_count);
     return result;
 }
+
+esp_err_t WL_Flash::config_cache(size_t sector_count, size_t flush_interval)
+{
+    if (!this->configured || this->initialized || this->cache != NULL) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (sector_count == 0) {
+        return ESP_OK;
+    }
+    this->cache = (cache_line_t *)calloc(sector_count, sizeof(cache_line_t));
+    uint8_t *data = (uint8_t *)malloc(sector_count * this->cfg.flash_sector_size);
+    if (this->cache == NULL || data == NULL) {
+        free(this->cache);
+        free(data);
+        this->cache = NULL;
+        return ESP_ERR_NO_MEM;
+    }
+    for (size_t i = 0; i < sector_count; i++) {
+        this->cache[i].data = &data[i * this->cfg.flash_sector_size];
+    }
+    this->cache_count = sector_count;
+    this->cache_flush_interval = flush_interval;
+    ESP_LOGD(TAG, "%s - sector_count= %" PRIu32 ", flush_interval= %" PRIu32, __func__, (uint32_t) sector_count, (uint32_t) flush_interval);
+    return ESP_OK;
+}
+
+WL_Flash::cache_line_t *WL_Flash::cache_find(size_t sector)
+{
+    for (size_t i = 0; i < this->cache_count; i++) {
+        cache_line_t *line = &this->cache[i];
+        if (line->valid && line->sector == sector) {
+            line->last_access = ++this->cache_access;
+            return line;
+        }
+    }
+    return NULL;
+}
+
+esp_err_t WL_Flash::cache_alloc(size_t sector, cache_line_t **out_line)
+{
+    // Take a free line or evict the least recently used one
+    cache_line_t *line = &this->cache[0];
+    for (size_t i = 0; i < this->cache_count; i++) {
+        if (!this->cache[i].valid) {
+            line = &this->cache[i];
+            break;
+        }
+        if ((int32_t)(this->cache[i].last_access - line->last_access) < 0) {
+            line = &this->cache[i];
+        }
+    }
+    esp_err_t result = this->cache_writeback(line);
+    WL_RESULT_CHECK(result);
+    line->sector = sector;
+    line->valid = true;
+    line->last_access = ++this->cache_access;
+    *out_line = line;
+    return ESP_OK;
+}
+
+esp_err_t WL_Flash::cache_writeback(cache_line_t *line)
+{
+    if (!line->valid || !line->dirty) {
+        return ESP_OK;
+    }
+    ESP_LOGV(TAG, "%s - sector= 0x%08" PRIx32, __func__, (uint32_t) line->sector);
+    esp_err_t result = this->erase_sector_direct(line->sector);
+    WL_RESULT_CHECK(result);
+    // An erased sector does not need to be programmed
+    bool erased = true;
+    for (size_t i = 0; i < this->cfg.flash_sector_size; i++) {
+        if (line->data[i] != 0xff) {
+            erased = false;
+            break;
+        }
+    }
+    if (!erased) {
+        result = this->write_direct(line->sector * this->cfg.flash_sector_size, line->data, this->cfg.flash_sector_size);
+        WL_RESULT_CHECK(result);
+    }
+    line->dirty = false;
+    this->cache_stats.writebacks++;
+    return ESP_OK;
+}
+
+esp_err_t WL_Flash::cache_modified(cache_line_t *line)
+{
+    line->dirty = true;
+    this->cache_dirty_ops++;
+    if (this->cache_flush_interval != 0 && this->cache_dirty_ops >= this->cache_flush_interval) {
+        return this->flush_cache();
+    }
+    return ESP_OK;
+}
+
+esp_err_t WL_Flash::flush_cache()
+{
+    esp_err_t result = ESP_OK;
+    for (size_t i = 0; i < this->cache_count; i++) {
+        result = this->cache_writeback(&this->cache[i]);
+        WL_RESULT_CHECK(result);
+    }
+    this->cache_dirty_ops = 0;
+    return result;
+}
+
+void WL_Flash::get_cache_stats(wl_cache_stats_t *stats)
+{
+    *stats = this->cache_stats;
+}
+
+esp_err_t WL_Flash::discard(size_t start_address, size_t size)
+{
+    if (!this->initialized) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    ESP_LOGD(TAG, "%s - start_address= 0x%08" PRIx32 ", size= 0x%08" PRIx32 , __func__, (uint32_t) start_address, (uint32_t) size);
+    // Only sectors which are discarded completely are recorded
+    size_t first_sector = (start_address + this->cfg.flash_sector_size - 1) / this->cfg.flash_sector_size;
+    size_t end_sector = (start_address + size) / this->cfg.flash_sector_size;
+    if (end_sector > this->map_sector_count) {
+        end_sector = this->map_sector_count;
+    }
+    for (size_t sector = first_sector; sector < end_sector; sector++) {
+        this->setSectorFlag(this->discarded_map, sector, true);
+        // Modified data in the cache does not have to be written back any more
+        cache_line_t *line = this->cache_find(sector);
+        if (line != NULL) {
+            line->valid = false;
+            line->dirty = false;
+        }
+    }
+    return ESP_OK;
+}
@@ -6,12 +6,14 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <inttypes.h>
 
 #include "esp_partition.h"
 #include "esp_private/partition_linux.h"
 
 #include "wear_levelling.h"
 #include "WL_Flash.h"
+#include "Partition.h"
 #include "crc32.h"
 
 
@@ -421,3 +423,156 @@ TEST_CASE("power down between WL status 1 and WL status 2 update", "[wear_levell
 
     free(tmp_state);
 }
+
+// Same configuration as wl_mount() uses
+static void init_wl_config(wl_config_t *cfg, const esp_partition_t *partition)
+{
+    memset(cfg, 0, sizeof(wl_config_t));
+    cfg->wl_partition_start_addr   = 0;
+    cfg->wl_partition_size         = partition->size;
+    cfg->wl_page_size              = partition->erase_size;
+    cfg->flash_sector_size         = partition->erase_size;
+    cfg->wl_update_rate            = 16;
+    cfg->wl_pos_update_record_size = 16;
+    cfg->version                   = 2;
+    cfg->wl_temp_buff_size         = 32;
+}
+
+// Emulates FAT usage: every data sector write is followed by an update of the FAT and directory sectors
+static void write_fat_like_workload(WL_Flash *wl_flash, uint32_t *sector_data, size_t sector_size, uint32_t rounds)
+{
+    const size_t fat_sector = 0;
+    const size_t dir_sector = 1;
+    const size_t first_data_sector = 2;
+
+    for (uint32_t round = 0; round < rounds; round++) {
+        size_t data_sector = first_data_sector + round;
+        size_t updates[] = { data_sector, fat_sector, dir_sector };
+        for (size_t sector : updates) {
+            for (uint32_t m = 0; m < sector_size / sizeof(uint32_t); m++) {
+                sector_data[m] = (sector == data_sector) ? sector * sector_size + m : round + m;
+            }
+            REQUIRE(wl_flash->erase_range(sector * sector_size, sector_size) == ESP_OK);
+            REQUIRE(wl_flash->write(sector * sector_size, sector_data, sector_size) == ESP_OK);
+        }
+    }
+}
+
+TEST_CASE("write-back sector cache reduces flash erases", "[wear_levelling]")
+{
+    const esp_partition_t *partition = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY, "storage");
+    const uint32_t rounds = 64;
+    const size_t cache_sizes[] = { 0, 4 };
+    size_t erase_ops[2];
+
+    for (size_t c = 0; c < 2; c++) {
+        wl_config_t cfg;
+        init_wl_config(&cfg, partition);
+
+        Partition *part = new Partition(partition);
+        WL_Flash *wl_flash = new WL_Flash();
+        REQUIRE(wl_flash->config(&cfg, part) == ESP_OK);
+        REQUIRE(wl_flash->config_cache(cache_sizes[c], 0) == ESP_OK);
+        REQUIRE(wl_flash->init() == ESP_OK);
+
+        size_t sector_size = wl_flash->get_sector_size();
+        uint32_t *sector_data = new uint32_t[sector_size / sizeof(uint32_t)];
+
+        esp_partition_clear_stats();
+        write_fat_like_workload(wl_flash, sector_data, sector_size, rounds);
+        REQUIRE(wl_flash->flush_cache() == ESP_OK);
+        erase_ops[c] = esp_partition_get_erase_ops();
+
+        wl_cache_stats_t stats;
+        wl_flash->get_cache_stats(&stats);
+        ESP_LOGI(TAG, "cache sectors: %zu, partition erases: %zu, WL data erases: %" PRIu32 ", hits: %" PRIu32 ", misses: %" PRIu32 ", writebacks: %" PRIu32,
+                 cache_sizes[c], erase_ops[c], stats.flash_erases, stats.write_hits, stats.write_misses, stats.writebacks);
+        if (cache_sizes[c] == 0) {
+            REQUIRE(stats.write_hits == 0);
+            REQUIRE(stats.flash_erases == rounds * 3);
+        } else {
+            REQUIRE(stats.write_hits == rounds * 6);
+            REQUIRE(stats.flash_erases == stats.writebacks);
+        }
+
+        // The last version of each sector is on flash
+        REQUIRE(wl_flash->flush() == ESP_OK);
+        delete wl_flash;
+
+        wl_flash = new WL_Flash();
+        REQUIRE(wl_flash->config(&cfg, part) == ESP_OK);
+        REQUIRE(wl_flash->init() == ESP_OK);
+        for (size_t sector = 0; sector < rounds + 2; sector++) {
+            REQUIRE(wl_flash->read(sector * sector_size, sector_data, sector_size) == ESP_OK);
+            for (uint32_t m = 0; m < sector_size / sizeof(uint32_t); m++) {
+                uint32_t expected = (sector >= 2) ? sector * sector_size + m : rounds - 1 + m;
+                REQUIRE(sector_data[m] == expected);
+            }
+        }
+
+        delete[] sector_data;
+        delete wl_flash;
+        delete part;
+    }
+
+    REQUIRE(erase_ops[1] < erase_ops[0] / 2);
+}
+
+TEST_CASE("discarded sectors are not copied by wear levelling", "[wear_levelling]")
+{
+    const esp_partition_t *partition = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY, "storage");
+    const uint32_t rounds = 8;
+    size_t erase_ops[2];
+    size_t write_bytes[2];
+
+    for (int use_discard = 0; use_discard < 2; use_discard++) {
+        wl_config_t cfg;
+        init_wl_config(&cfg, partition);
+
+        Partition *part = new Partition(partition);
+        WL_Flash *wl_flash = new WL_Flash();
+        REQUIRE(wl_flash->config(&cfg, part) == ESP_OK);
+        REQUIRE(wl_flash->init() == ESP_OK);
+
+        size_t sector_size = wl_flash->get_sector_size();
+        size_t log_sectors = wl_flash->get_flash_size() / sector_size * 3 / 4;
+        uint32_t *sector_data = new uint32_t[sector_size / sizeof(uint32_t)];
+
+        // Sector 0 holds data which stays valid, the rest is a log file which is rewritten and deleted
+        for (uint32_t m = 0; m < sector_size / sizeof(uint32_t); m++) {
+            sector_data[m] = 0x5a5a0000 + m;
+        }
+        REQUIRE(wl_flash->erase_sector(0) == ESP_OK);
+        REQUIRE(wl_flash->write(0, sector_data, sector_size) == ESP_OK);
+
+        esp_partition_clear_stats();
+        for (uint32_t round = 0; round < rounds; round++) {
+            for (size_t sector = 1; sector <= log_sectors; sector++) {
+                for (uint32_t m = 0; m < sector_size / sizeof(uint32_t); m++) {
+                    sector_data[m] = round * sector_size + sector + m;
+                }
+                REQUIRE(wl_flash->erase_sector(sector) == ESP_OK);
+                REQUIRE(wl_flash->write(sector * sector_size, sector_data, sector_size) == ESP_OK);
+            }
+            if (use_discard) {
+                REQUIRE(wl_flash->discard(sector_size, log_sectors * sector_size) == ESP_OK);
+            }
+        }
+        erase_ops[use_discard] = esp_partition_get_erase_ops();
+        write_bytes[use_discard] = esp_partition_get_write_bytes();
+        ESP_LOGI(TAG, "discard: %d, partition erases: %zu, bytes written: %zu", use_discard, erase_ops[use_discard], write_bytes[use_discard]);
+
+        // Data which was not discarded survives the relocations
+        REQUIRE(wl_flash->read(0, sector_data, sector_size) == ESP_OK);
+        for (uint32_t m = 0; m < sector_size / sizeof(uint32_t); m++) {
+            REQUIRE(sector_data[m] == 0x5a5a0000 + m);
+        }
+
+        delete[] sector_data;
+        delete wl_flash;
+        delete part;
+    }
+
+    REQUIRE(erase_ops[1] < erase_ops[0]);
+    REQUIRE(write_bytes[1] < write_bytes[0]);
+}
@@ -21,6 +21,18 @@ typedef int32_t wl_handle_t;
 
 #define WL_INVALID_HANDLE -1
 
+/**
+* @brief Statistics of the write-back sector cache, see wl_get_cache_stats()
+*/
+typedef struct {
+    uint32_t read_hits;         /*!< Sector reads served from the cache */
+    uint32_t read_misses;       /*!< Sector reads served from flash */
+    uint32_t write_hits;        /*!< Sector writes and erases absorbed by the cache */
+    uint32_t write_misses;      /*!< Sector writes which went directly to flash */
+    uint32_t writebacks;        /*!< Modified sectors written back from the cache to flash */
+    uint32_t flash_erases;      /*!< Flash sectors erased for data, with or without the cache */
+} wl_cache_stats_t;
+
 /**
 * @brief Mount WL for defined partition
 *
@@ -62,6 +74,26 @@ esp_err_t wl_unmount(wl_handle_t handle);
 */
 esp_err_t wl_erase_range(wl_handle_t handle, size_t start_addr, size_t size);
 
+/**
+* @brief Inform WL that the data in a range is no longer needed
+*
+* The content of the discarded sectors is undefined until they are erased and written again.
+* WL does not copy discarded sectors when it relocates data, and skips erasing a discarded
+* sector which is already erased. Sectors which are only partially covered by the range are
+* ignored. The information is kept in RAM only and is lost on unmount.
+*
+* @param handle WL handle that are related to the partition
+* @param start_addr Address where the discarded range starts
+* @param size Size of the discarded range, in bytes
+*
+* @return
+*       - ESP_OK, if the range was recorded;
+*       - ESP_ERR_INVALID_STATE, if the WL instance is not initialized;
+*       - ESP_ERR_INVALID_ARG, if the handle is out of range;
+*       - ESP_ERR_NOT_FOUND, if the handle is not initialized.
+*/
+esp_err_t wl_discard(wl_handle_t handle, size_t start_addr, size_t size);
+
 /**
 * @brief Write data to the WL storage
 *
@@ -120,6 +152,32 @@ size_t wl_size(wl_handle_t handle);
 */
 size_t wl_sector_size(wl_handle_t handle);
 
+/**
+* @brief Write all the sectors modified in the write-back cache to flash
+*
+* Does nothing if the cache is disabled (CONFIG_WL_CACHE_SECTORS is 0).
+*
+* @param handle WL module handle that was initialized before
+*
+* @return
+*       - ESP_OK, if the operation is successful;
+*       - or one of error codes from lower-level flash driver.
+*/
+esp_err_t wl_flush(wl_handle_t handle);
+
+/**
+* @brief Get the statistics of the write-back sector cache
+*
+* @param handle WL module handle that was initialized before
+* @param[out] stats Statistics since the partition was mounted
+*
+* @return
+*       - ESP_OK, if the statistics were returned;
+*       - ESP_ERR_INVALID_ARG, if stats is NULL or the handle is out of range;
+*       - ESP_ERR_NOT_FOUND, if the handle is not initialized.
+*/
+esp_err_t wl_get_cache_stats(wl_handle_t handle, wl_cache_stats_t *stats);
+
 
 #ifdef __cplusplus
 } // extern "C"
@@ -30,6 +30,12 @@ public:
         return ESP_OK;
     };
 
+    // Inform the device that the data in the range is no longer needed
+    virtual esp_err_t discard(size_t /*start_address*/, size_t /*size*/)
+    {
+        return ESP_OK;
+    };
+
     virtual ~Flash_Access() {};
 };
 
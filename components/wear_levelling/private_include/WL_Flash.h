@@ -7,6 +7,7 @@
 #define _WL_Flash_H_
 
 #include "esp_err.h"
+#include "wear_levelling.h"
 #include "Flash_Access.h"
 #include "Partition.h"
 #include "WL_Config.h"
@@ -35,6 +36,17 @@ public :
     esp_err_t read(size_t src_addr, void *dest, size_t size) override;
 
     esp_err_t flush() override;
+    esp_err_t discard(size_t start_address, size_t size) override;
+
+    /**
+    * @brief Enable the write-back sector cache. Must be called after config() and before init().
+    *
+    * Erased and rewritten sectors are kept in RAM and written to flash when they are evicted,
+    * when flush_cache() is called, or after flush_interval modifications (0 disables periodic flushing).
+    */
+    esp_err_t config_cache(size_t sector_count, size_t flush_interval);
+    esp_err_t flush_cache();
+    void get_cache_stats(wl_cache_stats_t *stats);
 
     Partition *get_part();
     wl_config_t *get_cfg();
@@ -64,6 +76,39 @@ protected:
     esp_err_t recoverPos();
     size_t calcAddr(size_t addr);
 
+    struct cache_line_t {
+        size_t sector;
+        uint32_t last_access;
+        bool valid;
+        bool dirty;
+        uint8_t *data;
+    };
+    cache_line_t *cache = NULL;
+    size_t cache_count = 0;
+    size_t cache_flush_interval = 0;
+    size_t cache_dirty_ops = 0;
+    uint32_t cache_access = 0;
+    wl_cache_stats_t cache_stats = {};
+
+    cache_line_t *cache_find(size_t sector);
+    esp_err_t cache_alloc(size_t sector, cache_line_t **out_line);
+    esp_err_t cache_writeback(cache_line_t *line);
+    esp_err_t cache_modified(cache_line_t *line);
+
+    // One bit per sector: data discarded by the user, and sectors known to be erased on flash
+    uint32_t *discarded_map = NULL;
+    uint32_t *erased_map = NULL;
+    size_t map_sector_count = 0;
+
+    bool getSectorFlag(const uint32_t *map, size_t sector);
+    void setSectorFlag(uint32_t *map, size_t sector, bool value);
+    bool isPageDiscarded(size_t addr);
+    size_t calcLogicalAddr(size_t page_pos);
+
+    esp_err_t erase_sector_direct(size_t sector);
+    esp_err_t write_direct(size_t dest_addr, const void *src, size_t size);
+    esp_err_t read_direct(size_t src_addr, void *dest, size_t size);
+
     esp_err_t updateVersion();
     esp_err_t updateV1_V2();
     void fillOkBuff(int n);
@@ -140,6 +140,15 @@ esp_err_t wl_mount(const esp_partition_t *partition, wl_handle_t *out_handle)
         goto out;
     }
 
+#if CONFIG_WL_CACHE_SECTORS
+    // Allocate the write-back sector cache
+    result = wl_flash->config_cache(CONFIG_WL_CACHE_SECTORS, CONFIG_WL_CACHE_FLUSH_INTERVAL);
+    if (ESP_OK != result) {
+        ESP_LOGE(TAG, "%s: can't allocate sector cache, result=0x%x", __func__, result);
+        goto out;
+    }
+#endif // CONFIG_WL_CACHE_SECTORS
+
     // Initialise sectors used by WL layer for respective flash driver
     result = wl_flash->init();
     if (ESP_OK != result) {
@@ -203,6 +212,18 @@ esp_err_t wl_erase_range(wl_handle_t handle, size_t start_addr, size_t size)
     return result;
 }
 
+esp_err_t wl_discard(wl_handle_t handle, size_t start_addr, size_t size)
+{
+    esp_err_t result = check_handle(handle, __func__);
+    if (result != ESP_OK) {
+        return result;
+    }
+    _lock_acquire(&s_instances[handle].lock);
+    result = s_instances[handle].instance->discard(start_addr, size);
+    _lock_release(&s_instances[handle].lock);
+    return result;
+}
+
 esp_err_t wl_write(wl_handle_t handle, size_t dest_addr, const void *src, size_t size)
 {
     esp_err_t result = check_handle(handle, __func__);
@@ -251,6 +272,33 @@ size_t wl_sector_size(wl_handle_t handle)
     return result;
 }
 
+esp_err_t wl_flush(wl_handle_t handle)
+{
+    esp_err_t result = check_handle(handle, __func__);
+    if (result != ESP_OK) {
+        return result;
+    }
+    _lock_acquire(&s_instances[handle].lock);
+    result = s_instances[handle].instance->flush_cache();
+    _lock_release(&s_instances[handle].lock);
+    return result;
+}
+
+esp_err_t wl_get_cache_stats(wl_handle_t handle, wl_cache_stats_t *stats)
+{
+    if (stats == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    esp_err_t result = check_handle(handle, __func__);
+    if (result != ESP_OK) {
+        return result;
+    }
+    _lock_acquire(&s_instances[handle].lock);
+    s_instances[handle].instance->get_cache_stats(stats);
+    _lock_release(&s_instances[handle].lock);
+    return ESP_OK;
+}
+
 static esp_err_t check_handle(wl_handle_t handle, const char *func)
 {
     if (handle == WL_INVALID_HANDLE) {